@@ -4951,10 +4951,6 @@ def register_Ns3ArpCache_methods(root_module, cls):
     cls.add_method('SetWaitReplyTimeout', 
                    'void', 
                    [param('ns3::Time', 'waitReplyTimeout')])
-    ## arp-cache.h (module 'internet'): void ns3::ArpCache::StartWaitReplyTimer() [member function]
-    cls.add_method('StartWaitReplyTimer', 
-                   'void', 
-                   [])
     ## arp-cache.h (module 'internet'): void ns3::ArpCache::DoDispose() [member function]
     cls.add_method('DoDispose', 
                    'void', 
@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTI_FLOW_HELPER_H
+#define MULTI_FLOW_HELPER_H
+
+#include <stdint.h>
+#include <string>
+#include "ns3/object-factory.h"
+#include "ns3/address.h"
+#include "ns3/attribute.h"
+#include "ns3/node-container.h"
+#include "ns3/application-container.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup multiflow
+ * \brief A helper to make it easier to instantiate an ns3::MultiFlowApplication
+ * on a set of nodes.
+ */
+class MultiFlowHelper
+{
+public:
+  /**
+   * Create a MultiFlowHelper to make it easier to work with MultiFlowApplications
+   *
+   * \param remote the address of the MultiFlowSink to send the flows to.
+   */
+  MultiFlowHelper (Address remote);
+
+  /**
+   * Helper function used to set the underlying application attributes,
+   * _not_ the socket attributes.
+   *
+   * \param name the name of the application attribute to set
+   * \param value the value of the application attribute to set
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * Install an ns3::MultiFlowApplication on each node of the input container
+   * configured with all the attributes set with SetAttribute.
+   *
+   * \param c NodeContainer of the set of nodes on which a MultiFlowApplication
+   * will be installed.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (NodeContainer c) const;
+
+  /**
+   * Install an ns3::MultiFlowApplication on the node configured with all the
+   * attributes set with SetAttribute.
+   *
+   * \param node The node on which a MultiFlowApplication will be installed.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (Ptr<Node> node) const;
+
+  /**
+   * Install an ns3::MultiFlowApplication on the node configured with all the
+   * attributes set with SetAttribute.
+   *
+   * \param nodeName The node on which a MultiFlowApplication will be installed.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (std::string nodeName) const;
+
+private:
+  /**
+   * Install an ns3::MultiFlowApplication on the node configured with all the
+   * attributes set with SetAttribute.
+   *
+   * \param node The node on which a MultiFlowApplication will be installed.
+   * \returns Ptr to the application installed.
+   */
+  Ptr<Application> InstallPriv (Ptr<Node> node) const;
+
+  ObjectFactory m_factory; //!< Object factory.
+};
+
+/**
+ * \ingroup multiflow
+ * \brief A helper to make it easier to instantiate an ns3::MultiFlowSink
+ * on a set of nodes.
+ */
+class MultiFlowSinkHelper
+{
+public:
+  /**
+   * Create a MultiFlowSinkHelper to make it easier to work with MultiFlowSinks
+   *
+   * \param local the address the MultiFlowSink binds to.
+   */
+  MultiFlowSinkHelper (Address local);
+
+  /**
+   * Helper function used to set the underlying application attributes,
+   * _not_ the socket attributes.
+   *
+   * \param name the name of the application attribute to set
+   * \param value the value of the application attribute to set
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * Install an ns3::MultiFlowSink on each node of the input container
+   * configured with all the attributes set with SetAttribute.
+   *
+   * \param c NodeContainer of the set of nodes on which a MultiFlowSink
+   * will be installed.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (NodeContainer c) const;
+
+  /**
+   * Install an ns3::MultiFlowSink on the node configured with all the
+   * attributes set with SetAttribute.
+   *
+   * \param node The node on which a MultiFlowSink will be installed.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (Ptr<Node> node) const;
+
+  /**
+   * Install an ns3::MultiFlowSink on the node configured with all the
+   * attributes set with SetAttribute.
+   *
+   * \param nodeName The node on which a MultiFlowSink will be installed.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (std::string nodeName) const;
+
+private:
+  /**
+   * Install an ns3::MultiFlowSink on the node configured with all the
+   * attributes set with SetAttribute.
+   *
+   * \param node The node on which a MultiFlowSink will be installed.
+   * \returns Ptr to the application installed.
+   */
+  Ptr<Application> InstallPriv (Ptr<Node> node) const;
+
+  ObjectFactory m_factory; //!< Object factory.
+};
+
+} // namespace ns3
+
+#endif /* MULTI_FLOW_HELPER_H */
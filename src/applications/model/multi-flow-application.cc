@@ -0,0 +1,367 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "ns3/log.h"
+#include "ns3/address.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/socket-factory.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/fatal-error.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/inet6-socket-address.h"
+#include "multi-flow-header.h"
+#include "multi-flow-application.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MultiFlowApplication");
+
+NS_OBJECT_ENSURE_REGISTERED (MultiFlowApplication);
+
+namespace {
+
+/// A point of a flow size distribution, in packets of 1460 bytes
+struct FlowSizeCdfPoint
+{
+  double packets;   //!< the flow size
+  double cdf;       //!< the probability that a flow is not larger
+};
+
+/// The web search distribution of the DCTCP paper
+const FlowSizeCdfPoint g_webSearchCdf[] = {
+  { 6, 0 }, { 6, 0.15 }, { 13, 0.2 }, { 19, 0.3 }, { 33, 0.4 }, { 53, 0.53 },
+  { 133, 0.6 }, { 667, 0.7 }, { 1333, 0.8 }, { 3333, 0.9 }, { 6667, 0.97 },
+  { 20000, 1 }
+};
+
+/// The data mining distribution of the VL2 paper
+const FlowSizeCdfPoint g_dataMiningCdf[] = {
+  { 1, 0 }, { 1, 0.5 }, { 2, 0.6 }, { 3, 0.7 }, { 7, 0.8 }, { 267, 0.9 },
+  { 2107, 0.95 }, { 66667, 0.99 }, { 666667, 1 }
+};
+
+} // anonymous namespace
+
+TypeId
+MultiFlowApplication::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultiFlowApplication")
+    .SetParent<Application> ()
+    .SetGroupName("Applications")
+    .AddConstructor<MultiFlowApplication> ()
+    .AddAttribute ("Remote", "The address of the destination",
+                   AddressValue (),
+                   MakeAddressAccessor (&MultiFlowApplication::m_peer),
+                   MakeAddressChecker ())
+    .AddAttribute ("Interval",
+                   "A RandomVariableStream used to pick the time between the "
+                   "starts of two flows.",
+                   StringValue ("ns3::ExponentialRandomVariable[Mean=0.001]"),
+                   MakePointerAccessor (&MultiFlowApplication::m_interval),
+                   MakePointerChecker <RandomVariableStream>())
+    .AddAttribute ("FlowSize",
+                   "A RandomVariableStream used to pick the size of the flows, "
+                   "in bytes.",
+                   StringValue ("ns3::ConstantRandomVariable[Constant=100000]"),
+                   MakePointerAccessor (&MultiFlowApplication::m_flowSize),
+                   MakePointerChecker <RandomVariableStream>())
+    .AddAttribute ("FlowRate", "The rate at which each flow sends.",
+                   DataRateValue (DataRate ("10Mbps")),
+                   MakeDataRateAccessor (&MultiFlowApplication::m_flowRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("PacketSize", "The size of the packets, header included.",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&MultiFlowApplication::m_pktSize),
+                   MakeUintegerChecker<uint32_t> (16))
+    .AddAttribute ("MaxFlows",
+                   "The total number of flows to start. The value zero means "
+                   "that there is no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultiFlowApplication::m_maxFlows),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddTraceSource ("FlowStart", "A new flow starts",
+                     MakeTraceSourceAccessor (&MultiFlowApplication::m_flowStartTrace),
+                     "ns3::MultiFlowApplication::FlowTracedCallback")
+    .AddTraceSource ("Tx", "A new packet is created and is sent",
+                     MakeTraceSourceAccessor (&MultiFlowApplication::m_txTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+
+MultiFlowApplication::MultiFlowApplication ()
+  : m_socket (0),
+    m_started (0),
+    m_nextId (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_remoteChoice = CreateObject<UniformRandomVariable> ();
+}
+
+MultiFlowApplication::~MultiFlowApplication ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultiFlowApplication::AddRemote (Address remote)
+{
+  NS_LOG_FUNCTION (this << remote);
+  m_remotes.push_back (remote);
+}
+
+Ptr<Socket>
+MultiFlowApplication::GetSocket (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_socket;
+}
+
+uint32_t
+MultiFlowApplication::GetStartedFlows (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_started;
+}
+
+uint32_t
+MultiFlowApplication::GetActiveFlows (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_flows.size () - m_free.size ();
+}
+
+Ptr<EmpiricalRandomVariable>
+MultiFlowApplication::GetFlowSizeCdf (std::string name)
+{
+  NS_LOG_FUNCTION (name);
+  const FlowSizeCdfPoint *points;
+  uint32_t n;
+  if (name == "WebSearch")
+    {
+      points = g_webSearchCdf;
+      n = sizeof (g_webSearchCdf) / sizeof (g_webSearchCdf[0]);
+    }
+  else if (name == "DataMining")
+    {
+      points = g_dataMiningCdf;
+      n = sizeof (g_dataMiningCdf) / sizeof (g_dataMiningCdf[0]);
+    }
+  else
+    {
+      NS_FATAL_ERROR ("MultiFlowApplication: unknown flow size distribution \"" << name << "\"");
+      return 0;
+    }
+  Ptr<EmpiricalRandomVariable> cdf = CreateObject<EmpiricalRandomVariable> ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      cdf->CDF (points[i].packets * 1460, points[i].cdf);
+    }
+  return cdf;
+}
+
+Ptr<EmpiricalRandomVariable>
+MultiFlowApplication::LoadFlowSizeCdf (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ifstream file (filename.c_str ());
+  if (!file.is_open ())
+    {
+      NS_FATAL_ERROR ("MultiFlowApplication: unable to read flow size distribution \"" << filename << "\"");
+    }
+  Ptr<EmpiricalRandomVariable> cdf = CreateObject<EmpiricalRandomVariable> ();
+  std::string line;
+  while (std::getline (file, line))
+    {
+      if (line.empty () || line[0] == '#')
+        {
+          continue;
+        }
+      std::istringstream iss (line);
+      double size, c;
+      if (iss >> size >> c)
+        {
+          cdf->CDF (size, c);
+        }
+    }
+  return cdf;
+}
+
+int64_t
+MultiFlowApplication::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_interval->SetStream (stream);
+  m_flowSize->SetStream (stream + 1);
+  m_remoteChoice->SetStream (stream + 2);
+  return 3;
+}
+
+void
+MultiFlowApplication::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_socket = 0;
+  m_wheel.Clear ();
+  m_free.clear ();
+  m_flows.clear ();
+  // chain up
+  Application::DoDispose ();
+}
+
+// Application Methods
+void MultiFlowApplication::StartApplication (void) // Called at time specified by Start
+{
+  NS_LOG_FUNCTION (this);
+
+  m_destinations.clear ();
+  if (!m_peer.IsInvalid ())
+    {
+      m_destinations.push_back (m_peer);
+    }
+  m_destinations.insert (m_destinations.end (), m_remotes.begin (), m_remotes.end ());
+  if (m_destinations.empty ())
+    {
+      NS_FATAL_ERROR ("MultiFlowApplication: no destination");
+    }
+
+  // Create the socket if not already
+  if (!m_socket)
+    {
+      m_socket = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId ());
+      if (Inet6SocketAddress::IsMatchingType (m_destinations[0]))
+        {
+          m_socket->Bind6 ();
+        }
+      else
+        {
+          m_socket->Bind ();
+        }
+      m_socket->ShutdownRecv ();
+    }
+
+  StartFlow ();
+}
+
+void MultiFlowApplication::StopApplication (void) // Called at time specified by Stop
+{
+  NS_LOG_FUNCTION (this);
+
+  Simulator::Cancel (m_startEvent);
+  m_wheel.Clear ();
+  m_free.clear ();
+  for (std::deque<Flow>::iterator i = m_flows.begin (); i != m_flows.end (); ++i)
+    {
+      m_free.push_back (&*i);
+    }
+  if (m_socket != 0)
+    {
+      m_socket->Close ();
+    }
+  else
+    {
+      NS_LOG_WARN ("MultiFlowApplication found null socket to close in StopApplication");
+    }
+}
+
+void
+MultiFlowApplication::StartFlow (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Flow *flow;
+  if (m_free.empty ())
+    {
+      m_flows.emplace_back ();
+      flow = &m_flows.back ();
+      flow->app = this;
+      flow->timer.SetFunction (MakeCallback (&MultiFlowApplication::Flow::Send, flow));
+    }
+  else
+    {
+      flow = m_free.back ();
+      m_free.pop_back ();
+    }
+  flow->id = m_nextId++;
+  flow->size = std::max (1.0, m_flowSize->GetValue ());
+  flow->sent = 0;
+  flow->remote = m_destinations.size () > 1 ? m_remoteChoice->GetInteger (0, m_destinations.size () - 1) : 0;
+  flow->start = Simulator::Now ();
+  m_started++;
+  NS_LOG_LOGIC ("Flow " << flow->id << " of " << flow->size << " bytes starts");
+  m_flowStartTrace (flow->id, flow->size);
+  SendPacket (flow);
+
+  if (m_maxFlows == 0 || m_started < m_maxFlows)
+    {
+      m_startEvent = Simulator::Schedule (Seconds (m_interval->GetValue ()),
+                                          &MultiFlowApplication::StartFlow, this);
+    }
+}
+
+void
+MultiFlowApplication::Flow::Send (void)
+{
+  app->SendPacket (this);
+}
+
+void
+MultiFlowApplication::SendPacket (Flow *flow)
+{
+  NS_LOG_FUNCTION (this << flow->id);
+
+  MultiFlowHeader header;
+  header.SetFlowId (flow->id);
+  header.SetFlowSize (flow->size);
+  header.SetStart (flow->start);
+
+  // the header counts in the bytes of the flow, but the packet carries
+  // at least the header
+  uint32_t bytes = std::min (flow->size - flow->sent, m_pktSize);
+  Ptr<Packet> packet = Create<Packet> (std::max (bytes, header.GetSerializedSize ()) - header.GetSerializedSize ());
+  packet->AddHeader (header);
+  flow->sent += bytes;
+
+  m_txTrace (packet);
+  if (m_socket->SendTo (packet, 0, m_destinations[flow->remote]) < 0)
+    {
+      NS_LOG_INFO ("Error while sending " << packet->GetSize () << " bytes");
+    }
+
+  if (flow->sent < flow->size)
+    {
+      m_wheel.Schedule (&flow->timer, m_flowRate.CalculateBytesTxTime (packet->GetSize ()));
+    }
+  else
+    {
+      NS_LOG_LOGIC ("Flow " << flow->id << " sent");
+      m_free.push_back (flow);
+    }
+}
+
+} // Namespace ns3
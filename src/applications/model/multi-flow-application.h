@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTI_FLOW_APPLICATION_H
+#define MULTI_FLOW_APPLICATION_H
+
+#include <deque>
+#include <vector>
+#include <string>
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "ns3/timer-wheel.h"
+#include "ns3/traced-callback.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+class Socket;
+class Packet;
+
+/**
+ * \ingroup applications
+ * \defgroup multiflow MultiFlowApplication
+ *
+ * This traffic generator drives many flows from a single application.
+ */
+
+/**
+ * \ingroup multiflow
+ *
+ * \brief Generate many UDP flows from one application and one socket.
+ *
+ * Flows arrive one after the other, separated by the "Interval" random
+ * variable, each with a size drawn from the "FlowSize" random variable
+ * (see GetFlowSizeCdf and LoadFlowSizeCdf for empirical distributions of
+ * web search and data mining traffic) and a destination picked among the
+ * remote addresses.  Each flow sends its bytes in packets of PacketSize
+ * bytes, paced at FlowRate, with a MultiFlowHeader telling its identifier,
+ * size and start time to the MultiFlowSink which measures its completion
+ * time.
+ *
+ * All the flows share the socket of the application, and their pacing
+ * timers run on one TimerWheel, so that an application with a million
+ * active flows costs a million small records and not a million
+ * applications, sockets and scheduled events.  The flows are open loop:
+ * they do not react to losses nor to congestion.
+ */
+class MultiFlowApplication : public Application
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MultiFlowApplication ();
+
+  virtual ~MultiFlowApplication ();
+
+  /**
+   * \brief Add a destination of the flows, besides "Remote"
+   * \param remote the address of a MultiFlowSink
+   */
+  void AddRemote (Address remote);
+
+  /**
+   * \brief Get the socket this application is attached to.
+   * \return pointer to associated socket
+   */
+  Ptr<Socket> GetSocket (void) const;
+
+  /**
+   * \return the number of flows started so far
+   */
+  uint32_t GetStartedFlows (void) const;
+
+  /**
+   * \return the number of flows still sending
+   */
+  uint32_t GetActiveFlows (void) const;
+
+  /**
+   * \brief Get an empirical flow size distribution of the literature
+   *
+   * "WebSearch" is the distribution of the web search cluster measured in
+   * the DCTCP paper, "DataMining" the distribution of the data mining
+   * cluster measured in the VL2 paper, both as used by the pFabric
+   * simulations.
+   *
+   * \param name the name of the distribution
+   * \return the distribution of the flow sizes, in bytes
+   */
+  static Ptr<EmpiricalRandomVariable> GetFlowSizeCdf (std::string name);
+
+  /**
+   * \brief Load an empirical flow size distribution
+   *
+   * Each line of the file holds a flow size in bytes and the probability
+   * that a flow is not larger, in increasing order; lines starting with
+   * '#' are ignored.
+   *
+   * \param filename the name of the file
+   * \return the distribution of the flow sizes, in bytes
+   */
+  static Ptr<EmpiricalRandomVariable> LoadFlowSizeCdf (std::string filename);
+
+  /**
+   * \brief Assign a fixed random variable stream number to the random variables
+   * used by this model.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+  /**
+   * TracedCallback signature for the start of a flow.
+   *
+   * \param [in] id The identifier of the flow.
+   * \param [in] size The size of the flow, in bytes.
+   */
+  typedef void (* FlowTracedCallback)(uint32_t id, uint32_t size);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);    // Called at time specified by Start
+  virtual void StopApplication (void);     // Called at time specified by Stop
+
+  /// A flow
+  struct Flow
+  {
+    TimerWheel::Timer timer;      //!< the pacing timer
+    MultiFlowApplication *app;    //!< the application
+    uint32_t id;                  //!< the identifier of the flow
+    uint32_t size;                //!< the size of the flow
+    uint32_t sent;                //!< the bytes sent
+    uint32_t remote;              //!< the index of the destination
+    Time start;                   //!< the start of the flow
+    /// Send the next packet of the flow
+    void Send (void);
+  };
+
+  /**
+   * \brief Start a flow and schedule the next one
+   */
+  void StartFlow (void);
+  /**
+   * \brief Send the next packet of a flow
+   * \param flow the flow
+   */
+  void SendPacket (Flow *flow);
+
+  Ptr<Socket>     m_socket;       //!< Associated socket
+  Address         m_peer;         //!< Peer address
+  std::vector<Address> m_remotes; //!< The destinations added besides m_peer
+  std::vector<Address> m_destinations; //!< All the destinations of the flows
+  Ptr<RandomVariableStream> m_interval; //!< Time between the starts of two flows
+  Ptr<RandomVariableStream> m_flowSize; //!< Size of the flows
+  Ptr<UniformRandomVariable> m_remoteChoice; //!< Choice of the destination
+  DataRate        m_flowRate;     //!< Rate of each flow
+  uint32_t        m_pktSize;      //!< Size of the packets
+  uint32_t        m_maxFlows;     //!< Limit total number of flows
+  uint32_t        m_started;      //!< Counter for started flows
+  uint32_t        m_nextId;       //!< Identifier of the next flow
+  std::deque<Flow> m_flows;       //!< The flows, active or free
+  std::vector<Flow *> m_free;     //!< The free flows
+  TimerWheel      m_wheel;        //!< The pacing timers of the flows
+  EventId         m_startEvent;   //!< Event id of the next flow start
+
+  /// Traced Callback: started flows
+  TracedCallback<uint32_t, uint32_t> m_flowStartTrace;
+  /// Traced Callback: sent packets
+  TracedCallback<Ptr<const Packet> > m_txTrace;
+};
+
+} // namespace ns3
+
+#endif /* MULTI_FLOW_APPLICATION_H */
@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "multi-flow-header.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MultiFlowHeader");
+
+NS_OBJECT_ENSURE_REGISTERED (MultiFlowHeader);
+
+MultiFlowHeader::MultiFlowHeader ()
+  : m_flowId (0),
+    m_flowSize (0),
+    m_start (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultiFlowHeader::SetFlowId (uint32_t id)
+{
+  NS_LOG_FUNCTION (this << id);
+  m_flowId = id;
+}
+uint32_t
+MultiFlowHeader::GetFlowId (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_flowId;
+}
+
+void
+MultiFlowHeader::SetFlowSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  m_flowSize = size;
+}
+uint32_t
+MultiFlowHeader::GetFlowSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_flowSize;
+}
+
+void
+MultiFlowHeader::SetStart (Time start)
+{
+  NS_LOG_FUNCTION (this << start);
+  m_start = start.GetTimeStep ();
+}
+Time
+MultiFlowHeader::GetStart (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return TimeStep (m_start);
+}
+
+TypeId
+MultiFlowHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultiFlowHeader")
+    .SetParent<Header> ()
+    .SetGroupName("Applications")
+    .AddConstructor<MultiFlowHeader> ()
+  ;
+  return tid;
+}
+TypeId
+MultiFlowHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+void
+MultiFlowHeader::Print (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  os << "(flow=" << m_flowId << " size=" << m_flowSize
+     << " start=" << TimeStep (m_start).GetSeconds () << ")";
+}
+uint32_t
+MultiFlowHeader::GetSerializedSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return 4+4+8;
+}
+
+void
+MultiFlowHeader::Serialize (Buffer::Iterator start) const
+{
+  NS_LOG_FUNCTION (this << &start);
+  Buffer::Iterator i = start;
+  i.WriteHtonU32 (m_flowId);
+  i.WriteHtonU32 (m_flowSize);
+  i.WriteHtonU64 (m_start);
+}
+uint32_t
+MultiFlowHeader::Deserialize (Buffer::Iterator start)
+{
+  NS_LOG_FUNCTION (this << &start);
+  Buffer::Iterator i = start;
+  m_flowId = i.ReadNtohU32 ();
+  m_flowSize = i.ReadNtohU32 ();
+  m_start = i.ReadNtohU64 ();
+  return GetSerializedSize ();
+}
+
+} // namespace ns3
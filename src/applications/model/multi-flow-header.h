@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTI_FLOW_HEADER_H
+#define MULTI_FLOW_HEADER_H
+
+#include "ns3/header.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup multiflow
+ * \class MultiFlowHeader
+ * \brief Packet header of the flows of a MultiFlowApplication.
+ *
+ * The header is made of the 32bits identifier of the flow, its 32bits
+ * size in bytes and the 64bits time stamp of its start.
+ */
+class MultiFlowHeader : public Header
+{
+public:
+  MultiFlowHeader ();
+
+  /**
+   * \param id the identifier of the flow
+   */
+  void SetFlowId (uint32_t id);
+  /**
+   * \return the identifier of the flow
+   */
+  uint32_t GetFlowId (void) const;
+  /**
+   * \param size the size of the flow, in bytes
+   */
+  void SetFlowSize (uint32_t size);
+  /**
+   * \return the size of the flow, in bytes
+   */
+  uint32_t GetFlowSize (void) const;
+  /**
+   * \param start the time at which the flow started
+   */
+  void SetStart (Time start);
+  /**
+   * \return the time at which the flow started
+   */
+  Time GetStart (void) const;
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+private:
+  uint32_t m_flowId; //!< Flow identifier
+  uint32_t m_flowSize; //!< Flow size
+  uint64_t m_start; //!< Start time stamp
+};
+
+} // namespace ns3
+
+#endif /* MULTI_FLOW_HEADER_H */
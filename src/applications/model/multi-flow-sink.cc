@@ -0,0 +1,237 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "ns3/log.h"
+#include "ns3/address.h"
+#include "ns3/node.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/fatal-error.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/udp-socket-factory.h"
+#include "multi-flow-header.h"
+#include "multi-flow-sink.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MultiFlowSink");
+
+NS_OBJECT_ENSURE_REGISTERED (MultiFlowSink);
+
+TypeId
+MultiFlowSink::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultiFlowSink")
+    .SetParent<Application> ()
+    .SetGroupName("Applications")
+    .AddConstructor<MultiFlowSink> ()
+    .AddAttribute ("Local",
+                   "The Address on which to Bind the rx socket.",
+                   AddressValue (),
+                   MakeAddressAccessor (&MultiFlowSink::m_local),
+                   MakeAddressChecker ())
+    .AddAttribute ("FctFile",
+                   "The name of the file to write the completion times to, "
+                   "if any.",
+                   StringValue (""),
+                   MakeStringAccessor (&MultiFlowSink::m_fctFilename),
+                   MakeStringChecker ())
+    .AddAttribute ("KeepFcts",
+                   "Whether to keep the completion times of the flows "
+                   "for GetFctPercentile.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&MultiFlowSink::m_keepFcts),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("Rx",
+                     "A packet has been received",
+                     MakeTraceSourceAccessor (&MultiFlowSink::m_rxTrace),
+                     "ns3::Packet::PacketAddressTracedCallback")
+    .AddTraceSource ("FlowCompleted",
+                     "A flow has been received entirely",
+                     MakeTraceSourceAccessor (&MultiFlowSink::m_fctTrace),
+                     "ns3::MultiFlowSink::FctTracedCallback")
+  ;
+  return tid;
+}
+
+MultiFlowSink::MultiFlowSink ()
+  : m_socket (0),
+    m_totalRx (0),
+    m_keepFcts (true),
+    m_completed (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MultiFlowSink::~MultiFlowSink ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint64_t
+MultiFlowSink::GetTotalRx (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_totalRx;
+}
+
+uint32_t
+MultiFlowSink::GetCompletedFlows (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_completed;
+}
+
+uint32_t
+MultiFlowSink::GetIncompleteFlows (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_flows.size ();
+}
+
+Time
+MultiFlowSink::GetMeanFct (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_completed == 0)
+    {
+      return Seconds (0);
+    }
+  return m_fctSum / static_cast<int64_t> (m_completed);
+}
+
+Time
+MultiFlowSink::GetFctPercentile (double p) const
+{
+  NS_LOG_FUNCTION (this << p);
+  NS_ASSERT (p >= 0 && p <= 100);
+  NS_ASSERT_MSG (m_keepFcts, "MultiFlowSink: the completion times are not kept");
+  if (m_fcts.empty ())
+    {
+      return Seconds (0);
+    }
+  uint32_t rank = static_cast<uint32_t> (std::ceil (p / 100 * m_fcts.size ()));
+  rank = std::max (rank, 1u) - 1;
+  std::nth_element (m_fcts.begin (), m_fcts.begin () + rank, m_fcts.end ());
+  return m_fcts[rank];
+}
+
+void
+MultiFlowSink::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_socket = 0;
+  m_flows.clear ();
+
+  // chain up
+  Application::DoDispose ();
+}
+
+
+// Application Methods
+void MultiFlowSink::StartApplication ()    // Called at time specified by Start
+{
+  NS_LOG_FUNCTION (this);
+  // Create the socket if not already
+  if (!m_socket)
+    {
+      m_socket = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId ());
+      m_socket->Bind (m_local);
+      m_socket->ShutdownSend ();
+    }
+  m_socket->SetRecvCallback (MakeCallback (&MultiFlowSink::HandleRead, this));
+
+  if (!m_fctFilename.empty () && !m_fctFile.is_open ())
+    {
+      m_fctFile.open (m_fctFilename.c_str ());
+      if (!m_fctFile.is_open ())
+        {
+          NS_FATAL_ERROR ("MultiFlowSink: unable to write \"" << m_fctFilename << "\"");
+        }
+    }
+}
+
+void MultiFlowSink::StopApplication ()     // Called at time specified by Stop
+{
+  NS_LOG_FUNCTION (this);
+  if (m_socket)
+    {
+      m_socket->Close ();
+      m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+    }
+  if (m_fctFile.is_open ())
+    {
+      m_fctFile.close ();
+    }
+  NS_LOG_INFO ("MultiFlowSink completed " << m_completed << " flows, "
+               << m_flows.size () << " flows incomplete");
+}
+
+void MultiFlowSink::HandleRead (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  Ptr<Packet> packet;
+  Address from;
+  while ((packet = socket->RecvFrom (from)))
+    {
+      uint32_t size = packet->GetSize ();
+      m_totalRx += size;
+      m_rxTrace (packet, from);
+
+      MultiFlowHeader header;
+      if (size < header.GetSerializedSize ())
+        {
+          NS_LOG_WARN ("Packet too small for a MultiFlowHeader");
+          continue;
+        }
+      packet->PeekHeader (header);
+
+      // the flow may be padded to carry the header of its last packet
+      FlowKey key (from, header.GetFlowId ());
+      std::map<FlowKey, uint32_t>::iterator it = m_flows.insert (std::make_pair (key, 0)).first;
+      it->second = std::min (it->second + size, header.GetFlowSize ());
+      if (it->second < header.GetFlowSize ())
+        {
+          continue;
+        }
+      m_flows.erase (it);
+
+      Time fct = Simulator::Now () - header.GetStart ();
+      NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds ()
+                   << "s flow " << header.GetFlowId () << " of "
+                   << header.GetFlowSize () << " bytes completed in "
+                   << fct.GetSeconds () << "s");
+      m_completed++;
+      if (m_keepFcts)
+        {
+          m_fcts.push_back (fct);
+        }
+      m_fctSum += fct;
+      m_fctTrace (header.GetFlowSize (), fct);
+      if (m_fctFile.is_open ())
+        {
+          m_fctFile << header.GetFlowSize () << " " << header.GetStart ().GetSeconds ()
+                    << " " << fct.GetSeconds () << "\n";
+        }
+    }
+}
+
+} // Namespace ns3
@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTI_FLOW_SINK_H
+#define MULTI_FLOW_SINK_H
+
+#include <map>
+#include <vector>
+#include <string>
+#include <fstream>
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+class Socket;
+class Packet;
+
+/**
+ * \ingroup multiflow
+ *
+ * \brief Receive the flows of MultiFlowApplications and measure their
+ * completion times.
+ *
+ * The sink counts the bytes received for each flow, identified by its
+ * sender and the identifier in its MultiFlowHeader.  A flow completes
+ * when all its bytes are received, and its completion time is the time
+ * from its start at the sender to the reception of its last byte.  The
+ * completion times are traced, kept for GetFctPercentile, and written
+ * to the "FctFile" if any, one flow per line: the size of the flow in
+ * bytes, its start and its completion time in seconds.
+ *
+ * Keeping the completion times takes 8 bytes per completed flow; long
+ * simulations relying on the trace or on the file can turn the
+ * "KeepFcts" attribute off, and GetFctPercentile is then not available.
+ *
+ * The flows lose the packets lost by the network, and never complete:
+ * they are counted by GetIncompleteFlows.
+ */
+class MultiFlowSink : public Application
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MultiFlowSink ();
+
+  virtual ~MultiFlowSink ();
+
+  /**
+   * \return the number of bytes received
+   */
+  uint64_t GetTotalRx (void) const;
+
+  /**
+   * \return the number of completed flows
+   */
+  uint32_t GetCompletedFlows (void) const;
+
+  /**
+   * \return the number of flows partially received
+   */
+  uint32_t GetIncompleteFlows (void) const;
+
+  /**
+   * \return the mean completion time of the completed flows
+   */
+  Time GetMeanFct (void) const;
+
+  /**
+   * \brief Get a percentile of the completion times
+   *
+   * The kept completion times are partially sorted in place, in time
+   * linear in the number of completed flows; "KeepFcts" must be on.
+   *
+   * \param p a percentage, between 0 and 100
+   * \return the completion time that p percent of the completed flows
+   * did not exceed
+   */
+  Time GetFctPercentile (double p) const;
+
+  /**
+   * TracedCallback signature for the completion of a flow.
+   *
+   * \param [in] size The size of the flow, in bytes.
+   * \param [in] fct The completion time of the flow.
+   */
+  typedef void (* FctTracedCallback)(uint32_t size, Time fct);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);    // Called at time specified by Start
+  virtual void StopApplication (void);     // Called at time specified by Stop
+
+  /**
+   * \brief Handle the packets received by the socket
+   * \param socket the socket the packets were received on
+   */
+  void HandleRead (Ptr<Socket> socket);
+
+  /// A flow of a sender
+  typedef std::pair<Address, uint32_t> FlowKey;
+
+  Ptr<Socket>     m_socket;       //!< Listening socket
+  Address         m_local;        //!< Local address to bind to
+  std::string     m_fctFilename;  //!< Name of the file of the completion times
+  std::ofstream   m_fctFile;      //!< File of the completion times
+  uint64_t        m_totalRx;      //!< Total bytes received
+  std::map<FlowKey, uint32_t> m_flows; //!< Bytes received of the incomplete flows
+  bool            m_keepFcts;     //!< Keep the completion times in m_fcts
+  uint32_t        m_completed;    //!< Number of completed flows
+  mutable std::vector<Time> m_fcts; //!< Completion times of the completed flows, in no particular order
+  Time            m_fctSum;       //!< Sum of the completion times
+
+  /// Traced Callback: received packets, source address.
+  TracedCallback<Ptr<const Packet>, const Address &> m_rxTrace;
+  /// Traced Callback: completed flows
+  TracedCallback<uint32_t, Time> m_fctTrace;
+};
+
+} // namespace ns3
+
+#endif /* MULTI_FLOW_SINK_H */
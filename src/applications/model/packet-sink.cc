@@ -29,6 +29,7 @@
 #include "ns3/socket-factory.h"
 #include "ns3/packet.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/string.h"
 #include "ns3/udp-socket-factory.h"
 #include "packet-sink.h"
 
@@ -55,6 +56,25 @@ PacketSink::GetTypeId (void)
                    TypeIdValue (UdpSocketFactory::GetTypeId ()),
                    MakeTypeIdAccessor (&PacketSink::m_tid),
                    MakeTypeIdChecker ())
+    .AddAttribute ("StatsBinWidth",
+                   "The width of the time bins of the per-flow statistics. "
+                   "The value zero disables the statistics.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&PacketSink::m_statsBinWidth),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("StatsInterval",
+                   "The interval at which the completed statistics bins are "
+                   "written out. The value zero means that they are written "
+                   "out when the application stops.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&PacketSink::m_statsInterval),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("StatsFile",
+                   "The name of the file to write the statistics bins to, "
+                   "if any.",
+                   StringValue (""),
+                   MakeStringAccessor (&PacketSink::m_statsFilename),
+                   MakeStringChecker ())
     .AddTraceSource ("Rx",
                      "A packet has been received",
                      MakeTraceSourceAccessor (&PacketSink::m_rxTrace),
@@ -95,11 +115,19 @@ PacketSink::GetAcceptedSockets (void) const
   return m_socketList;
 }
 
+ReceiveStatistics const &
+PacketSink::GetStatistics (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_stats;
+}
+
 void PacketSink::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
   m_socket = 0;
   m_socketList.clear ();
+  m_stats.Stop ();
 
   // chain up
   Application::DoDispose ();
@@ -132,6 +160,10 @@ void PacketSink::StartApplication ()    // Called at time specified by Start
         }
     }
 
+  m_stats.SetBinWidth (m_statsBinWidth);
+  m_stats.SetOutput (m_statsFilename);
+  m_stats.Start (m_statsInterval);
+
   m_socket->SetRecvCallback (MakeCallback (&PacketSink::HandleRead, this));
   m_socket->SetAcceptCallback (
     MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
@@ -155,6 +187,7 @@ void PacketSink::StopApplication ()     // Called at time specified by Stop
       m_socket->Close ();
       m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
     }
+  m_stats.Stop ();
 }
 
 void PacketSink::HandleRead (Ptr<Socket> socket)
@@ -162,6 +195,9 @@ void PacketSink::HandleRead (Ptr<Socket> socket)
   NS_LOG_FUNCTION (this << socket);
   Ptr<Packet> packet;
   Address from;
+  Address statsFrom;
+  uint32_t statsBytes = 0;
+  uint32_t statsPackets = 0;
   while ((packet = socket->RecvFrom (from)))
     {
       if (packet->GetSize () == 0)
@@ -169,6 +205,19 @@ void PacketSink::HandleRead (Ptr<Socket> socket)
           break;
         }
       m_totalRx += packet->GetSize ();
+      if (m_stats.IsEnabled ())
+        {
+          // account for the packets of a sender at once
+          if (statsPackets > 0 && from != statsFrom)
+            {
+              m_stats.NotifyReceived (statsFrom, statsBytes, statsPackets);
+              statsBytes = 0;
+              statsPackets = 0;
+            }
+          statsFrom = from;
+          statsBytes += packet->GetSize ();
+          statsPackets++;
+        }
       if (InetSocketAddress::IsMatchingType (from))
         {
           NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds ()
@@ -189,6 +238,10 @@ void PacketSink::HandleRead (Ptr<Socket> socket)
         }
       m_rxTrace (packet, from);
     }
+  if (statsPackets > 0)
+    {
+      m_stats.NotifyReceived (statsFrom, statsBytes, statsPackets);
+    }
 }
 
 
@@ -26,6 +26,8 @@
 #include "ns3/ptr.h"
 #include "ns3/traced-callback.h"
 #include "ns3/address.h"
+#include "ns3/nstime.h"
+#include "receive-statistics.h"
 
 namespace ns3 {
 
@@ -64,6 +66,11 @@ class Packet;
  * as a callback on the receiving socket.  By default, when logging is
  * enabled, it prints out the size of packets and their address.
  * A tracing source to Receive() is also available.
+ *
+ * When "StatsBinWidth" is set, the sink also keeps per-flow statistics
+ * in time bins (see ReceiveStatistics), written to "StatsFile": the
+ * packets drained from a socket in one go are accounted for once per
+ * sender, rather than once per packet.
  */
 class PacketSink : public Application 
 {
@@ -91,6 +98,12 @@ public:
    * \return list of pointers to accepted sockets
    */
   std::list<Ptr<Socket> > GetAcceptedSockets (void) const;
+
+  /**
+   * \return the receive statistics of the flows, kept if "StatsBinWidth"
+   * is not zero
+   */
+  ReceiveStatistics const &GetStatistics (void) const;
  
 protected:
   virtual void DoDispose (void);
@@ -129,6 +142,10 @@ private:
   Address         m_local;        //!< Local address to bind to
   uint32_t        m_totalRx;      //!< Total bytes received
   TypeId          m_tid;          //!< Protocol TypeId
+  Time            m_statsBinWidth; //!< Width of the statistics bins
+  Time            m_statsInterval; //!< Interval of the statistics output
+  std::string     m_statsFilename; //!< Name of the statistics file
+  ReceiveStatistics m_stats;      //!< Per-flow receive statistics
 
   /// Traced Callback: received packets, source address.
   TracedCallback<Ptr<const Packet>, const Address &> m_rxTrace;
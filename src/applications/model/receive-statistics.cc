@@ -0,0 +1,290 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/fatal-error.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "receive-statistics.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ReceiveStatistics");
+
+ReceiveStatistics::ReceiveStatistics ()
+  : m_binWidth (Seconds (0)),
+    m_delayWidth (MilliSeconds (1)),
+    m_delayBins (0),
+    m_interval (Seconds (0)),
+    m_rxBytes (0),
+    m_rxPackets (0),
+    m_lost (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_lastFlow = m_flows.end ();
+}
+
+ReceiveStatistics::~ReceiveStatistics ()
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_flushEvent);
+}
+
+void
+ReceiveStatistics::SetBinWidth (Time width)
+{
+  NS_LOG_FUNCTION (this << width);
+  NS_ASSERT (!width.IsStrictlyNegative ());
+  m_binWidth = width;
+}
+
+bool
+ReceiveStatistics::IsEnabled (void) const
+{
+  return m_binWidth.IsStrictlyPositive ();
+}
+
+void
+ReceiveStatistics::SetDelayHistogram (Time width, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << width << n);
+  NS_ASSERT (n == 0 || width.IsStrictlyPositive ());
+  m_delayWidth = width;
+  m_delayBins = n;
+}
+
+void
+ReceiveStatistics::SetOutput (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_filename = filename;
+}
+
+void
+ReceiveStatistics::Start (Time interval)
+{
+  NS_LOG_FUNCTION (this << interval);
+  if (!IsEnabled ())
+    {
+      return;
+    }
+  if (!m_filename.empty () && !m_output.is_open ())
+    {
+      m_output.open (m_filename.c_str ());
+      if (!m_output.is_open ())
+        {
+          NS_FATAL_ERROR ("ReceiveStatistics: unable to write \"" << m_filename << "\"");
+        }
+      m_output << "# sender bin_start rx_bytes rx_packets lost mean_delay delay_histogram\n";
+    }
+  m_interval = interval;
+  Simulator::Cancel (m_flushEvent);
+  if (m_interval.IsStrictlyPositive ())
+    {
+      m_flushEvent = Simulator::Schedule (m_interval, &ReceiveStatistics::PeriodicFlush, this);
+    }
+}
+
+void
+ReceiveStatistics::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_flushEvent);
+  Flush (true);
+  if (m_output.is_open ())
+    {
+      m_output.close ();
+    }
+}
+
+void
+ReceiveStatistics::PeriodicFlush (void)
+{
+  NS_LOG_FUNCTION (this);
+  Flush (false);
+  m_flushEvent = Simulator::Schedule (m_interval, &ReceiveStatistics::PeriodicFlush, this);
+}
+
+ReceiveStatistics::Bin &
+ReceiveStatistics::GetBin (Address const &from)
+{
+  //
+  // The packets of a flow tend to come in trains: look up the flow of the
+  // previous packet first.
+  //
+  if (m_lastFlow == m_flows.end () || m_lastFlow->first != from)
+    {
+      m_lastFlow = m_flows.find (from);
+      if (m_lastFlow == m_flows.end ())
+        {
+          Flow flow;
+          flow.maxSeq = 0;
+          flow.seqValid = false;
+          m_lastFlow = m_flows.insert (std::make_pair (from, flow)).first;
+        }
+    }
+
+  std::vector<Bin> &bins = m_lastFlow->second.bins;
+  uint64_t index = Simulator::Now ().GetTimeStep () / m_binWidth.GetTimeStep ();
+  if (bins.empty () || bins.back ().index != index)
+    {
+      Bin bin;
+      bin.index = index;
+      bin.bytes = 0;
+      bin.packets = 0;
+      bin.lost = 0;
+      bin.delayed = 0;
+      bin.delays.resize (m_delayBins, 0);
+      bins.push_back (bin);
+    }
+  return bins.back ();
+}
+
+void
+ReceiveStatistics::NotifyReceived (Address const &from, uint32_t bytes, uint32_t packets)
+{
+  NS_LOG_FUNCTION (this << from << bytes << packets);
+  Bin &bin = GetBin (from);
+  bin.bytes += bytes;
+  bin.packets += packets;
+  m_rxBytes += bytes;
+  m_rxPackets += packets;
+}
+
+void
+ReceiveStatistics::NotifyReceived (Address const &from, uint32_t bytes, uint32_t seq, Time delay)
+{
+  NS_LOG_FUNCTION (this << from << bytes << seq << delay);
+  Bin &bin = GetBin (from);
+  Flow &flow = m_lastFlow->second;
+  bin.bytes += bytes;
+  bin.packets++;
+  m_rxBytes += bytes;
+  m_rxPackets++;
+
+  // the sequence numbers of a flow start from zero
+  int32_t lost = 0;
+  if (!flow.seqValid)
+    {
+      lost = seq;
+      flow.maxSeq = seq;
+      flow.seqValid = true;
+    }
+  else if (seq > flow.maxSeq)
+    {
+      lost = seq - flow.maxSeq - 1;
+      flow.maxSeq = seq;
+    }
+  else
+    {
+      lost = -1;
+    }
+  bin.lost += lost;
+  m_lost += lost;
+
+  bin.delaySum += delay;
+  bin.delayed++;
+  if (m_delayBins > 0)
+    {
+      uint64_t i = delay.GetTimeStep () / m_delayWidth.GetTimeStep ();
+      bin.delays[std::min<uint64_t> (i, m_delayBins - 1)]++;
+    }
+}
+
+void
+ReceiveStatistics::Write (Address const &from, Bin const &bin)
+{
+  if (!m_output.is_open ())
+    {
+      return;
+    }
+  if (InetSocketAddress::IsMatchingType (from))
+    {
+      InetSocketAddress address = InetSocketAddress::ConvertFrom (from);
+      m_output << address.GetIpv4 () << ":" << address.GetPort ();
+    }
+  else if (Inet6SocketAddress::IsMatchingType (from))
+    {
+      Inet6SocketAddress address = Inet6SocketAddress::ConvertFrom (from);
+      m_output << "[" << address.GetIpv6 () << "]:" << address.GetPort ();
+    }
+  else
+    {
+      m_output << from;
+    }
+  m_output << " " << TimeStep (bin.index * m_binWidth.GetTimeStep ()).GetSeconds ()
+           << " " << bin.bytes << " " << bin.packets << " " << bin.lost << " "
+           << (bin.delayed > 0 ? (bin.delaySum / static_cast<int64_t> (bin.delayed)).GetSeconds () : 0);
+  for (std::vector<uint32_t>::const_iterator i = bin.delays.begin (); i != bin.delays.end (); ++i)
+    {
+      m_output << " " << *i;
+    }
+  m_output << "\n";
+}
+
+void
+ReceiveStatistics::Flush (bool all)
+{
+  NS_LOG_FUNCTION (this << all);
+  if (!IsEnabled ())
+    {
+      return;
+    }
+  uint64_t current = Simulator::Now ().GetTimeStep () / m_binWidth.GetTimeStep ();
+  for (std::map<Address, Flow>::iterator it = m_flows.begin (); it != m_flows.end (); ++it)
+    {
+      std::vector<Bin> &bins = it->second.bins;
+      std::vector<Bin>::iterator end = bins.begin ();
+      while (end != bins.end () && (all || end->index < current))
+        {
+          Write (it->first, *end);
+          ++end;
+        }
+      bins.erase (bins.begin (), end);
+    }
+  if (m_output.is_open ())
+    {
+      m_output.flush ();
+    }
+}
+
+uint32_t
+ReceiveStatistics::GetNFlows (void) const
+{
+  return m_flows.size ();
+}
+
+uint64_t
+ReceiveStatistics::GetRxBytes (void) const
+{
+  return m_rxBytes;
+}
+
+uint64_t
+ReceiveStatistics::GetRxPackets (void) const
+{
+  return m_rxPackets;
+}
+
+uint64_t
+ReceiveStatistics::GetLost (void) const
+{
+  return m_lost > 0 ? m_lost : 0;
+}
+
+} // namespace ns3
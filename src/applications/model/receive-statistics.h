@@ -0,0 +1,186 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RECEIVE_STATISTICS_H
+#define RECEIVE_STATISTICS_H
+
+#include <map>
+#include <vector>
+#include <string>
+#include <fstream>
+#include "ns3/address.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ *
+ * \brief Receive statistics of the flows of a sink, aggregated in time
+ * bins.
+ *
+ * Each flow, identified by the address of its sender, counts the bytes
+ * and packets received, the packets lost and the one-way delays in bins
+ * of "bin width" simulation time.  Losses are derived from the sequence
+ * numbers of the packets, if any: a gap counts as lost packets, and a
+ * late packet makes up for one of them; duplicates are not detected.
+ * The delays are summed up, and counted in a histogram of fixed-width
+ * bins, if any; the last histogram bin also counts the larger delays.
+ *
+ * A bin costs a few counters, whatever the number of packets it holds,
+ * and is written out, one line per flow and bin, when Flush () is called
+ * or periodically (see Start ()); bins written out are freed.  The line
+ * holds the address of the sender, the start of the bin in seconds, the
+ * bytes, packets and losses of the bin, the mean delay of the bin in
+ * seconds, and the counts of the delay histogram.
+ */
+class ReceiveStatistics
+{
+public:
+  ReceiveStatistics ();
+  ~ReceiveStatistics ();
+
+  /**
+   * \brief Set the width of the time bins
+   * \param width the width of the bins; zero disables the statistics
+   */
+  void SetBinWidth (Time width);
+  /**
+   * \return true if the statistics are kept
+   */
+  bool IsEnabled (void) const;
+
+  /**
+   * \brief Set the delay histogram of each bin
+   * \param width the width of the histogram bins
+   * \param n the number of histogram bins, zero for no histogram
+   */
+  void SetDelayHistogram (Time width, uint32_t n);
+
+  /**
+   * \brief Set the file the bins are written out to
+   * \param filename the name of the file; the bins are only counted in
+   *        the totals if it is empty
+   */
+  void SetOutput (std::string filename);
+
+  /**
+   * \brief Write out the completed bins every interval, until Stop ()
+   * \param interval the interval; zero to write out all the bins at Stop ()
+   *        only
+   */
+  void Start (Time interval);
+  /**
+   * \brief Stop writing out the bins periodically and write out all of them
+   */
+  void Stop (void);
+
+  /**
+   * \brief Account for packets without sequence numbers
+   * \param from the sender of the packets
+   * \param bytes the bytes received
+   * \param packets the number of packets received
+   */
+  void NotifyReceived (Address const &from, uint32_t bytes, uint32_t packets);
+  /**
+   * \brief Account for a packet with a sequence number and a send time
+   * \param from the sender of the packet
+   * \param bytes the size of the packet
+   * \param seq the sequence number of the packet
+   * \param delay the one-way delay of the packet
+   */
+  void NotifyReceived (Address const &from, uint32_t bytes, uint32_t seq, Time delay);
+
+  /**
+   * \brief Write out the bins and free them
+   * \param all write out the current bins too, rather than only the bins
+   *        which have ended
+   */
+  void Flush (bool all);
+
+  /**
+   * \return the number of flows seen
+   */
+  uint32_t GetNFlows (void) const;
+  /**
+   * \return the bytes received by all the flows
+   */
+  uint64_t GetRxBytes (void) const;
+  /**
+   * \return the packets received by all the flows
+   */
+  uint64_t GetRxPackets (void) const;
+  /**
+   * \return the packets lost by all the flows
+   */
+  uint64_t GetLost (void) const;
+
+private:
+  /// The statistics of a flow in a time bin
+  struct Bin
+  {
+    uint64_t index;             //!< the index of the bin
+    uint64_t bytes;             //!< the bytes received
+    uint32_t packets;           //!< the packets received
+    int32_t lost;               //!< the packets lost
+    Time delaySum;              //!< the sum of the delays
+    uint32_t delayed;           //!< the packets with a delay
+    std::vector<uint32_t> delays; //!< the delay histogram
+  };
+
+  /// A flow
+  struct Flow
+  {
+    std::vector<Bin> bins;      //!< the bins not written out yet
+    uint32_t maxSeq;            //!< the highest sequence number received
+    bool seqValid;              //!< a sequence number was received
+  };
+
+  /**
+   * \brief Get the current bin of a flow
+   * \param from the sender of the flow
+   * \return the bin
+   */
+  Bin &GetBin (Address const &from);
+  /**
+   * \brief Write out a bin
+   * \param from the sender of the flow
+   * \param bin the bin
+   */
+  void Write (Address const &from, Bin const &bin);
+  /**
+   * \brief Write out the completed bins and reschedule
+   */
+  void PeriodicFlush (void);
+
+  Time m_binWidth;              //!< the width of the bins
+  Time m_delayWidth;            //!< the width of the histogram bins
+  uint32_t m_delayBins;         //!< the number of histogram bins
+  std::string m_filename;       //!< the name of the output file
+  std::ofstream m_output;       //!< the output file
+  Time m_interval;              //!< the interval of the periodic flushes
+  EventId m_flushEvent;         //!< the next periodic flush
+  std::map<Address, Flow> m_flows; //!< the flows
+  std::map<Address, Flow>::iterator m_lastFlow; //!< the flow of the last packet
+  uint64_t m_rxBytes;           //!< the bytes received
+  uint64_t m_rxPackets;         //!< the packets received
+  int64_t m_lost;               //!< the packets lost
+};
+
+} // namespace ns3
+
+#endif /* RECEIVE_STATISTICS_H */
@@ -0,0 +1,363 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/address.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/socket-factory.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/abort.h"
+#include "ns3/string.h"
+#include "ns3/fatal-error.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/packet-socket-address.h"
+#include "trace-replay-application.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TraceReplayApplication");
+
+NS_OBJECT_ENSURE_REGISTERED (TraceReplayApplication);
+
+TypeId
+TraceReplayApplication::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TraceReplayApplication")
+    .SetParent<Application> ()
+    .SetGroupName("Applications")
+    .AddConstructor<TraceReplayApplication> ()
+    .AddAttribute ("Filename", "The name of the pcap file to replay.",
+                   StringValue (""),
+                   MakeStringAccessor (&TraceReplayApplication::m_filename),
+                   MakeStringChecker ())
+    .AddAttribute ("Remote", "The address of the destination",
+                   AddressValue (),
+                   MakeAddressAccessor (&TraceReplayApplication::m_peer),
+                   MakeAddressChecker ())
+    .AddAttribute ("Protocol", "The type of protocol to use.",
+                   TypeIdValue (UdpSocketFactory::GetTypeId ()),
+                   MakeTypeIdAccessor (&TraceReplayApplication::m_tid),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("PayloadOffset",
+                   "The number of bytes at the start of each record which "
+                   "are not part of the payload (e.g., 42 for UDP over IPv4 "
+                   "over Ethernet).",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TraceReplayApplication::m_payloadOffset),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("CopyPayload",
+                   "Send the captured bytes as payload, instead of zeros. "
+                   "Records truncated by the capture snaplen are always "
+                   "zero-filled.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TraceReplayApplication::m_copyPayload),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxPackets",
+                   "The total number of packets to send. The value zero means "
+                   "that there is no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TraceReplayApplication::m_maxPackets),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Loop",
+                   "Replay the capture from the beginning when its last "
+                   "record has been sent.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TraceReplayApplication::m_loop),
+                   MakeBooleanChecker ())
+    .AddAttribute ("BatchWindow",
+                   "The records due within this time of a record are sent "
+                   "with it, by the same event.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&TraceReplayApplication::m_batchWindow),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("SourceCount",
+                   "The number of sources the source addresses of the capture "
+                   "are dealt to.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&TraceReplayApplication::m_sourceCount),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("SourceIndex",
+                   "The source replayed by this application, lower than "
+                   "SourceCount.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TraceReplayApplication::m_sourceIndex),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddTraceSource ("Tx", "A new packet is created and is sent",
+                     MakeTraceSourceAccessor (&TraceReplayApplication::m_txTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+
+TraceReplayApplication::TraceReplayApplication ()
+  : m_socket (0),
+    m_sent (0),
+    m_position (0),
+    m_records (0),
+    m_next (0),
+    m_size (0),
+    m_data (0),
+    m_inclLen (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TraceReplayApplication::~TraceReplayApplication ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ptr<Socket>
+TraceReplayApplication::GetSocket (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_socket;
+}
+
+uint32_t
+TraceReplayApplication::GetSent (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_sent;
+}
+
+void
+TraceReplayApplication::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_socket = 0;
+  m_file = 0;
+  m_records = 0;
+  // chain up
+  Application::DoDispose ();
+}
+
+// Application Methods
+void TraceReplayApplication::StartApplication (void) // Called at time specified by Start
+{
+  NS_LOG_FUNCTION (this);
+
+  // Create the socket if not already
+  if (!m_socket)
+    {
+      m_socket = Socket::CreateSocket (GetNode (), m_tid);
+      if (Inet6SocketAddress::IsMatchingType (m_peer))
+        {
+          m_socket->Bind6 ();
+        }
+      else if (InetSocketAddress::IsMatchingType (m_peer) ||
+               PacketSocketAddress::IsMatchingType (m_peer))
+        {
+          m_socket->Bind ();
+        }
+      m_socket->Connect (m_peer);
+      m_socket->SetAllowBroadcast (true);
+      m_socket->ShutdownRecv ();
+    }
+
+  m_file = TraceReplayFile::Open (m_filename);
+  if (m_file == 0)
+    {
+      NS_FATAL_ERROR ("TraceReplayApplication: unable to read trace file \"" << m_filename << "\"");
+    }
+  m_position = m_file->Begin ();
+  m_next = 0;
+  m_records = 0;
+  if (m_sourceCount > 1)
+    {
+      NS_ABORT_MSG_UNLESS (m_sourceIndex < m_sourceCount, "TraceReplayApplication: SourceIndex " << m_sourceIndex
+                           << " is not lower than SourceCount " << m_sourceCount);
+      m_records = &m_file->GetSourceRecords (m_sourceCount, m_sourceIndex);
+    }
+  m_start = Simulator::Now ();
+  m_due = m_start;
+  m_origin = Time (-1);
+  if (m_records != 0)
+    {
+      // the sources keep their timing relative to each other
+      uint64_t position = m_file->Begin ();
+      TraceReplayFile::Record first;
+      if (m_file->Read (position, first))
+        {
+          m_origin = first.time;
+        }
+    }
+  ScheduleNextRecord ();
+}
+
+void TraceReplayApplication::StopApplication (void) // Called at time specified by Stop
+{
+  NS_LOG_FUNCTION (this);
+
+  Simulator::Cancel (m_sendEvent);
+  m_file = 0;
+  m_records = 0;
+  if (m_socket != 0)
+    {
+      m_socket->Close ();
+    }
+  else
+    {
+      NS_LOG_WARN ("TraceReplayApplication found null socket to close in StopApplication");
+    }
+}
+
+bool
+TraceReplayApplication::ReadRecord (TraceReplayFile::Record &record)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_records != 0)
+    {
+      if (m_next == m_records->size ())
+        {
+          return false;
+        }
+      uint64_t position = (*m_records)[m_next++];
+      return m_file->Read (position, record);
+    }
+  return m_file->Read (m_position, record);
+}
+
+bool
+TraceReplayApplication::NextRecord (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_maxPackets > 0 && m_sent >= m_maxPackets)
+    {
+      return false;
+    }
+
+  TraceReplayFile::Record record;
+  if (!ReadRecord (record))
+    {
+      if (!m_loop || m_sent == 0)
+        {
+          NS_LOG_LOGIC ("End of the capture");
+          return false;
+        }
+      //
+      // Start over: the first record of the next round is due with the
+      // last record of this round, and the following ones keep their
+      // spacing.  A capture whose records all have the same timestamp
+      // would never let the simulation time advance, so it is not looped.
+      //
+      if (m_start == m_due)
+        {
+          NS_LOG_WARN ("Capture " << m_filename << " has a null duration, not looping");
+          return false;
+        }
+      m_position = m_file->Begin ();
+      m_next = 0;
+      m_start = m_due;
+      if (m_records == 0)
+        {
+          m_origin = Time (-1);
+        }
+      if (!ReadRecord (record))
+        {
+          return false;
+        }
+    }
+
+  if (m_origin.IsNegative ())
+    {
+      m_origin = record.time;
+    }
+
+  m_size = record.size > m_payloadOffset ? record.size - m_payloadOffset : 0;
+  m_data = record.data;
+  m_inclLen = record.inclLen;
+
+  //
+  // Captures are not always sorted; never go back in time.
+  //
+  m_due = std::max (m_start + (record.time - m_origin), Simulator::Now ());
+  return true;
+}
+
+void
+TraceReplayApplication::ScheduleNextRecord (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (NextRecord ())
+    {
+      m_sendEvent = Simulator::Schedule (m_due - Simulator::Now (),
+                                         &TraceReplayApplication::SendRecords, this);
+    }
+}
+
+void
+TraceReplayApplication::SendRecords (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Time end = Simulator::Now () + m_batchWindow;
+  SendRecord ();
+  while (NextRecord ())
+    {
+      if (m_due > end)
+        {
+          m_sendEvent = Simulator::Schedule (m_due - Simulator::Now (),
+                                             &TraceReplayApplication::SendRecords, this);
+          return;
+        }
+      SendRecord ();
+    }
+}
+
+void
+TraceReplayApplication::SendRecord (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<Packet> packet;
+  if (m_copyPayload && m_data != 0 && m_inclLen >= m_payloadOffset + m_size)
+    {
+      packet = Create<Packet> (m_data + m_payloadOffset, m_size);
+    }
+  else
+    {
+      packet = Create<Packet> (m_size);
+    }
+
+  m_txTrace (packet);
+  if (m_socket->Send (packet) >= 0)
+    {
+      NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds ()
+                   << "s trace replay application sent "
+                   <<  packet->GetSize () << " bytes");
+    }
+  else
+    {
+      NS_LOG_INFO ("Error while sending " << packet->GetSize () << " bytes");
+    }
+  ++m_sent;
+}
+
+} // Namespace ns3
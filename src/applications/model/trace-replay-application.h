@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRACE_REPLAY_APPLICATION_H
+#define TRACE_REPLAY_APPLICATION_H
+
+#include <string>
+#include <vector>
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+#include "trace-replay-file.h"
+
+namespace ns3 {
+
+class Socket;
+class Packet;
+
+/**
+ * \ingroup applications
+ * \defgroup tracereplay TraceReplayApplication
+ *
+ * This traffic generator replays the packets of a pcap capture.
+ */
+
+/**
+ * \ingroup tracereplay
+ *
+ * \brief Send one packet per record of a pcap file or binary packet
+ * trace, with the timing of the capture.
+ *
+ * The capture is mapped in memory (see TraceReplayFile) and walked one
+ * record at a time, so arbitrarily large captures can be replayed
+ * without loading them.  The first record is sent when the application
+ * starts; every following record is sent with the same delay from the
+ * first one as in the capture.  All the records due within "BatchWindow"
+ * of the current one are sent by the same event, which trades timing
+ * accuracy for fewer events on dense traces.
+ *
+ * The applications replaying the same file share its mapping.  With
+ * "SourceCount" larger than one, each application only replays the
+ * packets of the source addresses dealt to its "SourceIndex", so that
+ * one trace drives many nodes (see TraceReplayHelper::InstallSources).
+ *
+ * The payload of the packets is the part of each record that follows
+ * the first "PayloadOffset" bytes, which typically hold the link,
+ * network and transport headers of the captured packet; its size is
+ * computed from the original length of the packet, so captures taken
+ * with a small snaplen still produce packets of the right size.  By
+ * default the payload is zero-filled; set "CopyPayload" to send the
+ * captured bytes instead.  Binary packet traces (see PacketTraceFile)
+ * hold the size of the IP packets and no data: set "PayloadOffset" to
+ * the size of the IP and transport headers, and the payload is always
+ * zero-filled.
+ */
+class TraceReplayApplication : public Application
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TraceReplayApplication ();
+
+  virtual ~TraceReplayApplication ();
+
+  /**
+   * \brief Get the socket this application is attached to.
+   * \return pointer to associated socket
+   */
+  Ptr<Socket> GetSocket (void) const;
+
+  /**
+   * \return the number of packets sent so far
+   */
+  uint32_t GetSent (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);    // Called at time specified by Start
+  virtual void StopApplication (void);     // Called at time specified by Stop
+
+  /**
+   * \brief Read the next record of the capture to replay, starting over
+   * at the end of the capture if "Loop" is set.
+   * \param record [out] the record
+   * \return false if there are no more records
+   */
+  bool ReadRecord (TraceReplayFile::Record &record);
+  /**
+   * \brief Read the next record of the capture and compute its send time.
+   * \return false if there are no more packets to send
+   */
+  bool NextRecord (void);
+  /**
+   * \brief Read the next record of the capture and schedule its
+   * transmission.
+   */
+  void ScheduleNextRecord (void);
+  /**
+   * \brief Send the packets of the current record and of the following
+   * records due within the batch window.
+   */
+  void SendRecords (void);
+  /**
+   * \brief Send the packet of the current record.
+   */
+  void SendRecord (void);
+
+  Ptr<Socket>     m_socket;       //!< Associated socket
+  Address         m_peer;         //!< Peer address
+  TypeId          m_tid;          //!< The type of protocol to use.
+  std::string     m_filename;     //!< Name of the pcap file
+  uint32_t        m_payloadOffset; //!< Bytes of each record which are not payload
+  bool            m_copyPayload;  //!< Send the captured bytes rather than zeros
+  uint32_t        m_maxPackets;   //!< Limit total number of packets sent
+  bool            m_loop;         //!< Replay the capture again when it ends
+  Time            m_batchWindow;  //!< Records sent by one event
+  uint32_t        m_sourceCount;  //!< Number of sources the capture is split among
+  uint32_t        m_sourceIndex;  //!< Source replayed by this application
+  uint32_t        m_sent;         //!< Counter for sent packets
+  Ptr<TraceReplayFile> m_file;    //!< The capture
+  uint64_t        m_position;     //!< Position of the next record in the capture
+  std::vector<uint64_t> const *m_records; //!< Records of the source, if split
+  uint64_t        m_next;         //!< Index of the next record of the source
+  Time            m_origin;       //!< Capture timestamp of the first record
+  Time            m_start;        //!< Simulation time of the first record
+  Time            m_due;          //!< Simulation time of the current record
+  uint32_t        m_size;         //!< Payload size of the current record
+  uint8_t const  *m_data;         //!< Data of the current record
+  uint32_t        m_inclLen;      //!< Captured length of the current record
+  EventId         m_sendEvent;    //!< Event id of pending send event
+
+  /// Traced Callback: sent packets
+  TracedCallback<Ptr<const Packet> > m_txTrace;
+};
+
+} // namespace ns3
+
+#endif /* TRACE_REPLAY_APPLICATION_H */
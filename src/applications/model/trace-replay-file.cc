@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/hash.h"
+#include "ns3/sgi-hashmap.h"
+#include "trace-replay-file.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TraceReplayFile");
+
+std::map<std::string, TraceReplayFile *> &
+TraceReplayFile::GetFiles (void)
+{
+  static std::map<std::string, TraceReplayFile *> files;
+  return files;
+}
+
+Ptr<TraceReplayFile>
+TraceReplayFile::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (filename);
+  std::map<std::string, TraceReplayFile *>::iterator it = GetFiles ().find (filename);
+  if (it != GetFiles ().end ())
+    {
+      return it->second;
+    }
+
+  Ptr<TraceReplayFile> file = Ptr<TraceReplayFile> (new TraceReplayFile (filename), false);
+  if (file->m_pcap.Fail () && file->m_trace.Fail ())
+    {
+      return 0;
+    }
+  GetFiles ()[filename] = PeekPointer (file);
+  return file;
+}
+
+TraceReplayFile::TraceReplayFile (std::string const &filename)
+  : m_filename (filename),
+    m_binary (false)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_pcap.Open (filename);
+  if (m_pcap.Fail ())
+    {
+      m_trace.Open (filename, std::ios::in);
+      m_binary = !m_trace.Fail ();
+    }
+}
+
+TraceReplayFile::~TraceReplayFile ()
+{
+  NS_LOG_FUNCTION (this);
+  std::map<std::string, TraceReplayFile *>::iterator it = GetFiles ().find (m_filename);
+  if (it != GetFiles ().end () && it->second == this)
+    {
+      GetFiles ().erase (it);
+    }
+}
+
+uint64_t
+TraceReplayFile::Begin (void) const
+{
+  return m_binary ? 16 : 24;
+}
+
+bool
+TraceReplayFile::Read (uint64_t &position, Record &record)
+{
+  NS_LOG_FUNCTION (this << position);
+  if (m_binary)
+    {
+      m_trace.Seek (position);
+      if (!m_trace.Read (m_last))
+        {
+          return false;
+        }
+      position = m_trace.GetOffset ();
+      record.time = NanoSeconds (m_last.timestamp);
+      record.size = m_last.size;
+      record.inclLen = 0;
+      record.data = 0;
+      return true;
+    }
+
+  uint32_t tsSec, tsUsec;
+  m_pcap.Seek (position);
+  if (!m_pcap.Read (tsSec, tsUsec, record.inclLen, record.size, record.data))
+    {
+      return false;
+    }
+  position = m_pcap.GetOffset ();
+  record.time = Seconds (tsSec);
+  record.time += m_pcap.IsNanoSecondMode () ? NanoSeconds (tsUsec) : MicroSeconds (tsUsec);
+  m_lastPcap = record;
+  return true;
+}
+
+uint32_t
+TraceReplayFile::GetLastSource (void) const
+{
+  if (m_binary)
+    {
+      return m_last.source;
+    }
+
+  //
+  // Find the IP header after the link layer header.
+  //
+  uint8_t const *data = m_lastPcap.data;
+  uint32_t len = m_lastPcap.inclLen;
+  uint32_t offset;
+  switch (m_pcap.GetDataLinkType ())
+    {
+    case 1:         // Ethernet
+      offset = 14;
+      if (len >= 18 && data[12] == 0x81 && data[13] == 0x00)
+        {
+          offset = 18;      // 802.1Q tag
+        }
+      break;
+    case 12:        // raw IP
+    case 14:
+    case 101:
+    case 228:       // IPv4
+    case 229:       // IPv6
+      offset = 0;
+      break;
+    case 113:       // Linux cooked capture
+      offset = 16;
+      break;
+    default:
+      return 0;
+    }
+
+  if (len > offset && (data[offset] >> 4) == 4 && len >= offset + 16)
+    {
+      return (data[offset + 12] << 24) | (data[offset + 13] << 16)
+        | (data[offset + 14] << 8) | data[offset + 15];
+    }
+  if (len > offset && (data[offset] >> 4) == 6 && len >= offset + 24)
+    {
+      return Hash32 (reinterpret_cast<char const *> (data + offset + 8), 16);
+    }
+  return 0;
+}
+
+std::vector<uint64_t> const &
+TraceReplayFile::GetSourceRecords (uint32_t count, uint32_t index)
+{
+  NS_LOG_FUNCTION (this << count << index);
+  NS_ASSERT (index < count);
+
+  std::map<uint32_t, std::vector<std::vector<uint64_t> > >::iterator it = m_sources.find (count);
+  if (it != m_sources.end ())
+    {
+      return it->second[index];
+    }
+
+  std::vector<std::vector<uint64_t> > &sources = m_sources[count];
+  sources.resize (count);
+  sgi::hash_map<uint32_t, uint32_t> order;
+  uint64_t position = Begin ();
+  uint64_t record = position;
+  Record r;
+  while (Read (position, r))
+    {
+      uint32_t n = order.insert (std::make_pair (GetLastSource (), order.size ())).first->second;
+      sources[n % count].push_back (record);
+      record = position;
+    }
+  NS_LOG_LOGIC (m_filename << ": " << order.size () << " source addresses dealt to "
+                << count << " sources");
+  return sources[index];
+}
+
+} // namespace ns3
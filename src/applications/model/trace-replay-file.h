@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TRACE_REPLAY_FILE_H
+#define TRACE_REPLAY_FILE_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/mapped-pcap-file.h"
+#include "ns3/packet-trace-file.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tracereplay
+ *
+ * \brief A packet trace replayed by TraceReplayApplications.
+ *
+ * The trace is either a pcap file (see MappedPcapFile) or a binary
+ * packet trace (see PacketTraceFile); the format is found from the
+ * content of the file.  It is mapped once, however many applications
+ * replay it: Open () returns the same object for the same file name as
+ * long as it is in use, and every application keeps its own position in
+ * the trace.
+ *
+ * A trace can also be split among a number of sources: the distinct
+ * source addresses of the packets are dealt, in order of appearance, to
+ * the sources, and GetSourceRecords () lists the records of each source.
+ * The trace is walked once per number of sources, rather than once per
+ * source.
+ */
+class TraceReplayFile : public SimpleRefCount<TraceReplayFile>
+{
+public:
+  /// A packet of the trace
+  struct Record
+  {
+    Time time;                  //!< the time of the packet in the trace
+    uint32_t size;              //!< the original size of the packet
+    uint32_t inclLen;           //!< the number of bytes of the packet in the trace
+    uint8_t const *data;        //!< the bytes of the packet in the trace, if any
+  };
+
+  ~TraceReplayFile ();
+
+  /**
+   * \brief Open a trace, or get the trace already opened with this name.
+   * \param filename the name of the file
+   * \return the trace, or 0 if the file is not a readable trace
+   */
+  static Ptr<TraceReplayFile> Open (std::string const &filename);
+
+  /**
+   * \return the position of the first record
+   */
+  uint64_t Begin (void) const;
+
+  /**
+   * \brief Read a record of the trace.
+   * \param position [in,out] the position of the record, updated to the
+   *        position of the next record
+   * \param record [out] the record
+   * \return false if there are no more records
+   */
+  bool Read (uint64_t &position, Record &record);
+
+  /**
+   * \brief Get the records of a source, when the trace is split among
+   * a number of sources.
+   * \param count the number of sources
+   * \param index the source, lower than count
+   * \return the positions of the records of the source, in order
+   */
+  std::vector<uint64_t> const &GetSourceRecords (uint32_t count, uint32_t index);
+
+private:
+  /**
+   * \brief Constructor
+   * \param filename the name of the file
+   */
+  TraceReplayFile (std::string const &filename);
+
+  /**
+   * \brief Identify the source of a record
+   * \return the source address of the packet read last, or 0 if the
+   * packet is not an IP packet
+   */
+  uint32_t GetLastSource (void) const;
+
+  /// The traces in use, by file name
+  static std::map<std::string, TraceReplayFile *> &GetFiles (void);
+
+  std::string m_filename;       //!< the name of the file
+  bool m_binary;                //!< the file is a PacketTraceFile
+  MappedPcapFile m_pcap;        //!< the pcap file
+  PacketTraceFile m_trace;      //!< the binary trace
+  PacketTraceFile::Record m_last; //!< the binary record read last
+  Record m_lastPcap;            //!< the pcap record read last
+  /// The records of each source, by number of sources
+  std::map<uint32_t, std::vector<std::vector<uint64_t> > > m_sources;
+};
+
+} // namespace ns3
+
+#endif /* TRACE_REPLAY_FILE_H */
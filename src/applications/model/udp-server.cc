@@ -29,6 +29,7 @@
 #include "ns3/socket-factory.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/string.h"
 #include "packet-loss-counter.h"
 
 #include "seq-ts-header.h"
@@ -59,6 +60,37 @@ UdpServer::GetTypeId (void)
                    MakeUintegerAccessor (&UdpServer::GetPacketWindowSize,
                                          &UdpServer::SetPacketWindowSize),
                    MakeUintegerChecker<uint16_t> (8,256))
+    .AddAttribute ("StatsBinWidth",
+                   "The width of the time bins of the per-flow statistics. "
+                   "The value zero disables the statistics.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&UdpServer::m_statsBinWidth),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("StatsInterval",
+                   "The interval at which the completed statistics bins are "
+                   "written out. The value zero means that they are written "
+                   "out when the application stops.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&UdpServer::m_statsInterval),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("StatsFile",
+                   "The name of the file to write the statistics bins to, "
+                   "if any.",
+                   StringValue (""),
+                   MakeStringAccessor (&UdpServer::m_statsFilename),
+                   MakeStringChecker ())
+    .AddAttribute ("DelayBinWidth",
+                   "The width of the bins of the delay histograms of the "
+                   "statistics.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&UdpServer::m_delayBinWidth),
+                   MakeTimeChecker (NanoSeconds (1)))
+    .AddAttribute ("DelayBins",
+                   "The number of bins of the delay histograms of the "
+                   "statistics. The value zero disables the histograms.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&UdpServer::m_delayBins),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -93,9 +125,20 @@ uint32_t
 UdpServer::GetLost (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_stats.IsEnabled ())
+    {
+      return m_stats.GetLost ();
+    }
   return m_lossCounter.GetLost ();
 }
 
+ReceiveStatistics const &
+UdpServer::GetStatistics (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_stats;
+}
+
 uint32_t
 UdpServer::GetReceived (void) const
 {
@@ -107,6 +150,7 @@ void
 UdpServer::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  m_stats.Stop ();
   Application::DoDispose ();
 }
 
@@ -137,6 +181,10 @@ UdpServer::StartApplication (void)
 
   m_socket6->SetRecvCallback (MakeCallback (&UdpServer::HandleRead, this));
 
+  m_stats.SetBinWidth (m_statsBinWidth);
+  m_stats.SetDelayHistogram (m_delayBinWidth, m_delayBins);
+  m_stats.SetOutput (m_statsFilename);
+  m_stats.Start (m_statsInterval);
 }
 
 void
@@ -148,6 +196,7 @@ UdpServer::StopApplication ()
     {
       m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
     }
+  m_stats.Stop ();
 }
 
 void
@@ -160,6 +209,7 @@ UdpServer::HandleRead (Ptr<Socket> socket)
     {
       if (packet->GetSize () > 0)
         {
+          uint32_t size = packet->GetSize ();
           SeqTsHeader seqTs;
           packet->RemoveHeader (seqTs);
           uint32_t currentSequenceNumber = seqTs.GetSeq ();
@@ -184,7 +234,15 @@ UdpServer::HandleRead (Ptr<Socket> socket)
                            " Delay: " << Simulator::Now () - seqTs.GetTs ());
             }
 
-          m_lossCounter.NotifyReceived (currentSequenceNumber);
+          if (m_stats.IsEnabled ())
+            {
+              m_stats.NotifyReceived (from, size, currentSequenceNumber,
+                                      Simulator::Now () - seqTs.GetTs ());
+            }
+          else
+            {
+              m_lossCounter.NotifyReceived (currentSequenceNumber);
+            }
           m_received++;
         }
     }
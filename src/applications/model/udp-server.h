@@ -27,7 +27,9 @@
 #include "ns3/event-id.h"
 #include "ns3/ptr.h"
 #include "ns3/address.h"
+#include "ns3/nstime.h"
 #include "packet-loss-counter.h"
+#include "receive-statistics.h"
 namespace ns3 {
 /**
  * \ingroup applications
@@ -42,6 +44,12 @@ namespace ns3 {
  * UDP packets carry a 32bits sequence number followed by a 64bits time
  * stamp in their payloads. The application uses the sequence number
  * to determine if a packet is lost, and the time stamp to compute the delay.
+ *
+ * When "StatsBinWidth" is set, the server keeps per-flow statistics of
+ * goodput, losses and delays in time bins instead (see ReceiveStatistics),
+ * written to "StatsFile", and counts the losses from the gaps in the
+ * sequence numbers of each flow rather than with the window of
+ * PacketLossCounter.
  */
 class UdpServer : public Application
 {
@@ -78,6 +86,13 @@ public:
    *  be a multiple of 8
    */
   void SetPacketWindowSize (uint16_t size);
+
+  /**
+   * \brief Returns the receive statistics of the flows, kept if
+   * "StatsBinWidth" is not zero
+   * \return the statistics
+   */
+  ReceiveStatistics const &GetStatistics (void) const;
 protected:
   virtual void DoDispose (void);
 
@@ -100,6 +115,12 @@ private:
   Ptr<Socket> m_socket6; //!< IPv6 Socket
   uint32_t m_received; //!< Number of received packets
   PacketLossCounter m_lossCounter; //!< Lost packet counter
+  Time m_statsBinWidth; //!< Width of the statistics bins
+  Time m_statsInterval; //!< Interval of the statistics output
+  std::string m_statsFilename; //!< Name of the statistics file
+  Time m_delayBinWidth; //!< Width of the delay histogram bins
+  uint32_t m_delayBins; //!< Number of delay histogram bins
+  ReceiveStatistics m_stats; //!< Per-flow receive statistics
 };
 
 } // namespace ns3
@@ -28,8 +28,22 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/arp-cache.h"
+#include "ns3/arp-l3-protocol.h"
 #include "ns3/udp-client-server-helper.h"
 #include "ns3/udp-echo-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/receive-statistics.h"
+#include "ns3/trace-replay-helper.h"
+#include "ns3/trace-replay-application.h"
+#include "ns3/multi-flow-helper.h"
+#include "ns3/multi-flow-application.h"
+#include "ns3/multi-flow-sink.h"
+#include "ns3/pcap-file.h"
+#include "ns3/packet-trace-file.h"
 #include "ns3/simple-net-device.h"
 #include "ns3/simple-channel.h"
 #include "ns3/test.h"
@@ -331,6 +345,511 @@ void UdpEchoClientSetFillTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * Test that a TraceReplayApplication sends one packet per record of a
+ * pcap file, with the timing and sizes of the capture
+ */
+
+class TraceReplayTestCase : public TestCase
+{
+public:
+  TraceReplayTestCase ();
+  virtual ~TraceReplayTestCase ();
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Tx trace sink of the application
+   * \param p the packet sent
+   */
+  void Tx (Ptr<const Packet> p);
+
+  std::string m_filename; //!< the pcap file to replay
+  std::vector<Time> m_txTimes; //!< times at which the packets were sent
+  std::vector<uint32_t> m_txSizes; //!< sizes of the packets sent
+};
+
+TraceReplayTestCase::TraceReplayTestCase ()
+  : TestCase ("Test that a TraceReplayApplication replays a pcap file with the capture timing")
+{
+}
+
+TraceReplayTestCase::~TraceReplayTestCase ()
+{
+}
+
+void
+TraceReplayTestCase::DoSetup (void)
+{
+  m_filename = CreateTempDirFilename ("trace-replay.pcap");
+  PcapFile f;
+  f.Open (m_filename, std::ios::out);
+  f.Init (1);
+  uint8_t data[342] = { 0 };
+  // 42 bytes of Ethernet, IPv4 and UDP headers, then the payload
+  f.Write (10, 0, data, 142);
+  f.Write (10, 500, data, 242);
+  f.Write (10, 2000, data, 342);
+  f.Write (10, 2000, data, 92);
+  f.Close ();
+}
+
+void
+TraceReplayTestCase::DoTeardown (void)
+{
+  remove (m_filename.c_str ());
+}
+
+void
+TraceReplayTestCase::Tx (Ptr<const Packet> p)
+{
+  m_txTimes.push_back (Simulator::Now ());
+  m_txSizes.push_back (p->GetSize ());
+}
+
+void TraceReplayTestCase::DoRun (void)
+{
+  NodeContainer n;
+  n.Create (2);
+
+  InternetStackHelper internet;
+  internet.Install (n);
+
+  Ptr<SimpleNetDevice> txDev = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> rxDev = CreateObject<SimpleNetDevice> ();
+  n.Get (0)->AddDevice (txDev);
+  n.Get (1)->AddDevice (rxDev);
+  Ptr<SimpleChannel> channel1 = CreateObject<SimpleChannel> ();
+  rxDev->SetChannel (channel1);
+  txDev->SetChannel (channel1);
+  NetDeviceContainer d;
+  d.Add (txDev);
+  d.Add (rxDev);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (d);
+
+  // resolve the address of the sink without the random request jitter,
+  // which could hold back more records than the ARP pending queue keeps
+  n.Get (0)->GetObject<ArpL3Protocol> ()->SetAttribute ("RequestJitter", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
+
+  uint16_t port = 4000;
+  PacketSinkHelper sink ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (n.Get (1));
+  sinkApps.Start (Seconds (1.0));
+  sinkApps.Stop (Seconds (10.0));
+
+  TraceReplayHelper replay ("ns3::UdpSocketFactory", InetSocketAddress (i.GetAddress (1), port), m_filename);
+  replay.SetAttribute ("PayloadOffset", UintegerValue (42));
+  ApplicationContainer apps = replay.Install (n.Get (0));
+  apps.Get (0)->TraceConnectWithoutContext ("Tx", MakeCallback (&TraceReplayTestCase::Tx, this));
+  apps.Start (Seconds (2.0));
+  apps.Stop (Seconds (10.0));
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (DynamicCast<TraceReplayApplication> (apps.Get (0))->GetSent (), 4, "Not one packet per record");
+  NS_TEST_ASSERT_MSG_EQ (DynamicCast<PacketSink> (sinkApps.Get (0))->GetTotalRx (), 650, "Payload sizes do not match the capture");
+  NS_TEST_ASSERT_MSG_EQ (m_txSizes.size (), 4, "Not one packet per record");
+  NS_TEST_ASSERT_MSG_EQ (m_txSizes[0], 100, "Payload size does not match the capture");
+  NS_TEST_ASSERT_MSG_EQ (m_txTimes[0], Seconds (2.0), "First record not sent at start");
+  NS_TEST_ASSERT_MSG_EQ (m_txTimes[1], Seconds (2.0) + MicroSeconds (500), "Record timing does not match the capture");
+  NS_TEST_ASSERT_MSG_EQ (m_txTimes[3], Seconds (2.0) + MicroSeconds (2000), "Record timing does not match the capture");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Test that the flows of a MultiFlowApplication are paced at the flow rate
+ * and completed at a MultiFlowSink
+ */
+
+class MultiFlowTestCase : public TestCase
+{
+public:
+  MultiFlowTestCase ();
+  virtual ~MultiFlowTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+};
+
+MultiFlowTestCase::MultiFlowTestCase ()
+  : TestCase ("Test that a MultiFlowSink measures the completion times of the flows of a MultiFlowApplication")
+{
+}
+
+MultiFlowTestCase::~MultiFlowTestCase ()
+{
+}
+
+void MultiFlowTestCase::DoRun (void)
+{
+  NodeContainer n;
+  n.Create (2);
+
+  InternetStackHelper internet;
+  internet.Install (n);
+
+  Ptr<SimpleNetDevice> txDev = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> rxDev = CreateObject<SimpleNetDevice> ();
+  n.Get (0)->AddDevice (txDev);
+  n.Get (1)->AddDevice (rxDev);
+  Ptr<SimpleChannel> channel1 = CreateObject<SimpleChannel> ();
+  rxDev->SetChannel (channel1);
+  txDev->SetChannel (channel1);
+  NetDeviceContainer d;
+  d.Add (txDev);
+  d.Add (rxDev);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (d);
+
+  // resolve the address of the sink without the random request jitter,
+  // so that the first flows are not delayed by a varying amount
+  n.Get (0)->GetObject<ArpL3Protocol> ()->SetAttribute ("RequestJitter", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
+
+  uint16_t port = 4000;
+  MultiFlowSinkHelper sink (InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (n.Get (1));
+  sinkApps.Start (Seconds (1.0));
+  sinkApps.Stop (Seconds (10.0));
+
+  // 5 packets per flow, 0.8 ms apart at 10 Mbps, a new flow every 2 ms:
+  // the flows overlap
+  MultiFlowHelper flows (InetSocketAddress (i.GetAddress (1), port));
+  flows.SetAttribute ("Interval", StringValue ("ns3::ConstantRandomVariable[Constant=0.002]"));
+  flows.SetAttribute ("FlowSize", StringValue ("ns3::ConstantRandomVariable[Constant=5000]"));
+  flows.SetAttribute ("FlowRate", DataRateValue (DataRate ("10Mbps")));
+  flows.SetAttribute ("PacketSize", UintegerValue (1000));
+  flows.SetAttribute ("MaxFlows", UintegerValue (50));
+  ApplicationContainer apps = flows.Install (n.Get (0));
+  apps.Start (Seconds (2.0));
+  apps.Stop (Seconds (10.0));
+
+  Simulator::Run ();
+
+  Ptr<MultiFlowApplication> app = DynamicCast<MultiFlowApplication> (apps.Get (0));
+  Ptr<MultiFlowSink> fct = DynamicCast<MultiFlowSink> (sinkApps.Get (0));
+  NS_TEST_ASSERT_MSG_EQ (app->GetStartedFlows (), 50, "Did not start the expected number of flows");
+  NS_TEST_ASSERT_MSG_EQ (app->GetActiveFlows (), 0, "Flows still active");
+  NS_TEST_ASSERT_MSG_EQ (fct->GetTotalRx (), 250000, "Did not receive the bytes of the flows");
+  NS_TEST_ASSERT_MSG_EQ (fct->GetCompletedFlows (), 50, "Did not complete the expected number of flows");
+  NS_TEST_ASSERT_MSG_EQ (fct->GetIncompleteFlows (), 0, "Flows left incomplete");
+  NS_TEST_ASSERT_MSG_EQ (fct->GetMeanFct (), MicroSeconds (3200), "Flows not paced at the flow rate");
+  NS_TEST_ASSERT_MSG_EQ (fct->GetFctPercentile (99), MicroSeconds (3200), "Flows not paced at the flow rate");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Test that TraceReplayApplications split a binary packet trace by source
+ * address and send the records due within their batch window together
+ */
+
+class TraceReplaySourcesTestCase : public TestCase
+{
+public:
+  TraceReplaySourcesTestCase ();
+  virtual ~TraceReplaySourcesTestCase ();
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Tx trace sink of the application
+   * \param p the packet sent
+   */
+  void Tx (Ptr<const Packet> p);
+
+  std::string m_filename; //!< the packet trace to replay
+  std::vector<Time> m_txTimes; //!< times at which the packets were sent
+};
+
+TraceReplaySourcesTestCase::TraceReplaySourcesTestCase ()
+  : TestCase ("Test that TraceReplayApplications split a packet trace among sources")
+{
+}
+
+TraceReplaySourcesTestCase::~TraceReplaySourcesTestCase ()
+{
+}
+
+void
+TraceReplaySourcesTestCase::DoSetup (void)
+{
+  m_filename = CreateTempDirFilename ("trace-replay.ns3t");
+  // three source addresses: the first and the third are dealt to the
+  // first of two sources
+  uint32_t sources[6] = { 1, 2, 3, 1, 2, 3 };
+  uint64_t times[6] = { 0, 0, 100000, 200000, 1000000, 1050000 };
+  uint32_t sizes[6] = { 128, 228, 128, 328, 128, 128 };
+  PacketTraceFile f;
+  f.Open (m_filename, std::ios::out);
+  for (uint32_t i = 0; i < 6; ++i)
+    {
+      PacketTraceFile::Record r;
+      r.timestamp = 1000000000 + times[i];
+      r.size = sizes[i];
+      r.source = 0x0a000000 + sources[i];
+      r.destination = 0x0a000100;
+      r.sourcePort = 5000;
+      r.destinationPort = 6000;
+      r.protocol = 17;
+      f.Write (r);
+    }
+  f.Close ();
+}
+
+void
+TraceReplaySourcesTestCase::DoTeardown (void)
+{
+  remove (m_filename.c_str ());
+}
+
+void
+TraceReplaySourcesTestCase::Tx (Ptr<const Packet> p)
+{
+  m_txTimes.push_back (Simulator::Now ());
+}
+
+void TraceReplaySourcesTestCase::DoRun (void)
+{
+  NodeContainer n;
+  n.Create (3);
+
+  InternetStackHelper internet;
+  internet.Install (n);
+
+  Ptr<SimpleChannel> channel1 = CreateObject<SimpleChannel> ();
+  NetDeviceContainer d;
+  for (uint32_t j = 0; j < 3; ++j)
+    {
+      Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice> ();
+      dev->SetAddress (Mac48Address::Allocate ());
+      n.Get (j)->AddDevice (dev);
+      dev->SetChannel (channel1);
+      d.Add (dev);
+    }
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (d);
+
+  // the four packets of the first batch wait together for the address
+  // of the sink to be resolved, without the random request jitter
+  for (uint32_t j = 0; j < 2; ++j)
+    {
+      n.Get (j)->GetObject<ArpL3Protocol> ()->SetAttribute ("RequestJitter", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
+      Ptr<Ipv4L3Protocol> ipv4L3 = n.Get (j)->GetObject<Ipv4L3Protocol> ();
+      ipv4L3->GetInterface (1)->GetArpCache ()->SetAttribute ("PendingQueueSize", UintegerValue (10));
+    }
+
+  uint16_t port = 4000;
+  PacketSinkHelper sink ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (n.Get (2));
+  sinkApps.Start (Seconds (1.0));
+  sinkApps.Stop (Seconds (10.0));
+
+  TraceReplayHelper replay ("ns3::UdpSocketFactory", InetSocketAddress (i.GetAddress (2), port), m_filename);
+  replay.SetAttribute ("PayloadOffset", UintegerValue (28));
+  replay.SetAttribute ("BatchWindow", TimeValue (MicroSeconds (500)));
+  ApplicationContainer apps = replay.InstallSources (NodeContainer (n.Get (0), n.Get (1)));
+  apps.Get (0)->TraceConnectWithoutContext ("Tx", MakeCallback (&TraceReplaySourcesTestCase::Tx, this));
+  apps.Start (Seconds (2.0));
+  apps.Stop (Seconds (10.0));
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (DynamicCast<TraceReplayApplication> (apps.Get (0))->GetSent (), 4, "Records of the first source not replayed");
+  NS_TEST_ASSERT_MSG_EQ (DynamicCast<TraceReplayApplication> (apps.Get (1))->GetSent (), 2, "Records of the second source not replayed");
+  NS_TEST_ASSERT_MSG_EQ (DynamicCast<PacketSink> (sinkApps.Get (0))->GetTotalRx (), 900, "Payload sizes do not match the trace");
+  NS_TEST_ASSERT_MSG_EQ (m_txTimes.size (), 4, "Not one packet per record");
+  NS_TEST_ASSERT_MSG_EQ (m_txTimes[0], Seconds (2.0), "First record not sent at start");
+  NS_TEST_ASSERT_MSG_EQ (m_txTimes[2], Seconds (2.0), "Record within the batch window not sent with the first one");
+  NS_TEST_ASSERT_MSG_EQ (m_txTimes[3], Seconds (2.0) + MicroSeconds (1050), "Record timing does not match the trace");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * Test that ReceiveStatistics aggregates the packets of each flow in time
+ * bins, with their losses and delays
+ */
+
+class ReceiveStatisticsTestCase : public TestCase
+{
+public:
+  ReceiveStatisticsTestCase ();
+  virtual ~ReceiveStatisticsTestCase ();
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Notify the statistics of a packet
+   * \param from the sender
+   * \param seq the sequence number of the packet
+   * \param delay the delay of the packet
+   */
+  void Receive (Address from, uint32_t seq, Time delay);
+
+  std::string m_filename; //!< the statistics file
+  ReceiveStatistics m_stats; //!< the statistics
+};
+
+ReceiveStatisticsTestCase::ReceiveStatisticsTestCase ()
+  : TestCase ("Test that ReceiveStatistics aggregates the packets of each flow in time bins")
+{
+}
+
+ReceiveStatisticsTestCase::~ReceiveStatisticsTestCase ()
+{
+}
+
+void
+ReceiveStatisticsTestCase::DoSetup (void)
+{
+  m_filename = CreateTempDirFilename ("receive-statistics.txt");
+}
+
+void
+ReceiveStatisticsTestCase::DoTeardown (void)
+{
+  remove (m_filename.c_str ());
+}
+
+void
+ReceiveStatisticsTestCase::Receive (Address from, uint32_t seq, Time delay)
+{
+  m_stats.NotifyReceived (from, 100, seq, delay);
+}
+
+void ReceiveStatisticsTestCase::DoRun (void)
+{
+  Address a = InetSocketAddress (Ipv4Address ("10.1.1.1"), 1000);
+  Address b = InetSocketAddress (Ipv4Address ("10.1.1.2"), 1000);
+
+  m_stats.SetBinWidth (Seconds (1));
+  m_stats.SetDelayHistogram (MilliSeconds (1), 4);
+  m_stats.SetOutput (m_filename);
+  m_stats.Start (Seconds (0));
+
+  // flow a loses packet 2 in the first bin and gets it late in the
+  // second one; flow b loses packets 0 and 1
+  Simulator::Schedule (Seconds (0.1), &ReceiveStatisticsTestCase::Receive, this, a, 0, MicroSeconds (500));
+  Simulator::Schedule (Seconds (0.2), &ReceiveStatisticsTestCase::Receive, this, a, 1, MicroSeconds (1500));
+  Simulator::Schedule (Seconds (0.3), &ReceiveStatisticsTestCase::Receive, this, b, 2, MicroSeconds (2500));
+  Simulator::Schedule (Seconds (0.4), &ReceiveStatisticsTestCase::Receive, this, a, 3, MilliSeconds (10));
+  Simulator::Schedule (Seconds (1.5), &ReceiveStatisticsTestCase::Receive, this, a, 2, MicroSeconds (500));
+  Simulator::Schedule (Seconds (1.6), &ReceiveStatisticsTestCase::Receive, this, a, 4, MicroSeconds (500));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_stats.Stop ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_stats.GetNFlows (), 2, "Not one flow per sender");
+  NS_TEST_ASSERT_MSG_EQ (m_stats.GetRxPackets (), 6, "Packets not counted");
+  NS_TEST_ASSERT_MSG_EQ (m_stats.GetRxBytes (), 600, "Bytes not counted");
+  NS_TEST_ASSERT_MSG_EQ (m_stats.GetLost (), 2, "Losses not counted");
+
+  std::ifstream file (m_filename.c_str ());
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline (file, line))
+    {
+      lines.push_back (line);
+    }
+  NS_TEST_ASSERT_MSG_EQ (lines.size (), 4, "Not one line per flow and bin");
+  NS_TEST_EXPECT_MSG_EQ (lines[1], "10.1.1.1:1000 0 300 3 1 0.004 1 1 0 1", "Wrong first bin of flow a");
+  NS_TEST_EXPECT_MSG_EQ (lines[2], "10.1.1.1:1000 1 200 2 -1 0.0005 2 0 0 0", "Wrong second bin of flow a");
+  NS_TEST_EXPECT_MSG_EQ (lines[3], "10.1.1.2:1000 0 100 1 2 0.0025 0 0 1 0", "Wrong bin of flow b");
+}
+
+/**
+ * Test that a UdpServer keeps the statistics of its flows in time bins
+ */
+
+class UdpServerStatisticsTestCase : public TestCase
+{
+public:
+  UdpServerStatisticsTestCase ();
+  virtual ~UdpServerStatisticsTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+};
+
+UdpServerStatisticsTestCase::UdpServerStatisticsTestCase ()
+  : TestCase ("Test that a UdpServer keeps the statistics of its flows in time bins")
+{
+}
+
+UdpServerStatisticsTestCase::~UdpServerStatisticsTestCase ()
+{
+}
+
+void UdpServerStatisticsTestCase::DoRun (void)
+{
+  NodeContainer n;
+  n.Create (2);
+
+  InternetStackHelper internet;
+  internet.Install (n);
+
+  Ptr<SimpleNetDevice> txDev = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> rxDev = CreateObject<SimpleNetDevice> ();
+  n.Get (0)->AddDevice (txDev);
+  n.Get (1)->AddDevice (rxDev);
+  Ptr<SimpleChannel> channel1 = CreateObject<SimpleChannel> ();
+  rxDev->SetChannel (channel1);
+  txDev->SetChannel (channel1);
+  NetDeviceContainer d;
+  d.Add (txDev);
+  d.Add (rxDev);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (d);
+
+  uint16_t port = 4000;
+  UdpServerHelper server (port);
+  ApplicationContainer apps = server.Install (n.Get (1));
+  apps.Get (0)->SetAttribute ("StatsBinWidth", TimeValue (MilliSeconds (500)));
+  apps.Get (0)->SetAttribute ("StatsInterval", TimeValue (Seconds (1)));
+  apps.Start (Seconds (1.0));
+  apps.Stop (Seconds (10.0));
+
+  UdpClientHelper client (i.GetAddress (1), port);
+  client.SetAttribute ("MaxPackets", UintegerValue (100));
+  client.SetAttribute ("Interval", TimeValue (MilliSeconds (10)));
+  client.SetAttribute ("PacketSize", UintegerValue (500));
+  apps = client.Install (n.Get (0));
+  apps.Start (Seconds (2.0));
+  apps.Stop (Seconds (10.0));
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  ReceiveStatistics const &stats = server.GetServer ()->GetStatistics ();
+  NS_TEST_ASSERT_MSG_EQ (stats.IsEnabled (), true, "Statistics not enabled");
+  NS_TEST_ASSERT_MSG_EQ (stats.GetNFlows (), 1, "Not one flow per sender");
+  NS_TEST_ASSERT_MSG_EQ (stats.GetRxPackets (), 100, "Packets not counted");
+  NS_TEST_ASSERT_MSG_EQ (stats.GetRxBytes (), 50000, "Bytes not counted");
+  NS_TEST_ASSERT_MSG_EQ (server.GetServer ()->GetLost (), 0, "Packets were lost !");
+  NS_TEST_ASSERT_MSG_EQ (server.GetServer ()->GetReceived (), 100, "Did not receive expected number of packets !");
+}
+
 class UdpClientServerTestSuite : public TestSuite
 {
 public:
@@ -343,7 +862,12 @@ UdpClientServerTestSuite::UdpClientServerTestSuite ()
   AddTestCase (new UdpTraceClientServerTestCase, TestCase::QUICK);
   AddTestCase (new UdpClientServerTestCase, TestCase::QUICK);
   AddTestCase (new PacketLossCounterTestCase, TestCase::QUICK);
+  AddTestCase (new ReceiveStatisticsTestCase, TestCase::QUICK);
+  AddTestCase (new UdpServerStatisticsTestCase, TestCase::QUICK);
   AddTestCase (new UdpEchoClientSetFillTestCase, TestCase::QUICK);
+  AddTestCase (new TraceReplayTestCase, TestCase::QUICK);
+  AddTestCase (new TraceReplaySourcesTestCase, TestCase::QUICK);
+  AddTestCase (new MultiFlowTestCase, TestCase::QUICK);
 }
 
 static UdpClientServerTestSuite udpClientServerTestSuite;
@@ -0,0 +1,372 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <algorithm>
+#include "timer-wheel.h"
+#include "simulator.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimerWheel");
+
+namespace {
+
+/// Number of bits of the tick indexing the first level
+const uint32_t FIRST_BITS = 8;
+/// Number of bits of the tick indexing each of the other levels
+const uint32_t LEVEL_BITS = 6;
+/// Number of buckets of the first level
+const uint32_t FIRST_SIZE = 1 << FIRST_BITS;
+/// Number of buckets of each of the other levels
+const uint32_t LEVEL_SIZE = 1 << LEVEL_BITS;
+
+/**
+ * \param level a level
+ * \return the number of bits of the tick below the index of the level
+ */
+uint32_t
+TimerWheelShift (uint32_t level)
+{
+  return level == 0 ? 0 : FIRST_BITS + (level - 1) * LEVEL_BITS;
+}
+
+/**
+ * \param level a level
+ * \param tick a tick
+ * \return the index of the bucket of the tick in the level
+ */
+uint32_t
+TimerWheelBucket (uint32_t level, int64_t tick)
+{
+  if (level == 0)
+    {
+      return tick & (FIRST_SIZE - 1);
+    }
+  return FIRST_SIZE + (level - 1) * LEVEL_SIZE + ((tick >> TimerWheelShift (level)) & (LEVEL_SIZE - 1));
+}
+
+/**
+ * \param bucket the index of a bucket
+ * \return the level of the bucket
+ */
+uint32_t
+TimerWheelLevel (uint32_t bucket)
+{
+  return bucket < FIRST_SIZE ? 0 : 1 + (bucket - FIRST_SIZE) / LEVEL_SIZE;
+}
+
+} // anonymous namespace
+
+TimerWheel::Timer::Timer ()
+  : m_wheel (0),
+    m_uid (0),
+    m_bucket (0)
+{
+  m_next = 0;
+  m_prev = 0;
+}
+
+TimerWheel::Timer::~Timer ()
+{
+  if (m_wheel != 0)
+    {
+      m_wheel->Cancel (this);
+    }
+}
+
+void
+TimerWheel::Timer::SetFunction (Callback<void> function)
+{
+  m_function = function;
+}
+
+bool
+TimerWheel::Timer::IsRunning (void) const
+{
+  return m_wheel != 0;
+}
+
+Time
+TimerWheel::Timer::GetExpiry (void) const
+{
+  return m_expiry;
+}
+
+TimerWheel::TimerWheel (Time granularity)
+  : m_granularity (granularity.GetTimeStep ()),
+    m_current (0),
+    m_nTimers (0),
+    m_uid (0)
+{
+  NS_LOG_FUNCTION (this << granularity);
+  NS_ASSERT (m_granularity > 0);
+  uint32_t n = FIRST_SIZE + (LEVELS - 1) * LEVEL_SIZE;
+  m_buckets = new Link[n];
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_buckets[i].m_next = &m_buckets[i];
+      m_buckets[i].m_prev = &m_buckets[i];
+    }
+  for (uint32_t i = 0; i < LEVELS; i++)
+    {
+      m_count[i] = 0;
+    }
+}
+
+TimerWheel::~TimerWheel ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+  delete [] m_buckets;
+}
+
+int64_t
+TimerWheel::GetTick (Time t) const
+{
+  return t.GetTimeStep () / m_granularity;
+}
+
+void
+TimerWheel::Insert (Timer *timer)
+{
+  int64_t tick = std::max (GetTick (timer->m_expiry), m_current);
+  int64_t diff = tick - m_current;
+  uint32_t level = 0;
+  while (level < LEVELS - 1 && diff >= (int64_t (1) << TimerWheelShift (level + 1)))
+    {
+      level++;
+    }
+  if (level == LEVELS - 1 && diff >= (int64_t (1) << (TimerWheelShift (level) + LEVEL_BITS)))
+    {
+      // beyond the range of the wheel: wait in the last bucket reached
+      tick = m_current + (int64_t (1) << (TimerWheelShift (level) + LEVEL_BITS)) - 1;
+    }
+  timer->m_bucket = TimerWheelBucket (level, tick);
+  Link *bucket = &m_buckets[timer->m_bucket];
+  timer->m_next = bucket;
+  timer->m_prev = bucket->m_prev;
+  bucket->m_prev->m_next = timer;
+  bucket->m_prev = timer;
+  m_count[level]++;
+}
+
+void
+TimerWheel::Unlink (Timer *timer)
+{
+  timer->m_prev->m_next = timer->m_next;
+  timer->m_next->m_prev = timer->m_prev;
+  timer->m_next = 0;
+  timer->m_prev = 0;
+  m_count[TimerWheelLevel (timer->m_bucket)]--;
+}
+
+void
+TimerWheel::Schedule (Timer *timer, Time delay)
+{
+  NS_LOG_FUNCTION (this << timer << delay);
+  NS_ASSERT (!delay.IsStrictlyNegative ());
+  if (timer->m_wheel != 0)
+    {
+      Cancel (timer);
+    }
+  timer->m_wheel = this;
+  timer->m_expiry = Simulator::Now () + delay;
+  timer->m_uid = m_uid++;
+  Insert (timer);
+  m_nTimers++;
+  if (!m_event.IsRunning () || timer->m_expiry < m_next)
+    {
+      m_event.Cancel ();
+      m_next = timer->m_expiry;
+      m_event = Simulator::Schedule (delay, &TimerWheel::Expire, this);
+    }
+}
+
+void
+TimerWheel::Cancel (Timer *timer)
+{
+  NS_LOG_FUNCTION (this << timer);
+  if (timer->m_wheel == 0)
+    {
+      return;
+    }
+  NS_ASSERT (timer->m_wheel == this);
+  Unlink (timer);
+  timer->m_wheel = 0;
+  m_nTimers--;
+  // a pending event left without timer expires nothing and stops
+}
+
+void
+TimerWheel::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t n = FIRST_SIZE + (LEVELS - 1) * LEVEL_SIZE;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Link *bucket = &m_buckets[i];
+      while (bucket->m_next != bucket)
+        {
+          Timer *timer = static_cast<Timer *> (bucket->m_next);
+          Unlink (timer);
+          timer->m_wheel = 0;
+        }
+    }
+  m_nTimers = 0;
+  m_event.Cancel ();
+}
+
+uint32_t
+TimerWheel::GetNTimers (void) const
+{
+  return m_nTimers;
+}
+
+void
+TimerWheel::Cascade (uint32_t index)
+{
+  Link *bucket = &m_buckets[index];
+  if (bucket->m_next == bucket)
+    {
+      return;
+    }
+  // detach the list first: a timer beyond the range of the wheel may go
+  // back to a bucket of the same level
+  Link list;
+  list.m_next = bucket->m_next;
+  list.m_prev = bucket->m_prev;
+  list.m_next->m_prev = &list;
+  list.m_prev->m_next = &list;
+  bucket->m_next = bucket;
+  bucket->m_prev = bucket;
+  uint32_t level = TimerWheelLevel (index);
+  while (list.m_next != &list)
+    {
+      Timer *timer = static_cast<Timer *> (list.m_next);
+      list.m_next = timer->m_next;
+      timer->m_next->m_prev = &list;
+      m_count[level]--;
+      Insert (timer);
+    }
+}
+
+void
+TimerWheel::CascadeAll (void)
+{
+  // from the top level down, so that timers cascaded into a bucket
+  // reached at the same time go down with it
+  for (uint32_t level = LEVELS - 1; level > 0; level--)
+    {
+      if ((m_current & ((int64_t (1) << TimerWheelShift (level)) - 1)) == 0)
+        {
+          Cascade (TimerWheelBucket (level, m_current));
+        }
+    }
+}
+
+TimerWheel::Timer *
+TimerWheel::FindNext (void)
+{
+  if (m_nTimers == 0)
+    {
+      return 0;
+    }
+  while (true)
+    {
+      if (m_count[0] > 0)
+        {
+          Link *bucket = &m_buckets[TimerWheelBucket (0, m_current)];
+          if (bucket->m_next != bucket)
+            {
+              // the first level holds the ticks from m_current on, so the
+              // bucket of m_current holds the earliest timers
+              Timer *next = static_cast<Timer *> (bucket->m_next);
+              for (Link *i = next->m_next; i != bucket; i = i->m_next)
+                {
+                  Timer *timer = static_cast<Timer *> (i);
+                  if (timer->m_expiry < next->m_expiry
+                      || (timer->m_expiry == next->m_expiry && timer->m_uid < next->m_uid))
+                    {
+                      next = timer;
+                    }
+                }
+              return next;
+            }
+          m_current++;
+        }
+      else
+        {
+          // skip to the next bucket of the lowest non empty level
+          uint32_t level = 1;
+          while (level < LEVELS - 1 && m_count[level] == 0)
+            {
+              level++;
+            }
+          m_current = (m_current | ((int64_t (1) << TimerWheelShift (level)) - 1)) + 1;
+        }
+      if (TimerWheelBucket (0, m_current) == 0)
+        {
+          CascadeAll ();
+        }
+    }
+}
+
+void
+TimerWheel::ScheduleNext (void)
+{
+  Timer *next = FindNext ();
+  if (next == 0)
+    {
+      m_event.Cancel ();
+      return;
+    }
+  if (!m_event.IsRunning () || next->m_expiry != m_next)
+    {
+      m_event.Cancel ();
+      m_next = next->m_expiry;
+      m_event = Simulator::Schedule (m_next - Simulator::Now (), &TimerWheel::Expire, this);
+    }
+}
+
+void
+TimerWheel::Expire (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event = EventId ();
+  Time now = Simulator::Now ();
+  while (true)
+    {
+      Timer *timer = FindNext ();
+      if (timer == 0 || timer->m_expiry > now)
+        {
+          break;
+        }
+      Unlink (timer);
+      timer->m_wheel = 0;
+      m_nTimers--;
+      // the function may start, stop or destroy any timer, this one included
+      timer->m_function ();
+    }
+  ScheduleNext ();
+}
+
+} // namespace ns3
@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+#include "nstime.h"
+#include "event-id.h"
+#include "callback.h"
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup timer
+ * \brief A hierarchical timer wheel sharing one simulator event among
+ * many timers
+ *
+ * Protocols keeping a timer on each of thousands of records (neighbor
+ * caches for instance) would otherwise keep as many events in the
+ * scheduler, and pay a scheduler insertion and removal each time a
+ * timer is restarted.  A TimerWheel keeps its timers in buckets of
+ * ticks instead: a first level of 256 buckets of one tick, then three
+ * levels of 64 buckets each 64 times as long as the buckets of the level
+ * below, whose timers are moved down when the wheel reaches them.
+ * Starting and stopping a timer is a constant time list operation, and
+ * the wheel keeps a single event in the scheduler, for the earliest
+ * timer.
+ *
+ * The granularity only sizes the buckets: each timer expires at its
+ * exact expiration time, and timers expiring at the same time expire
+ * in the order in which they were started.
+ *
+ * The timers are owned by the caller and linked into the wheel while
+ * running; a timer is stopped when destroyed.
+ */
+class TimerWheel
+{
+public:
+  class Timer;
+
+  /**
+   * \param granularity the duration of a tick
+   */
+  TimerWheel (Time granularity = MilliSeconds (10));
+  ~TimerWheel ();
+
+  /**
+   * \brief Start a timer, or restart it if it is running
+   *
+   * \param timer the timer
+   * \param delay the delay after which the function of the timer is called
+   */
+  void Schedule (Timer *timer, Time delay);
+  /**
+   * \brief Stop a timer
+   * \param timer the timer, running or not
+   */
+  void Cancel (Timer *timer);
+  /**
+   * \brief Stop all the timers
+   */
+  void Clear (void);
+  /**
+   * \return the number of running timers
+   */
+  uint32_t GetNTimers (void) const;
+
+  /// Link of the lists of timers
+  struct Link
+  {
+    Link *m_next; //!< the next timer of the bucket
+    Link *m_prev; //!< the previous timer of the bucket
+  };
+
+  /**
+   * \brief A timer of a TimerWheel
+   */
+  class Timer : private Link
+  {
+public:
+    Timer ();
+    ~Timer ();
+
+    /**
+     * \param function the function called when the timer expires
+     */
+    void SetFunction (Callback<void> function);
+    /**
+     * \return true if the timer is running
+     */
+    bool IsRunning (void) const;
+    /**
+     * \return the time at which the running timer expires
+     */
+    Time GetExpiry (void) const;
+
+private:
+    friend class TimerWheel;
+
+    /**
+     * \brief Copy constructor, disabled
+     * \param o the timer
+     */
+    Timer (const Timer &o);
+    /**
+     * \brief Assignment operator, disabled
+     * \param o the timer
+     * \return the timer
+     */
+    Timer &operator = (const Timer &o);
+
+    TimerWheel *m_wheel;        //!< the wheel of the running timer, 0 otherwise
+    Time m_expiry;              //!< the expiration time
+    uint64_t m_uid;             //!< the order of the timer among those of the same expiration time
+    uint32_t m_bucket;          //!< the bucket holding the running timer
+    Callback<void> m_function;  //!< the function to call
+  };
+
+private:
+  /**
+   * \brief Copy constructor, disabled
+   * \param o the wheel
+   */
+  TimerWheel (const TimerWheel &o);
+  /**
+   * \brief Assignment operator, disabled
+   * \param o the wheel
+   * \return the wheel
+   */
+  TimerWheel &operator = (const TimerWheel &o);
+
+  /**
+   * \brief Link a timer into the bucket of its expiration time
+   * \param timer the timer
+   */
+  void Insert (Timer *timer);
+  /**
+   * \brief Unlink a timer from its bucket
+   * \param timer the timer
+   */
+  void Unlink (Timer *timer);
+  /**
+   * \brief Move the timers of a bucket to the buckets below
+   * \param bucket the index of the bucket
+   */
+  void Cascade (uint32_t bucket);
+  /**
+   * \brief Move down the timers of the buckets reached by the first level
+   */
+  void CascadeAll (void);
+  /**
+   * \brief Move to the first non empty bucket of the first level
+   * \return the earliest timer, or 0 if there is none
+   */
+  Timer *FindNext (void);
+  /**
+   * \brief Schedule the event of the wheel for its earliest timer
+   */
+  void ScheduleNext (void);
+  /**
+   * \brief Expire the due timers
+   */
+  void Expire (void);
+  /**
+   * \param t a time
+   * \return the tick of the time
+   */
+  int64_t GetTick (Time t) const;
+
+  /// Number of levels
+  static const uint32_t LEVELS = 4;
+
+  int64_t m_granularity;        //!< the duration of a tick, in time steps
+  int64_t m_current;            //!< the tick of the first bucket of the first level
+  Link *m_buckets;              //!< the buckets, heads of circular lists
+  uint32_t m_count[LEVELS];     //!< the number of timers of each level
+  uint32_t m_nTimers;           //!< the number of running timers
+  uint64_t m_uid;               //!< the order of the next timer started
+  EventId m_event;              //!< the event of the earliest timer
+  Time m_next;                  //!< the time of m_event
+};
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
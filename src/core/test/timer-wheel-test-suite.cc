@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <vector>
+#include "ns3/timer-wheel.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup timer
+ * \brief Check that the timers of a TimerWheel expire at their exact time
+ * and in order, from the first level to beyond the range of the wheel
+ */
+class TimerWheelTestCase : public TestCase
+{
+public:
+  TimerWheelTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /// A timer recording its expiration
+  struct Probe
+  {
+    TimerWheel::Timer timer;     //!< the timer
+    uint32_t id;                 //!< the index of the probe
+    TimerWheelTestCase *test;    //!< the test
+    /// Record the expiration
+    void Expire (void);
+  };
+
+  /**
+   * \brief Start a timer
+   * \param i the index of the probe
+   * \param delay the delay of the timer
+   */
+  void Start (uint32_t i, Time delay);
+
+  TimerWheel m_wheel;                 //!< the wheel
+  Probe m_probes[8];                  //!< the timers
+  std::vector<uint32_t> m_order;      //!< the probes in the order of their expiration
+  std::vector<Time> m_times;          //!< the times of the expirations
+};
+
+TimerWheelTestCase::TimerWheelTestCase ()
+  : TestCase ("Check the expiration time and order of TimerWheel timers")
+{
+}
+
+void
+TimerWheelTestCase::Probe::Expire (void)
+{
+  test->m_order.push_back (id);
+  test->m_times.push_back (Simulator::Now ());
+}
+
+void
+TimerWheelTestCase::Start (uint32_t i, Time delay)
+{
+  m_wheel.Schedule (&m_probes[i].timer, delay);
+}
+
+void
+TimerWheelTestCase::DoRun (void)
+{
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      m_probes[i].id = i;
+      m_probes[i].test = this;
+      m_probes[i].timer.SetFunction (MakeCallback (&TimerWheelTestCase::Probe::Expire, &m_probes[i]));
+    }
+  // one per level, and one beyond the range of the 10 ms wheel
+  Start (0, MicroSeconds (12345));
+  Start (1, Seconds (3) + NanoSeconds (7));
+  Start (2, Seconds (300));
+  Start (3, Seconds (40000));
+  Start (4, Seconds (1000000));
+  // the same expiration as 2, started later from the first level
+  Simulator::Schedule (Seconds (299.5), &TimerWheelTestCase::Start, this, 5, MilliSeconds (500));
+  // restarted before it expires, then cancelled
+  Start (6, Seconds (1));
+  Simulator::Schedule (Seconds (0.5), &TimerWheelTestCase::Start, this, 6, Seconds (2));
+  Start (7, Seconds (2));
+  Simulator::Schedule (Seconds (1.5), &TimerWheel::Cancel, &m_wheel, &m_probes[7].timer);
+
+  NS_TEST_ASSERT_MSG_EQ (m_wheel.GetNTimers (), 7, "Timers not running");
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_wheel.GetNTimers (), 0, "Timers still running");
+
+  uint32_t order[] = { 0, 6, 1, 2, 5, 3, 4 };
+  Time times[] = { MicroSeconds (12345), Seconds (2.5), Seconds (3) + NanoSeconds (7),
+                   Seconds (300), Seconds (300), Seconds (40000), Seconds (1000000) };
+  NS_TEST_ASSERT_MSG_EQ (m_order.size (), 7, "Wrong number of expirations");
+  for (uint32_t i = 0; i < 7; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_order[i], order[i], "Wrong expiration order");
+      NS_TEST_EXPECT_MSG_EQ (m_times[i], times[i], "Wrong expiration time");
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup timer
+ * \brief Check that a TimerWheel keeps a single event for many timers
+ */
+class TimerWheelEventTestCase : public TestCase
+{
+public:
+  TimerWheelEventTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /// Count an expiration
+  void Expire (void);
+
+  uint32_t m_expired;   //!< the number of expirations
+};
+
+TimerWheelEventTestCase::TimerWheelEventTestCase ()
+  : TestCase ("Check that a TimerWheel keeps a single event")
+{
+}
+
+void
+TimerWheelEventTestCase::Expire (void)
+{
+  m_expired++;
+}
+
+void
+TimerWheelEventTestCase::DoRun (void)
+{
+  m_expired = 0;
+  TimerWheel wheel;
+  TimerWheel::Timer *timers = new TimerWheel::Timer[1000];
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      timers[i].SetFunction (MakeCallback (&TimerWheelEventTestCase::Expire, this));
+      wheel.Schedule (&timers[i], Seconds (30) + MilliSeconds (i));
+    }
+  Simulator::Stop (Seconds (30.4995));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_expired, 500, "Wrong number of expirations");
+  NS_TEST_ASSERT_MSG_EQ (wheel.GetNTimers (), 500, "Wrong number of running timers");
+  // destroying the timers stops them
+  delete [] timers;
+  NS_TEST_ASSERT_MSG_EQ (wheel.GetNTimers (), 0, "Destroyed timers still running");
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_expired, 500, "Destroyed timers expired");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup timer
+ * \brief TimerWheel TestSuite
+ */
+static class TimerWheelTestSuite : public TestSuite
+{
+public:
+  TimerWheelTestSuite ()
+    : TestSuite ("timer-wheel", UNIT)
+  {
+    AddTestCase (new TimerWheelTestCase (), TestCase::QUICK);
+    AddTestCase (new TimerWheelEventTestCase (), TestCase::QUICK);
+  }
+} g_timerWheelTestSuite;
@@ -21,6 +21,7 @@
 #include "csma-channel.h"
 #include "csma-net-device.h"
 #include "ns3/packet.h"
+#include "ns3/packet-batch.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 
@@ -189,11 +190,52 @@ CsmaChannel::TransmitStart (Ptr<Packet> p, uint32_t srcId)
 
   NS_LOG_LOGIC ("switch to TRANSMITTING");
   m_currentPkt = p;
+  m_currentBatch = 0;
   m_currentSrc = srcId;
   m_state = TRANSMITTING;
   return true;
 }
 
+bool
+CsmaChannel::TransmitBatchStart (Ptr<PacketBatch> batch, uint32_t srcId)
+{
+  NS_LOG_FUNCTION (this << batch << srcId);
+  NS_ASSERT (!batch->IsEmpty ());
+
+  //
+  // The last packet of the batch stands for the whole transmission in the
+  // channel state, so that the logging and the checks of the single packet
+  // path remain valid.
+  //
+  if (TransmitStart (batch->GetPacket (batch->GetNPackets () - 1), srcId) == false)
+    {
+      return false;
+    }
+  m_currentBatch = batch;
+
+  //
+  // The reception events are scheduled right away rather than at
+  // TransmitEnd, since the first packets of the batch reach the other
+  // devices before the last bit of the batch leaves the source.
+  //
+  std::vector<CsmaDeviceRec>::iterator it;
+  for (it = m_deviceList.begin (); it < m_deviceList.end (); it++)
+    {
+      if (it->IsActive ())
+        {
+          for (uint32_t i = 0; i < batch->GetNPackets (); ++i)
+            {
+              Time arrival = batch->GetTimestamp (i) + m_delay - Simulator::Now ();
+              Simulator::ScheduleWithContext (it->devicePtr->GetNode ()->GetId (),
+                                              arrival,
+                                              &CsmaNetDevice::Receive, it->devicePtr,
+                                              batch->GetPacket (i)->Copy (), m_deviceList[srcId].devicePtr);
+            }
+        }
+    }
+  return true;
+}
+
 bool
 CsmaChannel::IsActive (uint32_t deviceId)
 {
@@ -203,7 +245,13 @@ CsmaChannel::IsActive (uint32_t deviceId)
 bool
 CsmaChannel::TransmitEnd ()
 {
-  NS_LOG_FUNCTION (this << m_currentPkt << m_currentSrc);
+  return TransmitEnd (Seconds (0));
+}
+
+bool
+CsmaChannel::TransmitEnd (Time extraDelay)
+{
+  NS_LOG_FUNCTION (this << m_currentPkt << m_currentSrc << extraDelay);
   NS_LOG_INFO ("UID is " << m_currentPkt->GetUid () << ")");
 
   NS_ASSERT (m_state == TRANSMITTING);
@@ -228,14 +276,19 @@ CsmaChannel::TransmitEnd ()
     {
       if (it->IsActive ())
         {
-          // schedule reception events
-          Simulator::ScheduleWithContext (it->devicePtr->GetNode ()->GetId (),
-                                          m_delay,
-                                          &CsmaNetDevice::Receive, it->devicePtr,
-                                          m_currentPkt->Copy (), m_deviceList[m_currentSrc].devicePtr);
+          // schedule reception events, unless they were scheduled along
+          // with the batch at TransmitBatchStart
+          if (m_currentBatch == 0)
+            {
+              Simulator::ScheduleWithContext (it->devicePtr->GetNode ()->GetId (),
+                                              m_delay + extraDelay,
+                                              &CsmaNetDevice::Receive, it->devicePtr,
+                                              m_currentPkt->Copy (), m_deviceList[m_currentSrc].devicePtr);
+            }
         }
       devId++;
     }
+  m_currentBatch = 0;
 
   // also schedule for the tx side to go back to IDLE
   Simulator::Schedule (m_delay, &CsmaChannel::PropagationCompleteEvent,
@@ -29,6 +29,7 @@
 namespace ns3 {
 
 class Packet;
+class PacketBatch;
 
 class CsmaNetDevice;
 
@@ -167,6 +168,26 @@ public:
    */
   bool TransmitStart (Ptr<Packet> p, uint32_t srcId);
 
+  /**
+   * \brief Start transmitting a batch of back-to-back packets over the
+   * channel
+   *
+   * Works like TransmitStart, except that the channel stays busy until
+   * the whole batch has been transmitted and propagated.  The timestamp of
+   * each packet of the batch is expected to hold the (absolute) time at
+   * which its last bit leaves the source device.  A reception event is
+   * scheduled right away for each packet and each attached device, when
+   * the last bit of the packet arrives at the device.
+   *
+   * \param batch The batch of packets that will be transmitted over the
+   * channel
+   * \param srcId The device Id of the net device that wants to
+   * transmit on the channel.
+   * \return True if the channel is not busy and the transmitting net
+   * device is currently active.
+   */
+  bool TransmitBatchStart (Ptr<PacketBatch> batch, uint32_t srcId);
+
   /**
    * \brief Indicates that the net device has finished transmitting
    * the packet over the channel
@@ -183,6 +204,22 @@ public:
    */
   bool TransmitEnd ();
 
+  /**
+   * \brief Indicates that the net device has finished transmitting
+   * the packet over the channel, which reaches the other net devices
+   * later than the propagation delay
+   *
+   * Works like TransmitEnd (), except that the receptions are scheduled
+   * after an extra delay, during which the channel does not stay busy;
+   * the CsmaNetDevice uses it for the time its packet spends behind
+   * background traffic (see FluidBackground).
+   *
+   * \param extraDelay The delay added to the propagation delay
+   * \return Returns true unless the source was detached before it
+   * completed its transmission.
+   */
+  bool TransmitEnd (Time extraDelay);
+
   /**
    * \brief Indicates that the channel has finished propagating the
    * current packet. The channel is released and becomes free.
@@ -308,6 +345,12 @@ private:
    */
   Ptr<Packet> m_currentPkt;
 
+  /**
+   * The batch that is currently being transmitted on the channel, if the
+   * current transmission is a batch.
+   */
+  Ptr<PacketBatch> m_currentBatch;
+
   /**
    * Device Id of the source that is currently transmitting on the
    * channel. Or last source to have transmitted a packet on the
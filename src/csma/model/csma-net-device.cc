@@ -30,6 +30,8 @@
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/packet-batch.h"
+#include "ns3/fluid-background.h"
 #include "csma-net-device.h"
 #include "csma-channel.h"
 
@@ -77,6 +79,11 @@ CsmaNetDevice::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&CsmaNetDevice::m_receiveErrorModel),
                    MakePointerChecker<ErrorModel> ())
+    .AddAttribute ("FluidBackground",
+                   "The fluid model of the background traffic sharing the medium",
+                   PointerValue (),
+                   MakePointerAccessor (&CsmaNetDevice::m_fluidBackground),
+                   MakePointerChecker<FluidBackground> ())
 
     //
     // Transmit queueing discipline for the device which includes its own set
@@ -217,6 +224,8 @@ CsmaNetDevice::DoDispose ()
   NS_LOG_FUNCTION_NOARGS ();
   m_channel = 0;
   m_node = 0;
+  m_currentBatch = 0;
+  m_fluidBackground = 0;
   NetDevice::DoDispose ();
 }
 
@@ -521,13 +530,77 @@ CsmaNetDevice::TransmitStart (void)
           m_txMachineState = BUSY;
           m_phyTxBeginTrace (m_currentPkt);
 
-          Time tEvent = m_bps.CalculateBytesTxTime (m_currentPkt->GetSize ());
+          Time tEvent;
+          if (m_fluidBackground)
+            {
+              //
+              // The background traffic takes its share of the medium, and the
+              // packet is received only once the background backlog drained.
+              //
+              tEvent = m_fluidBackground->GetTransmissionTime (m_bps, m_currentPkt->GetSize ());
+              m_fluidDelay = m_fluidBackground->GetQueueingDelay (m_bps, tEvent);
+            }
+          else
+            {
+              tEvent = m_bps.CalculateBytesTxTime (m_currentPkt->GetSize ());
+              // the background may have been removed since the last packet
+              m_fluidDelay = Seconds (0);
+            }
           NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << tEvent.GetSeconds () << "sec");
           Simulator::Schedule (tEvent, &CsmaNetDevice::TransmitCompleteEvent, this);
         }
     }
 }
 
+bool
+CsmaNetDevice::TransmitBatchStart (Ptr<PacketBatch> batch)
+{
+  NS_LOG_FUNCTION (this << batch);
+  NS_LOG_LOGIC ("Batch of " << batch->GetNPackets () << " packets");
+
+  NS_ASSERT_MSG (m_txMachineState == READY, 
+                 "Must be READY to transmit. Tx state is: " << m_txMachineState);
+
+  //
+  // The packets go out back to back, so the last bit of each packet leaves
+  // the device one transmission time (plus the interframe gap separating it
+  // from its predecessor) after the previous one.
+  //
+  Time txEnd = Simulator::Now ();
+  for (uint32_t i = 0; i < batch->GetNPackets (); ++i)
+    {
+      if (i > 0)
+        {
+          txEnd += m_tInterframeGap;
+        }
+      txEnd += m_bps.CalculateBytesTxTime (batch->GetPacket (i)->GetSize ());
+      batch->SetTimestamp (i, txEnd);
+    }
+
+  if (m_channel->TransmitBatchStart (batch, m_deviceId) == false)
+    {
+      NS_LOG_WARN ("Channel TransmitBatchStart returns an error");
+      for (std::vector<Ptr<Packet> >::const_iterator i = batch->Begin (); i != batch->End (); ++i)
+        {
+          m_phyTxDropTrace (*i);
+        }
+      return false;
+    }
+
+  m_backoff.ResetBackoffTime ();
+  m_txMachineState = BUSY;
+  m_currentBatch = batch;
+  for (std::vector<Ptr<Packet> >::const_iterator i = batch->Begin (); i != batch->End (); ++i)
+    {
+      m_phyTxBeginTrace (*i);
+    }
+
+  Time tEvent = txEnd - Simulator::Now ();
+  NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << tEvent.GetSeconds () << "sec");
+  Simulator::Schedule (tEvent, &CsmaNetDevice::TransmitCompleteEvent, this);
+  return true;
+}
+
 void
 CsmaNetDevice::TransmitAbort (void)
 {
@@ -591,13 +664,25 @@ CsmaNetDevice::TransmitCompleteEvent (void)
   // When we started transmitting the current packet, it was placed in 
   // m_currentPkt.  So we had better find one there.
   //
-  NS_ASSERT_MSG (m_currentPkt != 0, "CsmaNetDevice::TransmitCompleteEvent(): m_currentPkt zero");
-  NS_LOG_LOGIC ("m_currentPkt=" << m_currentPkt);
-  NS_LOG_LOGIC ("Pkt UID is " << m_currentPkt->GetUid () << ")");
+  if (m_currentBatch != 0)
+    {
+      m_channel->TransmitEnd (); 
+      for (std::vector<Ptr<Packet> >::const_iterator i = m_currentBatch->Begin (); i != m_currentBatch->End (); ++i)
+        {
+          m_phyTxEndTrace (*i);
+        }
+      m_currentBatch = 0;
+    }
+  else
+    {
+      NS_ASSERT_MSG (m_currentPkt != 0, "CsmaNetDevice::TransmitCompleteEvent(): m_currentPkt zero");
+      NS_LOG_LOGIC ("m_currentPkt=" << m_currentPkt);
+      NS_LOG_LOGIC ("Pkt UID is " << m_currentPkt->GetUid () << ")");
 
-  m_channel->TransmitEnd (); 
-  m_phyTxEndTrace (m_currentPkt);
-  m_currentPkt = 0;
+      m_channel->TransmitEnd (m_fluidDelay);
+      m_phyTxEndTrace (m_currentPkt);
+      m_currentPkt = 0;
+    }
 
   NS_LOG_LOGIC ("Schedule TransmitReadyEvent in " << m_tInterframeGap.GetSeconds () << "sec");
 
@@ -680,6 +765,13 @@ CsmaNetDevice::SetReceiveErrorModel (Ptr<ErrorModel> em)
   m_receiveErrorModel = em; 
 }
 
+void
+CsmaNetDevice::SetFluidBackground (Ptr<FluidBackground> fluid)
+{
+  NS_LOG_FUNCTION (fluid);
+  m_fluidBackground = fluid;
+}
+
 void
 CsmaNetDevice::Receive (Ptr<Packet> packet, Ptr<CsmaNetDevice> senderDevice)
 {
@@ -964,6 +1056,17 @@ CsmaNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address&
 
   m_macTxTrace (packet);
 
+  //
+  // The transmit buffer is shared with the background traffic, which may
+  // leave no room for the packet.
+  //
+  if (m_fluidBackground
+      && !m_fluidBackground->Admit (m_bps, packet->GetSize (), m_queue->GetNBytes ()))
+    {
+      m_macTxDropTrace (packet);
+      return false;
+    }
+
   //
   // Place the packet to be sent on the send queue.  Note that the 
   // queue may fire a drop trace, but we will too.
@@ -993,6 +1096,70 @@ CsmaNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address&
   return true;
 }
 
+bool
+CsmaNetDevice::SendBatch (Ptr<PacketBatch> batch, const Address& dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (batch << dest << protocolNumber);
+
+  //
+  // A batch only goes out as a unit if the transmitter is idle, nothing is
+  // waiting in the queue and nobody else is on the wire; otherwise the
+  // packets are subject to the usual queueing and backoff, one at a time.
+  // The same goes when background traffic shares the medium.
+  //
+  if (IsSendEnabled () == false || m_txMachineState != READY
+      || m_queue->IsEmpty () == false || m_channel->GetState () != IDLE
+      || batch->GetNPackets () < 2 || m_fluidBackground)
+    {
+      return NetDevice::SendBatch (batch, dest, protocolNumber);
+    }
+
+  Mac48Address destination = Mac48Address::ConvertFrom (dest);
+
+  //
+  // Every packet still goes through the queue, both to hit the tracing hooks
+  // and so that the queue limits apply exactly as if the packets had been
+  // sent one by one: the first one goes straight to the wire, the others
+  // wait in the queue until the whole batch has been accepted.
+  //
+  bool result = true;
+  Ptr<PacketBatch> wire = CreateObject<PacketBatch> ();
+  for (std::vector<Ptr<Packet> >::const_iterator i = batch->Begin (); i != batch->End (); ++i)
+    {
+      Ptr<Packet> packet = *i;
+      AddHeader (packet, m_address, destination, protocolNumber);
+      m_macTxTrace (packet);
+      if (m_queue->Enqueue (packet) == false)
+        {
+          m_macTxDropTrace (packet);
+          result = false;
+          continue;
+        }
+      if (wire->IsEmpty ())
+        {
+          wire->AddPacket (m_queue->Dequeue ());
+        }
+    }
+
+  Ptr<Packet> packet;
+  while ((packet = m_queue->Dequeue ()) != 0)
+    {
+      wire->AddPacket (packet);
+    }
+
+  if (wire->IsEmpty ())
+    {
+      return false;
+    }
+
+  for (std::vector<Ptr<Packet> >::const_iterator i = wire->Begin (); i != wire->End (); ++i)
+    {
+      m_promiscSnifferTrace (*i);
+      m_snifferTrace (*i);
+    }
+  return TransmitBatchStart (wire) && result;
+}
+
 Ptr<Node>
 CsmaNetDevice::GetNode (void) const
 {
@@ -37,8 +37,10 @@
 namespace ns3 {
 
 class Queue;
+class PacketBatch;
 class CsmaChannel;
 class ErrorModel;
+class FluidBackground;
 
 /** 
  * \defgroup csma CSMA Network Device
@@ -148,6 +150,18 @@ public:
    */
   void SetReceiveErrorModel (Ptr<ErrorModel> em);
 
+  /**
+   * Attach a fluid model of background traffic to the CsmaNetDevice.
+   *
+   * The background traffic shares the transmit buffer and the medium with
+   * the packets of the device: the packets hold the medium for the time
+   * needed at the rate it leaves, are delayed by its backlog and are lost
+   * when it fills the buffer.
+   *
+   * \param fluid a pointer to the FluidBackground
+   */
+  void SetFluidBackground (Ptr<FluidBackground> fluid);
+
   /**
    * Receive a packet from a connected CsmaChannel.
    *
@@ -278,6 +292,20 @@ public:
   virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, 
                          uint16_t protocolNumber);
 
+  /**
+   * Start sending a batch of back-to-back packets down the channel.
+   *
+   * If the transmitter is idle, the queue is empty and the channel is
+   * free, the whole batch is put on the wire as a single transmission;
+   * otherwise the packets are sent one at a time.
+   *
+   * \param batch packets to send
+   * \param dest layer 2 destination address
+   * \param protocolNumber protocol number
+   * \return true if successfull, false otherwise (drop, ...)
+   */
+  virtual bool SendBatch (Ptr<PacketBatch> batch, const Address& dest, uint16_t protocolNumber);
+
   /**
    * Get the node to which this device is attached.
    *
@@ -392,6 +420,22 @@ private:
    */
   void TransmitStart ();
 
+  /**
+   * Start Sending a Batch of Packets Down the Wire.
+   *
+   * The packets are serialized back to back, separated by the interframe
+   * gap, and the channel stays busy for the whole batch.  The timestamp of
+   * each packet is set to the time at which its last bit leaves the device
+   * and a single TransmitCompleteEvent is scheduled at the end of the batch.
+   * Unlike TransmitStart (), this method expects the channel to be idle and
+   * never backs off.
+   *
+   * \see CsmaChannel::TransmitBatchStart ()
+   * \param batch the batch of packets to send
+   * \return true if the channel accepted the batch, false otherwise
+   */
+  bool TransmitBatchStart (Ptr<PacketBatch> batch);
+
   /**
    * Stop Sending a Packet Down the Wire and Begin the Interframe Gap.
    *
@@ -509,6 +553,11 @@ private:
    */
   Ptr<Packet> m_currentPkt;
 
+  /**
+   * Batch of packets that is currently being transmitted, if any.
+   */
+  Ptr<PacketBatch> m_currentBatch;
+
   /**
    * The CsmaChannel to which this CsmaNetDevice has been
    * attached.
@@ -532,6 +581,18 @@ private:
    */
   Ptr<ErrorModel> m_receiveErrorModel;
 
+  /**
+   * Background traffic sharing the transmit buffer and the medium
+   */
+  Ptr<FluidBackground> m_fluidBackground;
+
+  /**
+   * The time the packet being transmitted spends behind the background
+   * traffic, on top of the propagation delay.  It is computed when the
+   * transmission starts, and is zero without background traffic.
+   */
+  Time m_fluidDelay;
+
   /**
    * The trace source fired when packets come into the "top" of the device
    * at the L3/L2 transition, before being queued for transmission.
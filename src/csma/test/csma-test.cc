@@ -0,0 +1,272 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/packet-batch.h"
+#include "ns3/csma-net-device.h"
+#include "ns3/csma-channel.h"
+#include "ns3/mac48-address.h"
+#include "ns3/data-rate.h"
+#include "ns3/fluid-background.h"
+
+using namespace ns3;
+
+/**
+ * \brief Test class for PacketBatch transmission over a CsmaChannel
+ *
+ * It sends a batch of packets from one CsmaNetDevice to the two others
+ * attached to the channel and checks that they are delivered in order,
+ * each one when its own last bit arrives.
+ */
+class CsmaBatchTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  CsmaBatchTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send a batch of packets to the device specified
+   *
+   * \param device NetDevice to send to
+   */
+  void SendBatch (Ptr<CsmaNetDevice> device);
+
+  /**
+   * \brief Receive callback of the destination devices
+   *
+   * \param device the receiving device
+   * \param packet the received packet
+   * \param protocol the protocol number
+   * \param sender the address of the sender
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &sender);
+
+  Ptr<NetDevice> m_receiver;       //!< device whose receptions are checked
+  std::vector<uint32_t> m_rxSizes; //!< sizes of the packets received by m_receiver
+  std::vector<Time> m_rxTimes;     //!< times at which m_receiver received the packets
+  uint32_t m_rxOthers;             //!< number of packets received by the other devices
+};
+
+CsmaBatchTest::CsmaBatchTest ()
+  : TestCase ("Csma PacketBatch"),
+    m_rxOthers (0)
+{
+}
+
+void
+CsmaBatchTest::SendBatch (Ptr<CsmaNetDevice> device)
+{
+  Ptr<PacketBatch> batch = CreateObject<PacketBatch> ();
+  batch->AddPacket (Create<Packet> (100));
+  batch->AddPacket (Create<Packet> (200));
+  batch->AddPacket (Create<Packet> (300));
+  device->SendBatch (batch, device->GetBroadcast (), 0x800);
+}
+
+bool
+CsmaBatchTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &sender)
+{
+  if (device != m_receiver)
+    {
+      m_rxOthers++;
+      return true;
+    }
+  m_rxSizes.push_back (packet->GetSize ());
+  m_rxTimes.push_back (Simulator::Now ());
+  return true;
+}
+
+void
+CsmaBatchTest::DoRun (void)
+{
+  Ptr<CsmaChannel> channel = CreateObject<CsmaChannel> ();
+  channel->SetAttribute ("DataRate", DataRateValue (DataRate ("8Mbps")));
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (2)));
+
+  Ptr<CsmaNetDevice> devices[3];
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      devices[i] = CreateObject<CsmaNetDevice> ();
+      devices[i]->SetAddress (Mac48Address::Allocate ());
+      devices[i]->SetQueue (CreateObject<DropTailQueue> ());
+      devices[i]->Attach (channel);
+      node->AddDevice (devices[i]);
+      // Node::AddDevice installs its own receive callback
+      devices[i]->SetReceiveCallback (MakeCallback (&CsmaBatchTest::Receive, this));
+    }
+  m_receiver = devices[1];
+
+  Simulator::Schedule (Seconds (1.0), &CsmaBatchTest::SendBatch, this, devices[0]);
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxSizes.size (), 3, "Not all the packets of the batch were received");
+  NS_TEST_ASSERT_MSG_EQ (m_rxOthers, 3, "The batch was not received by the third device");
+  NS_TEST_ASSERT_MSG_EQ (m_rxSizes[0], 100, "Packets of the batch received out of order");
+  NS_TEST_ASSERT_MSG_EQ (m_rxSizes[1], 200, "Packets of the batch received out of order");
+  NS_TEST_ASSERT_MSG_EQ (m_rxSizes[2], 300, "Packets of the batch received out of order");
+
+  // three packets with a 14 bytes Ethernet header and a 4 bytes trailer
+  // each, separated by the 12 bytes interframe gap
+  DataRate rate ("8Mbps");
+  Time lastBit = Seconds (1.0) + MilliSeconds (2);
+  lastBit += rate.CalculateBytesTxTime (118);
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[0], lastBit, "First packet of the batch not received at its arrival time");
+  lastBit += rate.CalculateBytesTxTime (12) + rate.CalculateBytesTxTime (218);
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[1], lastBit, "Second packet of the batch not received at its arrival time");
+  lastBit += rate.CalculateBytesTxTime (12) + rate.CalculateBytesTxTime (318);
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[2], lastBit, "Third packet of the batch not received at its arrival time");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Test class for removing the background fluid traffic of a CsmaNetDevice
+ *
+ * A packet sent behind the backlog of a FluidBackground is delayed; once
+ * the background is removed, the next packet only takes its transmission
+ * and propagation times.
+ */
+class CsmaFluidRemovalTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  CsmaFluidRemovalTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send a packet to the device specified
+   *
+   * \param device NetDevice to send to
+   * \param size the size of the packet
+   */
+  void Send (Ptr<CsmaNetDevice> device, uint32_t size);
+
+  /**
+   * \brief Receive callback of the destination device
+   *
+   * \param device the receiving device
+   * \param packet the received packet
+   * \param protocol the protocol number
+   * \param sender the address of the sender
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &sender);
+
+  std::vector<Time> m_rxTimes; //!< times at which the packets were received
+};
+
+CsmaFluidRemovalTest::CsmaFluidRemovalTest ()
+  : TestCase ("Csma FluidBackground removal")
+{
+}
+
+void
+CsmaFluidRemovalTest::Send (Ptr<CsmaNetDevice> device, uint32_t size)
+{
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x800);
+}
+
+bool
+CsmaFluidRemovalTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &sender)
+{
+  m_rxTimes.push_back (Simulator::Now ());
+  return true;
+}
+
+void
+CsmaFluidRemovalTest::DoRun (void)
+{
+  Ptr<CsmaChannel> channel = CreateObject<CsmaChannel> ();
+  channel->SetAttribute ("DataRate", DataRateValue (DataRate ("8Mbps")));
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (2)));
+
+  Ptr<CsmaNetDevice> devices[2];
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      devices[i] = CreateObject<CsmaNetDevice> ();
+      devices[i]->SetAddress (Mac48Address::Allocate ());
+      devices[i]->SetQueue (CreateObject<DropTailQueue> ());
+      devices[i]->Attach (channel);
+      node->AddDevice (devices[i]);
+    }
+  devices[1]->SetReceiveCallback (MakeCallback (&CsmaFluidRemovalTest::Receive, this));
+
+  // 12 Mb/s of background on a 8 Mb/s medium builds a backlog
+  Ptr<FluidBackground> fluid = CreateObject<FluidBackground> ();
+  fluid->AssignStreams (1);
+  fluid->AddFlows (DataRate ("120bps"), Seconds (0.9), Seconds (10), 100000);
+  devices[0]->SetFluidBackground (fluid);
+
+  Simulator::Schedule (Seconds (1.0), &CsmaFluidRemovalTest::Send, this, devices[0], 100);
+  Simulator::Schedule (Seconds (1.5), &CsmaNetDevice::SetFluidBackground, devices[0], Ptr<FluidBackground> (0));
+  Simulator::Schedule (Seconds (2.0), &CsmaFluidRemovalTest::Send, this, devices[0], 100);
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes.size (), 2, "Not all the packets were received");
+  DataRate rate ("8Mbps");
+  Time alone = rate.CalculateBytesTxTime (118) + MilliSeconds (2);
+  NS_TEST_EXPECT_MSG_GT (m_rxTimes[0], Seconds (1.0) + alone, "The packet was not delayed by the fluid backlog");
+  NS_TEST_EXPECT_MSG_EQ (m_rxTimes[1], Seconds (2.0) + alone, "The packet was delayed by the removed fluid");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief TestSuite for Csma module
+ */
+class CsmaTestSuite : public TestSuite
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  CsmaTestSuite ();
+};
+
+CsmaTestSuite::CsmaTestSuite ()
+  : TestSuite ("devices-csma", UNIT)
+{
+  AddTestCase (new CsmaBatchTest, TestCase::QUICK);
+  AddTestCase (new CsmaFluidRemovalTest, TestCase::QUICK);
+}
+
+static CsmaTestSuite g_csmaTestSuite; //!< The testsuite
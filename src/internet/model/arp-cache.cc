@@ -102,10 +102,6 @@ ArpCache::DoDispose (void)
   Flush ();
   m_device = 0;
   m_interface = 0;
-  if (!m_waitReplyTimer.IsRunning ())
-    {
-      Simulator::Remove (m_waitReplyTimer);
-    }
   Object::DoDispose ();
 }
 
@@ -177,63 +173,34 @@ ArpCache::SetArpRequestCallback (Callback<void, Ptr<const ArpCache>,
   m_arpRequestCallback = arpRequestCallback;
 }
 
-void 
-ArpCache::StartWaitReplyTimer (void)
+void
+ArpCache::HandleWaitReplyTimeout (ArpCache::Entry *entry)
 {
-  NS_LOG_FUNCTION (this);
-  if (!m_waitReplyTimer.IsRunning ())
+  NS_LOG_FUNCTION (this << entry);
+  NS_ASSERT (entry->IsWaitReply ());
+  if (entry->GetRetries () < m_maxRetries)
     {
-      NS_LOG_LOGIC ("Starting WaitReplyTimer at " << Simulator::Now () << " for " <<
-                    m_waitReplyTimeout);
-      m_waitReplyTimer = Simulator::Schedule (m_waitReplyTimeout, 
-                                              &ArpCache::HandleWaitReplyTimeout, this);
+      NS_LOG_LOGIC ("node="<< m_device->GetNode ()->GetId () <<
+                    ", ArpWaitTimeout for " << entry->GetIpv4Address () <<
+                    " expired -- retransmitting arp request since retries = " <<
+                    entry->GetRetries ());
+      m_arpRequestCallback (this, entry->GetIpv4Address ());
+      entry->IncrementRetries ();
     }
-}
-
-void
-ArpCache::HandleWaitReplyTimeout (void)
-{
-  NS_LOG_FUNCTION (this);
-  ArpCache::Entry* entry;
-  bool restartWaitReplyTimer = false;
-  for (CacheI i = m_arpCache.begin (); i != m_arpCache.end (); i++) 
+  else
     {
-      entry = (*i).second;
-      if (entry != 0 && entry->IsWaitReply ())
+      NS_LOG_LOGIC ("node="<<m_device->GetNode ()->GetId () <<
+                    ", wait reply for " << entry->GetIpv4Address () <<
+                    " expired -- drop since max retries exceeded: " <<
+                    entry->GetRetries ());
+      entry->MarkDead ();
+      entry->ClearRetries ();
+      Ptr<Packet> pending = entry->DequeuePending ();
+      while (pending != 0)
         {
-          if (entry->GetRetries () < m_maxRetries)
-            {
-              NS_LOG_LOGIC ("node="<< m_device->GetNode ()->GetId () <<
-                            ", ArpWaitTimeout for " << entry->GetIpv4Address () <<
-                            " expired -- retransmitting arp request since retries = " <<
-                            entry->GetRetries ());
-              m_arpRequestCallback (this, entry->GetIpv4Address ());
-              restartWaitReplyTimer = true;
-              entry->IncrementRetries ();
-            }
-          else
-            {
-              NS_LOG_LOGIC ("node="<<m_device->GetNode ()->GetId () <<
-                            ", wait reply for " << entry->GetIpv4Address () <<
-                            " expired -- drop since max retries exceeded: " <<
-                            entry->GetRetries ());
-              entry->MarkDead ();
-              entry->ClearRetries ();
-              Ptr<Packet> pending = entry->DequeuePending ();
-              while (pending != 0)
-                {
-                  m_dropTrace (pending);
-                  pending = entry->DequeuePending ();
-                }
-            }
+          m_dropTrace (pending);
+          pending = entry->DequeuePending ();
         }
-
-    }
-  if (restartWaitReplyTimer)
-    {
-      NS_LOG_LOGIC ("Restarting WaitReplyTimer at " << Simulator::Now ().GetSeconds ());
-      m_waitReplyTimer = Simulator::Schedule (m_waitReplyTimeout, 
-                                              &ArpCache::HandleWaitReplyTimeout, this);
     }
 }
 
@@ -246,11 +213,7 @@ ArpCache::Flush (void)
       delete (*i).second;
     }
   m_arpCache.erase (m_arpCache.begin (), m_arpCache.end ());
-  if (m_waitReplyTimer.IsRunning ())
-    {
-      NS_LOG_LOGIC ("Stopping WaitReplyTimer at " << Simulator::Now ().GetSeconds () << " due to ArpCache flush");
-      m_waitReplyTimer.Cancel ();
-    }
+  m_timerWheel.Clear ();
 }
 
 void
@@ -319,6 +282,7 @@ ArpCache::Entry::Entry (ArpCache *arp)
     m_retries (0)
 {
   NS_LOG_FUNCTION (this << arp);
+  m_waitReplyTimer.SetFunction (MakeCallback (&ArpCache::Entry::WaitReplyTimeout, this));
 }
 
 
@@ -349,6 +313,7 @@ ArpCache::Entry::MarkDead (void)
   m_state = DEAD;
   ClearRetries ();
   UpdateSeen ();
+  m_arp->m_timerWheel.Cancel (&m_waitReplyTimer);
 }
 void
 ArpCache::Entry::MarkAlive (Address macAddress) 
@@ -359,6 +324,7 @@ ArpCache::Entry::MarkAlive (Address macAddress)
   m_state = ALIVE;
   ClearRetries ();
   UpdateSeen ();
+  m_arp->m_timerWheel.Cancel (&m_waitReplyTimer);
 }
 
 bool
@@ -386,7 +352,7 @@ ArpCache::Entry::MarkWaitReply (Ptr<Packet> waiting)
   m_state = WAIT_REPLY;
   m_pending.push_back (waiting);
   UpdateSeen ();
-  m_arp->StartWaitReplyTimer ();
+  m_arp->m_timerWheel.Schedule (&m_waitReplyTimer, m_arp->m_waitReplyTimeout);
 }
 
 Address
@@ -452,6 +418,16 @@ ArpCache::Entry::DequeuePending (void)
       return p;
     }
 }
+void
+ArpCache::Entry::WaitReplyTimeout (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_arp->HandleWaitReplyTimeout (this);
+  if (m_state == WAIT_REPLY)
+    {
+      m_arp->m_timerWheel.Schedule (&m_waitReplyTimer, m_arp->m_waitReplyTimeout);
+    }
+}
 void 
 ArpCache::Entry::UpdateSeen (void)
 {
@@ -33,6 +33,7 @@
 #include "ns3/object.h"
 #include "ns3/traced-callback.h"
 #include "ns3/sgi-hashmap.h"
+#include "ns3/timer-wheel.h"
 #include "ns3/output-stream-wrapper.h"
 
 namespace ns3 {
@@ -46,6 +47,10 @@ class Ipv4Interface;
  *
  * A cached lookup table for translating layer 3 addresses to layer 2.
  * This implementation does lookups from IPv4 to a MAC address
+ *
+ * Each entry waiting for a reply has its own retransmission timer, on a
+ * TimerWheel of the cache, so that a cache of thousands of neighbors
+ * keeps a single event in the scheduler and never scans its entries.
  */
 class ArpCache : public Object
 {
@@ -133,12 +138,6 @@ public:
    */
   void SetArpRequestCallback (Callback<void, Ptr<const ArpCache>, 
                                        Ipv4Address> arpRequestCallback);
-  /**
-   * This method will schedule a timeout at WaitReplyTimeout interval
-   * in the future, unless a timer is already running for the cache,
-   * in which case this method does nothing.
-   */
-  void StartWaitReplyTimer (void);
   /**
    * \brief Do lookup in the ARP cache against an IP address
    * \param destination The destination IPv4 address to lookup the MAC address
@@ -256,6 +255,11 @@ private:
      */
     void UpdateSeen (void);
 
+    /**
+     * \brief Function called when the WaitReply timer expires
+     */
+    void WaitReplyTimeout (void);
+
     /**
      * \brief Returns the entry timeout
      * \returns the entry timeout
@@ -269,6 +273,7 @@ private:
     Ipv4Address m_ipv4Address; //!< entry's IP address
     std::list<Ptr<Packet> > m_pending; //!< list of pending packets for the entry's IP
     uint32_t m_retries; //!< rerty counter
+    TimerWheel::Timer m_waitReplyTimer; //!< WaitReply retransmission timer
   };
 
 private:
@@ -288,16 +293,17 @@ private:
   Time m_aliveTimeout; //!< cache alive state timeout
   Time m_deadTimeout; //!< cache dead state timeout
   Time m_waitReplyTimeout; //!< cache reply state timeout
-  EventId m_waitReplyTimer;  //!< cache alive state timer
+  TimerWheel m_timerWheel;  //!< wheel of the WaitReply timers of the entries
   Callback<void, Ptr<const ArpCache>, Ipv4Address> m_arpRequestCallback;  //!< reply timeout callback
   uint32_t m_maxRetries; //!< max retries for a resolution
 
   /**
-   * This function is an event handler for the event that the
-   * ArpCache wants to check whether it must retry any Arp requests.
-   * If there are no Arp requests pending, this event is not scheduled.
+   * This function is called when the WaitReply timer of an entry
+   * expires, to retransmit its Arp request or to mark it dead.
+   *
+   * \param entry the entry
    */
-  void HandleWaitReplyTimeout (void);
+  void HandleWaitReplyTimeout (ArpCache::Entry *entry);
   uint32_t m_pendingQueueSize; //!< number of packets waiting for a resolution
   Cache m_arpCache; //!< the ARP cache
   TracedCallback<Ptr<const Packet> > m_dropTrace; //!< trace for packets dropped by the ARP cache queue
@@ -241,24 +241,36 @@ CoDelQueue::~CoDelQueue ()
   NS_LOG_FUNCTION (this);
 }
 
-void
-CoDelQueue::NewtonStep (void)
+uint16_t
+CoDelQueue::NewtonStep (uint16_t recInvSqrt, uint32_t count)
 {
-  NS_LOG_FUNCTION (this);
-  uint32_t invsqrt = ((uint32_t) m_recInvSqrt) << REC_INV_SQRT_SHIFT;
+  uint32_t invsqrt = ((uint32_t) recInvSqrt) << REC_INV_SQRT_SHIFT;
   uint32_t invsqrt2 = ((uint64_t) invsqrt * invsqrt) >> 32;
-  uint64_t val = (3ll << 32) - ((uint64_t) m_count * invsqrt2);
+  uint64_t val = (3ll << 32) - ((uint64_t) count * invsqrt2);
 
   val >>= 2; /* avoid overflow */
   val = (val * invsqrt) >> (32 - 2 + 1);
-  m_recInvSqrt = val >> REC_INV_SQRT_SHIFT;
+  return val >> REC_INV_SQRT_SHIFT;
+}
+
+uint32_t
+CoDelQueue::ControlLaw (uint32_t t, Time interval, uint16_t recInvSqrt)
+{
+  return t + ReciprocalDivide (Time2CoDel (interval), recInvSqrt << REC_INV_SQRT_SHIFT);
+}
+
+void
+CoDelQueue::NewtonStep (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_recInvSqrt = NewtonStep (m_recInvSqrt, m_count);
 }
 
 uint32_t
 CoDelQueue::ControlLaw (uint32_t t)
 {
   NS_LOG_FUNCTION (this);
-  return t + ReciprocalDivide (Time2CoDel (m_interval), m_recInvSqrt << REC_INV_SQRT_SHIFT);
+  return ControlLaw (t, m_interval, m_recInvSqrt);
 }
 
 void
@@ -280,7 +292,12 @@ CoDelQueue::DoEnqueue (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this << p);
 
-  if (m_mode == QUEUE_MODE_PACKETS && (m_packets.size () + 1 > m_maxPackets))
+  if (m_mode == QUEUE_MODE_PACKETS && m_packets.GetCapacity () == 0)
+    {
+      m_packets.Reserve (m_maxPackets);
+    }
+
+  if (m_mode == QUEUE_MODE_PACKETS && (m_packets.GetNPackets () + 1 > m_maxPackets))
     {
       NS_LOG_LOGIC ("Queue full (at max packets) -- droppping pkt");
       Drop (p);
@@ -288,7 +305,7 @@ CoDelQueue::DoEnqueue (Ptr<Packet> p)
       return false;
     }
 
-  if (m_mode == QUEUE_MODE_BYTES && (m_bytesInQueue + p->GetSize () > m_maxBytes))
+  if (m_mode == QUEUE_MODE_BYTES && (m_packets.GetNBytes () + p->GetSize () > m_maxBytes))
     {
       NS_LOG_LOGIC ("Queue full (packet would exceed max bytes) -- droppping pkt");
       Drop (p);
@@ -300,11 +317,11 @@ CoDelQueue::DoEnqueue (Ptr<Packet> p)
   CoDelTimestampTag tag;
   p->AddPacketTag (tag);
 
-  m_bytesInQueue += p->GetSize ();
-  m_packets.push (p);
+  m_packets.Push (p);
+  m_bytesInQueue = m_packets.GetNBytes ();
 
-  NS_LOG_LOGIC ("Number packets " << m_packets.size ());
-  NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
+  NS_LOG_LOGIC ("Number packets " << m_packets.GetNPackets ());
+  NS_LOG_LOGIC ("Number bytes " << m_packets.GetNBytes ());
 
   return true;
 }
@@ -325,7 +342,7 @@ CoDelQueue::OkToDrop (Ptr<Packet> p, uint32_t now)
   uint32_t sojournTime = Time2CoDel (delta);
 
   if (CoDelTimeBefore (sojournTime, Time2CoDel (m_target))
-      || m_bytesInQueue < m_minBytes)
+      || m_packets.GetNBytes () < m_minBytes)
     {
       // went below so we'll stay below for at least q->interval
       NS_LOG_LOGIC ("Sojourn time is below target or number of bytes in queue is less than minBytes; packet should not be dropped");
@@ -356,7 +373,7 @@ CoDelQueue::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_packets.empty ())
+  if (m_packets.IsEmpty ())
     {
       // Leave dropping state when queue is empty
       m_dropping = false;
@@ -365,13 +382,11 @@ CoDelQueue::DoDequeue (void)
       return 0;
     }
   uint32_t now = CoDelGetTime ();
-  Ptr<Packet> p = m_packets.front ();
-  m_packets.pop ();
-  m_bytesInQueue -= p->GetSize ();
+  Ptr<Packet> p = m_packets.Pop ();
 
   NS_LOG_LOGIC ("Popped " << p);
-  NS_LOG_LOGIC ("Number packets remaining " << m_packets.size ());
-  NS_LOG_LOGIC ("Number bytes remaining " << m_bytesInQueue);
+  NS_LOG_LOGIC ("Number packets remaining " << m_packets.GetNPackets ());
+  NS_LOG_LOGIC ("Number bytes remaining " << m_packets.GetNBytes ());
 
   // Determine if p should be dropped
   bool okToDrop = OkToDrop (p, now);
@@ -409,20 +424,19 @@ CoDelQueue::DoDequeue (void)
               ++m_dropCount;
               ++m_count;
               NewtonStep ();
-              if (m_packets.empty ())
+              if (m_packets.IsEmpty ())
                 {
                   m_dropping = false;
                   NS_LOG_LOGIC ("Queue empty");
                   ++m_states;
+                  m_bytesInQueue = 0;
                   return 0;
                 }
-              p = m_packets.front ();
-              m_packets.pop ();
-              m_bytesInQueue -= p->GetSize ();
+              p = m_packets.Pop ();
 
               NS_LOG_LOGIC ("Popped " << p);
-              NS_LOG_LOGIC ("Number packets remaining " << m_packets.size ());
-              NS_LOG_LOGIC ("Number bytes remaining " << m_bytesInQueue);
+              NS_LOG_LOGIC ("Number packets remaining " << m_packets.GetNPackets ());
+              NS_LOG_LOGIC ("Number bytes remaining " << m_packets.GetNBytes ());
 
               if (!OkToDrop (p, now))
                 {
@@ -457,7 +471,7 @@ CoDelQueue::DoDequeue (void)
           m_nBytes -= p->GetSize ();
           m_nPackets--;
 
-          if (m_packets.empty ())
+          if (m_packets.IsEmpty ())
             {
               m_dropping = false;
               okToDrop = false;
@@ -466,13 +480,11 @@ CoDelQueue::DoDequeue (void)
             }
           else
             {
-              p = m_packets.front ();
-              m_packets.pop ();
-              m_bytesInQueue -= p->GetSize ();
+              p = m_packets.Pop ();
 
               NS_LOG_LOGIC ("Popped " << p);
-              NS_LOG_LOGIC ("Number packets remaining " << m_packets.size ());
-              NS_LOG_LOGIC ("Number bytes remaining " << m_bytesInQueue);
+              NS_LOG_LOGIC ("Number packets remaining " << m_packets.GetNPackets ());
+              NS_LOG_LOGIC ("Number bytes remaining " << m_packets.GetNBytes ());
 
               okToDrop = OkToDrop (p, now);
               m_dropping = true;
@@ -501,6 +513,7 @@ CoDelQueue::DoDequeue (void)
         }
     }
   ++m_states;
+  m_bytesInQueue = m_packets.GetNBytes ();
   return p;
 }
 
@@ -510,11 +523,11 @@ CoDelQueue::GetQueueSize (void)
   NS_LOG_FUNCTION (this);
   if (GetMode () == QUEUE_MODE_BYTES)
     {
-      return m_bytesInQueue;
+      return m_packets.GetNBytes ();
     }
   else if (GetMode () == QUEUE_MODE_PACKETS)
     {
-      return m_packets.size ();
+      return m_packets.GetNPackets ();
     }
   else
     {
@@ -557,16 +570,16 @@ CoDelQueue::DoPeek (void) const
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_packets.empty ())
+  if (m_packets.IsEmpty ())
     {
       NS_LOG_LOGIC ("Queue empty");
       return 0;
     }
 
-  Ptr<Packet> p = m_packets.front ();
+  Ptr<Packet> p = m_packets.Front ();
 
-  NS_LOG_LOGIC ("Number packets " << m_packets.size ());
-  NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
+  NS_LOG_LOGIC ("Number packets " << m_packets.GetNPackets ());
+  NS_LOG_LOGIC ("Number bytes " << m_packets.GetNBytes ());
 
   return p;
 }
@@ -28,8 +28,8 @@
 #ifndef CODEL_H
 #define CODEL_H
 
-#include <queue>
 #include "ns3/packet.h"
+#include "ns3/packet-ring.h"
 #include "ns3/queue.h"
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
@@ -136,6 +136,62 @@ public:
    */
   uint32_t GetDropNext (void);
 
+  /**
+   * \brief Apply one step of Newton's method to a reciprocal square root
+   *
+   * Shared with the queues that keep CoDel state for several sub-queues.
+   *
+   * \param recInvSqrt The current approximation of 1/sqrt(count)
+   * \param count The number of drops since entering the dropping state
+   * \returns The new approximation of 1/sqrt(count)
+   */
+  static uint16_t NewtonStep (uint16_t recInvSqrt, uint32_t count);
+
+  /**
+   * \brief Compute the CoDel control law t + interval/sqrt(count)
+   *
+   * \param t Current next drop time
+   * \param interval The CoDel interval
+   * \param recInvSqrt The approximation of 1/sqrt(count)
+   * \returns The new next drop time
+   */
+  static uint32_t ControlLaw (uint32_t t, Time interval, uint16_t recInvSqrt);
+
+  /**
+   * Check if CoDel time a is successive to b
+   * @param a left operand
+   * @param b right operand
+   * @return true if a is greater than b
+   */
+  static bool CoDelTimeAfter (uint32_t a, uint32_t b);
+  /**
+   * Check if CoDel time a is successive or equal to b
+   * @param a left operand
+   * @param b right operand
+   * @return true if a is greater than or equal to b
+   */
+  static bool CoDelTimeAfterEq (uint32_t a, uint32_t b);
+  /**
+   * Check if CoDel time a is preceding b
+   * @param a left operand
+   * @param b right operand
+   * @return true if a is less than to b
+   */
+  static bool CoDelTimeBefore (uint32_t a, uint32_t b);
+  /**
+   * Check if CoDel time a is preceding or equal to b
+   * @param a left operand
+   * @param b right operand
+   * @return true if a is less than or equal to b
+   */
+  static bool CoDelTimeBeforeEq (uint32_t a, uint32_t b);
+
+  /**
+   * returned unsigned 32-bit integer representation of the input Time object
+   * units are microseconds
+   */
+  static uint32_t Time2CoDel (Time t);
+
 private:
   friend class::CoDelQueueNewtonStepTest;  // Test code
   friend class::CoDelQueueControlLawTest;  // Test code
@@ -188,45 +244,10 @@ private:
    */
   bool OkToDrop (Ptr<Packet> p, uint32_t now);
 
-  /**
-   * Check if CoDel time a is successive to b
-   * @param a left operand
-   * @param b right operand
-   * @return true if a is greater than b
-   */
-  bool CoDelTimeAfter (uint32_t a, uint32_t b);
-  /**
-   * Check if CoDel time a is successive or equal to b
-   * @param a left operand
-   * @param b right operand
-   * @return true if a is greater than or equal to b
-   */
-  bool CoDelTimeAfterEq (uint32_t a, uint32_t b);
-  /**
-   * Check if CoDel time a is preceding b
-   * @param a left operand
-   * @param b right operand
-   * @return true if a is less than to b
-   */
-  bool CoDelTimeBefore (uint32_t a, uint32_t b);
-  /**
-   * Check if CoDel time a is preceding or equal to b
-   * @param a left operand
-   * @param b right operand
-   * @return true if a is less than or equal to b
-   */
-  bool CoDelTimeBeforeEq (uint32_t a, uint32_t b);
-
-  /**
-   * returned unsigned 32-bit integer representation of the input Time object
-   * units are microseconds
-   */
-  uint32_t Time2CoDel (Time t);
-
-  std::queue<Ptr<Packet> > m_packets;     //!< The packet queue
+  PacketRing m_packets;                   //!< The packet queue
   uint32_t m_maxPackets;                  //!< Max # of packets accepted by the queue
   uint32_t m_maxBytes;                    //!< Max # of bytes accepted by the queue
-  TracedValue<uint32_t> m_bytesInQueue;   //!< The total number of bytes in queue
+  TracedValue<uint32_t> m_bytesInQueue;   //!< The bytes in queue, traced once per enqueue or dequeue
   uint32_t m_minBytes;                    //!< Minimum bytes in queue to allow a packet drop
   Time m_interval;                        //!< 100 ms sliding minimum time window width
   Time m_target;                          //!< 5 ms target queue delay
@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ecn-marker.h"
+#include "ipv4-header.h"
+#include "ipv6-header.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EcnMarker");
+
+/**
+ * Number of leading bytes of a packet looked at to find its IP header:
+ * an Ethernet and LLC/SNAP header and an IPv6 header.
+ */
+static const uint32_t ECN_MARKER_LEADING_BYTES = 22 + 40;
+
+/**
+ * Mark a packet starting with its IP header
+ * \param p the packet
+ * \param version the IP version of the packet
+ * \return false if the packet is not ECN-capable
+ */
+static bool
+EcnMarkerMarkIp (Ptr<Packet> p, uint8_t version)
+{
+  if (version == 4)
+    {
+      Ipv4Header header;
+      if (Node::ChecksumEnabled ())
+        {
+          // keep the checksum read from the packet, so that SetEcn
+          // updates it as per RFC 1624 instead of it being summed again
+          header.EnableChecksum ();
+        }
+      p->RemoveHeader (header);
+      Ipv4Header::EcnType ecn = header.GetEcn ();
+      if (ecn == Ipv4Header::ECN_ECT0 || ecn == Ipv4Header::ECN_ECT1)
+        {
+          header.SetEcn (Ipv4Header::ECN_CE);
+        }
+      p->AddHeader (header);
+      return ecn != Ipv4Header::ECN_NotECT;
+    }
+  else
+    {
+      Ipv6Header header;
+      p->RemoveHeader (header);
+      uint8_t tclass = header.GetTrafficClass ();
+      if ((tclass & 0x03) != 0)
+        {
+          header.SetTrafficClass (tclass | 0x03);
+        }
+      p->AddHeader (header);
+      return (tclass & 0x03) != 0;
+    }
+}
+
+bool
+EcnMarker::Mark (Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (p);
+  uint8_t buf[ECN_MARKER_LEADING_BYTES];
+  uint32_t len = p->CopyData (buf, ECN_MARKER_LEADING_BYTES);
+  uint8_t version = 0;
+  int off = FindIp (buf, len, version);
+  if (off < 0)
+    {
+      return false;
+    }
+  if (off == 0)
+    {
+      return EcnMarkerMarkIp (p, version);
+    }
+
+  //
+  // The link header is split off as a fragment and put back in front of the
+  // marked packet, so that its bytes and metadata are kept whatever its type.
+  //
+  Ptr<Packet> packet = p->CreateFragment (0, off);
+  p->RemoveAtStart (off);
+  bool marked = EcnMarkerMarkIp (p, version);
+  packet->AddAtEnd (p);
+  *p = *packet;
+  return marked;
+}
+
+int
+EcnMarker::FindIp (const uint8_t *buf, uint32_t len, uint8_t &version)
+{
+  struct Encapsulation
+  {
+    uint32_t typeOffset;   // offset of the protocol or EtherType field
+    uint32_t ipOffset;     // offset of the IP header
+    uint16_t ipv4;         // value of the field for IPv4
+    uint16_t ipv6;         // value of the field for IPv6
+  };
+  static const Encapsulation encapsulations[] = {
+    { 0, 2, 0x0021, 0x0057 },    // PPP
+    { 12, 14, 0x0800, 0x86dd },  // Ethernet II
+    { 20, 22, 0x0800, 0x86dd },  // Ethernet with LLC/SNAP
+  };
+
+  for (uint32_t i = 0; i < sizeof (encapsulations) / sizeof (encapsulations[0]); i++)
+    {
+      const Encapsulation &e = encapsulations[i];
+      if (e.ipOffset + 20 > len)
+        {
+          continue;
+        }
+      if (e.typeOffset == 20 && (buf[14] != 0xaa || buf[15] != 0xaa || buf[16] != 0x03))
+        {
+          continue;
+        }
+      uint16_t type = (buf[e.typeOffset] << 8) | buf[e.typeOffset + 1];
+      uint8_t v = buf[e.ipOffset] >> 4;
+      if ((type == e.ipv4 && v == 4) || (type == e.ipv6 && v == 6 && e.ipOffset + 40 <= len))
+        {
+          version = v;
+          return e.ipOffset;
+        }
+    }
+  if (len >= 20 && (buf[0] >> 4) == 4 && (buf[0] & 0x0f) >= 5)
+    {
+      version = 4;
+      return 0;
+    }
+  if (len >= 40 && (buf[0] >> 4) == 6)
+    {
+      version = 6;
+      return 0;
+    }
+  return -1;
+}
+
+} // namespace ns3
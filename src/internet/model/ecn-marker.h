@@ -0,0 +1,67 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ECN_MARKER_H
+#define ECN_MARKER_H
+
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief Set the congestion experienced codepoint of IP packets (\RFC{3168}).
+ *
+ * The queues of the network module hold opaque packets.  Mark () is meant
+ * to be given to the queues marking packets instead of dropping them, e.g.:
+ * \code
+ *   red->SetAttribute ("UseEcn", BooleanValue (true));
+ *   red->SetMarkCallback (MakeCallback (&EcnMarker::Mark));
+ * \endcode
+ * The IP header may be preceded by the PPP header or by the Ethernet header,
+ * with or without LLC/SNAP encapsulation, that the point-to-point and CSMA
+ * devices add before queueing a packet.  The link header is left untouched.
+ */
+class EcnMarker
+{
+public:
+  /**
+   * \brief Mark a packet as having experienced congestion
+   * \param p the packet, starting with its IP header or a link header
+   * \return false if the packet is not an ECN-capable IP packet
+   */
+  static bool Mark (Ptr<Packet> p);
+
+  /**
+   * \brief Find the IP header in the leading bytes of a packet
+   *
+   * The IP header is looked for behind a PPP header, an Ethernet II header
+   * and an Ethernet header followed by LLC/SNAP, then at the start of the
+   * packet.
+   *
+   * \param buf the leading bytes
+   * \param len the number of leading bytes
+   * \param version the IP version found
+   * \return the offset of the IP header, or -1 if the packet is not IP
+   */
+  static int FindIp (const uint8_t *buf, uint32_t len, uint8_t &version);
+};
+
+} // namespace ns3
+
+#endif /* ECN_MARKER_H */
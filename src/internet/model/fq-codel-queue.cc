@@ -0,0 +1,544 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * FQ-CoDel, the Flow Queue CoDel queueing discipline (RFC 8290),
+ * following the Linux sch_fq_codel scheduler.
+ */
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
+#include "fq-codel-queue.h"
+#include "codel-queue.h"
+#include "ecn-marker.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FqCoDelQueue");
+
+/**
+ * Number of leading bytes of a packet looked at by the classifier:
+ * an Ethernet and LLC/SNAP header, an IPv6 header and the ports.
+ */
+static const uint32_t FQ_CODEL_CLASSIFY_BYTES = 22 + 40 + 4;
+
+/**
+ * Returns the current time translated in CoDel time representation
+ * \return the current time
+ */
+static uint32_t
+FqCoDelGetTime (void)
+{
+  return CoDelQueue::Time2CoDel (Simulator::Now ());
+}
+
+/**
+ * Mix a word into a flow hash
+ * \param h the hash so far
+ * \param w the word
+ * \return the new hash
+ */
+static inline uint64_t
+FqCoDelMix (uint64_t h, uint64_t w)
+{
+  h = (h ^ w) * 0x9e3779b97f4a7c15ULL;
+  return h ^ (h >> 29);
+}
+
+/**
+ * Read a 32-bit word in network order
+ * \param buf the bytes
+ * \return the word
+ */
+static inline uint32_t
+FqCoDelRead32 (const uint8_t *buf)
+{
+  return (static_cast<uint32_t> (buf[0]) << 24) | (buf[1] << 16) | (buf[2] << 8) | buf[3];
+}
+
+NS_OBJECT_ENSURE_REGISTERED (FqCoDelQueue);
+
+TypeId FqCoDelQueue::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FqCoDelQueue")
+    .SetParent<Queue> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<FqCoDelQueue> ()
+    .AddAttribute ("Flows",
+                   "The number of flow queues; fixed once a packet was enqueued.",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&FqCoDelQueue::m_flows),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxPackets",
+                   "The maximum number of packets accepted by this FqCoDelQueue; fixed once a packet was enqueued.",
+                   UintegerValue (10240),
+                   MakeUintegerAccessor (&FqCoDelQueue::m_maxPackets),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Quantum",
+                   "The number of bytes a flow may send in each deficit round robin round.",
+                   UintegerValue (1514),
+                   MakeUintegerAccessor (&FqCoDelQueue::m_quantum),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MinBytes",
+                   "The CoDel algorithm minbytes parameter, applied to each flow queue.",
+                   UintegerValue (1500),
+                   MakeUintegerAccessor (&FqCoDelQueue::m_minBytes),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Perturbation",
+                   "The seed of the hash mapping the flows to the flow queues.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&FqCoDelQueue::m_perturbation),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Interval",
+                   "The CoDel algorithm interval",
+                   StringValue ("100ms"),
+                   MakeTimeAccessor (&FqCoDelQueue::m_interval),
+                   MakeTimeChecker ())
+    .AddAttribute ("Target",
+                   "The CoDel algorithm target queue delay",
+                   StringValue ("5ms"),
+                   MakeTimeAccessor (&FqCoDelQueue::m_target),
+                   MakeTimeChecker ())
+    .AddTraceSource ("DropCount",
+                     "CoDel drop count",
+                     MakeTraceSourceAccessor (&FqCoDelQueue::m_dropCount),
+                     "ns3::TracedValue::Uint32Callback")
+  ;
+
+  return tid;
+}
+
+FqCoDelQueue::FqCoDelQueue ()
+  : Queue (),
+    m_freeSlot (NONE),
+    m_dropCount (0),
+    m_dropOverLimit (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_newFlows.head = m_newFlows.tail = NONE;
+  m_oldFlows.head = m_oldFlows.tail = NONE;
+}
+
+FqCoDelQueue::~FqCoDelQueue ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FqCoDelQueue::AllocateTables (void)
+{
+  NS_LOG_FUNCTION (this);
+  Flow flow;
+  flow.head = flow.tail = NONE;
+  flow.packets = 0;
+  flow.bytes = 0;
+  flow.deficit = 0;
+  flow.next = NONE;
+  flow.list = FLOW_INACTIVE;
+  flow.dropping = false;
+  flow.recInvSqrt = ~0U >> REC_INV_SQRT_SHIFT;
+  flow.count = 0;
+  flow.lastCount = 0;
+  flow.firstAboveTime = 0;
+  flow.dropNext = 0;
+  m_flowTable.assign (m_flows, flow);
+
+  m_slots.resize (m_maxPackets);
+  for (uint32_t i = 0; i < m_maxPackets; i++)
+    {
+      m_slots[i].next = i + 1 < m_maxPackets ? i + 1 : NONE;
+    }
+  m_freeSlot = 0;
+}
+
+uint32_t
+FqCoDelQueue::Classify (Ptr<const Packet> p) const
+{
+  NS_LOG_FUNCTION (this << p);
+  uint8_t buf[FQ_CODEL_CLASSIFY_BYTES];
+  uint32_t len = p->CopyData (buf, FQ_CODEL_CLASSIFY_BYTES);
+  uint8_t version = 0;
+  int off = EcnMarker::FindIp (buf, len, version);
+  if (off < 0)
+    {
+      NS_LOG_LOGIC ("Not an IP packet, using the first flow queue");
+      return 0;
+    }
+
+  const uint8_t *ip = buf + off;
+  uint64_t h = m_perturbation;
+  uint8_t protocol;
+  const uint8_t *ports = 0;
+  if (version == 4)
+    {
+      protocol = ip[9];
+      h = FqCoDelMix (h, FqCoDelRead32 (ip + 12));
+      h = FqCoDelMix (h, FqCoDelRead32 (ip + 16));
+      uint32_t headerLength = (ip[0] & 0x0f) * 4;
+      bool fragment = ((ip[6] & 0x3f) | ip[7]) != 0;
+      if (!fragment && static_cast<uint32_t> (off) + headerLength + 4 <= len)
+        {
+          ports = ip + headerLength;
+        }
+    }
+  else
+    {
+      protocol = ip[6];
+      for (uint32_t i = 8; i < 40; i += 4)
+        {
+          h = FqCoDelMix (h, FqCoDelRead32 (ip + i));
+        }
+      // the flow label
+      h = FqCoDelMix (h, FqCoDelRead32 (ip) & 0xfffff);
+      if (off + 44 <= static_cast<int> (len))
+        {
+          ports = ip + 40;
+        }
+    }
+  h = FqCoDelMix (h, protocol);
+  // TCP, UDP, DCCP and SCTP all start with the two ports
+  if (ports != 0 && (protocol == 6 || protocol == 17 || protocol == 33 || protocol == 132))
+    {
+      h = FqCoDelMix (h, FqCoDelRead32 (ports));
+    }
+  h ^= h >> 32;
+  return static_cast<uint32_t> (((h & 0xffffffff) * m_flows) >> 32);
+}
+
+void
+FqCoDelQueue::PushFlow (List &list, uint32_t flow)
+{
+  m_flowTable[flow].next = NONE;
+  if (list.tail == NONE)
+    {
+      list.head = flow;
+    }
+  else
+    {
+      m_flowTable[list.tail].next = flow;
+    }
+  list.tail = flow;
+}
+
+uint32_t
+FqCoDelQueue::PopFlow (List &list)
+{
+  uint32_t flow = list.head;
+  list.head = m_flowTable[flow].next;
+  if (list.head == NONE)
+    {
+      list.tail = NONE;
+    }
+  m_flowTable[flow].next = NONE;
+  return flow;
+}
+
+Ptr<Packet>
+FqCoDelQueue::PopPacket (uint32_t flow, uint32_t &enqueue)
+{
+  Flow &f = m_flowTable[flow];
+  if (f.head == NONE)
+    {
+      return 0;
+    }
+  uint32_t slot = f.head;
+  Ptr<Packet> p = m_slots[slot].packet;
+  enqueue = m_slots[slot].enqueue;
+  m_slots[slot].packet = 0;
+  f.head = m_slots[slot].next;
+  if (f.head == NONE)
+    {
+      f.tail = NONE;
+    }
+  m_slots[slot].next = m_freeSlot;
+  m_freeSlot = slot;
+  f.packets--;
+  f.bytes -= p->GetSize ();
+  return p;
+}
+
+void
+FqCoDelQueue::DropQueued (Ptr<Packet> p)
+{
+  Drop (p);
+
+  // p was in queue, trace the dequeue and update stats manually
+  m_traceDequeue (p);
+  m_nBytes -= p->GetSize ();
+  m_nPackets--;
+}
+
+void
+FqCoDelQueue::DropFromFattest (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t fattest = 0;
+  for (uint32_t i = 1; i < m_flows; i++)
+    {
+      if (m_flowTable[i].bytes > m_flowTable[fattest].bytes)
+        {
+          fattest = i;
+        }
+    }
+  uint32_t enqueue;
+  Ptr<Packet> p = PopPacket (fattest, enqueue);
+  NS_ASSERT (p != 0);
+  NS_LOG_LOGIC ("Queue full -- dropping " << p << " from flow " << fattest);
+  DropQueued (p);
+  ++m_dropOverLimit;
+}
+
+bool
+FqCoDelQueue::DoEnqueue (Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << p);
+
+  if (m_flowTable.empty ())
+    {
+      AllocateTables ();
+    }
+  if (m_freeSlot == NONE)
+    {
+      DropFromFattest ();
+    }
+
+  uint32_t flow = Classify (p);
+  Flow &f = m_flowTable[flow];
+  uint32_t slot = m_freeSlot;
+  m_freeSlot = m_slots[slot].next;
+  m_slots[slot].packet = p;
+  m_slots[slot].enqueue = FqCoDelGetTime ();
+  m_slots[slot].next = NONE;
+  if (f.tail == NONE)
+    {
+      f.head = slot;
+    }
+  else
+    {
+      m_slots[f.tail].next = slot;
+    }
+  f.tail = slot;
+  f.packets++;
+  f.bytes += p->GetSize ();
+
+  if (f.list == FLOW_INACTIVE)
+    {
+      f.list = FLOW_NEW;
+      f.deficit = m_quantum;
+      PushFlow (m_newFlows, flow);
+    }
+
+  NS_LOG_LOGIC ("Flow " << flow << " packets " << f.packets << " bytes " << f.bytes);
+  return true;
+}
+
+bool
+FqCoDelQueue::OkToDrop (Flow &flow, uint32_t enqueue, uint32_t now)
+{
+  uint32_t sojournTime = now - enqueue;
+
+  if (CoDelQueue::CoDelTimeBefore (sojournTime, CoDelQueue::Time2CoDel (m_target))
+      || flow.bytes < m_minBytes)
+    {
+      flow.firstAboveTime = 0;
+      return false;
+    }
+  bool okToDrop = false;
+  if (flow.firstAboveTime == 0)
+    {
+      flow.firstAboveTime = now + CoDelQueue::Time2CoDel (m_interval);
+    }
+  else if (CoDelQueue::CoDelTimeAfter (now, flow.firstAboveTime))
+    {
+      okToDrop = true;
+    }
+  return okToDrop;
+}
+
+Ptr<Packet>
+FqCoDelQueue::CoDelDequeue (uint32_t flow)
+{
+  NS_LOG_FUNCTION (this << flow);
+  Flow &f = m_flowTable[flow];
+  uint32_t now = FqCoDelGetTime ();
+  uint32_t enqueue;
+  Ptr<Packet> p = PopPacket (flow, enqueue);
+  if (p == 0)
+    {
+      f.dropping = false;
+      f.firstAboveTime = 0;
+      return 0;
+    }
+
+  bool okToDrop = OkToDrop (f, enqueue, now);
+  if (f.dropping)
+    {
+      if (!okToDrop)
+        {
+          f.dropping = false;
+        }
+      else
+        {
+          while (f.dropping && CoDelQueue::CoDelTimeAfterEq (now, f.dropNext))
+            {
+              NS_LOG_LOGIC ("Flow " << flow << " still above target, dropping " << p);
+              DropQueued (p);
+              ++m_dropCount;
+              ++f.count;
+              f.recInvSqrt = CoDelQueue::NewtonStep (f.recInvSqrt, f.count);
+              p = PopPacket (flow, enqueue);
+              if (p == 0)
+                {
+                  f.dropping = false;
+                  return 0;
+                }
+              if (!OkToDrop (f, enqueue, now))
+                {
+                  f.dropping = false;
+                }
+              else
+                {
+                  f.dropNext = CoDelQueue::ControlLaw (f.dropNext, m_interval, f.recInvSqrt);
+                }
+            }
+        }
+    }
+  else if (okToDrop)
+    {
+      NS_LOG_LOGIC ("Flow " << flow << " went above target, dropping " << p << " and entering the dropping state");
+      DropQueued (p);
+      ++m_dropCount;
+      p = PopPacket (flow, enqueue);
+      if (p != 0)
+        {
+          OkToDrop (f, enqueue, now);
+          f.dropping = true;
+        }
+      // as in CoDelQueue, restart from the last drop rate if it was recent
+      uint32_t delta = f.count - f.lastCount;
+      if (f.count > f.lastCount && delta > 1
+          && CoDelQueue::CoDelTimeBefore (now - f.dropNext, 16 * CoDelQueue::Time2CoDel (m_interval)))
+        {
+          f.count = delta;
+          f.recInvSqrt = CoDelQueue::NewtonStep (f.recInvSqrt, f.count);
+        }
+      else
+        {
+          f.count = 1;
+          f.recInvSqrt = ~0U >> REC_INV_SQRT_SHIFT;
+        }
+      f.lastCount = f.count;
+      f.dropNext = CoDelQueue::ControlLaw (now, m_interval, f.recInvSqrt);
+    }
+  return p;
+}
+
+Ptr<Packet>
+FqCoDelQueue::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  while (true)
+    {
+      List *list = &m_newFlows;
+      if (list->head == NONE)
+        {
+          list = &m_oldFlows;
+          if (list->head == NONE)
+            {
+              NS_LOG_LOGIC ("Queue empty");
+              return 0;
+            }
+        }
+      uint32_t flow = list->head;
+      Flow &f = m_flowTable[flow];
+
+      if (f.deficit <= 0)
+        {
+          // the flow used up its quantum: give it another and move it to the old flows
+          f.deficit += m_quantum;
+          PopFlow (*list);
+          f.list = FLOW_OLD;
+          PushFlow (m_oldFlows, flow);
+          continue;
+        }
+
+      Ptr<Packet> p = CoDelDequeue (flow);
+      if (p == 0)
+        {
+          PopFlow (*list);
+          // a new flow which emptied goes through the old flows once, so
+          // that a flow sending a packet now and then cannot stay new
+          if (list == &m_newFlows && m_oldFlows.head != NONE)
+            {
+              f.list = FLOW_OLD;
+              PushFlow (m_oldFlows, flow);
+            }
+          else
+            {
+              f.list = FLOW_INACTIVE;
+            }
+          continue;
+        }
+
+      f.deficit -= p->GetSize ();
+      NS_LOG_LOGIC ("Popped " << p << " from flow " << flow);
+      return p;
+    }
+}
+
+Ptr<const Packet>
+FqCoDelQueue::DoPeek (void) const
+{
+  NS_LOG_FUNCTION (this);
+  const List *lists[] = { &m_newFlows, &m_oldFlows };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      for (uint32_t flow = lists[i]->head; flow != NONE; flow = m_flowTable[flow].next)
+        {
+          if (m_flowTable[flow].head != NONE)
+            {
+              return m_slots[m_flowTable[flow].head].packet;
+            }
+        }
+    }
+  NS_LOG_LOGIC ("Queue empty");
+  return 0;
+}
+
+uint32_t
+FqCoDelQueue::GetDropOverLimit (void) const
+{
+  return m_dropOverLimit;
+}
+
+uint32_t
+FqCoDelQueue::GetDropCount (void) const
+{
+  return m_dropCount;
+}
+
+uint32_t
+FqCoDelQueue::GetFlowPackets (uint32_t flow) const
+{
+  if (flow >= m_flowTable.size ())
+    {
+      return 0;
+    }
+  return m_flowTable[flow].packets;
+}
+
+} // namespace ns3
@@ -0,0 +1,220 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * FQ-CoDel, the Flow Queue CoDel queueing discipline (RFC 8290),
+ * following the Linux sch_fq_codel scheduler.
+ */
+
+#ifndef FQ_CODEL_QUEUE_H
+#define FQ_CODEL_QUEUE_H
+
+#include <vector>
+#include "ns3/packet.h"
+#include "ns3/queue.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-value.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup queue
+ *
+ * \brief A Flow Queue CoDel packet queue
+ *
+ * Packets are classified by a hash of their IPv4 or IPv6 5-tuple into
+ * one of a fixed number of flow queues, each running its own CoDel
+ * instance (sharing the control law of CoDelQueue), and the flow queues
+ * are served by deficit round robin, new flows first.
+ *
+ * The queue sits below the link layer of the NetDevice, so the IP header
+ * is looked for after a PPP header (PointToPointNetDevice), after an
+ * Ethernet header with or without LLC/SNAP (CsmaNetDevice), or at the
+ * start of the packet.  Packets which are not IP all go to the first
+ * flow queue.
+ *
+ * The flows and the packet slots are two flat tables allocated once, of
+ * Flows and MaxPackets entries: the flow queues and the scheduling lists
+ * are linked by indices into them, so that thousands of flows cost no
+ * object or allocation per flow or per packet.  When the queue is full,
+ * the packet at the head of the longest flow queue is dropped.
+ */
+class FqCoDelQueue : public Queue
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief FqCoDelQueue Constructor
+   */
+  FqCoDelQueue ();
+
+  virtual ~FqCoDelQueue ();
+
+  /**
+   * \brief Get the number of packets dropped when the queue was full
+   *
+   * \returns The number of dropped packets
+   */
+  uint32_t GetDropOverLimit (void) const;
+
+  /**
+   * \brief Get the number of packets dropped by the CoDel instances
+   *
+   * \returns The number of dropped packets
+   */
+  uint32_t GetDropCount (void) const;
+
+  /**
+   * \brief Get the flow queue a packet is classified into
+   *
+   * \param p The packet, with the link header the NetDevice put on it
+   * \returns The index of the flow queue
+   */
+  uint32_t Classify (Ptr<const Packet> p) const;
+
+  /**
+   * \brief Get the number of packets in a flow queue
+   *
+   * \param flow The index of the flow queue
+   * \returns The number of packets in the flow queue
+   */
+  uint32_t GetFlowPackets (uint32_t flow) const;
+
+private:
+  virtual bool DoEnqueue (Ptr<Packet> p);
+  virtual Ptr<Packet> DoDequeue (void);
+  virtual Ptr<const Packet> DoPeek (void) const;
+
+  /// Index standing for no slot, no flow or an empty list
+  static const uint32_t NONE = 0xffffffff;
+
+  /// The scheduling list a flow is in
+  enum FlowList
+  {
+    FLOW_INACTIVE = 0,   //!< not scheduled, the flow queue is empty
+    FLOW_NEW,            //!< in the list of new flows
+    FLOW_OLD             //!< in the list of old flows
+  };
+
+  /// A packet slot, linked into the flow queue holding the packet
+  struct Slot
+  {
+    Ptr<Packet> packet;  //!< the packet
+    uint32_t enqueue;    //!< enqueue time, in CoDel time
+    uint32_t next;       //!< next slot of the flow queue, or of the free list
+  };
+
+  /// A flow queue and the state of its CoDel instance
+  struct Flow
+  {
+    uint32_t head;           //!< first slot of the flow queue
+    uint32_t tail;           //!< last slot of the flow queue
+    uint32_t packets;        //!< packets in the flow queue
+    uint32_t bytes;          //!< bytes in the flow queue
+    int32_t deficit;         //!< DRR deficit, in bytes
+    uint32_t next;           //!< next flow in the scheduling list
+    uint8_t list;            //!< the scheduling list the flow is in
+    bool dropping;           //!< CoDel dropping state
+    uint16_t recInvSqrt;     //!< CoDel reciprocal inverse square root of count
+    uint32_t count;          //!< CoDel drops since entering the dropping state
+    uint32_t lastCount;      //!< count when the dropping state was last left
+    uint32_t firstAboveTime; //!< CoDel time to declare the sojourn time above target
+    uint32_t dropNext;       //!< CoDel time of the next drop
+  };
+
+  /// A list of flows, linked through Flow::next
+  struct List
+  {
+    uint32_t head;  //!< first flow
+    uint32_t tail;  //!< last flow
+  };
+
+  /**
+   * \brief Allocate the flow and slot tables, on first use
+   */
+  void AllocateTables (void);
+
+  /**
+   * \brief Append a flow to a scheduling list
+   * \param list the list
+   * \param flow the flow
+   */
+  void PushFlow (List &list, uint32_t flow);
+
+  /**
+   * \brief Remove the first flow of a scheduling list
+   * \param list the list
+   * \returns the flow removed
+   */
+  uint32_t PopFlow (List &list);
+
+  /**
+   * \brief Remove the packet at the head of a flow queue
+   * \param flow the flow
+   * \param enqueue the enqueue time of the packet, in CoDel time
+   * \returns the packet, or 0 if the flow queue is empty
+   */
+  Ptr<Packet> PopPacket (uint32_t flow, uint32_t &enqueue);
+
+  /**
+   * \brief Drop the packet at the head of the longest flow queue
+   */
+  void DropFromFattest (void);
+
+  /**
+   * \brief Decide whether CoDel may drop a packet of a flow
+   * \param flow the flow
+   * \param enqueue the enqueue time of the packet, in CoDel time
+   * \param now the current CoDel time
+   * \returns true if the sojourn time has been above target for an interval
+   */
+  bool OkToDrop (Flow &flow, uint32_t enqueue, uint32_t now);
+
+  /**
+   * \brief Dequeue a packet from a flow queue through its CoDel instance
+   * \param flow the flow
+   * \returns the packet, or 0 if the flow queue got empty
+   */
+  Ptr<Packet> CoDelDequeue (uint32_t flow);
+
+  /**
+   * \brief Drop a packet which was counted in the queue
+   * \param p the packet
+   */
+  void DropQueued (Ptr<Packet> p);
+
+  uint32_t m_flows;                 //!< Number of flow queues
+  uint32_t m_maxPackets;            //!< Max # of packets accepted by the queue
+  uint32_t m_quantum;               //!< DRR quantum, in bytes
+  uint32_t m_minBytes;              //!< Minimum bytes in a flow queue to allow a drop
+  uint32_t m_perturbation;          //!< Seed of the flow hash
+  Time m_interval;                  //!< CoDel interval
+  Time m_target;                    //!< CoDel target queue delay
+  std::vector<Flow> m_flowTable;    //!< The flow queues
+  std::vector<Slot> m_slots;        //!< The packet slots
+  uint32_t m_freeSlot;              //!< First free packet slot
+  List m_newFlows;                  //!< Flows served first
+  List m_oldFlows;                  //!< Flows served after the new ones
+  TracedValue<uint32_t> m_dropCount;  //!< Number of packets dropped by CoDel
+  uint32_t m_dropOverLimit;         //!< Number of packets dropped when full
+};
+
+} // namespace ns3
+
+#endif /* FQ_CODEL_QUEUE_H */
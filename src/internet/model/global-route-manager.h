@@ -62,6 +62,19 @@ public:
  */
   static void InitializeRoutes ();
 
+/**
+ * @brief Rebuild the routing database and recompute the routes of the
+ * nodes that the changes since the last computation may affect.
+ *
+ * The routes of a node are deleted and computed again only if its
+ * shortest path tree, or the destinations its tree reaches, may have
+ * changed.  Other nodes keep their routes, which are the ones a full
+ * computation would give.  Without a previous computation, this is the
+ * same as DeleteGlobalRoutes (), BuildGlobalRoutingDatabase () and
+ * InitializeRoutes ().
+ */
+  static void UpdateRoutes ();
+
 private:
 /**
  * @brief Global Route Manager copy construction is disallowed.  There's no 
@@ -554,10 +554,9 @@ private:
   ListOfAttachedRouters_t m_attachedRouters;
 
 /**
- * This is a tristate flag used internally in the SPF computation to mark
- * if an SPFVertex (a data structure representing a vertex in the SPF tree
- * -- a router) is new, is a candidate for a shortest path, or is in its
- * proper position in the tree.
+ * This is a tristate flag to mark if the vertex of the LSA in an SPF
+ * computation (a router) is new, is a candidate for a shortest path, or is
+ * in its proper position in the tree.
  */
   SPFStatus m_status;
   uint32_t m_node_id; //!< node ID
@@ -32,6 +32,7 @@ namespace ns3 {
 
 class Header;
 class Packet;
+class Ipv4EndPointDemux;
 
 /**
  * \brief A representation of an internet endpoint/connection
@@ -169,6 +170,8 @@ public:
                     uint32_t icmpInfo);
 
 private:
+  friend class Ipv4EndPointDemux;
+
   /**
    * \brief ForwardUp wrapper.
    * \param p packet
@@ -215,6 +218,16 @@ private:
    */
   Ptr<NetDevice> m_boundnetdevice;
 
+  /**
+   * \brief The demux indexing the end point, 0 if none.
+   */
+  Ipv4EndPointDemux *m_demux;
+
+  /**
+   * \brief The rank of the end point in the order of allocation.
+   */
+  uint64_t m_rank;
+
   /**
    * \brief The RX callback.
    */
@@ -0,0 +1,301 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ipv4-global-fib.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4GlobalFib");
+
+Ipv4GlobalFib::Ipv4GlobalFib ()
+  : m_version (0)
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+Ipv4GlobalFib::~Ipv4GlobalFib ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+Ipv4GlobalFib::AcquireNextHopSet (const NextHopSet &set)
+{
+  NextHopSetUse use;
+  use.index = m_freeNextHopSets.empty () ? m_nextHopSetsByIndex.size () : m_freeNextHopSets.back ();
+  use.references = 0;
+  std::pair<NextHopSets::iterator, bool> result = m_nextHopSets.insert (std::make_pair (set, use));
+  if (result.second)
+    {
+      if (m_freeNextHopSets.empty ())
+        {
+          m_nextHopSetsByIndex.push_back (result.first);
+        }
+      else
+        {
+          m_freeNextHopSets.pop_back ();
+          m_nextHopSetsByIndex[use.index] = result.first;
+        }
+    }
+  result.first->second.references++;
+  return result.first->second.index;
+}
+
+void
+Ipv4GlobalFib::ReleaseNextHopSet (uint32_t index)
+{
+  NextHopSets::iterator i = m_nextHopSetsByIndex[index];
+  NS_ASSERT (i->second.references > 0);
+  if (--i->second.references == 0)
+    {
+      m_nextHopSets.erase (i);
+      m_nextHopSetsByIndex[index] = m_nextHopSets.end ();
+      m_freeNextHopSets.push_back (index);
+    }
+}
+
+const Ipv4GlobalFib::NextHopSet *
+Ipv4GlobalFib::GetNextHops (const Destination &destination, uint32_t node) const
+{
+  std::vector<NodeNextHops>::const_iterator i =
+    std::lower_bound (destination.nextHops.begin (), destination.nextHops.end (), NodeNextHops (node, 0));
+  if (i == destination.nextHops.end () || i->first != node)
+    {
+      return 0;
+    }
+  return &m_nextHopSetsByIndex[i->second]->first;
+}
+
+void
+Ipv4GlobalFib::SetNextHops (uint32_t index, uint32_t node, const NextHopSet &set)
+{
+  std::vector<NodeNextHops> &nextHops = m_destinations[index].nextHops;
+  std::vector<NodeNextHops>::iterator i =
+    std::lower_bound (nextHops.begin (), nextHops.end (), NodeNextHops (node, 0));
+  bool found = i != nextHops.end () && i->first == node;
+  // acquire the new set first, it may be the old one
+  if (!set.empty ())
+    {
+      uint32_t setIndex = AcquireNextHopSet (set);
+      if (found)
+        {
+          ReleaseNextHopSet (i->second);
+          i->second = setIndex;
+        }
+      else
+        {
+          nextHops.insert (i, NodeNextHops (node, setIndex));
+          if (m_nodeDestinations.size () <= node)
+            {
+              m_nodeDestinations.resize (node + 1);
+            }
+          m_nodeDestinations[node].insert (index);
+        }
+    }
+  else if (found)
+    {
+      ReleaseNextHopSet (i->second);
+      nextHops.erase (i);
+      m_nodeDestinations[node].erase (index);
+    }
+}
+
+Ipv4RoutingTableEntry
+Ipv4GlobalFib::CreateRoute (const Destination &destination, uint64_t nextHop)
+{
+  Ipv4Address gateway (static_cast<uint32_t> (nextHop >> 32));
+  uint32_t interface = static_cast<uint32_t> (nextHop);
+  if (destination.type == HOST_ROUTE)
+    {
+      return Ipv4RoutingTableEntry::CreateHostRouteTo (destination.entry.GetDest (), gateway, interface);
+    }
+  return Ipv4RoutingTableEntry::CreateNetworkRouteTo (destination.entry.GetDestNetwork (),
+                                                      destination.entry.GetDestNetworkMask (),
+                                                      gateway, interface);
+}
+
+void
+Ipv4GlobalFib::AddRoute (uint32_t node, RouteType type, Ipv4Address network, Ipv4Mask mask,
+                         Ipv4Address nextHop, uint32_t interface)
+{
+  NS_LOG_FUNCTION (this << node << type << network << mask << nextHop << interface);
+  NS_ASSERT (type < N_ROUTE_TYPES);
+  if (type == HOST_ROUTE)
+    {
+      mask = Ipv4Mask::GetOnes ();
+    }
+  uint64_t key = (static_cast<uint64_t> (network.Get ()) << 32) | mask.Get ();
+  std::pair<std::map<uint64_t, uint32_t>::iterator, bool> result =
+    m_index[type].insert (std::make_pair (key, m_destinations.size ()));
+  if (result.second)
+    {
+      Destination destination;
+      destination.entry = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network, mask, 0);
+      destination.type = type;
+      m_destinations.push_back (destination);
+      // the deque never moves its elements, the trie may keep pointers to them
+      m_tries[type].Insert (network, mask, &m_destinations.back ().entry, result.first->second);
+    }
+  const NextHopSet *current = GetNextHops (m_destinations[result.first->second], node);
+  NextHopSet set = current != 0 ? *current : NextHopSet ();
+  set.push_back ((static_cast<uint64_t> (nextHop.Get ()) << 32) | interface);
+  SetNextHops (result.first->second, node, set);
+  m_version++;
+}
+
+void
+Ipv4GlobalFib::GetRoutes (uint32_t node, std::vector<Ipv4RoutingTableEntry> &routes) const
+{
+  NS_LOG_FUNCTION (this << node);
+  if (node >= m_nodeDestinations.size ())
+    {
+      return;
+    }
+  const std::set<uint32_t> &destinations = m_nodeDestinations[node];
+  for (uint32_t type = 0; type < N_ROUTE_TYPES; type++)
+    {
+      for (std::set<uint32_t>::const_iterator i = destinations.begin (); i != destinations.end (); i++)
+        {
+          const Destination &destination = m_destinations[*i];
+          if (destination.type != type)
+            {
+              continue;
+            }
+          const NextHopSet &set = *GetNextHops (destination, node);
+          for (NextHopSet::const_iterator j = set.begin (); j != set.end (); j++)
+            {
+              routes.push_back (CreateRoute (destination, *j));
+            }
+        }
+    }
+}
+
+void
+Ipv4GlobalFib::RemoveRoute (uint32_t node, uint32_t index)
+{
+  NS_LOG_FUNCTION (this << node << index);
+  NS_ASSERT_MSG (node < m_nodeDestinations.size (), "No route " << index << " for node " << node);
+  const std::set<uint32_t> &destinations = m_nodeDestinations[node];
+  for (uint32_t type = 0; type < N_ROUTE_TYPES; type++)
+    {
+      for (std::set<uint32_t>::const_iterator i = destinations.begin (); i != destinations.end (); i++)
+        {
+          const Destination &destination = m_destinations[*i];
+          if (destination.type != type)
+            {
+              continue;
+            }
+          const NextHopSet &set = *GetNextHops (destination, node);
+          if (index >= set.size ())
+            {
+              index -= set.size ();
+              continue;
+            }
+          NextHopSet remaining = set;
+          remaining.erase (remaining.begin () + index);
+          // this may erase the destination from the set walked, hence the return
+          SetNextHops (*i, node, remaining);
+          m_version++;
+          return;
+        }
+    }
+  NS_ASSERT_MSG (false, "No route " << index << " for node " << node);
+}
+
+void
+Ipv4GlobalFib::RemoveRoutes (uint32_t node)
+{
+  NS_LOG_FUNCTION (this << node);
+  if (node < m_nodeDestinations.size ())
+    {
+      std::set<uint32_t> destinations;
+      destinations.swap (m_nodeDestinations[node]);
+      for (std::set<uint32_t>::const_iterator i = destinations.begin (); i != destinations.end (); i++)
+        {
+          std::vector<NodeNextHops> &nextHops = m_destinations[*i].nextHops;
+          std::vector<NodeNextHops>::iterator j =
+            std::lower_bound (nextHops.begin (), nextHops.end (), NodeNextHops (node, 0));
+          NS_ASSERT (j != nextHops.end () && j->first == node);
+          ReleaseNextHopSet (j->second);
+          nextHops.erase (j);
+        }
+    }
+  m_version++;
+}
+
+void
+Ipv4GlobalFib::Lookup (uint32_t node, RouteType type, Ipv4Address dest,
+                       std::vector<Ipv4RoutingTableEntry> &routes) const
+{
+  NS_LOG_FUNCTION (this << node << type << dest);
+  m_matches.clear ();
+  m_tries[type].Lookup (dest, m_matches);
+  for (std::vector<Ipv4RouteTrie::Route>::const_iterator i = m_matches.begin (); i != m_matches.end (); i++)
+    {
+      const Destination &destination = m_destinations[i->metric];
+      const NextHopSet *set = GetNextHops (destination, node);
+      if (set == 0)
+        {
+          continue;
+        }
+      for (NextHopSet::const_iterator j = set->begin (); j != set->end (); j++)
+        {
+          routes.push_back (CreateRoute (destination, *j));
+        }
+    }
+}
+
+void
+Ipv4GlobalFib::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t type = 0; type < N_ROUTE_TYPES; type++)
+    {
+      m_tries[type].Clear ();
+      m_index[type].clear ();
+    }
+  m_destinations.clear ();
+  m_nodeDestinations.clear ();
+  m_nextHopSets.clear ();
+  m_nextHopSetsByIndex.clear ();
+  m_freeNextHopSets.clear ();
+  m_version++;
+}
+
+uint32_t
+Ipv4GlobalFib::GetVersion (void) const
+{
+  return m_version;
+}
+
+uint32_t
+Ipv4GlobalFib::GetNDestinations (void) const
+{
+  return m_destinations.size ();
+}
+
+uint32_t
+Ipv4GlobalFib::GetNNextHopSets (void) const
+{
+  return m_nextHopSets.size ();
+}
+
+} // namespace ns3
@@ -0,0 +1,223 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef IPV4_GLOBAL_FIB_H
+#define IPV4_GLOBAL_FIB_H
+
+#include <deque>
+#include <map>
+#include <set>
+#include <vector>
+#include <stdint.h>
+
+#include "ns3/simple-ref-count.h"
+#include "ns3/ipv4-address.h"
+#include "ipv4-routing-table-entry.h"
+#include "ipv4-route-trie.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup globalrouting
+ *
+ * \brief A forwarding table holding the global routes of all the nodes.
+ *
+ * When the GlobalRoutingSharedTable global value is set, the
+ * GlobalRouteManager writes the routes it computes here instead of
+ * in a list of Ipv4RoutingTableEntry objects of every node, and every
+ * Ipv4GlobalRouting looks its routes up here.
+ *
+ * Each destination (a host, a network or an external network) is
+ * stored once, with the list of the nodes having a route to it and the
+ * set of next hops each of them uses.  The sets of next hops, that is
+ * ordered lists of (gateway, interface) pairs, are stored once as well
+ * whatever the number of destinations and nodes using them, and freed
+ * when no node uses them anymore.  A route thus costs eight bytes
+ * instead of a heap allocated entry, a list node and an index entry,
+ * and an index of the destinations of each node keeps GetRoutes ()
+ * proportional to the number of routes of the node.
+ *
+ * Destinations are never freed before Clear (): removing routes is
+ * expected to be rare, the GlobalRouteManager throws the whole table
+ * away when it recomputes all the routes, and only removes the routes
+ * of the nodes it updates otherwise.
+ */
+class Ipv4GlobalFib : public SimpleRefCount<Ipv4GlobalFib>
+{
+public:
+  /**
+   * \brief The kinds of routes, in the order Ipv4GlobalRouting
+   * considers them.
+   */
+  enum RouteType
+  {
+    HOST_ROUTE = 0,     //!< route to a host
+    NETWORK_ROUTE,      //!< route to a network of the routing domain
+    EXTERNAL_ROUTE,     //!< route to a network outside the routing domain
+    N_ROUTE_TYPES       //!< number of kinds of routes
+  };
+
+  Ipv4GlobalFib ();
+  ~Ipv4GlobalFib ();
+
+  /**
+   * \brief Add a route of a node
+   * \param node the id of the node
+   * \param type the kind of the route
+   * \param network the destination of the route
+   * \param mask the mask of the destination, ignored for host routes
+   * \param nextHop the gateway of the route
+   * \param interface the interface of the route
+   */
+  void AddRoute (uint32_t node, RouteType type, Ipv4Address network, Ipv4Mask mask,
+                 Ipv4Address nextHop, uint32_t interface);
+
+  /**
+   * \brief Get the routes of a node
+   * \param node the id of the node
+   * \param routes the routes of the node, host routes first, then
+   *        network routes and external routes, are appended to this vector
+   */
+  void GetRoutes (uint32_t node, std::vector<Ipv4RoutingTableEntry> &routes) const;
+
+  /**
+   * \brief Remove a route of a node
+   * \param node the id of the node
+   * \param index the index of the route in the vector given by GetRoutes ()
+   */
+  void RemoveRoute (uint32_t node, uint32_t index);
+
+  /**
+   * \brief Remove all the routes of a node
+   * \param node the id of the node
+   */
+  void RemoveRoutes (uint32_t node);
+
+  /**
+   * \brief Find the routes of a node matching a destination
+   * \param node the id of the node
+   * \param type the kind of routes to look for
+   * \param dest the destination
+   * \param routes the matching routes are appended to this vector
+   */
+  void Lookup (uint32_t node, RouteType type, Ipv4Address dest,
+               std::vector<Ipv4RoutingTableEntry> &routes) const;
+
+  /**
+   * \brief Remove all the routes
+   */
+  void Clear (void);
+
+  /**
+   * \return a number which changes every time routes are added or removed
+   */
+  uint32_t GetVersion (void) const;
+
+  /**
+   * \return the number of destinations in the table
+   */
+  uint32_t GetNDestinations (void) const;
+
+  /**
+   * \return the number of distinct sets of next hops in the table
+   */
+  uint32_t GetNNextHopSets (void) const;
+
+private:
+  /**
+   * \brief A list of next hops, each one being the gateway in the 32
+   * upper bits and the interface in the 32 lower bits.
+   */
+  typedef std::vector<uint64_t> NextHopSet;
+
+  /**
+   * \brief The index of a set of next hops and the number of
+   * (destination, node) pairs using it.
+   */
+  struct NextHopSetUse
+  {
+    uint32_t index;      //!< index of the set in m_nextHopSetsByIndex
+    uint32_t references; //!< number of (destination, node) pairs using the set
+  };
+
+  /// container of the sets of next hops, giving their index and use count
+  typedef std::map<NextHopSet, NextHopSetUse> NextHopSets;
+
+  /// a node and the index of the set of next hops it uses
+  typedef std::pair<uint32_t, uint32_t> NodeNextHops;
+
+  /**
+   * \brief A destination and the sets of next hops the nodes use to
+   * reach it.
+   */
+  struct Destination
+  {
+    Ipv4RoutingTableEntry entry;          //!< the destination and its mask
+    RouteType type;                       //!< the kind of routes to the destination
+    std::vector<NodeNextHops> nextHops;   //!< the nodes having routes to the destination, sorted by id
+  };
+
+  /**
+   * \param destination a destination
+   * \param node the id of a node
+   * \return the set of next hops the node uses to reach the destination,
+   *         or 0 if it has no route to it
+   */
+  const NextHopSet *GetNextHops (const Destination &destination, uint32_t node) const;
+
+  /**
+   * \brief Set the next hops a node uses to reach a destination
+   * \param index the index of the destination
+   * \param node the id of the node
+   * \param set the next hops, the node has no route to the
+   *        destination anymore if it is empty
+   */
+  void SetNextHops (uint32_t index, uint32_t node, const NextHopSet &set);
+
+  /**
+   * \param set a set of next hops
+   * \return the index of the set, which is added if it is not known yet;
+   *         the use count of the set is incremented
+   */
+  uint32_t AcquireNextHopSet (const NextHopSet &set);
+
+  /**
+   * \brief Decrement the use count of a set of next hops, freeing it
+   * when it drops to zero
+   * \param index the index of the set
+   */
+  void ReleaseNextHopSet (uint32_t index);
+
+  /**
+   * \param destination a destination
+   * \param nextHop a next hop of the destination
+   * \return the route to the destination through the next hop
+   */
+  static Ipv4RoutingTableEntry CreateRoute (const Destination &destination, uint64_t nextHop);
+
+  std::deque<Destination> m_destinations;                 //!< the destinations
+  std::map<uint64_t, uint32_t> m_index[N_ROUTE_TYPES];    //!< destinations by address and mask
+  Ipv4RouteTrie m_tries[N_ROUTE_TYPES];                   //!< destinations by prefix, the metric being their index
+  std::vector<std::set<uint32_t> > m_nodeDestinations;    //!< index of the destinations of each node, by node id
+  NextHopSets m_nextHopSets;                              //!< the sets of next hops
+  std::vector<NextHopSets::iterator> m_nextHopSetsByIndex; //!< the sets of next hops, by index
+  std::vector<uint32_t> m_freeNextHopSets;                //!< indexes of the freed sets of next hops
+  mutable std::vector<Ipv4RouteTrie::Route> m_matches;    //!< destinations found by Lookup (), kept to reuse their storage
+  uint32_t m_version;                                     //!< changes with the routes
+};
+
+} // namespace ns3
+
+#endif /* IPV4_GLOBAL_FIB_H */
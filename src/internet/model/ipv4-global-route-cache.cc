@@ -0,0 +1,225 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/node.h"
+#include "ipv4-global-route-cache.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4GlobalRouteCache");
+
+Ipv4GlobalRouteCache::Ipv4GlobalRouteCache (uint32_t capacity, uint32_t spfCapacity)
+  : m_capacity (capacity),
+    m_graph (0),
+    m_calculator (0),
+    m_spfCapacity (spfCapacity),
+    m_version (0),
+    m_nCalculations (0)
+{
+  NS_LOG_FUNCTION (this << capacity << spfCapacity);
+  NS_ASSERT_MSG (capacity > 0, "A route cache needs room for one entry at least");
+  NS_ASSERT_MSG (spfCapacity > 0, "A route cache needs room for one calculation at least");
+}
+
+Ipv4GlobalRouteCache::~Ipv4GlobalRouteCache ()
+{
+  NS_LOG_FUNCTION (this);
+  delete m_calculator;
+}
+
+void
+Ipv4GlobalRouteCache::SetGraph (const SPFGraph *graph)
+{
+  NS_LOG_FUNCTION (this << graph);
+  m_graph = graph;
+  delete m_calculator;
+  m_calculator = new SPFCalculator (graph);
+  m_vertices.clear ();
+  for (uint32_t i = 0; i < graph->GetNVertices (); i++)
+    {
+      Ptr<Node> node = graph->GetNode (i);
+      if (node == 0)
+        {
+          continue;
+        }
+      if (m_vertices.size () <= node->GetId ())
+        {
+          m_vertices.resize (node->GetId () + 1, SPFGraph::NO_VERTEX);
+        }
+      m_vertices[node->GetId ()] = i;
+    }
+  m_calculations.clear ();
+  m_calculationIndex.clear ();
+  m_version++;
+}
+
+void
+Ipv4GlobalRouteCache::Invalidate (uint32_t node)
+{
+  NS_LOG_FUNCTION (this << node);
+  std::map<uint64_t, Entries::iterator>::iterator first =
+    m_index.lower_bound (static_cast<uint64_t> (node) << 32);
+  std::map<uint64_t, Entries::iterator>::iterator last =
+    m_index.lower_bound ((static_cast<uint64_t> (node) + 1) << 32);
+  for (std::map<uint64_t, Entries::iterator>::iterator i = first; i != last; i++)
+    {
+      m_entries.erase (i->second);
+    }
+  m_index.erase (first, last);
+  std::map<uint32_t, Calculations::iterator>::iterator calculation = m_calculationIndex.find (node);
+  if (calculation != m_calculationIndex.end ())
+    {
+      m_calculations.erase (calculation->second);
+      m_calculationIndex.erase (calculation);
+    }
+  m_version++;
+}
+
+void
+Ipv4GlobalRouteCache::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_entries.clear ();
+  m_index.clear ();
+  m_calculations.clear ();
+  m_calculationIndex.clear ();
+  m_version++;
+}
+
+const std::vector<SPFRoute> &
+Ipv4GlobalRouteCache::Calculate (uint32_t node)
+{
+  NS_LOG_FUNCTION (this << node);
+  NS_ASSERT_MSG (m_calculator != 0, "No graph to compute the routes from");
+  std::map<uint32_t, Calculations::iterator>::iterator found = m_calculationIndex.find (node);
+  if (found != m_calculationIndex.end ())
+    {
+      m_calculations.splice (m_calculations.begin (), m_calculations, found->second);
+      return m_calculations.front ().routes;
+    }
+  m_calculations.push_front (Calculation ());
+  Calculation &calculation = m_calculations.front ();
+  calculation.node = node;
+  if (node < m_vertices.size () && m_vertices[node] != SPFGraph::NO_VERTEX)
+    {
+      m_calculator->Calculate (m_vertices[node], calculation.routes);
+      m_nCalculations++;
+    }
+  NS_LOG_LOGIC ("Computed " << calculation.routes.size () << " routes for node " << node);
+  m_calculationIndex[node] = m_calculations.begin ();
+  if (m_calculations.size () > m_spfCapacity)
+    {
+      NS_LOG_LOGIC ("Dropping the routes of node " << m_calculations.back ().node);
+      m_calculationIndex.erase (m_calculations.back ().node);
+      m_calculations.pop_back ();
+    }
+  return calculation.routes;
+}
+
+Ipv4RoutingTableEntry
+Ipv4GlobalRouteCache::CreateRoute (const SPFRoute &route)
+{
+  if (route.type == Ipv4GlobalFib::HOST_ROUTE)
+    {
+      return Ipv4RoutingTableEntry::CreateHostRouteTo (route.network, route.nextHop, route.interface);
+    }
+  return Ipv4RoutingTableEntry::CreateNetworkRouteTo (route.network, route.mask, route.nextHop, route.interface);
+}
+
+void
+Ipv4GlobalRouteCache::Lookup (uint32_t node, Ipv4GlobalFib::RouteType type, Ipv4Address dest,
+                              std::vector<Ipv4RoutingTableEntry> &routes)
+{
+  NS_LOG_FUNCTION (this << node << type << dest);
+  uint64_t key = (static_cast<uint64_t> (node) << 32) | dest.Get ();
+  std::map<uint64_t, Entries::iterator>::iterator found = m_index.find (key);
+  if (found != m_index.end ())
+    {
+      m_entries.splice (m_entries.begin (), m_entries, found->second);
+    }
+  else
+    {
+      NS_LOG_LOGIC ("No entry for " << dest << " in node " << node);
+      m_entries.push_front (Entry ());
+      Entry &entry = m_entries.front ();
+      entry.key = key;
+      const std::vector<SPFRoute> &all = Calculate (node);
+      for (std::vector<SPFRoute>::const_iterator i = all.begin (); i != all.end (); i++)
+        {
+          bool match = i->type == Ipv4GlobalFib::HOST_ROUTE ? i->network == dest
+            : i->mask.IsMatch (dest, i->network);
+          if (match)
+            {
+              entry.routes.push_back (*i);
+            }
+        }
+      m_index[key] = m_entries.begin ();
+      if (m_entries.size () > m_capacity)
+        {
+          NS_LOG_LOGIC ("Cache full, dropping the least recently used entry");
+          m_index.erase (m_entries.back ().key);
+          m_entries.pop_back ();
+        }
+    }
+
+  const std::vector<SPFRoute> &matches = m_entries.front ().routes;
+  for (std::vector<SPFRoute>::const_iterator i = matches.begin (); i != matches.end (); i++)
+    {
+      if (i->type == type)
+        {
+          routes.push_back (CreateRoute (*i));
+        }
+    }
+}
+
+void
+Ipv4GlobalRouteCache::GetRoutes (uint32_t node, std::vector<Ipv4RoutingTableEntry> &routes)
+{
+  NS_LOG_FUNCTION (this << node);
+  const std::vector<SPFRoute> &all = Calculate (node);
+  for (uint32_t type = 0; type < Ipv4GlobalFib::N_ROUTE_TYPES; type++)
+    {
+      for (std::vector<SPFRoute>::const_iterator i = all.begin (); i != all.end (); i++)
+        {
+          if (i->type == type)
+            {
+              routes.push_back (CreateRoute (*i));
+            }
+        }
+    }
+}
+
+uint32_t
+Ipv4GlobalRouteCache::GetVersion (void) const
+{
+  return m_version;
+}
+
+uint32_t
+Ipv4GlobalRouteCache::GetNEntries (void) const
+{
+  return m_entries.size ();
+}
+
+uint32_t
+Ipv4GlobalRouteCache::GetNCalculations (void) const
+{
+  return m_nCalculations;
+}
+
+} // namespace ns3
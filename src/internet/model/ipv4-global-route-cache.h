@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef IPV4_GLOBAL_ROUTE_CACHE_H
+#define IPV4_GLOBAL_ROUTE_CACHE_H
+
+#include <list>
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+#include "ns3/simple-ref-count.h"
+#include "ns3/ipv4-address.h"
+#include "ipv4-routing-table-entry.h"
+#include "ipv4-global-fib.h"
+#include "spf-graph.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup globalrouting
+ *
+ * \brief The global routes of the nodes, computed the first time they
+ * are looked up.
+ *
+ * When the GlobalRoutingOnDemand global value is set, the
+ * GlobalRouteManager computes no route up front: every Ipv4GlobalRouting
+ * looks its routes up here instead.  The first lookup of a destination by
+ * a node runs the SPF calculation of the node, and keeps the routes
+ * matching the destination in a cache of at most GlobalRoutingCacheSize
+ * (node, destination) entries, the least recently used entry being dropped
+ * when the cache is full.  All the routes computed for the
+ * GlobalRoutingSpfCacheSize nodes used most recently are kept as well, in
+ * the same way, so that nodes looking up new destinations in turn run a
+ * single calculation each.
+ *
+ * The routes given are the ones the GlobalRouteManager would have
+ * installed in the node, in the same order.
+ */
+class Ipv4GlobalRouteCache : public SimpleRefCount<Ipv4GlobalRouteCache>
+{
+public:
+  /**
+   * \param capacity the maximum number of (node, destination) entries
+   * \param spfCapacity the maximum number of nodes whose SPF calculation
+   *        is kept
+   */
+  Ipv4GlobalRouteCache (uint32_t capacity, uint32_t spfCapacity);
+  ~Ipv4GlobalRouteCache ();
+
+  /**
+   * \brief Compute the routes from another graph.
+   *
+   * The entries already in the cache are kept: the caller invalidates
+   * the ones of the nodes whose routes change.
+   *
+   * \param graph the graph, which must outlive its use by the cache
+   */
+  void SetGraph (const SPFGraph *graph);
+
+  /**
+   * \brief Drop the entries of a node
+   * \param node the id of the node
+   */
+  void Invalidate (uint32_t node);
+
+  /**
+   * \brief Drop all the entries
+   */
+  void Clear (void);
+
+  /**
+   * \brief Find the routes of a node matching a destination
+   * \param node the id of the node
+   * \param type the kind of routes to look for
+   * \param dest the destination
+   * \param routes the matching routes are appended to this vector
+   */
+  void Lookup (uint32_t node, Ipv4GlobalFib::RouteType type, Ipv4Address dest,
+               std::vector<Ipv4RoutingTableEntry> &routes);
+
+  /**
+   * \brief Get all the routes of a node
+   * \param node the id of the node
+   * \param routes the routes of the node, host routes first, then
+   *        network routes and external routes, are appended to this vector
+   */
+  void GetRoutes (uint32_t node, std::vector<Ipv4RoutingTableEntry> &routes);
+
+  /**
+   * \return a number which changes every time the routes of a node may
+   *         have changed
+   */
+  uint32_t GetVersion (void) const;
+
+  /**
+   * \return the number of (node, destination) entries in the cache
+   */
+  uint32_t GetNEntries (void) const;
+
+  /**
+   * \return the number of SPF calculations run so far
+   */
+  uint32_t GetNCalculations (void) const;
+
+private:
+  /**
+   * \brief Copy constructor, disabled
+   * \param o object to copy
+   */
+  Ipv4GlobalRouteCache (const Ipv4GlobalRouteCache &o);
+  /**
+   * \brief Assignment operator, disabled
+   * \param o object to copy
+   * \returns the object
+   */
+  Ipv4GlobalRouteCache &operator = (const Ipv4GlobalRouteCache &o);
+
+  /// The routes of a node matching a destination
+  struct Entry
+  {
+    uint64_t key;                  //!< the node id and the destination
+    std::vector<SPFRoute> routes;  //!< the matching routes
+  };
+  /// container of the entries, the most recently used first
+  typedef std::list<Entry> Entries;
+
+  /// All the routes of a node
+  struct Calculation
+  {
+    uint32_t node;                 //!< the node id
+    std::vector<SPFRoute> routes;  //!< the routes, in the order they would be installed
+  };
+  /// container of the calculations, the most recently used first
+  typedef std::list<Calculation> Calculations;
+
+  /**
+   * \param node the id of a node
+   * \return all the routes of the node, in the order they would be installed
+   */
+  const std::vector<SPFRoute> & Calculate (uint32_t node);
+
+  /**
+   * \param route a route
+   * \return the routing table entry of the route
+   */
+  static Ipv4RoutingTableEntry CreateRoute (const SPFRoute &route);
+
+  uint32_t m_capacity;                          //!< the maximum number of entries
+  Entries m_entries;                            //!< the entries
+  std::map<uint64_t, Entries::iterator> m_index; //!< the entries by key
+  const SPFGraph *m_graph;                      //!< the graph
+  SPFCalculator *m_calculator;                  //!< the calculator working on m_graph
+  std::vector<uint32_t> m_vertices;             //!< the vertex of each node id
+  uint32_t m_spfCapacity;                       //!< the maximum number of calculations
+  Calculations m_calculations;                  //!< the calculations kept
+  std::map<uint32_t, Calculations::iterator> m_calculationIndex; //!< the calculations by node id
+  uint32_t m_version;                           //!< changes with the routes
+  uint32_t m_nCalculations;                     //!< number of SPF calculations
+};
+
+} // namespace ns3
+
+#endif /* IPV4_GLOBAL_ROUTE_CACHE_H */
@@ -27,6 +27,9 @@
 #include "ns3/ipv4-route.h"
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/hash.h"
+#include "ns3/node.h"
 #include "ipv4-global-routing.h"
 #include "global-route-manager.h"
 
@@ -47,6 +50,18 @@ Ipv4GlobalRouting::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&Ipv4GlobalRouting::m_randomEcmpRouting),
                    MakeBooleanChecker ())
+    .AddAttribute ("FlowEcmpRouting",
+                   "Set to true if packets are routed among ECMP by a hash of their 5-tuple, so that "
+                   "the packets of a flow follow one route and are not reordered; takes precedence "
+                   "over RandomEcmpRouting",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv4GlobalRouting::m_flowEcmpRouting),
+                   MakeBooleanChecker ())
+    .AddAttribute ("EcmpHashSeed",
+                   "The seed of the flow hash of FlowEcmpRouting, hashed with the id of the node",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&Ipv4GlobalRouting::m_ecmpHashSeed),
+                   MakeUintegerChecker<uint32_t> ())
     .AddAttribute ("RespondToInterfaceEvents",
                    "Set to true if you want to dynamically recompute the global routes upon Interface notification events (up/down, or add/remove address)",
                    BooleanValue (false),
@@ -58,7 +73,14 @@ Ipv4GlobalRouting::GetTypeId (void)
 
 Ipv4GlobalRouting::Ipv4GlobalRouting () 
   : m_randomEcmpRouting (false),
-    m_respondToInterfaceEvents (false)
+    m_flowEcmpRouting (false),
+    m_ecmpHashSeed (0),
+    m_respondToInterfaceEvents (false),
+    m_routeTriesStale (false),
+    m_sharedTableId (0),
+    m_sharedRoutesVersion (0),
+    m_sharedRoutesStale (true),
+    m_nodeId (0)
 {
   NS_LOG_FUNCTION (this);
 
@@ -79,6 +101,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
   m_hostRoutes.push_back (route);
+  m_hostTrie.Insert (dest, Ipv4Mask::GetOnes (), route);
 }
 
 void 
@@ -89,6 +112,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
   m_hostRoutes.push_back (route);
+  m_hostTrie.Insert (dest, Ipv4Mask::GetOnes (), route);
 }
 
 void 
@@ -104,6 +128,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_networkTrie.Insert (network, networkMask, route);
 }
 
 void 
@@ -117,6 +142,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_networkTrie.Insert (network, networkMask, route);
 }
 
 void 
@@ -132,109 +158,326 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_ASexternalRoutes.push_back (route);
+  m_ASexternalTrie.Insert (network, networkMask, route);
+}
+
+
+void
+Ipv4GlobalRouting::UpdateRouteTries (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_routeTriesStale)
+    {
+      return;
+    }
+  m_hostTrie.Clear ();
+  for (HostRoutesCI i = m_hostRoutes.begin (); i != m_hostRoutes.end (); i++)
+    {
+      m_hostTrie.Insert ((*i)->GetDest (), Ipv4Mask::GetOnes (), *i);
+    }
+  m_networkTrie.Clear ();
+  for (NetworkRoutesCI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
+    {
+      m_networkTrie.Insert ((*j)->GetDestNetwork (), (*j)->GetDestNetworkMask (), *j);
+    }
+  m_ASexternalTrie.Clear ();
+  for (ASExternalRoutesCI k = m_ASexternalRoutes.begin (); k != m_ASexternalRoutes.end (); k++)
+    {
+      m_ASexternalTrie.Insert ((*k)->GetDestNetwork (), (*k)->GetDestNetworkMask (), *k);
+    }
+  m_routeTriesStale = false;
+}
+
+void
+Ipv4GlobalRouting::SetSharedTable (Ptr<Ipv4GlobalFib> table, uint32_t id)
+{
+  NS_LOG_FUNCTION (this << table << id);
+  m_sharedTable = table;
+  m_sharedTableId = id;
+  m_sharedRoutes.clear ();
+  m_sharedRoutesStale = true;
+}
+
+Ptr<Ipv4GlobalFib>
+Ipv4GlobalRouting::GetSharedTable (void) const
+{
+  return m_sharedTable;
+}
+
+void
+Ipv4GlobalRouting::SetRouteCache (Ptr<Ipv4GlobalRouteCache> cache, uint32_t id)
+{
+  NS_LOG_FUNCTION (this << cache << id);
+  m_routeCache = cache;
+  m_sharedTableId = id;
+  m_sharedRoutes.clear ();
+  m_sharedRoutesStale = true;
+}
+
+Ptr<Ipv4GlobalRouteCache>
+Ipv4GlobalRouting::GetRouteCache (void) const
+{
+  return m_routeCache;
+}
+
+void
+Ipv4GlobalRouting::UpdateSharedRoutes (void) const
+{
+  if (m_sharedTable != 0)
+    {
+      if (m_sharedRoutesStale || m_sharedRoutesVersion != m_sharedTable->GetVersion ())
+        {
+          m_sharedRoutes.clear ();
+          m_sharedTable->GetRoutes (m_sharedTableId, m_sharedRoutes);
+          m_sharedRoutesVersion = m_sharedTable->GetVersion ();
+          m_sharedRoutesStale = false;
+        }
+    }
+  else if (m_routeCache != 0)
+    {
+      if (m_sharedRoutesStale || m_sharedRoutesVersion != m_routeCache->GetVersion ())
+        {
+          m_sharedRoutes.clear ();
+          m_routeCache->GetRoutes (m_sharedTableId, m_sharedRoutes);
+          m_sharedRoutesVersion = m_routeCache->GetVersion ();
+          m_sharedRoutesStale = false;
+        }
+    }
+}
+
+void
+Ipv4GlobalRouting::LookupComputedRoutes (Ipv4GlobalFib::RouteType type, Ipv4Address dest,
+                                         std::vector<Ipv4RoutingTableEntry> &routes)
+{
+  if (m_sharedTable != 0)
+    {
+      m_sharedTable->Lookup (m_sharedTableId, type, dest, routes);
+    }
+  else if (m_routeCache != 0)
+    {
+      m_routeCache->Lookup (m_sharedTableId, type, dest, routes);
+    }
+}
+
+void
+Ipv4GlobalRouting::SetEcmpWeight (uint32_t interface, uint32_t weight)
+{
+  NS_LOG_FUNCTION (this << interface << weight);
+  NS_ASSERT_MSG (weight > 0, "The weight of an interface must be at least 1");
+  if (interface >= m_ecmpWeights.size ())
+    {
+      m_ecmpWeights.resize (interface + 1, 1);
+    }
+  m_ecmpWeights[interface] = weight;
+}
+
+uint32_t
+Ipv4GlobalRouting::GetEcmpWeight (uint32_t interface) const
+{
+  NS_LOG_FUNCTION (this << interface);
+  return interface < m_ecmpWeights.size () ? m_ecmpWeights[interface] : 1;
 }
 
+uint32_t
+Ipv4GlobalRouting::GetFlowHash (Ptr<const Packet> p, const Ipv4Header &header, bool withPorts)
+{
+  NS_LOG_FUNCTION (this << p << header << withPorts);
+  if (!m_flowEcmpRouting)
+    {
+      return 0;
+    }
+  // addresses, protocol, ports, seed and node id
+  uint8_t buf[21] = { 0 };
+  header.GetSource ().Serialize (buf);
+  header.GetDestination ().Serialize (buf + 4);
+  buf[8] = header.GetProtocol ();
+  // only the first fragment carries the ports
+  bool hasPorts = header.GetProtocol () == 6 || header.GetProtocol () == 17;
+  if (withPorts && hasPorts && p != 0 && p->GetSize () >= 4
+      && header.GetFragmentOffset () == 0 && header.IsLastFragment ())
+    {
+      p->CopyData (buf + 9, 4);
+    }
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      buf[13 + i] = (m_ecmpHashSeed >> (8 * i)) & 0xff;
+      buf[17 + i] = (m_nodeId >> (8 * i)) & 0xff;
+    }
+  return Hash32 (reinterpret_cast<char *> (buf), sizeof (buf));
+}
+
+uint32_t
+Ipv4GlobalRouting::SelectEcmpRoute (const std::vector<const Ipv4RoutingTableEntry *> &routes, uint32_t flowHash)
+{
+  NS_LOG_FUNCTION (this << routes.size () << flowHash);
+  uint32_t total = 0;
+  for (uint32_t i = 0; i < routes.size (); i++)
+    {
+      total += GetEcmpWeight (routes[i]->GetInterface ());
+    }
+  uint32_t value;
+  if (m_flowEcmpRouting)
+    {
+      value = flowHash % total;
+    }
+  else
+    {
+      value = m_rand->GetInteger (0, total - 1);
+    }
+  for (uint32_t i = 0; i < routes.size (); i++)
+    {
+      uint32_t weight = GetEcmpWeight (routes[i]->GetInterface ());
+      if (value < weight)
+        {
+          return i;
+        }
+      value -= weight;
+    }
+  NS_ASSERT (false);
+  return 0;
+}
 
 Ptr<Ipv4Route>
-Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
+Ipv4GlobalRouting::LookupGlobal (Ptr<const Packet> p, const Ipv4Header &header, bool withPorts,
+                                 Ptr<NetDevice> oif)
 {
-  NS_LOG_FUNCTION (this << dest << oif);
+  NS_LOG_FUNCTION (this << p << header << withPorts << oif);
+  Ipv4Address dest = header.GetDestination ();
   NS_LOG_LOGIC ("Looking for route for destination " << dest);
+  UpdateRouteTries ();
   Ptr<Ipv4Route> rtentry = 0;
-  // store all available routes that bring packets to their destination
-  typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
-  RouteVec_t allRoutes;
+  // all available routes that bring packets to their destination, pointing
+  // in the route lists or in m_sharedMatches; the vectors are members so
+  // that their storage is reused from one packet to the next
+  typedef std::vector<const Ipv4RoutingTableEntry *> RouteVec_t;
+  RouteVec_t &allRoutes = m_allRoutes;
+  allRoutes.clear ();
+  // routes matching the destination, in the order of the route lists
+  typedef std::vector<Ipv4RouteTrie::Route> MatchVec_t;
+  MatchVec_t &matches = m_matches;
+  matches.clear ();
+  // routes of the shared table or of the route cache matching the destination
+  typedef std::vector<Ipv4RoutingTableEntry> SharedVec_t;
+  SharedVec_t &sharedMatches = m_sharedMatches;
+  sharedMatches.clear ();
 
   NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
-       i++) 
+  m_hostTrie.Lookup (dest, matches);
+  for (MatchVec_t::const_iterator i = matches.begin (); i != matches.end (); i++)
     {
-      NS_ASSERT ((*i)->IsHost ());
-      if ((*i)->GetDest ().IsEqual (dest)) 
+      NS_ASSERT (i->entry->IsHost ());
+      if (oif != 0)
         {
-          if (oif != 0)
+          if (oif != m_ipv4->GetNetDevice (i->entry->GetInterface ()))
             {
-              if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
-                {
-                  NS_LOG_LOGIC ("Not on requested interface, skipping");
-                  continue;
-                }
+              NS_LOG_LOGIC ("Not on requested interface, skipping");
+              continue;
             }
-          allRoutes.push_back (*i);
-          NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i); 
         }
+      allRoutes.push_back (i->entry);
+      NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << i->entry);
+    }
+  LookupComputedRoutes (Ipv4GlobalFib::HOST_ROUTE, dest, sharedMatches);
+  for (SharedVec_t::const_iterator i = sharedMatches.begin (); i != sharedMatches.end (); i++)
+    {
+      if (oif != 0 && oif != m_ipv4->GetNetDevice (i->GetInterface ()))
+        {
+          NS_LOG_LOGIC ("Not on requested interface, skipping");
+          continue;
+        }
+      allRoutes.push_back (&*i);
+      NS_LOG_LOGIC (allRoutes.size () << "Found shared host route" << *i);
     }
   if (allRoutes.size () == 0) // if no host route is found
     {
       NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
-           j++) 
+      matches.clear ();
+      m_networkTrie.Lookup (dest, matches);
+      for (MatchVec_t::const_iterator j = matches.begin (); j != matches.end (); j++)
         {
-          Ipv4Mask mask = (*j)->GetDestNetworkMask ();
-          Ipv4Address entry = (*j)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry)) 
+          if (oif != 0)
             {
-              if (oif != 0)
+              if (oif != m_ipv4->GetNetDevice (j->entry->GetInterface ()))
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
-                    {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
-                    }
+                  NS_LOG_LOGIC ("Not on requested interface, skipping");
+                  continue;
                 }
-              allRoutes.push_back (*j);
-              NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
             }
+          allRoutes.push_back (j->entry);
+          NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << j->entry);
+        }
+      sharedMatches.clear ();
+      LookupComputedRoutes (Ipv4GlobalFib::NETWORK_ROUTE, dest, sharedMatches);
+      for (SharedVec_t::const_iterator j = sharedMatches.begin (); j != sharedMatches.end (); j++)
+        {
+          if (oif != 0 && oif != m_ipv4->GetNetDevice (j->GetInterface ()))
+            {
+              NS_LOG_LOGIC ("Not on requested interface, skipping");
+              continue;
+            }
+          allRoutes.push_back (&*j);
+          NS_LOG_LOGIC (allRoutes.size () << "Found shared network route" << *j);
         }
     }
   if (allRoutes.size () == 0)  // consider external if no host/network found
     {
-      for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
-           k != m_ASexternalRoutes.end ();
-           k++)
+      matches.clear ();
+      m_ASexternalTrie.Lookup (dest, matches);
+      for (MatchVec_t::const_iterator k = matches.begin (); k != matches.end (); k++)
         {
-          Ipv4Mask mask = (*k)->GetDestNetworkMask ();
-          Ipv4Address entry = (*k)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry))
+          NS_LOG_LOGIC ("Found external route" << k->entry);
+          if (oif != 0)
             {
-              NS_LOG_LOGIC ("Found external route" << *k);
-              if (oif != 0)
+              if (oif != m_ipv4->GetNetDevice (k->entry->GetInterface ()))
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
-                    {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
-                    }
+                  NS_LOG_LOGIC ("Not on requested interface, skipping");
+                  continue;
                 }
-              allRoutes.push_back (*k);
-              break;
             }
+          allRoutes.push_back (k->entry);
+          break;
+        }
+    }
+  if (allRoutes.size () == 0)
+    {
+      sharedMatches.clear ();
+      LookupComputedRoutes (Ipv4GlobalFib::EXTERNAL_ROUTE, dest, sharedMatches);
+      for (SharedVec_t::const_iterator k = sharedMatches.begin (); k != sharedMatches.end (); k++)
+        {
+          NS_LOG_LOGIC ("Found shared external route" << *k);
+          if (oif != 0 && oif != m_ipv4->GetNetDevice (k->GetInterface ()))
+            {
+              NS_LOG_LOGIC ("Not on requested interface, skipping");
+              continue;
+            }
+          allRoutes.push_back (&*k);
+          break;
         }
     }
   if (allRoutes.size () > 0 ) // if route(s) is found
     {
-      // pick up one of the routes uniformly at random if random
-      // ECMP routing is enabled, or always select the first route
-      // consistently if random ECMP routing is disabled
+      // pick up one of the routes by the hash of the flow if flow ECMP
+      // routing is enabled, at random if random ECMP routing is enabled,
+      // or always select the first route consistently otherwise
       uint32_t selectIndex;
-      if (m_randomEcmpRouting)
+      if (m_flowEcmpRouting || m_randomEcmpRouting)
         {
-          selectIndex = m_rand->GetInteger (0, allRoutes.size ()-1);
+          // there is nothing to hash the flow for if a single route matches
+          uint32_t flowHash = allRoutes.size () > 1 ? GetFlowHash (p, header, withPorts) : 0;
+          selectIndex = SelectEcmpRoute (allRoutes, flowHash);
         }
       else 
         {
           selectIndex = 0;
         }
-      Ipv4RoutingTableEntry* route = allRoutes.at (selectIndex); 
+      const Ipv4RoutingTableEntry &route = *allRoutes.at (selectIndex);
       // create a Ipv4Route object from the selected routing table entry
       rtentry = Create<Ipv4Route> ();
-      rtentry->SetDestination (route->GetDest ());
+      rtentry->SetDestination (route.GetDest ());
       /// \todo handle multi-address case
-      rtentry->SetSource (m_ipv4->GetAddress (route->GetInterface (), 0).GetLocal ());
-      rtentry->SetGateway (route->GetGateway ());
-      uint32_t interfaceIdx = route->GetInterface ();
+      rtentry->SetSource (m_ipv4->GetAddress (route.GetInterface (), 0).GetLocal ());
+      rtentry->SetGateway (route.GetGateway ());
+      uint32_t interfaceIdx = route.GetInterface ();
       rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
       return rtentry;
     }
@@ -252,6 +495,8 @@ Ipv4GlobalRouting::GetNRoutes (void) const
   n += m_hostRoutes.size ();
   n += m_networkRoutes.size ();
   n += m_ASexternalRoutes.size ();
+  UpdateSharedRoutes ();
+  n += m_sharedRoutes.size ();
   return n;
 }
 
@@ -300,6 +545,12 @@ Ipv4GlobalRouting::GetRoute (uint32_t index) const
         }
       tmp++;
     }
+  index -= m_ASexternalRoutes.size ();
+  UpdateSharedRoutes ();
+  if (index < m_sharedRoutes.size ())
+    {
+      return &m_sharedRoutes[index];
+    }
   NS_ASSERT (false);
   // quiet compiler.
   return 0;
@@ -308,6 +559,7 @@ void
 Ipv4GlobalRouting::RemoveRoute (uint32_t index)
 {
   NS_LOG_FUNCTION (this << index);
+  m_routeTriesStale = true;
   if (index < m_hostRoutes.size ())
     {
       uint32_t tmp = 0;
@@ -358,6 +610,14 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
         }
       tmp++;
     }
+  index -= m_ASexternalRoutes.size ();
+  if (m_sharedTable != 0)
+    {
+      NS_LOG_LOGIC ("Removing shared route " << index);
+      m_sharedTable->RemoveRoute (m_sharedTableId, index);
+      return;
+    }
+  NS_ASSERT_MSG (m_routeCache == 0, "Routes computed on demand cannot be removed");
   NS_ASSERT (false);
 }
 
@@ -391,6 +651,12 @@ Ipv4GlobalRouting::DoDispose (void)
     {
       delete (*l);
     }
+  m_hostTrie.Clear ();
+  m_networkTrie.Clear ();
+  m_ASexternalTrie.Clear ();
+  m_sharedTable = 0;
+  m_routeCache = 0;
+  m_sharedRoutes.clear ();
 
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -460,7 +726,8 @@ Ipv4GlobalRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<Net
 // See if this is a unicast packet we have a route for.
 //
   NS_LOG_LOGIC ("Unicast destination- looking up");
-  Ptr<Ipv4Route> rtentry = LookupGlobal (header.GetDestination (), oif);
+  // the packet does not carry its transport header yet
+  Ptr<Ipv4Route> rtentry = LookupGlobal (p, header, false, oif);
   if (rtentry)
     {
       sockerr = Socket::ERROR_NOTERROR;
@@ -537,7 +804,7 @@ Ipv4GlobalRouting::RouteInput  (Ptr<const Packet> p, const Ipv4Header &header, P
     }
   // Next, try to find a route
   NS_LOG_LOGIC ("Unicast destination- looking up global route");
-  Ptr<Ipv4Route> rtentry = LookupGlobal (header.GetDestination ());
+  Ptr<Ipv4Route> rtentry = LookupGlobal (p, header, true);
   if (rtentry != 0)
     {
       NS_LOG_LOGIC ("Found unicast destination- calling unicast callback");
@@ -557,9 +824,7 @@ Ipv4GlobalRouting::NotifyInterfaceUp (uint32_t i)
   NS_LOG_FUNCTION (this << i);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::UpdateRoutes ();
     }
 }
 
@@ -569,9 +834,7 @@ Ipv4GlobalRouting::NotifyInterfaceDown (uint32_t i)
   NS_LOG_FUNCTION (this << i);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::UpdateRoutes ();
     }
 }
 
@@ -581,9 +844,7 @@ Ipv4GlobalRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress ad
   NS_LOG_FUNCTION (this << interface << address);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::UpdateRoutes ();
     }
 }
 
@@ -593,9 +854,7 @@ Ipv4GlobalRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
   NS_LOG_FUNCTION (this << interface << address);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      GlobalRouteManager::UpdateRoutes ();
     }
 }
 
@@ -605,6 +864,9 @@ Ipv4GlobalRouting::SetIpv4 (Ptr<Ipv4> ipv4)
   NS_LOG_FUNCTION (this << ipv4);
   NS_ASSERT (m_ipv4 == 0 && ipv4 != 0);
   m_ipv4 = ipv4;
+  // look the node id up once rather than for each hashed packet
+  Ptr<Node> node = m_ipv4->GetObject<Node> ();
+  m_nodeId = node != 0 ? node->GetId () : 0;
 }
 
 
@@ -28,6 +28,9 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ipv4-route-trie.h"
+#include "ipv4-global-fib.h"
+#include "ipv4-global-route-cache.h"
 
 namespace ns3 {
 
@@ -63,6 +66,12 @@ class Node;
  *
  * This class deals with Ipv4 unicast routes only.
  *
+ * When several routes of equal cost lead to a destination, the first one
+ * is used, unless RandomEcmpRouting picks one at random for each packet,
+ * or FlowEcmpRouting picks one by a hash of the 5-tuple of the packet,
+ * which keeps the packets of a flow in order.  The routes are weighted by
+ * the weights of their interfaces, see SetEcmpWeight.
+ *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
  */
@@ -216,6 +225,60 @@ public:
    */
   void RemoveRoute (uint32_t i);
 
+  /**
+   * \brief Look up the routes computed by the GlobalRouteManager in a
+   * table shared by all the nodes.
+   *
+   * The routes of the shared table come after the routes added to this
+   * object in GetRoute (); GetRoute () returns copies of them.
+   *
+   * \param table the shared table, or 0 to stop using one
+   * \param id the id of this node in the table
+   */
+  void SetSharedTable (Ptr<Ipv4GlobalFib> table, uint32_t id);
+
+  /**
+   * \return the shared table the routes are looked up in, if any
+   */
+  Ptr<Ipv4GlobalFib> GetSharedTable (void) const;
+
+  /**
+   * \brief Look up the routes computed by the GlobalRouteManager in a
+   * cache computing them the first time they are needed.
+   *
+   * The routes of the cache come after the routes added to this object
+   * in GetRoute (); asking for them computes all the routes of the node.
+   * They cannot be removed.
+   *
+   * \param cache the route cache, or 0 to stop using one
+   * \param id the id of this node in the cache
+   */
+  void SetRouteCache (Ptr<Ipv4GlobalRouteCache> cache, uint32_t id);
+
+  /**
+   * \return the route cache the routes are looked up in, if any
+   */
+  Ptr<Ipv4GlobalRouteCache> GetRouteCache (void) const;
+
+  /**
+   * \brief Set the weight of an interface among equal-cost routes
+   *
+   * With RandomEcmpRouting or FlowEcmpRouting, a route is picked among
+   * the equal-cost routes with a probability proportional to the weight
+   * of its output interface, 1 by default.  This spreads the load of a
+   * node unevenly, e.g. over the uplinks of an asymmetric Clos network.
+   *
+   * \param interface the interface index
+   * \param weight the weight of the interface, at least 1
+   */
+  void SetEcmpWeight (uint32_t interface, uint32_t weight);
+
+  /**
+   * \param interface the interface index
+   * \return the weight of the interface among equal-cost routes
+   */
+  uint32_t GetEcmpWeight (uint32_t interface) const;
+
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model.  Return the number of streams (possibly zero) that
@@ -232,6 +295,12 @@ protected:
 private:
   /// Set to true if packets are randomly routed among ECMP; set to false for using only one route consistently
   bool m_randomEcmpRouting;
+  /// Set to true if packets are routed among ECMP by a hash of their flow
+  bool m_flowEcmpRouting;
+  /// Seed of the flow hash
+  uint32_t m_ecmpHashSeed;
+  /// Weights of the interfaces among ECMP, 1 if missing
+  std::vector<uint32_t> m_ecmpWeights;
   /// Set to true if this interface should respond to interface events by globallly recomputing routes 
   bool m_respondToInterfaceEvents;
   /// A uniform random number generator for randomly routing packets among ECMP 
@@ -258,13 +327,96 @@ private:
   /// iterator of container of Ipv4RoutingTableEntry (routes to external AS)
   typedef std::list<Ipv4RoutingTableEntry *>::iterator ASExternalRoutesI;
 
-  Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
+  /**
+   * \brief Lookup in the forwarding table for the destination of a packet.
+   *
+   * The flow of the packet is only hashed if several equal-cost routes
+   * match its destination.
+   *
+   * \param p the packet, see GetFlowHash
+   * \param header the IPv4 header of the packet
+   * \param withPorts false if the packet does not start with its
+   * transport header
+   * \param oif output interface if any (put 0 otherwise)
+   * \return Ipv4Route to route the packet to reach its destination
+   */
+  Ptr<Ipv4Route> LookupGlobal (Ptr<const Packet> p, const Ipv4Header &header, bool withPorts,
+                               Ptr<NetDevice> oif = 0);
+
+  /**
+   * \brief Hash the flow of a packet, to pick one of equal-cost routes
+   *
+   * The flow is the 5-tuple of the packet, or its addresses and protocol
+   * only for fragments and protocols without ports.  The seed and the id
+   * of the node are hashed too, so that successive nodes do not make
+   * correlated choices.
+   *
+   * \param p the packet, starting with its transport header, if any
+   * \param header the IPv4 header of the packet
+   * \param withPorts false if the packet does not start with its
+   * transport header
+   * \return the hash of the flow
+   */
+  uint32_t GetFlowHash (Ptr<const Packet> p, const Ipv4Header &header, bool withPorts);
+
+  /**
+   * \brief Pick one of equal-cost routes according to the weights of
+   * their interfaces
+   * \param routes the routes
+   * \param flowHash the hash of the flow of the packet
+   * \return the index of the route picked
+   */
+  uint32_t SelectEcmpRoute (const std::vector<const Ipv4RoutingTableEntry *> &routes, uint32_t flowHash);
+
+  /**
+   * \brief Rebuild the route tries from the route lists if a route was
+   * removed since they were last built.
+   */
+  void UpdateRouteTries (void);
 
   HostRoutes m_hostRoutes;             //!< Routes to hosts
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  Ipv4RouteTrie m_hostTrie;            //!< Index of m_hostRoutes
+  Ipv4RouteTrie m_networkTrie;         //!< Index of m_networkRoutes
+  Ipv4RouteTrie m_ASexternalTrie;      //!< Index of m_ASexternalRoutes
+  bool m_routeTriesStale;              //!< The tries must be rebuilt before use
+
+  /// Routes found by LookupGlobal, kept to reuse their storage
+  std::vector<const Ipv4RoutingTableEntry *> m_allRoutes;
+  /// Routes of the tries matching the destination in LookupGlobal
+  std::vector<Ipv4RouteTrie::Route> m_matches;
+  /// Routes of the shared table or of the route cache matching the destination in LookupGlobal
+  std::vector<Ipv4RoutingTableEntry> m_sharedMatches;
+
+  /**
+   * \brief Copy the routes of the shared table or of the route cache in
+   * m_sharedRoutes if they changed.
+   */
+  void UpdateSharedRoutes (void) const;
+
+  /**
+   * \brief Look up the routes of the shared table or of the route cache
+   * \param type the kind of routes to look for
+   * \param dest the destination
+   * \param routes the matching routes are appended to this vector
+   */
+  void LookupComputedRoutes (Ipv4GlobalFib::RouteType type, Ipv4Address dest,
+                             std::vector<Ipv4RoutingTableEntry> &routes);
+
+  Ptr<Ipv4GlobalFib> m_sharedTable;    //!< Table shared by all the nodes
+  Ptr<Ipv4GlobalRouteCache> m_routeCache; //!< Routes computed on demand
+  uint32_t m_sharedTableId;            //!< Id of this node in m_sharedTable or m_routeCache
+  /// Copies of the routes of the shared table or of the route cache, for GetRoute ()
+  mutable std::vector<Ipv4RoutingTableEntry> m_sharedRoutes;
+  /// Version of the shared table copied in m_sharedRoutes
+  mutable uint32_t m_sharedRoutesVersion;
+  /// m_sharedRoutes is not a copy of the routes of m_sharedTable
+  mutable bool m_sharedRoutesStale;
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
+  uint32_t m_nodeId; //!< id of the node of m_ipv4, hashed with the flows
 };
 
 } // Namespace ns3
@@ -41,6 +41,7 @@ Ipv4Header::Ipv4Header ()
     m_fragmentOffset (0),
     m_checksum (0),
     m_goodChecksum (true),
+    m_checksumValid (false),
     m_headerSize(5*4)
 {
 }
@@ -56,7 +57,9 @@ void
 Ipv4Header::SetPayloadSize (uint16_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  uint16_t old = GetHeaderWord (1);
   m_payloadSize = size;
+  UpdateChecksum (old, GetHeaderWord (1));
 }
 uint16_t
 Ipv4Header::GetPayloadSize (void) const
@@ -75,30 +78,38 @@ void
 Ipv4Header::SetIdentification (uint16_t identification)
 {
   NS_LOG_FUNCTION (this << identification);
+  uint16_t old = GetHeaderWord (2);
   m_identification = identification;
+  UpdateChecksum (old, GetHeaderWord (2));
 }
 
 void 
 Ipv4Header::SetTos (uint8_t tos)
 {
   NS_LOG_FUNCTION (this << static_cast<uint32_t> (tos));
+  uint16_t old = GetHeaderWord (0);
   m_tos = tos;
+  UpdateChecksum (old, GetHeaderWord (0));
 }
 
 void
 Ipv4Header::SetDscp (DscpType dscp)
 {
   NS_LOG_FUNCTION (this << dscp);
+  uint16_t old = GetHeaderWord (0);
   m_tos &= 0x3; // Clear out the DSCP part, retain 2 bits of ECN
   m_tos |= dscp;
+  UpdateChecksum (old, GetHeaderWord (0));
 }
 
 void
 Ipv4Header::SetEcn (EcnType ecn)
 {
   NS_LOG_FUNCTION (this << ecn);
+  uint16_t old = GetHeaderWord (0);
   m_tos &= 0xFC; // Clear out the ECN part, retain 6 bits of DSCP
   m_tos |= ecn;
+  UpdateChecksum (old, GetHeaderWord (0));
 }
 
 Ipv4Header::DscpType 
@@ -200,13 +211,17 @@ void
 Ipv4Header::SetMoreFragments (void)
 {
   NS_LOG_FUNCTION (this);
+  uint16_t old = GetHeaderWord (3);
   m_flags |= MORE_FRAGMENTS;
+  UpdateChecksum (old, GetHeaderWord (3));
 }
 void
 Ipv4Header::SetLastFragment (void)
 {
   NS_LOG_FUNCTION (this);
+  uint16_t old = GetHeaderWord (3);
   m_flags &= ~MORE_FRAGMENTS;
+  UpdateChecksum (old, GetHeaderWord (3));
 }
 bool 
 Ipv4Header::IsLastFragment (void) const
@@ -219,13 +234,17 @@ void
 Ipv4Header::SetDontFragment (void)
 {
   NS_LOG_FUNCTION (this);
+  uint16_t old = GetHeaderWord (3);
   m_flags |= DONT_FRAGMENT;
+  UpdateChecksum (old, GetHeaderWord (3));
 }
 void 
 Ipv4Header::SetMayFragment (void)
 {
   NS_LOG_FUNCTION (this);
+  uint16_t old = GetHeaderWord (3);
   m_flags &= ~DONT_FRAGMENT;
+  UpdateChecksum (old, GetHeaderWord (3));
 }
 bool 
 Ipv4Header::IsDontFragment (void) const
@@ -240,7 +259,9 @@ Ipv4Header::SetFragmentOffset (uint16_t offsetBytes)
   NS_LOG_FUNCTION (this << offsetBytes);
   // check if the user is trying to set an invalid offset
   NS_ABORT_MSG_IF ((offsetBytes & 0x7), "offsetBytes must be multiple of 8 bytes");
+  uint16_t old = GetHeaderWord (3);
   m_fragmentOffset = offsetBytes;
+  UpdateChecksum (old, GetHeaderWord (3));
 }
 uint16_t 
 Ipv4Header::GetFragmentOffset (void) const
@@ -259,7 +280,9 @@ void
 Ipv4Header::SetTtl (uint8_t ttl)
 {
   NS_LOG_FUNCTION (this << static_cast<uint32_t> (ttl));
+  uint16_t old = GetHeaderWord (4);
   m_ttl = ttl;
+  UpdateChecksum (old, GetHeaderWord (4));
 }
 uint8_t 
 Ipv4Header::GetTtl (void) const
@@ -278,14 +301,20 @@ void
 Ipv4Header::SetProtocol (uint8_t protocol)
 {
   NS_LOG_FUNCTION (this << static_cast<uint32_t> (protocol));
+  uint16_t old = GetHeaderWord (4);
   m_protocol = protocol;
+  UpdateChecksum (old, GetHeaderWord (4));
 }
 
 void 
 Ipv4Header::SetSource (Ipv4Address source)
 {
   NS_LOG_FUNCTION (this << source);
+  uint16_t old0 = GetHeaderWord (6);
+  uint16_t old1 = GetHeaderWord (7);
   m_source = source;
+  UpdateChecksum (old0, GetHeaderWord (6));
+  UpdateChecksum (old1, GetHeaderWord (7));
 }
 Ipv4Address
 Ipv4Header::GetSource (void) const
@@ -298,7 +327,11 @@ void
 Ipv4Header::SetDestination (Ipv4Address dst)
 {
   NS_LOG_FUNCTION (this << dst);
+  uint16_t old0 = GetHeaderWord (8);
+  uint16_t old1 = GetHeaderWord (9);
   m_destination = dst;
+  UpdateChecksum (old0, GetHeaderWord (8));
+  UpdateChecksum (old1, GetHeaderWord (9));
 }
 Ipv4Address
 Ipv4Header::GetDestination (void) const
@@ -315,6 +348,71 @@ Ipv4Header::IsChecksumOk (void) const
   return m_goodChecksum;
 }
 
+uint16_t
+Ipv4Header::GetHeaderWord (uint8_t index) const
+{
+  switch (index)
+    {
+    case 0:
+      return ((4 << 4 | 5) << 8) | m_tos;
+    case 1:
+      return m_payloadSize + 5*4;
+    case 2:
+      return m_identification;
+    case 3:
+      {
+        uint16_t word = (m_fragmentOffset / 8) & 0x1fff;
+        if (m_flags & DONT_FRAGMENT)
+          {
+            word |= (1<<14);
+          }
+        if (m_flags & MORE_FRAGMENTS)
+          {
+            word |= (1<<13);
+          }
+        return word;
+      }
+    case 4:
+      return (m_ttl << 8) | m_protocol;
+    case 6:
+      return m_source.Get () >> 16;
+    case 7:
+      return m_source.Get () & 0xffff;
+    case 8:
+      return m_destination.Get () >> 16;
+    case 9:
+      return m_destination.Get () & 0xffff;
+    default:
+      return 0;
+    }
+}
+
+uint16_t
+Ipv4Header::CalculateChecksum (void) const
+{
+  uint32_t sum = 0;
+  for (uint8_t index = 0; index < 10; index++)
+    {
+      sum += GetHeaderWord (index);
+    }
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum += sum >> 16;
+  return ~sum & 0xffff;
+}
+
+void
+Ipv4Header::UpdateChecksum (uint16_t oldWord, uint16_t newWord)
+{
+  if (!m_checksumValid || oldWord == newWord)
+    {
+      return;
+    }
+  uint32_t sum = (~m_checksum & 0xffff) + (~oldWord & 0xffff) + newWord;
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum += sum >> 16;
+  m_checksum = ~sum & 0xffff;
+}
+
 TypeId 
 Ipv4Header::GetTypeId (void)
 {
@@ -405,19 +503,23 @@ Ipv4Header::Serialize (Buffer::Iterator start) const
   i.WriteU8 (frag);
   i.WriteU8 (m_ttl);
   i.WriteU8 (m_protocol);
-  i.WriteHtonU16 (0);
-  i.WriteHtonU32 (m_source.Get ());
-  i.WriteHtonU32 (m_destination.Get ());
-
-  if (m_calcChecksum) 
+  if (!m_calcChecksum)
     {
-      i = start;
-      uint16_t checksum = i.CalculateIpChecksum (20);
+      i.WriteHtonU16 (0);
+    }
+  else if (m_checksumValid)
+    {
+      i.WriteHtonU16 (m_checksum);
+    }
+  else
+    {
+      // summed from the fields rather than read back from the buffer
+      uint16_t checksum = CalculateChecksum ();
       NS_LOG_LOGIC ("checksum=" <<checksum);
-      i = start;
-      i.Next (10);
-      i.WriteU16 (checksum);
+      i.WriteHtonU16 (checksum);
     }
+  i.WriteHtonU32 (m_source.Get ());
+  i.WriteHtonU32 (m_destination.Get ());
 }
 uint32_t
 Ipv4Header::Deserialize (Buffer::Iterator start)
@@ -449,7 +551,7 @@ Ipv4Header::Deserialize (Buffer::Iterator start)
   m_fragmentOffset <<= 3;
   m_ttl = i.ReadU8 ();
   m_protocol = i.ReadU8 ();
-  m_checksum = i.ReadU16 ();
+  m_checksum = i.ReadNtohU16 ();
   /* i.Next (2); // checksum */
   m_source.Set (i.ReadNtohU32 ());
   m_destination.Set (i.ReadNtohU32 ());
@@ -463,6 +565,8 @@ Ipv4Header::Deserialize (Buffer::Iterator start)
 
       m_goodChecksum = (checksum == 0);
     }
+  // the options are not serialized again, so their checksum is of no use
+  m_checksumValid = m_calcChecksum && m_goodChecksum && headerSize == 5*4;
   return GetSerializedSize ();
 }
 
@@ -37,6 +37,11 @@ public:
   Ipv4Header ();
   /**
    * \brief Enable checksum calculation for this header.
+   *
+   * A header deserialized with a correct checksum keeps that checksum,
+   * and the setters update it incrementally as per \RFC{1624}, so that
+   * forwarding a packet (TTL decrement, ECN marking, address rewrites)
+   * does not sum the whole header again.
    */
   void EnableChecksum (void);
   /**
@@ -240,6 +245,27 @@ private:
     MORE_FRAGMENTS = (1<<1)
   };
 
+  /**
+   * \brief Get a 16-bit word of the header, as serialized
+   * \param index the index of the word, the checksum word reading as zero
+   * \return the word, in host order
+   */
+  uint16_t GetHeaderWord (uint8_t index) const;
+  /**
+   * \brief Calculate the checksum of the header from its fields
+   * \return the checksum, in host order
+   */
+  uint16_t CalculateChecksum (void) const;
+  /**
+   * \brief Update the checksum after a word of the header changed
+   *
+   * This is equation 3 of \RFC{1624}, HC' = ~(~HC + ~m + m').
+   *
+   * \param oldWord the previous value of the word, in host order
+   * \param newWord the new value of the word, in host order
+   */
+  void UpdateChecksum (uint16_t oldWord, uint16_t newWord);
+
   bool m_calcChecksum; //!< true if the checksum must be calculated
 
   uint16_t m_payloadSize; //!< payload size
@@ -253,6 +279,7 @@ private:
   Ipv4Address m_destination; //!< destination address
   uint16_t m_checksum; //!< checksum
   bool m_goodChecksum; //!< true if checksum is correct
+  bool m_checksumValid; //!< true if m_checksum matches the fields, in host order
   uint16_t m_headerSize; //!< IP header size
 };
 
@@ -27,6 +27,7 @@
 #include "ns3/net-device.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
+#include "ns3/packet-batch.h"
 #include "ns3/node.h"
 #include "ns3/pointer.h"
 
@@ -284,6 +285,49 @@ Ipv4Interface::Send (Ptr<Packet> p, Ipv4Address dest)
     }
 }
 
+void
+Ipv4Interface::SendBatch (Ptr<PacketBatch> batch, Ipv4Address dest)
+{
+  NS_LOG_FUNCTION (this << batch << dest);
+  if (!IsUp ())
+    {
+      return;
+    }
+  bool batched = !DynamicCast<LoopbackNetDevice> (m_device);
+  for (Ipv4InterfaceAddressListCI i = m_ifaddrs.begin (); i != m_ifaddrs.end (); ++i)
+    {
+      if (dest == (*i).GetLocal ())
+        {
+          batched = false;
+          break;
+        }
+    }
+  Address hardwareDestination = m_device->GetBroadcast ();
+  if (batched && m_device->NeedsArp ())
+    {
+      // only a unicast next hop already resolved is sent the batch at once
+      ArpCache::Entry *entry = dest.IsBroadcast () || dest.IsMulticast () ? 0 : m_cache->Lookup (dest);
+      if (entry != 0 && entry->IsAlive () && !entry->IsExpired ())
+        {
+          hardwareDestination = entry->GetMacAddress ();
+        }
+      else
+        {
+          batched = false;
+        }
+    }
+  if (!batched)
+    {
+      for (std::vector<Ptr<Packet> >::const_iterator i = batch->Begin (); i != batch->End (); i++)
+        {
+          Send (*i, dest);
+        }
+      return;
+    }
+  NS_LOG_LOGIC ("Send " << batch->GetNPackets () << " packets at once");
+  m_device->SendBatch (batch, hardwareDestination, Ipv4L3Protocol::PROT_NUMBER);
+}
+
 uint32_t
 Ipv4Interface::GetNAddresses (void) const
 {
@@ -32,6 +32,7 @@ namespace ns3 {
 
 class NetDevice;
 class Packet;
+class PacketBatch;
 class Node;
 class ArpCache;
 
@@ -146,6 +147,16 @@ public:
    */ 
   void Send (Ptr<Packet> p, Ipv4Address dest);
 
+  /**
+   * \param batch packets to send back to back
+   * \param dest next hop address of the packets.
+   *
+   * The batch is given to the device in one call when the hardware
+   * address of the next hop is known, and each packet is sent with
+   * Send () otherwise.
+   */
+  void SendBatch (Ptr<PacketBatch> batch, Ipv4Address dest);
+
   /**
    * \param address The Ipv4InterfaceAddress to add to the interface
    * \returns true if succeeded
@@ -18,7 +18,9 @@
 // Author: George F. Riley<riley@ece.gatech.edu>
 //
 
+#include <algorithm>
 #include "ns3/packet.h"
+#include "ns3/packet-batch.h"
 #include "ns3/log.h"
 #include "ns3/callback.h"
 #include "ns3/ipv4-address.h"
@@ -39,6 +41,8 @@
 #include "icmpv4-l4-protocol.h"
 #include "ipv4-interface.h"
 #include "ipv4-raw-socket-impl.h"
+#include "tcp-header.h"
+#include "tcp-segment-offload-tag.h"
 
 namespace ns3 {
 
@@ -73,6 +77,12 @@ Ipv4L3Protocol::GetTypeId (void)
                    TimeValue (Seconds (30)),
                    MakeTimeAccessor (&Ipv4L3Protocol::m_fragmentExpirationTimeout),
                    MakeTimeChecker ())
+    .AddAttribute ("FragmentsMaxBytes",
+                   "The maximum number of bytes held by the fragments waiting "
+                   "for reassembly. Beyond it, the oldest packets are discarded.",
+                   UintegerValue (4194304),
+                   MakeUintegerAccessor (&Ipv4L3Protocol::m_fragmentsMaxBytes),
+                   MakeUintegerChecker<uint32_t> ())
     .AddTraceSource ("Tx",
                      "Send ipv4 packet to outgoing interface.",
                      MakeTraceSourceAccessor (&Ipv4L3Protocol::m_txTrace),
@@ -112,6 +122,7 @@ Ipv4L3Protocol::GetTypeId (void)
 }
 
 Ipv4L3Protocol::Ipv4L3Protocol()
+  : m_fragmentsBytes (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -237,19 +248,13 @@ Ipv4L3Protocol::DoDispose (void)
 
   for (MapFragments_t::iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
     {
+      it->second->m_timeout.Cancel ();
       it->second = 0;
     }
 
-  for (MapFragmentsTimers_t::iterator it = m_fragmentsTimers.begin (); it != m_fragmentsTimers.end (); it++)
-    {
-      if (it->second.IsRunning ())
-        {
-          it->second.Cancel ();
-        }
-    }
-
   m_fragments.clear ();
-  m_fragmentsTimers.clear ();
+  m_fragmentsAge.clear ();
+  m_fragmentsBytes = 0;
 
   Object::DoDispose ();
 }
@@ -810,7 +815,17 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to gateway " << route->GetGateway ());
-          if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () )
+          Ptr<PacketBatch> segments = Create<PacketBatch> ();
+          if (packet->GetSize () > outInterface->GetDevice ()->GetMtu ()
+              && DoSegmentation (packet, outInterface->GetDevice ()->GetMtu (), segments))
+            {
+              for (std::vector<Ptr<Packet> >::const_iterator it = segments->Begin (); it != segments->End (); it++)
+                {
+                  m_txTrace (*it, m_node->GetObject<Ipv4> (), interface);
+                }
+              outInterface->SendBatch (segments, route->GetGateway ());
+            }
+          else if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () )
             {
               std::list<Ptr<Packet> > listFragments;
               DoFragmentation (packet, outInterface->GetDevice ()->GetMtu (), listFragments);
@@ -839,7 +854,17 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to destination " << ipHeader.GetDestination ());
-          if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () )
+          Ptr<PacketBatch> segments = Create<PacketBatch> ();
+          if (packet->GetSize () > outInterface->GetDevice ()->GetMtu ()
+              && DoSegmentation (packet, outInterface->GetDevice ()->GetMtu (), segments))
+            {
+              for (std::vector<Ptr<Packet> >::const_iterator it = segments->Begin (); it != segments->End (); it++)
+                {
+                  m_txTrace (*it, m_node->GetObject<Ipv4> (), interface);
+                }
+              outInterface->SendBatch (segments, ipHeader.GetDestination ());
+            }
+          else if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () )
             {
               std::list<Ptr<Packet> > listFragments;
               DoFragmentation (packet, outInterface->GetDevice ()->GetMtu (), listFragments);
@@ -866,6 +891,74 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
     }
 }
 
+bool
+Ipv4L3Protocol::DoSegmentation (Ptr<Packet> packet, uint32_t outIfaceMtu, Ptr<PacketBatch> segments)
+{
+  TcpSegmentOffloadTag tag;
+  if (!packet->PeekPacketTag (tag) || tag.GetSegmentSize () == 0)
+    {
+      return false;
+    }
+  NS_LOG_FUNCTION (this << *packet << outIfaceMtu << segments);
+
+  Ptr<Packet> p = packet->Copy ();
+  p->RemovePacketTag (tag);
+  Ipv4Header ipHeader;
+  p->RemoveHeader (ipHeader);
+  TcpHeader tcpHeader;
+  p->RemoveHeader (tcpHeader);
+
+  uint32_t segmentSize = tag.GetSegmentSize ();
+  uint32_t size = p->GetSize ();
+  for (uint32_t offset = 0; offset < size; offset += segmentSize)
+    {
+      uint32_t length = std::min (segmentSize, size - offset);
+      bool last = (offset + length == size);
+      Ptr<Packet> segment = p->CreateFragment (offset, length);
+
+      // only the last segment keeps the flags ending the super-segment
+      TcpHeader header = tcpHeader;
+      header.SetSequenceNumber (tcpHeader.GetSequenceNumber () + offset);
+      if (!last)
+        {
+          header.SetFlags (tcpHeader.GetFlags () & ~(TcpHeader::FIN | TcpHeader::PSH));
+        }
+      if (Node::ChecksumEnabled ())
+        {
+          header.EnableChecksums ();
+          header.InitializeChecksum (ipHeader.GetSource (), ipHeader.GetDestination (),
+                                     ipHeader.GetProtocol ());
+        }
+      segment->AddHeader (header);
+
+      TcpSegmentOffloadTag segmentTag;
+      segmentTag.SetLast (last);
+      segment->AddPacketTag (segmentTag);
+
+      Ipv4Header segmentHeader = BuildHeader (ipHeader.GetSource (), ipHeader.GetDestination (),
+                                              ipHeader.GetProtocol (), segment->GetSize (),
+                                              ipHeader.GetTtl (), ipHeader.GetTos (),
+                                              !ipHeader.IsDontFragment ());
+      segment->AddHeader (segmentHeader);
+
+      if (segment->GetSize () > outIfaceMtu)
+        {
+          std::list<Ptr<Packet> > listFragments;
+          DoFragmentation (segment, outIfaceMtu, listFragments);
+          for (std::list<Ptr<Packet> >::iterator it = listFragments.begin (); it != listFragments.end (); it++)
+            {
+              segments->AddPacket (*it);
+            }
+        }
+      else
+        {
+          segments->AddPacket (segment);
+        }
+    }
+  NS_LOG_LOGIC ("Split a super-segment of " << size << " bytes in " << segments->GetNPackets () << " packets");
+  return true;
+}
+
 // This function analogous to Linux ip_mr_forward()
 void
 Ipv4L3Protocol::IpMulticastForward (Ptr<Ipv4MulticastRoute> mrtentry, Ptr<const Packet> p, const Ipv4Header &header)
@@ -1342,6 +1435,16 @@ Ipv4L3Protocol::DoFragmentation (Ptr<Packet> packet, uint32_t outIfaceMtu, std::
   return;
 }
 
+size_t
+Ipv4L3Protocol::FragmentsKeyHash::operator() (const FragmentsKey_t &x) const
+{
+  uint64_t h = x.first ^ (static_cast<uint64_t> (x.second) * 0x9e3779b97f4a7c15ULL);
+  h ^= h >> 29;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 32;
+  return static_cast<size_t> (h);
+}
+
 bool
 Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint32_t iif)
 {
@@ -1349,23 +1452,30 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
 
   uint64_t addressCombination = uint64_t (ipHeader.GetSource ().Get ()) << 32 | uint64_t (ipHeader.GetDestination ().Get ());
   uint32_t idProto = uint32_t (ipHeader.GetIdentification ()) << 16 | uint32_t (ipHeader.GetProtocol ());
-  std::pair<uint64_t, uint32_t> key;
-  bool ret = false;
-  Ptr<Packet> p = packet->Copy ();
+  FragmentsKey_t key (addressCombination, idProto);
 
-  key.first = addressCombination;
-  key.second = idProto;
+  if (packet->GetSize () > m_fragmentsMaxBytes)
+    {
+      m_dropTrace (ipHeader, packet, DROP_FRAGMENT_MEMORY, m_node->GetObject<Ipv4> (), iif);
+      return false;
+    }
+  // Make room by discarding the oldest packets
+  while (!m_fragmentsAge.empty () && m_fragmentsBytes + packet->GetSize () > m_fragmentsMaxBytes)
+    {
+      NS_LOG_LOGIC ("Reassembly memory full, discarding the oldest fragmented packet");
+      DropFragments (m_fragmentsAge.front (), DROP_FRAGMENT_MEMORY);
+    }
 
   Ptr<Fragments> fragments;
 
   MapFragments_t::iterator it = m_fragments.find (key);
   if (it == m_fragments.end ())
     {
-      fragments = Create<Fragments> ();
+      fragments = Create<Fragments> (ipHeader, iif);
       m_fragments.insert (std::make_pair (key, fragments));
-      m_fragmentsTimers[key] = Simulator::Schedule (m_fragmentExpirationTimeout,
-                                                    &Ipv4L3Protocol::HandleFragmentsTimeout, this,
-                                                    key, ipHeader, iif);
+      fragments->m_age = m_fragmentsAge.insert (m_fragmentsAge.end (), key);
+      fragments->m_timeout = Simulator::Schedule (m_fragmentExpirationTimeout,
+                                                  &Ipv4L3Protocol::HandleFragmentsTimeout, this, key);
     }
   else
     {
@@ -1374,27 +1484,28 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
 
   NS_LOG_LOGIC ("Adding fragment - Size: " << packet->GetSize ( ) << " - Offset: " << (ipHeader.GetFragmentOffset ()) );
 
-  fragments->AddFragment (p, ipHeader.GetFragmentOffset (), !ipHeader.IsLastFragment () );
+  m_fragmentsBytes += fragments->AddFragment (packet->Copy (), ipHeader.GetFragmentOffset (), !ipHeader.IsLastFragment ());
 
   if ( fragments->IsEntire () )
     {
+      NS_LOG_LOGIC ("Stopping WaitFragmentsTimer at " << Simulator::Now ().GetSeconds () << " due to complete packet");
       packet = fragments->GetPacket ();
-      fragments = 0;
+      fragments->m_timeout.Cancel ();
+      m_fragmentsBytes -= fragments->GetSize ();
+      m_fragmentsAge.erase (fragments->m_age);
       m_fragments.erase (key);
-      if (m_fragmentsTimers[key].IsRunning ())
-        {
-          NS_LOG_LOGIC ("Stopping WaitFragmentsTimer at " << Simulator::Now ().GetSeconds () << " due to complete packet");
-          m_fragmentsTimers[key].Cancel ();
-        }
-      m_fragmentsTimers.erase (key);
-      ret = true;
+      return true;
     }
 
-  return ret;
+  return false;
 }
 
-Ipv4L3Protocol::Fragments::Fragments ()
-  : m_moreFragment (0)
+Ipv4L3Protocol::Fragments::Fragments (const Ipv4Header &ipHeader, uint32_t iif)
+  : m_ipHeader (ipHeader),
+    m_iif (iif),
+    m_lastFragment (false),
+    m_end (0),
+    m_size (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -1404,27 +1515,55 @@ Ipv4L3Protocol::Fragments::~Fragments ()
   NS_LOG_FUNCTION (this);
 }
 
-void
+uint32_t
 Ipv4L3Protocol::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment)
 {
   NS_LOG_FUNCTION (this << fragment << fragmentOffset << moreFragment);
 
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it;
+  uint32_t start = fragmentOffset;
+  uint32_t end = fragmentOffset + fragment->GetSize ();
+  if (!moreFragment)
+    {
+      m_lastFragment = true;
+      m_end = end;
+    }
 
-  for (it = m_fragments.begin (); it != m_fragments.end (); it++)
+  // The fragments might overlap in strange ways.  We do not overwrite the
+  // "old" with the "new" because we do not know when each arrived: only the
+  // bytes not received yet are kept.  This is different from what Linux does.
+  // It is not possible to emulate a fragmentation attack.
+  std::map<uint32_t, Ptr<Packet> >::iterator it = m_fragments.upper_bound (start);
+  if (it != m_fragments.begin ())
     {
-      if (it->second > fragmentOffset)
-        {
-          break;
-        }
+      std::map<uint32_t, Ptr<Packet> >::iterator prev = it;
+      prev--;
+      start = std::max (start, prev->first + prev->second->GetSize ());
     }
 
-  if (it == m_fragments.end ())
+  uint32_t added = 0;
+  while (start < end)
     {
-      m_moreFragment = moreFragment;
+      uint32_t pieceEnd = (it == m_fragments.end ()) ? end : std::min (end, it->first);
+      if (pieceEnd > start)
+        {
+          Ptr<Packet> piece = fragment;
+          if (start != fragmentOffset || pieceEnd != fragmentOffset + fragment->GetSize ())
+            {
+              piece = fragment->CreateFragment (start - fragmentOffset, pieceEnd - start);
+            }
+          m_fragments.insert (it, std::make_pair (start, piece));
+          added += pieceEnd - start;
+        }
+      if (it == m_fragments.end ())
+        {
+          break;
+        }
+      start = std::max (start, it->first + it->second->GetSize ());
+      it++;
     }
 
-  m_fragments.insert (it, std::pair<Ptr<Packet>, uint16_t> (fragment, fragmentOffset));
+  m_size += added;
+  return added;
 }
 
 bool
@@ -1432,29 +1571,14 @@ Ipv4L3Protocol::Fragments::IsEntire () const
 {
   NS_LOG_FUNCTION (this);
 
-  bool ret = !m_moreFragment && m_fragments.size () > 0;
-
-  if (ret)
+  // The fragments do not overlap: they cover the packet if their bytes add
+  // up to its size and none lies beyond its end
+  if (!m_lastFragment || m_size != m_end || m_fragments.empty ())
     {
-      uint16_t lastEndOffset = 0;
-
-      for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
-        {
-          // overlapping fragments do exist
-          NS_LOG_LOGIC ("Checking overlaps " << lastEndOffset << " - " << it->second );
-
-          if (lastEndOffset < it->second)
-            {
-              ret = false;
-              break;
-            }
-          // fragments might overlap in strange ways
-          uint16_t fragmentEnd = it->first->GetSize () + it->second;
-          lastEndOffset = std::max ( lastEndOffset, fragmentEnd );
-        }
+      return false;
     }
-
-  return ret;
+  std::map<uint32_t, Ptr<Packet> >::const_reverse_iterator last = m_fragments.rbegin ();
+  return last->first + last->second->GetSize () == m_end;
 }
 
 Ptr<Packet>
@@ -1462,34 +1586,15 @@ Ipv4L3Protocol::Fragments::GetPacket () const
 {
   NS_LOG_FUNCTION (this);
 
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin ();
+  std::map<uint32_t, Ptr<Packet> >::const_iterator it = m_fragments.begin ();
 
-  Ptr<Packet> p = it->first->Copy ();
-  uint16_t lastEndOffset = p->GetSize ();
+  Ptr<Packet> p = it->second->Copy ();
   it++;
 
   for ( ; it != m_fragments.end (); it++)
     {
-      if ( lastEndOffset > it->second )
-        {
-          // The fragments are overlapping.
-          // We do not overwrite the "old" with the "new" because we do not know when each arrived.
-          // This is different from what Linux does.
-          // It is not possible to emulate a fragmentation attack.
-          uint32_t newStart = lastEndOffset - it->second;
-          if ( it->first->GetSize () > newStart )
-            {
-              uint32_t newSize = it->first->GetSize () - newStart;
-              Ptr<Packet> tempFragment = it->first->CreateFragment (newStart, newSize);
-              p->AddAtEnd (tempFragment);
-            }
-        }
-      else
-        {
-          NS_LOG_LOGIC ("Adding: " << *(it->first) );
-          p->AddAtEnd (it->first);
-        }
-      lastEndOffset = p->GetSize ();
+      NS_LOG_LOGIC ("Adding: " << *(it->second) );
+      p->AddAtEnd (it->second);
     }
 
   return p;
@@ -1499,57 +1604,56 @@ Ptr<Packet>
 Ipv4L3Protocol::Fragments::GetPartialPacket () const
 {
   NS_LOG_FUNCTION (this);
-  
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin ();
 
   Ptr<Packet> p = Create<Packet> ();
-  uint16_t lastEndOffset = 0;
-
-  if ( m_fragments.begin ()->second > 0 )
-    {
-      return p;
-    }
+  uint32_t lastEndOffset = 0;
 
-  for ( it = m_fragments.begin (); it != m_fragments.end (); it++)
+  for (std::map<uint32_t, Ptr<Packet> >::const_iterator it = m_fragments.begin ();
+       it != m_fragments.end () && it->first == lastEndOffset; it++)
     {
-      if ( lastEndOffset > it->second )
-        {
-          uint32_t newStart = lastEndOffset - it->second;
-          uint32_t newSize = it->first->GetSize () - newStart;
-          Ptr<Packet> tempFragment = it->first->CreateFragment (newStart, newSize);
-          p->AddAtEnd (tempFragment);
-        }
-      else if ( lastEndOffset == it->second )
-        {
-          NS_LOG_LOGIC ("Adding: " << *(it->first) );
-          p->AddAtEnd (it->first);
-        }
+      NS_LOG_LOGIC ("Adding: " << *(it->second) );
+      p->AddAtEnd (it->second);
       lastEndOffset = p->GetSize ();
     }
 
   return p;
 }
 
+uint32_t
+Ipv4L3Protocol::Fragments::GetSize () const
+{
+  return m_size;
+}
+
+void
+Ipv4L3Protocol::HandleFragmentsTimeout (FragmentsKey_t key)
+{
+  NS_LOG_FUNCTION (this << &key);
+  DropFragments (key, DROP_FRAGMENT_TIMEOUT);
+}
+
 void
-Ipv4L3Protocol::HandleFragmentsTimeout (std::pair<uint64_t, uint32_t> key, Ipv4Header & ipHeader, uint32_t iif)
+Ipv4L3Protocol::DropFragments (FragmentsKey_t key, DropReason reason)
 {
-  NS_LOG_FUNCTION (this << &key << &ipHeader << iif);
+  NS_LOG_FUNCTION (this << &key << reason);
 
   MapFragments_t::iterator it = m_fragments.find (key);
-  Ptr<Packet> packet = it->second->GetPartialPacket ();
+  NS_ASSERT_MSG (it != m_fragments.end (), "No fragments for this key");
+  Ptr<Fragments> fragments = it->second;
+  Ptr<Packet> packet = fragments->GetPartialPacket ();
 
   // if we have at least 8 bytes, we can send an ICMP.
-  if ( packet->GetSize () > 8 )
+  if ( reason == DROP_FRAGMENT_TIMEOUT && packet->GetSize () > 8 )
     {
       Ptr<Icmpv4L4Protocol> icmp = GetIcmp ();
-      icmp->SendTimeExceededTtl (ipHeader, packet);
+      icmp->SendTimeExceededTtl (fragments->m_ipHeader, packet);
     }
-  m_dropTrace (ipHeader, packet, DROP_FRAGMENT_TIMEOUT, m_node->GetObject<Ipv4> (), iif);
+  m_dropTrace (fragments->m_ipHeader, packet, reason, m_node->GetObject<Ipv4> (), fragments->m_iif);
 
   // clear the buffers
-  it->second = 0;
-
-  m_fragments.erase (key);
-  m_fragmentsTimers.erase (key);
+  fragments->m_timeout.Cancel ();
+  m_fragmentsBytes -= fragments->GetSize ();
+  m_fragmentsAge.erase (fragments->m_age);
+  m_fragments.erase (it);
 }
 } // namespace ns3
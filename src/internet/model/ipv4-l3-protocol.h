@@ -34,12 +34,14 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
+#include "ns3/sgi-hashmap.h"
 
 class Ipv4L3ProtocolTestCase;
 
 namespace ns3 {
 
 class Packet;
+class PacketBatch;
 class NetDevice;
 class Ipv4Interface;
 class Ipv4Address;
@@ -100,7 +102,8 @@ public:
     DROP_BAD_CHECKSUM,   /**< Bad checksum */
     DROP_INTERFACE_DOWN,   /**< Interface is down so can not send packet */
     DROP_ROUTE_ERROR,   /**< Route error */
-    DROP_FRAGMENT_TIMEOUT /**< Fragment timeout exceeded */
+    DROP_FRAGMENT_TIMEOUT, /**< Fragment timeout exceeded */
+    DROP_FRAGMENT_MEMORY /**< Fragments discarded to bound the reassembly memory */
   };
 
   /**
@@ -408,6 +411,19 @@ private:
    */
   void DoFragmentation (Ptr<Packet> packet, uint32_t outIfaceMtu, std::list<Ptr<Packet> >& listFragments);
 
+  /**
+   * \brief Split a TCP super-segment in segments, see TcpSegmentOffloadTag
+   *
+   * Segments still larger than the MTU are fragmented.
+   *
+   * \param packet the packet, with its IP header
+   * \param outIfaceMtu the MTU of the interface
+   * \param segments the batch the segments are added to
+   * \return false if the packet is not a super-segment, in which case
+   *         nothing is added to the batch
+   */
+  bool DoSegmentation (Ptr<Packet> packet, uint32_t outIfaceMtu, Ptr<PacketBatch> segments);
+
   /**
    * \brief Process a packet fragment
    * \param packet the packet
@@ -417,13 +433,23 @@ private:
    */
   bool ProcessFragment (Ptr<Packet>& packet, Ipv4Header & ipHeader, uint32_t iif);
 
+  /**
+   * \brief Key of the fragments of a packet: (src, dst) and (identification, protocol)
+   */
+  typedef std::pair<uint64_t, uint32_t> FragmentsKey_t;
+
   /**
    * \brief Process the timeout for packet fragments
    * \param key representing the packet fragments
-   * \param ipHeader the IP header of the original packet
-   * \param iif Input Interface
    */
-  void HandleFragmentsTimeout ( std::pair<uint64_t, uint32_t> key, Ipv4Header & ipHeader, uint32_t iif);
+  void HandleFragmentsTimeout (FragmentsKey_t key);
+
+  /**
+   * \brief Discard the fragments of a packet
+   * \param key representing the packet fragments
+   * \param reason the reason reported by the drop trace
+   */
+  void DropFragments (FragmentsKey_t key, DropReason reason);
   
   /**
    * \brief Container of the IPv4 Interfaces.
@@ -470,14 +496,20 @@ private:
   /**
    * \class Fragments
    * \brief A Set of Fragment belonging to the same packet (src, dst, identification and proto)
+   *
+   * The fragments are indexed by offset and never overlap: the bytes of a
+   * new fragment already received are cut off, so that the packet is
+   * entire when the bytes held add up to its size.
    */
   class Fragments : public SimpleRefCount<Fragments>
   {
 public:
     /**
      * \brief Constructor.
+     * \param ipHeader the IP header of the first fragment received
+     * \param iif the interface of the first fragment received
      */
-    Fragments ();
+    Fragments (const Ipv4Header &ipHeader, uint32_t iif);
 
     /**
      * \brief Destructor.
@@ -489,8 +521,9 @@ public:
      * \param fragment the fragment
      * \param fragmentOffset the offset of the fragment
      * \param moreFragment the bit "More Fragment"
+     * \return the number of new bytes held
      */
-    void AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment);
+    uint32_t AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment);
 
     /**
      * \brief If all fragments have been added.
@@ -510,27 +543,59 @@ public:
      */
     Ptr<Packet> GetPartialPacket () const;
 
+    /**
+     * \return the number of bytes held
+     */
+    uint32_t GetSize () const;
+
+    Ipv4Header m_ipHeader; //!< IP header of the first fragment received
+    uint32_t m_iif;        //!< Interface of the first fragment received
+    EventId m_timeout;     //!< Expiration event
+    std::list<FragmentsKey_t>::iterator m_age; //!< Position in the age list
+
 private:
     /**
-     * \brief True if other fragments will be sent.
+     * \brief True if the last fragment was received.
+     */
+    bool m_lastFragment;
+
+    /**
+     * \brief The size of the packet, known once the last fragment is received.
+     */
+    uint32_t m_end;
+
+    /**
+     * \brief The number of bytes held.
      */
-    bool m_moreFragment;
+    uint32_t m_size;
 
     /**
-     * \brief The current fragments.
+     * \brief The current fragments, by offset.
      */
-    std::list<std::pair<Ptr<Packet>, uint16_t> > m_fragments;
+    std::map<uint32_t, Ptr<Packet> > m_fragments;
+
+  };
 
+  /**
+   * \brief Hash function of the fragments keys.
+   */
+  struct FragmentsKeyHash
+  {
+    /**
+     * \param x a key
+     * \return the hash of the key
+     */
+    size_t operator() (const FragmentsKey_t &x) const;
   };
 
-  /// Container of fragments, stored as pairs(src+dst addr, src+dst port) / fragment
-  typedef std::map< std::pair<uint64_t, uint32_t>, Ptr<Fragments> > MapFragments_t;
-  /// Container of fragment timeout event, stored as pairs(src+dst addr, src+dst port) / EventId
-  typedef std::map< std::pair<uint64_t, uint32_t>, EventId > MapFragmentsTimers_t;
+  /// Container of fragments, stored as pairs(src+dst addr, id+proto) / fragment
+  typedef sgi::hash_map<FragmentsKey_t, Ptr<Fragments>, FragmentsKeyHash> MapFragments_t;
 
   MapFragments_t       m_fragments; //!< Fragmented packets.
+  std::list<FragmentsKey_t> m_fragmentsAge; //!< Fragmented packets, oldest first.
   Time                 m_fragmentExpirationTimeout; //!< Expiration timeout
-  MapFragmentsTimers_t m_fragmentsTimers; //!< Expiration events.
+  uint32_t             m_fragmentsMaxBytes; //!< Bound of the bytes held by the fragments
+  uint32_t             m_fragmentsBytes; //!< Bytes held by the fragments
 
 };
 
@@ -0,0 +1,214 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/log.h"
+#include "ipv4-route-trie.h"
+#include "ipv4-routing-table-entry.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4RouteTrie");
+
+/**
+ * \param length a prefix length
+ * \return the mask of the prefix length
+ */
+static inline uint32_t
+PrefixMask (uint8_t length)
+{
+  return length == 0 ? 0 : 0xffffffffU << (32 - length);
+}
+
+/**
+ * \param address an address
+ * \param i the index of a bit, 0 being the most significant one
+ * \return the value of the bit
+ */
+static inline uint32_t
+GetBit (uint32_t address, uint8_t i)
+{
+  return (address >> (31 - i)) & 1;
+}
+
+/**
+ * \param a a route
+ * \param b another route
+ * \return true if a was inserted before b
+ */
+static bool
+InsertedBefore (const Ipv4RouteTrie::Route &a, const Ipv4RouteTrie::Route &b)
+{
+  return a.order < b.order;
+}
+
+Ipv4RouteTrie::Ipv4RouteTrie ()
+  : m_root (0),
+    m_order (0),
+    m_nRoutes (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ipv4RouteTrie::~Ipv4RouteTrie ()
+{
+  NS_LOG_FUNCTION (this);
+  DeleteNode (m_root);
+}
+
+Ipv4RouteTrie::Node *
+Ipv4RouteTrie::CreateNode (uint32_t prefix, uint8_t length)
+{
+  Node *node = new Node;
+  node->prefix = prefix;
+  node->length = length;
+  node->child[0] = 0;
+  node->child[1] = 0;
+  return node;
+}
+
+void
+Ipv4RouteTrie::DeleteNode (Node *node)
+{
+  if (node != 0)
+    {
+      DeleteNode (node->child[0]);
+      DeleteNode (node->child[1]);
+      delete node;
+    }
+}
+
+void
+Ipv4RouteTrie::Insert (Ipv4Address network, Ipv4Mask mask, Ipv4RoutingTableEntry *entry, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << network << mask << entry << metric);
+  Route route;
+  route.entry = entry;
+  route.metric = metric;
+  route.order = m_order++;
+  m_nRoutes++;
+
+  uint8_t length = mask.GetPrefixLength ();
+  if (PrefixMask (length) != mask.Get ())
+    {
+      NS_LOG_LOGIC ("Non-contiguous mask " << mask << ", not in the trie");
+      m_others.push_back (route);
+      return;
+    }
+  uint32_t prefix = network.Get () & mask.Get ();
+
+  Node **link = &m_root;
+  while (true)
+    {
+      Node *node = *link;
+      if (node == 0)
+        {
+          node = CreateNode (prefix, length);
+          node->routes.push_back (route);
+          *link = node;
+          return;
+        }
+      uint8_t common = 0;
+      uint32_t diff = prefix ^ node->prefix;
+      uint8_t max = std::min (length, node->length);
+      while (common < max && GetBit (diff, common) == 0)
+        {
+          common++;
+        }
+      if (common == node->length && common == length)
+        {
+          node->routes.push_back (route);
+          return;
+        }
+      if (common == node->length)
+        {
+          // the node is a prefix of the route: go down
+          link = &node->child[GetBit (prefix, common)];
+          continue;
+        }
+      Node *leaf = CreateNode (prefix, length);
+      leaf->routes.push_back (route);
+      if (common == length)
+        {
+          // the route is a prefix of the node: insert it above
+          leaf->child[GetBit (node->prefix, common)] = node;
+          *link = leaf;
+          return;
+        }
+      // the route and the node diverge: insert a branch above both
+      Node *branch = CreateNode (prefix & PrefixMask (common), common);
+      branch->child[GetBit (prefix, common)] = leaf;
+      branch->child[GetBit (node->prefix, common)] = node;
+      *link = branch;
+      return;
+    }
+}
+
+void
+Ipv4RouteTrie::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  DeleteNode (m_root);
+  m_root = 0;
+  m_others.clear ();
+  m_order = 0;
+  m_nRoutes = 0;
+}
+
+uint32_t
+Ipv4RouteTrie::GetNRoutes (void) const
+{
+  return m_nRoutes;
+}
+
+void
+Ipv4RouteTrie::Lookup (Ipv4Address dest, std::vector<Route> &routes) const
+{
+  NS_LOG_FUNCTION (this << dest);
+  uint32_t address = dest.Get ();
+  std::vector<Route>::size_type first = routes.size ();
+  uint32_t nPrefixes = 0;
+
+  const Node *node = m_root;
+  while (node != 0 && ((address ^ node->prefix) & PrefixMask (node->length)) == 0)
+    {
+      if (!node->routes.empty ())
+        {
+          routes.insert (routes.end (), node->routes.begin (), node->routes.end ());
+          nPrefixes++;
+        }
+      if (node->length == 32)
+        {
+          break;
+        }
+      node = node->child[GetBit (address, node->length)];
+    }
+  for (std::vector<Route>::const_iterator i = m_others.begin (); i != m_others.end (); i++)
+    {
+      Ipv4Mask mask = i->entry->GetDestNetworkMask ();
+      if (mask.IsMatch (dest, i->entry->GetDestNetwork ()))
+        {
+          routes.push_back (*i);
+          nPrefixes++;
+        }
+    }
+  if (nPrefixes > 1)
+    {
+      std::sort (routes.begin () + first, routes.end (), &InsertedBefore);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef IPV4_ROUTE_TRIE_H
+#define IPV4_ROUTE_TRIE_H
+
+#include <vector>
+#include <stdint.h>
+
+#include "ns3/ipv4-address.h"
+
+namespace ns3 {
+
+class Ipv4RoutingTableEntry;
+
+/**
+ * \ingroup internet
+ *
+ * \brief A forwarding table indexing IPv4 routes by destination prefix.
+ *
+ * Routes are stored in a path-compressed binary trie: each node holds
+ * the routes of one prefix and only the nodes where prefixes diverge
+ * exist, so a lookup visits at most 33 nodes whatever the number of
+ * routes.  Lookup () returns every route whose prefix matches the
+ * destination, in the order in which they were inserted, which lets
+ * Ipv4GlobalRouting and Ipv4StaticRouting keep their selection rules
+ * (equal-cost multipath sets, longest match, metrics) unchanged.
+ *
+ * Routes with a non-contiguous mask cannot be placed in the trie; they
+ * are kept aside and checked one by one.
+ *
+ * The trie does not own the routing table entries.  It is not a
+ * reference counted object.
+ */
+class Ipv4RouteTrie
+{
+public:
+  /**
+   * \brief A route matched by Lookup ()
+   */
+  struct Route
+  {
+    Ipv4RoutingTableEntry *entry; //!< the routing table entry
+    uint32_t metric;              //!< the metric of the route
+    uint32_t order;               //!< the insertion order of the route
+  };
+
+  Ipv4RouteTrie ();
+  ~Ipv4RouteTrie ();
+
+  /**
+   * \brief Add a route
+   * \param network the destination network of the route
+   * \param mask the mask of the destination network
+   * \param entry the routing table entry
+   * \param metric the metric of the route
+   */
+  void Insert (Ipv4Address network, Ipv4Mask mask, Ipv4RoutingTableEntry *entry, uint32_t metric = 0);
+
+  /**
+   * \brief Remove all the routes
+   */
+  void Clear (void);
+
+  /**
+   * \return the number of routes
+   */
+  uint32_t GetNRoutes (void) const;
+
+  /**
+   * \brief Find the routes matching a destination
+   * \param dest the destination
+   * \param routes the matching routes, in insertion order, are appended
+   *        to this vector
+   */
+  void Lookup (Ipv4Address dest, std::vector<Route> &routes) const;
+
+private:
+  /**
+   * \brief A node of the trie: a prefix, its routes and the subtrees of
+   * the longer prefixes.
+   */
+  struct Node
+  {
+    uint32_t prefix;            //!< the prefix, with the bits past length cleared
+    uint8_t length;             //!< the length of the prefix
+    Node *child[2];             //!< the subtrees, by value of the bit following the prefix
+    std::vector<Route> routes;  //!< the routes to the prefix
+  };
+
+  /**
+   * \brief Copy constructor, disabled
+   * \param o object to copy
+   */
+  Ipv4RouteTrie (const Ipv4RouteTrie &o);
+  /**
+   * \brief Assignment operator, disabled
+   * \param o object to copy
+   * \returns the object
+   */
+  Ipv4RouteTrie &operator = (const Ipv4RouteTrie &o);
+
+  /**
+   * \param prefix a prefix
+   * \param length the length of the prefix
+   * \return a new node, without routes nor children
+   */
+  static Node *CreateNode (uint32_t prefix, uint8_t length);
+  /**
+   * \param node the root of a subtree to delete
+   */
+  static void DeleteNode (Node *node);
+
+  Node *m_root;                  //!< the root of the trie
+  std::vector<Route> m_others;   //!< the routes with a non-contiguous mask
+  uint32_t m_order;              //!< the order of the next route
+  uint32_t m_nRoutes;            //!< the number of routes
+};
+
+} // namespace ns3
+
+#endif /* IPV4_ROUTE_TRIE_H */
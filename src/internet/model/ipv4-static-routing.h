@@ -31,6 +31,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ipv4-route-trie.h"
 
 namespace ns3 {
 
@@ -425,11 +426,27 @@ private:
    */
   Ipv4Address SourceAddressSelection (uint32_t interface, Ipv4Address dest);
 
+  /**
+   * \brief Rebuild m_networkTrie from m_networkRoutes if a route was
+   * removed since it was last built.
+   */
+  void UpdateNetworkTrie (void);
+
   /**
    * \brief the forwarding table for network.
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the index of m_networkRoutes by destination prefix.
+   */
+  Ipv4RouteTrie m_networkTrie;
+
+  /**
+   * \brief m_networkTrie must be rebuilt before use.
+   */
+  bool m_networkTrieStale;
+
   /**
    * \brief the forwarding table for multicast.
    */
@@ -23,8 +23,10 @@
 
 #include <stdint.h>
 #include <list>
+#include <map>
 #include "ns3/ipv6-address.h"
-#include "ipv6-interface.h"
+#include "ns3/sgi-hashmap.h"
+#include "ns3/ipv6-interface.h"
 
 namespace ns3 {
 
@@ -33,6 +35,11 @@ class Ipv6EndPoint;
 /**
  * \class Ipv6EndPointDemux
  * \brief Demultiplexor for end points.
+ *
+ * The end points are indexed by their four-tuple and by their local port
+ * in hash tables, so that a lookup costs a few hash table probes instead
+ * of a walk through all the end points.  The end points found are the
+ * ones a walk would find, in the order they were allocated.
  */
 class Ipv6EndPointDemux
 {
@@ -137,6 +144,92 @@ public:
   EndPoints GetEndPoints () const;
 
 private:
+  friend class Ipv6EndPoint;
+
+  /**
+   * \brief The local and peer addresses and ports of an end point.
+   */
+  struct Tuple
+  {
+    Ipv6Address localAddress; //!< the local address
+    uint16_t localPort;       //!< the local port
+    Ipv6Address peerAddress;  //!< the peer address, any if not connected
+    uint16_t peerPort;        //!< the peer port, 0 if not connected
+
+    /**
+     * \param o another tuple
+     * \return true if the tuples are equal
+     */
+    bool operator== (const Tuple &o) const;
+  };
+
+  /**
+   * \brief Hash function of the tuples.
+   */
+  struct TupleHash
+  {
+    /**
+     * \param x a tuple
+     * \return the hash of the tuple
+     */
+    size_t operator() (const Tuple &x) const;
+  };
+
+  /**
+   * \brief End points by rank of allocation.
+   */
+  typedef std::map<uint64_t, Ipv6EndPoint *> RankedEndPoints;
+
+  /**
+   * \brief The end points of each tuple.
+   */
+  typedef sgi::hash_map<Tuple, RankedEndPoints, TupleHash> TupleIndex;
+
+  /**
+   * \brief The end points of each local port.
+   */
+  typedef sgi::hash_map<uint16_t, RankedEndPoints> PortIndex;
+
+  /**
+   * \param endPoint an end point
+   * \return the tuple of the end point
+   */
+  static Tuple GetTuple (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Add a new end point to the demux.
+   * \param endPoint the end point
+   */
+  void Insert (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Index an end point by its current tuple and local port.
+   *
+   * Called by Ipv6EndPoint once its tuple has changed.
+   *
+   * \param endPoint the end point
+   */
+  void Index (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the indexes.
+   *
+   * Called by Ipv6EndPoint before its tuple changes.
+   *
+   * \param endPoint the end point
+   */
+  void Unindex (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Append the end points of a tuple which are not bound to a
+   * device other than the one of an interface.
+   * \param tuple the tuple
+   * \param incomingInterface the interface
+   * \param endPoints the end points found are appended to this list
+   */
+  void AddMatches (const Tuple &tuple, Ptr<Ipv6Interface> incomingInterface,
+                   EndPoints &endPoints);
+
   /**
    * \brief Allocate a ephemeral port.
    * \return a port
@@ -159,9 +252,24 @@ private:
   uint16_t m_portLast;
 
   /**
-   * \brief A list of IPv6 end points.
+   * \brief The rank of the next end point allocated.
+   */
+  uint64_t m_nextRank;
+
+  /**
+   * \brief The IPv6 end points, by rank of allocation.
+   */
+  RankedEndPoints m_endPoints;
+
+  /**
+   * \brief The IPv6 end points, by tuple.
+   */
+  TupleIndex m_tuples;
+
+  /**
+   * \brief The IPv6 end points, by local port.
    */
-  EndPoints m_endPoints;
+  PortIndex m_ports;
 };
 
 } /* namespace ns3 */
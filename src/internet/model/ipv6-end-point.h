@@ -34,6 +34,7 @@ namespace ns3
 
 class Header;
 class Packet;
+class Ipv6EndPointDemux;
 
 /**
  * \brief A representation of an internet IPv6 endpoint/connection
@@ -178,6 +179,8 @@ public:
                     uint8_t code, uint32_t info);
 
 private:
+  friend class Ipv6EndPointDemux;
+
   /**
    * \brief ForwardUp wrapper.
    * \param p packet
@@ -223,6 +226,16 @@ private:
    */
   Ptr<NetDevice> m_boundnetdevice;
 
+  /**
+   * \brief The demux indexing the end point, 0 if none.
+   */
+  Ipv6EndPointDemux *m_demux;
+
+  /**
+   * \brief The rank of the end point in the order of allocation.
+   */
+  uint64_t m_rank;
+
   /**
    * \brief The RX callback.
    */
@@ -59,6 +59,10 @@ void Ipv6ExtensionDemux::DoDispose ()
       *it = 0;
     }
   m_extensions.clear ();
+  for (uint32_t i = 0; i < 256; i++)
+    {
+      m_extensionTable[i] = 0;
+    }
   m_node = 0;
   Object::DoDispose ();
 }
@@ -71,23 +75,31 @@ void Ipv6ExtensionDemux::SetNode (Ptr<Node> node)
 void Ipv6ExtensionDemux::Insert (Ptr<Ipv6Extension> extension)
 {
   m_extensions.push_back (extension);
+  uint8_t number = extension->GetExtensionNumber ();
+  if (!m_extensionTable[number])
+    {
+      m_extensionTable[number] = extension;
+    }
 }
 
 Ptr<Ipv6Extension> Ipv6ExtensionDemux::GetExtension (uint8_t extensionNumber)
 {
-  for (Ipv6ExtensionList_t::iterator i = m_extensions.begin (); i != m_extensions.end (); ++i)
-    {
-      if ((*i)->GetExtensionNumber () == extensionNumber)
-        {
-          return *i;
-        }
-    }
-  return 0;
+  return m_extensionTable[extensionNumber];
 }
 
 void Ipv6ExtensionDemux::Remove (Ptr<Ipv6Extension> extension)
 {
   m_extensions.remove (extension);
+  uint8_t number = extension->GetExtensionNumber ();
+  m_extensionTable[number] = 0;
+  for (Ipv6ExtensionList_t::iterator i = m_extensions.begin (); i != m_extensions.end (); ++i)
+    {
+      if ((*i)->GetExtensionNumber () == number)
+        {
+          m_extensionTable[number] = *i;
+          break;
+        }
+    }
 }
 
 } /* namespace ns3 */
@@ -97,6 +97,12 @@ private:
    */
   Ipv6ExtensionList_t m_extensions;
 
+  /**
+   * \brief The first extension of the list for each extension number,
+   * so that GetExtension does not walk the list for each header.
+   */
+  Ptr<Ipv6Extension> m_extensionTable[256];
+
   /**
    * \brief The node.
    */
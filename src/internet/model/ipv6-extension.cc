@@ -315,11 +315,18 @@ TypeId Ipv6ExtensionFragment::GetTypeId ()
     .SetParent<Ipv6Extension> ()
     .SetGroupName ("Internet")
     .AddConstructor<Ipv6ExtensionFragment> ()
+    .AddAttribute ("FragmentsMaxBytes",
+                   "The maximum number of bytes held by the fragments waiting "
+                   "for reassembly. Beyond it, the oldest packets are discarded.",
+                   UintegerValue (4194304),
+                   MakeUintegerAccessor (&Ipv6ExtensionFragment::m_fragmentsMaxBytes),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
 
 Ipv6ExtensionFragment::Ipv6ExtensionFragment ()
+  : m_fragmentsBytes (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -335,10 +342,13 @@ void Ipv6ExtensionFragment::DoDispose ()
 
   for (MapFragments_t::iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
     {
+      it->second->CancelTimeout ();
       it->second = 0;
     }
 
   m_fragments.clear ();
+  m_fragmentsAge.clear ();
+  m_fragmentsBytes = 0;
   Ipv6Extension::DoDispose ();
 }
 
@@ -376,20 +386,35 @@ uint8_t Ipv6ExtensionFragment::Process (Ptr<Packet>& packet,
   uint32_t identification = fragmentHeader.GetIdentification ();
   Ipv6Address src = ipv6Header.GetSourceAddress ();
 
-  std::pair<Ipv6Address, uint32_t> fragmentsId = std::pair<Ipv6Address, uint32_t> (src, identification);
+  FragmentsKey_t fragmentsId = FragmentsKey_t (src, identification);
   Ptr<Fragments> fragments;
 
   Ipv6Header ipHeader = ipv6Header;
   ipHeader.SetNextHeader (fragmentHeader.GetNextHeader ());
 
+  if (packet->GetSize () > m_fragmentsMaxBytes)
+    {
+      Ptr<Ipv6L3Protocol> ipL3 = GetNode ()->GetObject<Ipv6L3Protocol> ();
+      ipL3->ReportDrop (ipHeader, p, Ipv6L3Protocol::DROP_FRAGMENT_MEMORY);
+      stopProcessing = true;
+      return 0;
+    }
+  // Make room by discarding the oldest packets
+  while (!m_fragmentsAge.empty () && m_fragmentsBytes + packet->GetSize () > m_fragmentsMaxBytes)
+    {
+      NS_LOG_LOGIC ("Reassembly memory full, discarding the oldest fragmented packet");
+      DropFragments (m_fragmentsAge.front (), Ipv6L3Protocol::DROP_FRAGMENT_MEMORY);
+    }
+
   MapFragments_t::iterator it = m_fragments.find (fragmentsId);
   if (it == m_fragments.end ())
     {
-      fragments = Create<Fragments> ();
+      fragments = Create<Fragments> (ipHeader);
       m_fragments.insert (std::make_pair (fragmentsId, fragments));
+      fragments->SetAge (m_fragmentsAge.insert (m_fragmentsAge.end (), fragmentsId));
       EventId timeout = Simulator::Schedule (Seconds (60),
                                              &Ipv6ExtensionFragment::HandleFragmentsTimeout, this,
-                                             fragmentsId, ipHeader);
+                                             fragmentsId);
       fragments->SetTimeoutEventId (timeout);
     }
   else
@@ -397,6 +422,7 @@ uint8_t Ipv6ExtensionFragment::Process (Ptr<Packet>& packet,
       fragments = it->second;
     }
 
+  uint32_t size = fragments->GetSize ();
   if (fragmentOffset == 0)
     {
       Ptr<Packet> unfragmentablePart = packet->Copy ();
@@ -404,12 +430,23 @@ uint8_t Ipv6ExtensionFragment::Process (Ptr<Packet>& packet,
       fragments->SetUnfragmentablePart (unfragmentablePart);
     }
 
-  fragments->AddFragment (p, fragmentOffset, moreFragment);
+  if (!fragments->AddFragment (p, fragmentOffset, moreFragment))
+    {
+      // Overlapping fragments discard the whole packet (RFC 5722)
+      NS_LOG_LOGIC ("Overlapping fragment, discarding the packet");
+      m_fragmentsBytes += fragments->GetSize () - size;
+      DropFragments (fragmentsId, Ipv6L3Protocol::DROP_MALFORMED_HEADER);
+      stopProcessing = true;
+      return 0;
+    }
+  m_fragmentsBytes += fragments->GetSize () - size;
 
   if (fragments->IsEntire ())
     {
       packet = fragments->GetPacket ();
       fragments->CancelTimeout ();
+      m_fragmentsBytes -= fragments->GetSize ();
+      m_fragmentsAge.erase (fragments->GetAge ());
       m_fragments.erase (fragmentsId);
       stopProcessing = false;
     }
@@ -596,8 +633,21 @@ void Ipv6ExtensionFragment::GetFragments (Ptr<Packet> packet, uint32_t maxFragme
 }
 
 
-void Ipv6ExtensionFragment::HandleFragmentsTimeout (std::pair<Ipv6Address, uint32_t> fragmentsId,
-                                                    Ipv6Header ipHeader)
+size_t Ipv6ExtensionFragment::FragmentsKeyHash::operator() (const FragmentsKey_t &x) const
+{
+  uint64_t h = Ipv6AddressHash () (x.first) ^ (static_cast<uint64_t> (x.second) * 0x9e3779b97f4a7c15ULL);
+  h ^= h >> 29;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 32;
+  return static_cast<size_t> (h);
+}
+
+void Ipv6ExtensionFragment::HandleFragmentsTimeout (FragmentsKey_t fragmentsId)
+{
+  DropFragments (fragmentsId, Ipv6L3Protocol::DROP_FRAGMENT_TIMEOUT);
+}
+
+void Ipv6ExtensionFragment::DropFragments (FragmentsKey_t fragmentsId, Ipv6L3Protocol::DropReason reason)
 {
   Ptr<Fragments> fragments;
 
@@ -606,9 +656,14 @@ void Ipv6ExtensionFragment::HandleFragmentsTimeout (std::pair<Ipv6Address, uint3
   fragments = it->second;
 
   Ptr<Packet> packet = fragments->GetPartialPacket ();
+  Ipv6Header ipHeader = fragments->GetIpHeader ();
+  if (!packet)
+    {
+      packet = Create<Packet> ();
+    }
 
   // if we have at least 8 bytes, we can send an ICMP.
-  if ( packet->GetSize () > 8 )
+  if ( reason == Ipv6L3Protocol::DROP_FRAGMENT_TIMEOUT && packet->GetSize () > 8 )
     {
       Ptr<Packet> p = packet->Copy ();
       p->AddHeader (ipHeader);
@@ -617,14 +672,20 @@ void Ipv6ExtensionFragment::HandleFragmentsTimeout (std::pair<Ipv6Address, uint3
     }
 
   Ptr<Ipv6L3Protocol> ipL3 = GetNode ()->GetObject<Ipv6L3Protocol> ();
-  ipL3->ReportDrop (ipHeader, packet, Ipv6L3Protocol::DROP_FRAGMENT_TIMEOUT);
+  ipL3->ReportDrop (ipHeader, packet, reason);
 
   // clear the buffers
-  m_fragments.erase (fragmentsId);
+  fragments->CancelTimeout ();
+  m_fragmentsBytes -= fragments->GetSize ();
+  m_fragmentsAge.erase (fragments->GetAge ());
+  m_fragments.erase (it);
 }
 
-Ipv6ExtensionFragment::Fragments::Fragments ()
-  : m_moreFragment (0)
+Ipv6ExtensionFragment::Fragments::Fragments (const Ipv6Header &ipHeader)
+  : m_lastFragment (false),
+    m_end (0),
+    m_size (0),
+    m_ipHeader (ipHeader)
 {
 }
 
@@ -632,24 +693,40 @@ Ipv6ExtensionFragment::Fragments::~Fragments ()
 {
 }
 
-void Ipv6ExtensionFragment::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment)
+bool Ipv6ExtensionFragment::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment)
 {
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it;
+  uint32_t end = fragmentOffset + fragment->GetSize ();
 
-  for (it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
+  std::map<uint32_t, Ptr<Packet> >::iterator it = m_packetFragments.lower_bound (fragmentOffset);
+  if (it != m_packetFragments.end () && it->first == fragmentOffset
+      && it->second->GetSize () == fragment->GetSize ())
     {
-      if (it->second > fragmentOffset)
+      // Exact duplicate
+      return true;
+    }
+  if (it != m_packetFragments.end () && it->first < end)
+    {
+      return false;
+    }
+  if (it != m_packetFragments.begin ())
+    {
+      std::map<uint32_t, Ptr<Packet> >::iterator prev = it;
+      prev--;
+      if (prev->first + prev->second->GetSize () > fragmentOffset)
         {
-          break;
+          return false;
         }
     }
 
-  if (it == m_packetFragments.end ())
+  if (!moreFragment)
     {
-      m_moreFragment = moreFragment;
+      m_lastFragment = true;
+      m_end = end;
     }
 
-  m_packetFragments.insert (it, std::pair<Ptr<Packet>, uint16_t> (fragment, fragmentOffset));
+  m_packetFragments.insert (it, std::make_pair (fragmentOffset, fragment));
+  m_size += fragment->GetSize ();
+  return true;
 }
 
 void Ipv6ExtensionFragment::Fragments::SetUnfragmentablePart (Ptr<Packet> unfragmentablePart)
@@ -659,34 +736,23 @@ void Ipv6ExtensionFragment::Fragments::SetUnfragmentablePart (Ptr<Packet> unfrag
 
 bool Ipv6ExtensionFragment::Fragments::IsEntire () const
 {
-  bool ret = !m_moreFragment && m_packetFragments.size () > 0;
-
-  if (ret)
+  // The fragments do not overlap: they cover the packet if their bytes add
+  // up to its size and none lies beyond its end
+  if (!m_lastFragment || m_size != m_end || m_packetFragments.empty ())
     {
-      uint16_t lastEndOffset = 0;
-
-      for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
-        {
-          if (lastEndOffset != it->second)
-            {
-              ret = false;
-              break;
-            }
-
-          lastEndOffset += it->first->GetSize ();
-        }
+      return false;
     }
-
-  return ret;
+  std::map<uint32_t, Ptr<Packet> >::const_reverse_iterator last = m_packetFragments.rbegin ();
+  return last->first + last->second->GetSize () == m_end;
 }
 
 Ptr<Packet> Ipv6ExtensionFragment::Fragments::GetPacket () const
 {
   Ptr<Packet> p =  m_unfragmentable->Copy ();
 
-  for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
+  for (std::map<uint32_t, Ptr<Packet> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
     {
-      p->AddAtEnd (it->first);
+      p->AddAtEnd (it->second);
     }
 
   return p;
@@ -705,21 +771,31 @@ Ptr<Packet> Ipv6ExtensionFragment::Fragments::GetPartialPacket () const
       return p;
     }
 
-  uint16_t lastEndOffset = 0;
+  uint32_t lastEndOffset = 0;
 
-  for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
+  for (std::map<uint32_t, Ptr<Packet> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
     {
-      if (lastEndOffset != it->second)
+      if (lastEndOffset != it->first)
         {
           break;
         }
-      p->AddAtEnd (it->first);
-      lastEndOffset += it->first->GetSize ();
+      p->AddAtEnd (it->second);
+      lastEndOffset += it->second->GetSize ();
     }
 
   return p;
 }
 
+uint32_t Ipv6ExtensionFragment::Fragments::GetSize () const
+{
+  return m_size + (m_unfragmentable ? m_unfragmentable->GetSize () : 0);
+}
+
+Ipv6Header Ipv6ExtensionFragment::Fragments::GetIpHeader () const
+{
+  return m_ipHeader;
+}
+
 void Ipv6ExtensionFragment::Fragments::SetTimeoutEventId (EventId event)
 {
   m_timeoutEventId = event;
@@ -732,6 +808,16 @@ void Ipv6ExtensionFragment::Fragments::CancelTimeout ()
   return;
 }
 
+void Ipv6ExtensionFragment::Fragments::SetAge (std::list<FragmentsKey_t>::iterator age)
+{
+  m_age = age;
+}
+
+std::list<Ipv6ExtensionFragment::FragmentsKey_t>::iterator Ipv6ExtensionFragment::Fragments::GetAge () const
+{
+  return m_age;
+}
+
 
 NS_OBJECT_ENSURE_REGISTERED (Ipv6ExtensionRouting);
 
@@ -35,6 +35,7 @@
 #include "ns3/ipv6-address.h"
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/traced-callback.h"
+#include "ns3/sgi-hashmap.h"
 
 
 namespace ns3 {
@@ -300,17 +301,27 @@ protected:
   virtual void DoDispose ();
 
 private:
+  /**
+   * \brief Key of the fragments of a packet: source and identification
+   */
+  typedef std::pair<Ipv6Address, uint32_t> FragmentsKey_t;
+
   /**
    * \class Fragments
    * \brief A Set of Fragment
+   *
+   * The fragments are indexed by offset.  As overlapping fragments are
+   * not accepted (RFC 5722), the packet is entire when the bytes held add
+   * up to its size.
    */
   class Fragments : public SimpleRefCount<Fragments>
   {
 public:
     /**
      * \brief Constructor.
+     * \param ipHeader the IP header of the packet
      */
-    Fragments ();
+    Fragments (const Ipv6Header &ipHeader);
 
     /**
      * \brief Destructor.
@@ -322,8 +333,9 @@ public:
      * \param fragment the fragment
      * \param fragmentOffset the offset of the fragment
      * \param moreFragment the bit "More Fragment"
+     * \return false if the fragment overlaps the fragments already received
      */
-    void AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment);
+    bool AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment);
 
     /**
      * \brief Set the unfragmentable part of the packet.
@@ -349,6 +361,18 @@ public:
      */
     Ptr<Packet> GetPartialPacket () const;
 
+    /**
+     * \brief Get the number of bytes held, unfragmentable part included.
+     * \return the number of bytes
+     */
+    uint32_t GetSize () const;
+
+    /**
+     * \brief Get the IP header of the packet.
+     * \return the IP header
+     */
+    Ipv6Header GetIpHeader () const;
+
     /**
      * \brief Set the Timeout EventId.
      */
@@ -359,60 +383,109 @@ public:
      */
     void CancelTimeout ();
 
+    /**
+     * \brief Set the position of the packet in the age list.
+     * \param age the position
+     */
+    void SetAge (std::list<FragmentsKey_t>::iterator age);
+
+    /**
+     * \brief Get the position of the packet in the age list.
+     * \return the position
+     */
+    std::list<FragmentsKey_t>::iterator GetAge () const;
+
 private:
     /**
-     * \brief If other fragments will be sent.
+     * \brief If the last fragment was received.
      */
-    bool m_moreFragment;
+    bool m_lastFragment;
 
     /**
-     * \brief The current fragments.
+     * \brief The size of the fragmentable part, known once the last fragment is received.
      */
-    std::list<std::pair<Ptr<Packet>, uint16_t> > m_packetFragments;
+    uint32_t m_end;
+
+    /**
+     * \brief The number of bytes of the fragments held.
+     */
+    uint32_t m_size;
+
+    /**
+     * \brief The current fragments, by offset.
+     */
+    std::map<uint32_t, Ptr<Packet> > m_packetFragments;
 
     /**
      * \brief The unfragmentable part.
      */
     Ptr<Packet> m_unfragmentable;
 
+    /**
+     * \brief The IP header of the packet.
+     */
+    Ipv6Header m_ipHeader;
+
     /**
      * \brief Timeout handler event
      */
     EventId m_timeoutEventId;
+
+    /**
+     * \brief Position of the packet in the age list.
+     */
+    std::list<FragmentsKey_t>::iterator m_age;
+  };
+
+  /**
+   * \brief Hash function of the fragments keys.
+   */
+  struct FragmentsKeyHash
+  {
+    /**
+     * \param x a key
+     * \return the hash of the key
+     */
+    size_t operator() (const FragmentsKey_t &x) const;
   };
 
   /**
    * \brief Process the timeout for packet fragments
    * \param key representing the packet fragments
-   * \param ipHeader the IP header of the original packet
    */
-  void HandleFragmentsTimeout (std::pair<Ipv6Address, uint32_t> key, Ipv6Header ipHeader);
+  void HandleFragmentsTimeout (FragmentsKey_t key);
 
   /**
-   * \brief Get the packet parts so far received.
-   * \return the partial packet
+   * \brief Discard the fragments of a packet
+   * \param key representing the packet fragments
+   * \param reason the reason reported by the drop trace
    */
-  Ptr<Packet> GetPartialPacket () const;
+  void DropFragments (FragmentsKey_t key, Ipv6L3Protocol::DropReason reason);
 
   /**
-   * \brief Set the Timeout EventId.
+   * \brief Container for the packet fragments.
    */
-  void SetTimeoutEventId (EventId event);
+  typedef sgi::hash_map<FragmentsKey_t, Ptr<Fragments>, FragmentsKeyHash> MapFragments_t;
 
   /**
-   * \brief Cancel the timeout event
+   * \brief The hash of fragmented packets.
    */
-  void CancelTimeout ();
+  MapFragments_t m_fragments;
 
   /**
-   * \brief Container for the packet fragments.
+   * \brief The fragmented packets, oldest first.
    */
-  typedef std::map<std::pair<Ipv6Address, uint32_t>, Ptr<Fragments> > MapFragments_t;
+  std::list<FragmentsKey_t> m_fragmentsAge;
 
   /**
-   * \brief The hash of fragmented packets.
+   * \brief Bound of the bytes held by the fragments.
    */
-  MapFragments_t m_fragments;
+  uint32_t m_fragmentsMaxBytes;
+
+  /**
+   * \brief Bytes held by the fragments.
+   */
+  uint32_t m_fragmentsBytes;
 };
 
 /**
@@ -22,7 +22,6 @@
 #include "ns3/log.h"
 #include "ns3/header.h"
 
-#include "ns3/address-utils.h"
 #include "ipv6-header.h"
 
 namespace ns3 {
@@ -153,13 +152,20 @@ void Ipv6Header::Serialize (Buffer::Iterator start) const
 
   vTcFl= (6 << 28) | (m_trafficClass << 20) | (m_flowLabel);
 
-  i.WriteHtonU32 (vTcFl);
-  i.WriteHtonU16 (m_payloadLength);
-  i.WriteU8 (m_nextHeader);
-  i.WriteU8 (m_hopLimit);
+  /* the fixed header is written at once rather than field by field */
+  uint8_t buf[40];
+  buf[0] = (vTcFl >> 24) & 0xff;
+  buf[1] = (vTcFl >> 16) & 0xff;
+  buf[2] = (vTcFl >> 8) & 0xff;
+  buf[3] = vTcFl & 0xff;
+  buf[4] = (m_payloadLength >> 8) & 0xff;
+  buf[5] = m_payloadLength & 0xff;
+  buf[6] = m_nextHeader;
+  buf[7] = m_hopLimit;
+  m_sourceAddress.GetBytes (buf + 8);
+  m_destinationAddress.GetBytes (buf + 24);
 
-  WriteTo (i, m_sourceAddress);
-  WriteTo (i, m_destinationAddress);
+  i.Write (buf, sizeof (buf));
 }
 
 uint32_t Ipv6Header::Deserialize (Buffer::Iterator start)
@@ -167,19 +173,22 @@ uint32_t Ipv6Header::Deserialize (Buffer::Iterator start)
   Buffer::Iterator i = start;
   uint32_t vTcFl = 0;
 
-  vTcFl = i.ReadNtohU32 ();
+  uint8_t buf[40];
+  i.Read (buf, sizeof (buf));
+
+  vTcFl = (static_cast<uint32_t> (buf[0]) << 24) | (buf[1] << 16) | (buf[2] << 8) | buf[3];
   m_version = vTcFl >> 28;
 
   NS_ASSERT ((m_version) == 6);
 
   m_trafficClass = (uint8_t)((vTcFl >> 20) & 0x000000ff);
   m_flowLabel = vTcFl & 0xfff00000;
-  m_payloadLength = i.ReadNtohU16 ();
-  m_nextHeader = i.ReadU8 ();
-  m_hopLimit = i.ReadU8 ();
+  m_payloadLength = (buf[4] << 8) | buf[5];
+  m_nextHeader = buf[6];
+  m_hopLimit = buf[7];
 
-  ReadFrom (i, m_sourceAddress);
-  ReadFrom (i, m_destinationAddress);
+  m_sourceAddress.Set (buf + 8);
+  m_destinationAddress.Set (buf + 24);
 
   return GetSerializedSize ();
 }
@@ -163,6 +163,7 @@ void Ipv6L3Protocol::DoDispose ()
   m_prefixes.clear ();
 
   m_node = 0;
+  m_extensionDemux = 0;
   m_routingProtocol = 0;
   m_pmtuCache = 0;
   Object::DoDispose ();
@@ -911,16 +912,15 @@ void Ipv6L3Protocol::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16
       socket->ForwardUp (packet, hdr, device);
     }
 
-  Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = m_node->GetObject<Ipv6ExtensionDemux> ();
-  Ptr<Ipv6Extension> ipv6Extension = 0;
   uint8_t nextHeader = hdr.GetNextHeader ();
-  bool stopProcessing = false;
-  bool isDropped = false;
-  DropReason dropReason;
 
+  /* only a hop-by-hop extension is processed before routing */
   if (nextHeader == Ipv6Header::IPV6_EXT_HOP_BY_HOP)
     {
-      ipv6Extension = ipv6ExtensionDemux->GetExtension (nextHeader);
+      Ptr<Ipv6Extension> ipv6Extension = GetExtensionDemux ()->GetExtension (nextHeader);
+      bool stopProcessing = false;
+      bool isDropped = false;
+      DropReason dropReason;
 
       if (ipv6Extension)
         {
@@ -1004,7 +1004,7 @@ void Ipv6L3Protocol::SendRealOut (Ptr<Ipv6Route> route, Ptr<Packet> packet, Ipv6
           return;
         }
 
-      Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = m_node->GetObject<Ipv6ExtensionDemux> ();
+      Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = GetExtensionDemux ();
 
       packet->AddHeader (ipHeader);
 
@@ -1194,7 +1194,7 @@ void Ipv6L3Protocol::LocalDeliver (Ptr<const Packet> packet, Ipv6Header const& i
   NS_LOG_FUNCTION (this << packet << ip << iif);
   Ptr<Packet> p = packet->Copy ();
   Ptr<IpL4Protocol> protocol = 0;
-  Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = m_node->GetObject<Ipv6ExtensionDemux> ();
+  Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = GetExtensionDemux ();
   Ptr<Ipv6Extension> ipv6Extension = 0;
   Ipv6Address src = ip.GetSourceAddress ();
   Ipv6Address dst = ip.GetDestinationAddress ();
@@ -1245,14 +1245,15 @@ void Ipv6L3Protocol::LocalDeliver (Ptr<const Packet> packet, Ipv6Header const& i
       else
         {
           protocol = GetProtocol (nextHeader);
-          // For ICMPv6 Error packets
-          Ptr<Packet> malformedPacket  = packet->Copy ();
-          malformedPacket->AddHeader (ip);
 
           if (!protocol)
             {
               NS_LOG_LOGIC ("Unknown Next Header. Drop!");
 
+              // For ICMPv6 Error packets
+              Ptr<Packet> malformedPacket  = packet->Copy ();
+              malformedPacket->AddHeader (ip);
+
               if (nextHeaderPosition == 0)
                 {
                   GetIcmpv6 ()->SendErrorParameterError (malformedPacket, dst, Icmpv6Header::ICMPV6_UNKNOWN_NEXT_HEADER, 40);
@@ -1300,6 +1301,15 @@ void Ipv6L3Protocol::LocalDeliver (Ptr<const Packet> packet, Ipv6Header const& i
   while (ipv6Extension);
 }
 
+Ptr<Ipv6ExtensionDemux> Ipv6L3Protocol::GetExtensionDemux (void)
+{
+  if (!m_extensionDemux)
+    {
+      m_extensionDemux = m_node->GetObject<Ipv6ExtensionDemux> ();
+    }
+  return m_extensionDemux;
+}
+
 void Ipv6L3Protocol::RouteInputError (Ptr<const Packet> p, const Ipv6Header& ipHeader, Socket::SocketErrno sockErrno)
 {
   NS_LOG_FUNCTION (this << p << ipHeader << sockErrno);
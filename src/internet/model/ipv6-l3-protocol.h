@@ -43,6 +43,7 @@ class Ipv6MulticastRoute;
 class Ipv6RawSocketImpl;
 class Icmpv6L4Protocol;
 class Ipv6AutoconfiguredPrefix;
+class Ipv6ExtensionDemux;
 
 /**
  * \class Ipv6L3Protocol
@@ -86,6 +87,7 @@ public:
     DROP_UNKNOWN_OPTION, /**< Unknown option */
     DROP_MALFORMED_HEADER, /**< Malformed header */
     DROP_FRAGMENT_TIMEOUT, /**< Fragment timeout */
+    DROP_FRAGMENT_MEMORY, /**< Fragments discarded to bound the reassembly memory */
   };
 
   /**
@@ -606,11 +608,25 @@ private:
    */
   virtual bool GetSendIcmpv6Redirect () const;
 
+  /**
+   * \brief Get the extension demultiplexer of the node.
+   *
+   * The demultiplexer is looked up once, rather than for each packet.
+   *
+   * \return the extension demultiplexer
+   */
+  Ptr<Ipv6ExtensionDemux> GetExtensionDemux (void);
+
   /**
    * \brief Node attached to stack.
    */
   Ptr<Node> m_node;
 
+  /**
+   * \brief Extension demultiplexer of the node, once looked up.
+   */
+  Ptr<Ipv6ExtensionDemux> m_extensionDemux;
+
   /**
    * \brief Forwarding packets (i.e. router mode) state.
    */
@@ -64,6 +64,7 @@ void NdiscCache::DoDispose ()
 {
   NS_LOG_FUNCTION_NOARGS ();
   Flush ();
+  m_timerWheel.Clear ();
   m_device = 0;
   m_interface = 0;
   Object::DoDispose ();
@@ -115,15 +116,12 @@ void NdiscCache::Remove (NdiscCache::Entry* entry)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  for (CacheI i = m_ndCache.begin (); i != m_ndCache.end (); i++)
+  CacheI i = m_ndCache.find (entry->GetIpv6Address ());
+  if (i != m_ndCache.end () && (*i).second == entry)
     {
-      if ((*i).second == entry)
-        {
-          m_ndCache.erase (i);
-          entry->ClearWaitingPacket ();
-          delete entry;
-          return;
-        }
+      m_ndCache.erase (i);
+      entry->ClearWaitingPacket ();
+      delete entry;
     }
 }
 
@@ -198,11 +196,12 @@ NdiscCache::Entry::Entry (NdiscCache* nd)
   : m_ndCache (nd),
     m_waiting (),
     m_router (false),
-    m_nudTimer (Timer::CANCEL_ON_DESTROY),
+    m_nudFunction (0),
     m_lastReachabilityConfirmation (Seconds (0.0)),
     m_nsRetransmit (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  m_nudTimer.SetFunction (MakeCallback (&NdiscCache::Entry::FunctionNudTimeout, this));
 }
 
 void NdiscCache::Entry::SetRouter (bool router)
@@ -371,12 +370,24 @@ void NdiscCache::Entry::FunctionProbeTimeout ()
     }
 }
 
+void NdiscCache::Entry::FunctionNudTimeout ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  (this->*m_nudFunction)();
+}
+
 void NdiscCache::Entry::SetIpv6Address (Ipv6Address ipv6Address)
 {
   NS_LOG_FUNCTION (this << ipv6Address);
   m_ipv6Address = ipv6Address;
 }
 
+Ipv6Address NdiscCache::Entry::GetIpv6Address () const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return m_ipv6Address;
+}
+
 Time NdiscCache::Entry::GetLastReachabilityConfirmation () const
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -391,56 +402,35 @@ void NdiscCache::Entry::UpdateLastReachabilityconfirmation ()
 void NdiscCache::Entry::StartReachableTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionReachableTimeout, this);
-  m_nudTimer.SetDelay (MilliSeconds (Icmpv6L4Protocol::REACHABLE_TIME));
-  m_nudTimer.Schedule ();
+  m_nudFunction = &NdiscCache::Entry::FunctionReachableTimeout;
+  m_ndCache->m_timerWheel.Schedule (&m_nudTimer, MilliSeconds (Icmpv6L4Protocol::REACHABLE_TIME));
 }
 
 void NdiscCache::Entry::StartProbeTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionProbeTimeout, this);
-  m_nudTimer.SetDelay (MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
-  m_nudTimer.Schedule ();
+  m_nudFunction = &NdiscCache::Entry::FunctionProbeTimeout;
+  m_ndCache->m_timerWheel.Schedule (&m_nudTimer, MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
 }
 
 void NdiscCache::Entry::StartDelayTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionDelayTimeout, this);
-  m_nudTimer.SetDelay (Seconds (Icmpv6L4Protocol::DELAY_FIRST_PROBE_TIME));
-  m_nudTimer.Schedule ();
+  m_nudFunction = &NdiscCache::Entry::FunctionDelayTimeout;
+  m_ndCache->m_timerWheel.Schedule (&m_nudTimer, Seconds (Icmpv6L4Protocol::DELAY_FIRST_PROBE_TIME));
 }
 
 void NdiscCache::Entry::StartRetransmitTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  if (m_nudTimer.IsRunning ())
-    {
-      m_nudTimer.Cancel ();
-    }
-  m_nudTimer.SetFunction (&NdiscCache::Entry::FunctionRetransmitTimeout, this);
-  m_nudTimer.SetDelay (MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
-  m_nudTimer.Schedule ();
+  m_nudFunction = &NdiscCache::Entry::FunctionRetransmitTimeout;
+  m_ndCache->m_timerWheel.Schedule (&m_nudTimer, MilliSeconds (Icmpv6L4Protocol::RETRANS_TIMER));
 }
 
 void NdiscCache::Entry::StopNudTimer ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_nudTimer.Cancel ();
+  m_ndCache->m_timerWheel.Cancel (&m_nudTimer);
   m_nsRetransmit = 0;
 }
 
@@ -29,7 +29,7 @@
 #include "ns3/net-device.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/ptr.h"
-#include "ns3/timer.h"
+#include "ns3/timer-wheel.h"
 #include "ns3/sgi-hashmap.h"
 #include "ns3/output-stream-wrapper.h"
 
@@ -42,6 +42,9 @@ class Ipv6Interface;
 /**
  * \class NdiscCache
  * \brief IPv6 Neighbor Discovery cache.
+ *
+ * The NUD timers of the entries run on a TimerWheel of the cache, so that
+ * a cache of thousands of neighbors keeps a single event in the scheduler.
  */
 class NdiscCache : public Object
 {
@@ -307,12 +310,24 @@ public:
      */
     void FunctionDelayTimeout ();
 
+    /**
+     * \brief Function called when the NUD timer expires, calling the
+     * function of the timer last started.
+     */
+    void FunctionNudTimeout ();
+
     /**
      * \brief Set the IPv6 address.
      * \param ipv6Address IPv6 address
      */
     void SetIpv6Address (Ipv6Address ipv6Address);
 
+    /**
+     * \brief Get the IPv6 address.
+     * \return the IPv6 address
+     */
+    Ipv6Address GetIpv6Address () const;
+
 private:
     /**
      * \brief The IPv6 address.
@@ -357,9 +372,14 @@ private:
     bool m_router;
 
     /**
-     * \brief Timer (used for NUD).
+     * \brief Timer (used for NUD), on the TimerWheel of the cache.
      */
-    Timer m_nudTimer;
+    TimerWheel::Timer m_nudTimer;
+
+    /**
+     * \brief The function called when the NUD timer expires.
+     */
+    void (NdiscCache::Entry::*m_nudFunction)();
 
     /**
      * \brief Last time we see a reachability confirmation.
@@ -421,6 +441,11 @@ private:
    * \brief Max number of packet stored in m_waiting.
    */
   uint32_t m_unresQlen;
+
+  /**
+   * \brief The wheel of the NUD timers of the entries.
+   */
+  TimerWheel m_timerWheel;
 };
 
 } /* namespace ns3 */
@@ -0,0 +1,622 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/ipv4.h"
+#include "spf-graph.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SPFGraph");
+
+const uint32_t SPFGraph::NO_VERTEX;
+
+SPFGraph::SPFGraph (const GlobalRouteManagerLSDB *lsdb)
+  : m_hasNodes (NodeList::GetNNodes () > 0)
+{
+  NS_LOG_FUNCTION (this << lsdb);
+  std::vector<GlobalRoutingLSA *> lsas;
+  lsdb->GetLSAs (lsas);
+
+  //
+  // First the vertices, so that links can be resolved.  A network-LSA
+  // lists the addresses of its routers: the router is the first one, in
+  // the order of the database, with a transit link of that address.
+  //
+  std::map<Ipv4Address, uint32_t> byLinkData;
+  m_vertices.resize (lsas.size ());
+  for (uint32_t i = 0; i < lsas.size (); i++)
+    {
+      GlobalRoutingLSA *lsa = lsas[i];
+      Vertex &vertex = m_vertices[i];
+      vertex.id = lsa->GetLinkStateId ();
+      vertex.firstLink = 0;
+      vertex.nLinks = 0;
+      if (lsa->GetLSType () == GlobalRoutingLSA::NetworkLSA)
+        {
+          vertex.type = SPFGraph::VertexNetwork;
+          vertex.mask = lsa->GetNetworkLSANetworkMask ();
+        }
+      else
+        {
+          vertex.type = SPFGraph::VertexRouter;
+        }
+      m_index.insert (std::make_pair (vertex.id, i));
+      for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *record = lsa->GetLinkRecord (j);
+          if (record->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork)
+            {
+              byLinkData.insert (std::make_pair (record->GetLinkData (), i));
+            }
+        }
+    }
+
+  std::map<Ipv4Address, Ptr<Node> > nodes;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); i++)
+    {
+      Ptr<GlobalRouter> router = (*i)->GetObject<GlobalRouter> ();
+      if (router != 0)
+        {
+          nodes.insert (std::make_pair (router->GetRouterId (), *i));
+        }
+    }
+
+  m_nodes.resize (lsas.size ());
+  for (uint32_t i = 0; i < lsas.size (); i++)
+    {
+      GlobalRoutingLSA *lsa = lsas[i];
+      Vertex &vertex = m_vertices[i];
+      vertex.firstLink = m_links.size ();
+      if (vertex.type == SPFGraph::VertexNetwork)
+        {
+          for (uint32_t j = 0; j < lsa->GetNAttachedRouters (); j++)
+            {
+              Link link;
+              link.type = GlobalRoutingLinkRecord::Unknown;
+              link.linkData = lsa->GetAttachedRouter (j);
+              std::map<Ipv4Address, uint32_t>::const_iterator k = byLinkData.find (link.linkData);
+              link.target = k == byLinkData.end () ? NO_VERTEX : k->second;
+              link.interface = -1;
+              link.metric = 0;
+              m_links.push_back (link);
+            }
+          vertex.nLinks = m_links.size () - vertex.firstLink;
+          continue;
+        }
+
+      Ptr<Ipv4> ipv4;
+      std::map<Ipv4Address, Ptr<Node> >::const_iterator node = nodes.find (vertex.id);
+      if (node != nodes.end ())
+        {
+          m_nodes[i] = node->second;
+          ipv4 = node->second->GetObject<Ipv4> ();
+        }
+      for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *record = lsa->GetLinkRecord (j);
+          Link link;
+          link.type = record->GetLinkType ();
+          link.linkId = record->GetLinkId ();
+          link.linkData = record->GetLinkData ();
+          link.metric = record->GetMetric ();
+          link.target = NO_VERTEX;
+          link.interface = -1;
+          if (link.type == GlobalRoutingLinkRecord::PointToPoint
+              || link.type == GlobalRoutingLinkRecord::TransitNetwork)
+            {
+              link.target = FindVertex (link.linkId);
+            }
+          if (ipv4 != 0 && link.type == GlobalRoutingLinkRecord::PointToPoint)
+            {
+              // the link data is the address of the interface
+              link.interface = ipv4->GetInterfaceForPrefix (link.linkData, Ipv4Mask::GetOnes ());
+            }
+          else if (ipv4 != 0 && link.target != NO_VERTEX)
+            {
+              // the interface is the one on the transit network
+              const Vertex &network = m_vertices[link.target];
+              link.interface = ipv4->GetInterfaceForPrefix (network.id, network.mask);
+            }
+          m_links.push_back (link);
+        }
+      vertex.nLinks = m_links.size () - vertex.firstLink;
+    }
+
+  for (uint32_t i = 0; i < lsdb->GetNumExtLSAs (); i++)
+    {
+      GlobalRoutingLSA *lsa = lsdb->GetExtLSA (i);
+      External external;
+      external.advertisingRouter = lsa->GetAdvertisingRouter ();
+      external.router = FindVertex (external.advertisingRouter);
+      if (external.router != NO_VERTEX
+          && m_vertices[external.router].type != SPFGraph::VertexRouter)
+        {
+          external.router = NO_VERTEX;
+        }
+      external.mask = lsa->GetNetworkLSANetworkMask ();
+      external.network = lsa->GetLinkStateId ().CombineMask (external.mask);
+      m_externals.push_back (external);
+    }
+
+  //
+  // The reversed links, grouped by the vertex they reach, in the same
+  // compressed layout as the links.
+  //
+  m_firstSource.assign (m_vertices.size () + 1, 0);
+  for (std::vector<Link>::const_iterator i = m_links.begin (); i != m_links.end (); i++)
+    {
+      if (i->target != NO_VERTEX)
+        {
+          m_firstSource[i->target + 1]++;
+        }
+    }
+  for (uint32_t i = 0; i < m_vertices.size (); i++)
+    {
+      m_firstSource[i + 1] += m_firstSource[i];
+    }
+  m_sources.resize (m_firstSource.back ());
+  std::vector<uint32_t> next (m_firstSource.begin (), m_firstSource.end () - 1);
+  for (uint32_t i = 0; i < m_vertices.size (); i++)
+    {
+      const Vertex &vertex = m_vertices[i];
+      for (uint32_t j = vertex.firstLink; j < vertex.firstLink + vertex.nLinks; j++)
+        {
+          const Link &link = m_links[j];
+          if (link.target != NO_VERTEX)
+            {
+              uint32_t cost = vertex.type == SPFGraph::VertexRouter ? link.metric : 0;
+              m_sources[next[link.target]++] = Source (i, cost);
+            }
+        }
+    }
+  NS_LOG_LOGIC ("Graph of " << m_vertices.size () << " vertices and " << m_links.size () << " links");
+}
+
+uint32_t
+SPFGraph::GetNVertices (void) const
+{
+  return m_vertices.size ();
+}
+
+const SPFGraph::Vertex &
+SPFGraph::GetVertex (uint32_t i) const
+{
+  return m_vertices[i];
+}
+
+uint32_t
+SPFGraph::FindVertex (Ipv4Address id) const
+{
+  std::map<Ipv4Address, uint32_t>::const_iterator i = m_index.find (id);
+  return i == m_index.end () ? NO_VERTEX : i->second;
+}
+
+const SPFGraph::Link &
+SPFGraph::GetLink (uint32_t i) const
+{
+  return m_links[i];
+}
+
+Ptr<Node>
+SPFGraph::GetNode (uint32_t i) const
+{
+  return m_nodes[i];
+}
+
+bool
+SPFGraph::HasNodes (void) const
+{
+  return m_hasNodes;
+}
+
+uint32_t
+SPFGraph::GetNExternals (void) const
+{
+  return m_externals.size ();
+}
+
+const SPFGraph::External &
+SPFGraph::GetExternal (uint32_t i) const
+{
+  return m_externals[i];
+}
+
+void
+SPFGraph::GetSources (uint32_t i, std::vector<uint32_t> &sources) const
+{
+  for (uint32_t j = m_firstSource[i]; j < m_firstSource[i + 1]; j++)
+    {
+      sources.push_back (m_sources[j].first);
+    }
+}
+
+void
+SPFGraph::GetDistancesTo (uint32_t target, std::vector<uint32_t> &distances) const
+{
+  NS_LOG_FUNCTION (this << target);
+  typedef std::pair<uint32_t, uint32_t> Entry;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+  distances.assign (m_vertices.size (), SPF_INFINITY);
+  distances[target] = 0;
+  queue.push (Entry (0, target));
+  while (!queue.empty ())
+    {
+      Entry entry = queue.top ();
+      queue.pop ();
+      uint32_t v = entry.second;
+      if (entry.first != distances[v])
+        {
+          continue;
+        }
+      for (uint32_t j = m_firstSource[v]; j < m_firstSource[v + 1]; j++)
+        {
+          const Source &source = m_sources[j];
+          uint32_t distance = entry.first + source.second;
+          if (distance < distances[source.first])
+            {
+              distances[source.first] = distance;
+              queue.push (Entry (distance, source.first));
+            }
+        }
+    }
+}
+
+SPFCalculator::SPFCalculator (const SPFGraph *graph)
+  : m_graph (graph),
+    m_root (SPFGraph::NO_VERTEX),
+    m_order (0)
+{
+  NS_LOG_FUNCTION (this << graph);
+}
+
+bool
+SPFCalculator::After (const Candidate &a, const Candidate &b)
+{
+  if (a.distance != b.distance)
+    {
+      return a.distance > b.distance;
+    }
+  if (a.rank != b.rank)
+    {
+      return a.rank > b.rank;
+    }
+  return a.order > b.order;
+}
+
+//
+// No logging from here on: calculators run outside of the simulation
+// thread.
+//
+void
+SPFCalculator::Calculate (uint32_t root, std::vector<SPFRoute> &routes)
+{
+  routes.clear ();
+  uint32_t nVertices = m_graph->GetNVertices ();
+  m_status.assign (nVertices, NOT_EXPLORED);
+  m_distance.assign (nVertices, SPF_INFINITY);
+  m_candidateOrder.resize (nVertices);
+  m_exits.resize (nVertices);
+  m_parents.resize (nVertices);
+  m_children.resize (nVertices);
+  for (uint32_t i = 0; i < nVertices; i++)
+    {
+      m_exits[i].clear ();
+      m_parents[i].clear ();
+      m_children[i].clear ();
+    }
+  m_candidates.clear ();
+  m_order = 0;
+  m_root = root;
+  m_status[root] = IN_SPFTREE;
+  m_distance[root] = 0;
+
+  if (m_graph->HasNodes () && CheckForStubNode (routes))
+    {
+      return;
+    }
+
+  //
+  // First stage: Dijkstra over the routers and the transit networks,
+  // adding the host routes of the routers and the network routes of the
+  // networks as they join the tree.
+  //
+  uint32_t v = root;
+  for (;;)
+    {
+      Next (v);
+      v = SPFGraph::NO_VERTEX;
+      while (!m_candidates.empty ())
+        {
+          std::pop_heap (m_candidates.begin (), m_candidates.end (), &SPFCalculator::After);
+          Candidate candidate = m_candidates.back ();
+          m_candidates.pop_back ();
+          if (m_status[candidate.vertex] == CANDIDATE
+              && m_candidateOrder[candidate.vertex] == candidate.order)
+            {
+              v = candidate.vertex;
+              break;
+            }
+        }
+      if (v == SPFGraph::NO_VERTEX)
+        {
+          break;
+        }
+      m_status[v] = IN_SPFTREE;
+      for (std::vector<uint32_t>::const_iterator i = m_parents[v].begin (); i != m_parents[v].end (); i++)
+        {
+          m_children[*i].push_back (v);
+        }
+      const SPFGraph::Vertex &vertex = m_graph->GetVertex (v);
+      if (vertex.type == SPFGraph::VertexRouter)
+        {
+          for (uint32_t i = vertex.firstLink; i < vertex.firstLink + vertex.nLinks; i++)
+            {
+              const SPFGraph::Link &link = m_graph->GetLink (i);
+              if (link.type == GlobalRoutingLinkRecord::PointToPoint)
+                {
+                  AddRoutes (v, Ipv4GlobalFib::HOST_ROUTE, link.linkData, Ipv4Mask::GetOnes (), routes);
+                }
+            }
+        }
+      else
+        {
+          AddRoutes (v, Ipv4GlobalFib::NETWORK_ROUTE, vertex.id.CombineMask (vertex.mask), vertex.mask, routes);
+        }
+    }
+
+  //
+  // Second stage: the stub networks, walking the tree depth first.
+  //
+  std::vector<std::pair<uint32_t, uint32_t> > stack;
+  stack.push_back (std::make_pair (root, 0));
+  while (!stack.empty ())
+    {
+      uint32_t u = stack.back ().first;
+      uint32_t child = stack.back ().second++;
+      if (child == m_children[u].size ())
+        {
+          stack.pop_back ();
+          continue;
+        }
+      u = m_children[u][child];
+      if (m_status[u] == PROCESSED)
+        {
+          continue;
+        }
+      m_status[u] = PROCESSED;
+      stack.push_back (std::make_pair (u, 0));
+      const SPFGraph::Vertex &vertex = m_graph->GetVertex (u);
+      if (vertex.type != SPFGraph::VertexRouter)
+        {
+          continue;
+        }
+      for (uint32_t i = vertex.firstLink; i < vertex.firstLink + vertex.nLinks; i++)
+        {
+          const SPFGraph::Link &link = m_graph->GetLink (i);
+          if (link.type == GlobalRoutingLinkRecord::StubNetwork)
+            {
+              Ipv4Mask mask (link.linkData.Get ());
+              AddRoutes (u, Ipv4GlobalFib::NETWORK_ROUTE, link.linkId.CombineMask (mask), mask, routes);
+            }
+        }
+    }
+
+  //
+  // Last, the external networks, through their advertising router.
+  //
+  for (uint32_t i = 0; i < m_graph->GetNExternals (); i++)
+    {
+      const SPFGraph::External &external = m_graph->GetExternal (i);
+      if (external.router != SPFGraph::NO_VERTEX && external.router != root
+          && m_status[external.router] != NOT_EXPLORED)
+        {
+          AddRoutes (external.router, Ipv4GlobalFib::EXTERNAL_ROUTE, external.network, external.mask, routes);
+        }
+    }
+}
+
+bool
+SPFCalculator::CheckForStubNode (std::vector<SPFRoute> &routes) const
+{
+  const SPFGraph::Vertex &root = m_graph->GetVertex (m_root);
+  uint32_t transits = 0;
+  const SPFGraph::Link *transit = 0;
+  for (uint32_t i = root.firstLink; i < root.firstLink + root.nLinks; i++)
+    {
+      const SPFGraph::Link &link = m_graph->GetLink (i);
+      if (link.type == GlobalRoutingLinkRecord::TransitNetwork
+          || link.type == GlobalRoutingLinkRecord::PointToPoint)
+        {
+          transits++;
+          transit = &link;
+        }
+    }
+  if (transits == 0)
+    {
+      // not connected to any router, nothing to compute
+      return true;
+    }
+  if (transits > 1 || transit->type != GlobalRoutingLinkRecord::PointToPoint
+      || transit->target == SPFGraph::NO_VERTEX)
+    {
+      return false;
+    }
+  // a default route to the other end of the point-to-point link
+  const SPFGraph::Vertex &peer = m_graph->GetVertex (transit->target);
+  for (uint32_t i = peer.firstLink; i < peer.firstLink + peer.nLinks; i++)
+    {
+      const SPFGraph::Link &link = m_graph->GetLink (i);
+      if (link.type == GlobalRoutingLinkRecord::PointToPoint && link.linkId == root.id)
+        {
+          SPFRoute route;
+          route.type = Ipv4GlobalFib::NETWORK_ROUTE;
+          route.network = Ipv4Address::GetZero ();
+          route.mask = Ipv4Mask::GetZero ();
+          route.nextHop = link.linkData;
+          route.interface = transit->interface;
+          routes.push_back (route);
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+SPFCalculator::Next (uint32_t v)
+{
+  const SPFGraph::Vertex &vertex = m_graph->GetVertex (v);
+  for (uint32_t i = vertex.firstLink; i < vertex.firstLink + vertex.nLinks; i++)
+    {
+      const SPFGraph::Link &link = m_graph->GetLink (i);
+      uint32_t w = link.target;
+      // stub networks are for the second stage
+      if (w == SPFGraph::NO_VERTEX || m_status[w] == IN_SPFTREE)
+        {
+          continue;
+        }
+      uint32_t distance = m_distance[v];
+      if (vertex.type == SPFGraph::VertexRouter)
+        {
+          distance += link.metric;
+        }
+
+      if (m_status[w] == NOT_EXPLORED)
+        {
+          NexthopCalculation (v, w, link, m_exits[w]);
+          m_distance[w] = distance;
+          m_parents[w].assign (1, v);
+          m_status[w] = CANDIDATE;
+          Push (w);
+        }
+      else if (m_distance[w] == distance)
+        {
+          // an equal cost path: merge the exit directions and the parents
+          m_merged.clear ();
+          NexthopCalculation (v, w, link, m_merged);
+          Exits &exits = m_exits[w];
+          exits.insert (exits.end (), m_merged.begin (), m_merged.end ());
+          std::sort (exits.begin (), exits.end ());
+          exits.erase (std::unique (exits.begin (), exits.end ()), exits.end ());
+          if (std::find (m_parents[w].begin (), m_parents[w].end (), v) == m_parents[w].end ())
+            {
+              m_parents[w].push_back (v);
+            }
+        }
+      else if (m_distance[w] > distance)
+        {
+          // a shorter path
+          NexthopCalculation (v, w, link, m_exits[w]);
+          m_distance[w] = distance;
+          m_parents[w].assign (1, v);
+          Push (w);
+        }
+    }
+}
+
+void
+SPFCalculator::NexthopCalculation (uint32_t v, uint32_t w, const SPFGraph::Link &link, Exits &exits) const
+{
+  const SPFGraph::Vertex &parent = m_graph->GetVertex (v);
+  if (v == m_root)
+    {
+      if (m_graph->GetVertex (w).type == SPFGraph::VertexRouter)
+        {
+          // the next hop is the address of w on the point-to-point link
+          const SPFGraph::Link *remote = FindLink (w, parent.id);
+          if (remote == 0)
+            {
+              exits.clear ();
+              return;
+            }
+          exits.assign (1, Exit (remote->linkData, link.interface));
+        }
+      else
+        {
+          // a directly connected network, no next hop
+          exits.assign (1, Exit (Ipv4Address::GetZero (), link.interface));
+        }
+    }
+  else if (parent.type == SPFGraph::VertexNetwork && m_parents[v][0] == m_root)
+    {
+      // the next hop is the address of w on the network connected to the root
+      const SPFGraph::Link *remote = FindLink (w, parent.id);
+      if (remote != 0 && !m_exits[v].empty ())
+        {
+          exits.assign (1, Exit (remote->linkData, m_exits[v][0].second));
+        }
+    }
+  else
+    {
+      exits = m_exits[v];
+    }
+}
+
+const SPFGraph::Link *
+SPFCalculator::FindLink (uint32_t v, Ipv4Address id) const
+{
+  const SPFGraph::Vertex &vertex = m_graph->GetVertex (v);
+  for (uint32_t i = vertex.firstLink; i < vertex.firstLink + vertex.nLinks; i++)
+    {
+      const SPFGraph::Link &link = m_graph->GetLink (i);
+      if (link.linkId == id)
+        {
+          return &link;
+        }
+    }
+  return 0;
+}
+
+void
+SPFCalculator::Push (uint32_t w)
+{
+  Candidate candidate;
+  candidate.distance = m_distance[w];
+  candidate.rank = m_graph->GetVertex (w).type == SPFGraph::VertexNetwork ? 0 : 1;
+  candidate.order = m_order++;
+  candidate.vertex = w;
+  m_candidateOrder[w] = candidate.order;
+  m_candidates.push_back (candidate);
+  std::push_heap (m_candidates.begin (), m_candidates.end (), &SPFCalculator::After);
+}
+
+void
+SPFCalculator::AddRoutes (uint32_t v, Ipv4GlobalFib::RouteType type, Ipv4Address network,
+                          Ipv4Mask mask, std::vector<SPFRoute> &routes) const
+{
+  for (Exits::const_iterator i = m_exits[v].begin (); i != m_exits[v].end (); i++)
+    {
+      if (i->second < 0)
+        {
+          continue;
+        }
+      SPFRoute route;
+      route.type = type;
+      route.network = network;
+      route.mask = mask;
+      route.nextHop = i->first;
+      route.interface = i->second;
+      routes.push_back (route);
+    }
+}
+
+} // namespace ns3
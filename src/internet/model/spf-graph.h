@@ -0,0 +1,334 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SPF_GRAPH_H
+#define SPF_GRAPH_H
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+#include "ns3/ptr.h"
+#include "ns3/ipv4-address.h"
+#include "global-router-interface.h"
+#include "global-route-manager-impl.h"
+#include "ipv4-global-fib.h"
+
+namespace ns3 {
+
+class Node;
+
+/**
+ * \ingroup globalrouting
+ *
+ * \brief A compact copy of the Link State Database (LSDB) used by the
+ * shortest path first (SPF) computations.
+ *
+ * Every router-LSA and network-LSA of the database becomes a vertex
+ * identified by its index, and the link records of all the vertices are
+ * stored in a single array, each vertex owning a contiguous range of it
+ * (a compressed sparse row layout).  The vertex reached through a link
+ * and the interface of the router owning the link are resolved once when
+ * the graph is built, so that an SPF computation neither searches the
+ * database nor walks the list of nodes.
+ *
+ * Once built, a graph is only read: several SPFCalculator objects may use
+ * it at the same time from different threads.
+ */
+class SPFGraph
+{
+public:
+  /**
+   * \brief A link record of a router-LSA, or an attached router of a
+   * network-LSA.
+   */
+  struct Link
+  {
+    GlobalRoutingLinkRecord::LinkType type; //!< the type of the record, Unknown for attached routers
+    Ipv4Address linkId;                     //!< the link id of the record
+    Ipv4Address linkData;                   //!< the link data of the record, or the address of the attached router
+    uint32_t target;                        //!< the vertex reached through the link, NO_VERTEX if none
+    int32_t interface;                      //!< the interface of the router toward the link, -1 if unknown
+    uint16_t metric;                        //!< the cost of the link
+  };
+
+  /**
+   * \brief The kinds of vertices
+   */
+  enum VertexType
+  {
+    VertexUnknown = 0,  //!< uninitialized vertex
+    VertexRouter,       //!< a router, from a router-LSA
+    VertexNetwork       //!< a transit network, from a network-LSA
+  };
+
+  /**
+   * \brief A router or a transit network
+   */
+  struct Vertex
+  {
+    VertexType type;             //!< router or network
+    Ipv4Address id;              //!< the link state id of the LSA
+    Ipv4Mask mask;               //!< the mask of a network
+    uint32_t firstLink;          //!< the index of the first link of the vertex
+    uint32_t nLinks;             //!< the number of links of the vertex
+  };
+
+  /**
+   * \brief An AS-external-LSA
+   */
+  struct External
+  {
+    Ipv4Address advertisingRouter; //!< the router advertising the network
+    uint32_t router;               //!< the vertex of the advertising router, NO_VERTEX if none
+    Ipv4Address network;           //!< the external network
+    Ipv4Mask mask;                 //!< the mask of the external network
+  };
+
+  static const uint32_t NO_VERTEX = 0xffffffff; //!< index of no vertex
+
+  /**
+   * \brief Build the graph of a Link State Database.
+   *
+   * The routers are matched with the nodes of the NodeList through their
+   * router ID in order to find their interfaces.
+   *
+   * \param lsdb the database
+   */
+  SPFGraph (const GlobalRouteManagerLSDB *lsdb);
+
+  /**
+   * \return the number of vertices
+   */
+  uint32_t GetNVertices (void) const;
+  /**
+   * \param i the index of a vertex
+   * \return the vertex
+   */
+  const Vertex & GetVertex (uint32_t i) const;
+  /**
+   * \param id a link state id
+   * \return the index of the vertex of the LSA, NO_VERTEX if none
+   */
+  uint32_t FindVertex (Ipv4Address id) const;
+  /**
+   * \param i the index of a link
+   * \return the link
+   */
+  const Link & GetLink (uint32_t i) const;
+  /**
+   * \param i the index of a router vertex
+   * \return the node of the router, 0 if it is not in the NodeList
+   */
+  Ptr<Node> GetNode (uint32_t i) const;
+  /**
+   * \return true if there were nodes in the NodeList when the graph was built
+   */
+  bool HasNodes (void) const;
+  /**
+   * \return the number of AS-external-LSAs
+   */
+  uint32_t GetNExternals (void) const;
+  /**
+   * \param i the index of an AS-external-LSA
+   * \return the AS-external-LSA
+   */
+  const External & GetExternal (uint32_t i) const;
+
+  /**
+   * \brief Get the vertices having a link to a vertex.
+   * \param i the index of a vertex
+   * \param sources the vertices with a link to vertex i are appended to
+   *        this vector, once per link
+   */
+  void GetSources (uint32_t i, std::vector<uint32_t> &sources) const;
+
+  /**
+   * \brief Get the distance from every vertex to a vertex.
+   *
+   * This runs Dijkstra's algorithm over the reversed links.
+   *
+   * \param target the index of a vertex
+   * \param distances the distance of each vertex to the target,
+   *        SPF_INFINITY if the target cannot be reached from it
+   */
+  void GetDistancesTo (uint32_t target, std::vector<uint32_t> &distances) const;
+
+private:
+  /**
+   * \brief Copy constructor, disabled
+   * \param o object to copy
+   */
+  SPFGraph (const SPFGraph &o);
+  /**
+   * \brief Assignment operator, disabled
+   * \param o object to copy
+   * \returns the object
+   */
+  SPFGraph &operator = (const SPFGraph &o);
+
+  /// A reversed link: the vertex owning the link and the cost of the link
+  typedef std::pair<uint32_t, uint32_t> Source;
+
+  std::vector<Vertex> m_vertices;            //!< the vertices
+  std::vector<Link> m_links;                 //!< the links, grouped by vertex
+  std::vector<Ptr<Node> > m_nodes;           //!< the node of each vertex
+  std::map<Ipv4Address, uint32_t> m_index;   //!< vertices by link state id
+  std::vector<External> m_externals;         //!< the AS-external-LSAs
+  bool m_hasNodes;                           //!< whether the NodeList had nodes
+  std::vector<uint32_t> m_firstSource;       //!< index of the first source of each vertex
+  std::vector<Source> m_sources;             //!< the reversed links, grouped by vertex reached
+};
+
+/**
+ * \ingroup globalrouting
+ *
+ * \brief A route computed by an SPFCalculator
+ */
+struct SPFRoute
+{
+  Ipv4GlobalFib::RouteType type; //!< the kind of route
+  Ipv4Address network;           //!< the destination
+  Ipv4Mask mask;                 //!< the mask of the destination
+  Ipv4Address nextHop;           //!< the gateway
+  uint32_t interface;            //!< the outgoing interface
+};
+
+/**
+ * \ingroup globalrouting
+ *
+ * \brief Compute the routes of a router from an SPFGraph.
+ *
+ * This is the calculation of RFC 2328 section 16.1, in the way
+ * GlobalRouteManagerImpl has always done it: the same candidates are
+ * examined in the same order, equal cost paths are merged the same way and
+ * the routes come out in the same order.  The candidate list is a binary
+ * heap ordered by distance, networks before routers, then by the time the
+ * candidate got its distance, which is the order the sorted list of
+ * CandidateQueue used to give.
+ *
+ * A calculator keeps its working arrays from one root to the next.  It
+ * does not log nor touch any ns-3 object, so that calculators working on
+ * the same graph can run in parallel threads.
+ */
+class SPFCalculator
+{
+public:
+  /**
+   * \param graph the graph to work on
+   */
+  SPFCalculator (const SPFGraph *graph);
+
+  /**
+   * \brief Compute the routes of a router
+   * \param root the vertex of the router
+   * \param routes the routes, in the order they are to be installed
+   */
+  void Calculate (uint32_t root, std::vector<SPFRoute> &routes);
+
+private:
+  /// A root exit direction: next hop and outgoing interface
+  typedef std::pair<Ipv4Address, int32_t> Exit;
+  /// The root exit directions of a vertex
+  typedef std::vector<Exit> Exits;
+
+  /// The state of a vertex during a calculation
+  enum Status
+  {
+    NOT_EXPLORED = 0,   //!< not reached yet
+    CANDIDATE,          //!< reached, in the candidate heap
+    IN_SPFTREE,         //!< in the tree
+    PROCESSED           //!< in the tree, stub networks added
+  };
+
+  /**
+   * \brief An entry of the candidate heap.  Entries are not removed
+   * when a candidate gets a shorter distance: the outdated ones are
+   * skipped when they come out.
+   */
+  struct Candidate
+  {
+    uint32_t distance; //!< the distance of the candidate
+    uint32_t rank;     //!< 0 for networks, 1 for routers
+    uint32_t order;    //!< when the candidate got its distance
+    uint32_t vertex;   //!< the vertex
+  };
+
+  /**
+   * \param a a candidate
+   * \param b another candidate
+   * \return true if b comes out of the heap before a
+   */
+  static bool After (const Candidate &a, const Candidate &b);
+
+  /**
+   * \brief Install a default route if the root has a single
+   * point-to-point link, see GlobalRouteManagerImpl
+   * \param routes the routes of the root
+   * \return true if the root needs no SPF calculation
+   */
+  bool CheckForStubNode (std::vector<SPFRoute> &routes) const;
+  /**
+   * \brief Examine the links of a vertex just added to the tree and
+   * update the candidates, RFC 2328 16.1 (2)
+   * \param v the vertex
+   */
+  void Next (uint32_t v);
+  /**
+   * \brief Compute the root exit directions of w through v
+   * \param v the parent vertex
+   * \param w the vertex
+   * \param link the link from v to w
+   * \param exits the exit directions to set
+   */
+  void NexthopCalculation (uint32_t v, uint32_t w, const SPFGraph::Link &link, Exits &exits) const;
+  /**
+   * \param v a router vertex
+   * \param id a link id
+   * \return the first link of v with the link id, 0 if none
+   */
+  const SPFGraph::Link * FindLink (uint32_t v, Ipv4Address id) const;
+  /**
+   * \brief Push a candidate with its current distance
+   * \param w the vertex
+   */
+  void Push (uint32_t w);
+  /**
+   * \brief Add a route through each usable exit direction of a vertex
+   * \param v the vertex
+   * \param type the kind of route
+   * \param network the destination
+   * \param mask the mask of the destination
+   * \param routes the routes
+   */
+  void AddRoutes (uint32_t v, Ipv4GlobalFib::RouteType type, Ipv4Address network,
+                  Ipv4Mask mask, std::vector<SPFRoute> &routes) const;
+
+  const SPFGraph *m_graph;                   //!< the graph
+  uint32_t m_root;                           //!< the root of the calculation
+  uint32_t m_order;                          //!< the order of the next candidate
+  std::vector<uint8_t> m_status;             //!< the status of each vertex
+  std::vector<uint32_t> m_distance;          //!< the distance of each vertex
+  std::vector<uint32_t> m_candidateOrder;    //!< the order of the heap entry of each candidate
+  std::vector<Exits> m_exits;                //!< the root exit directions of each vertex
+  std::vector<std::vector<uint32_t> > m_parents;  //!< the parents of each vertex
+  std::vector<std::vector<uint32_t> > m_children; //!< the children of each vertex
+  std::vector<Candidate> m_candidates;       //!< the candidate heap
+  Exits m_merged;                            //!< exit directions of an equal cost path
+};
+
+} // namespace ns3
+
+#endif /* SPF_GRAPH_H */
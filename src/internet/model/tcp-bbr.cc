@@ -0,0 +1,281 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#define NS_LOG_APPEND_CONTEXT \
+  if (m_node) { std::clog << Simulator::Now ().GetSeconds () << " [node " << m_node->GetId () << "] "; }
+
+#include "tcp-bbr.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpBbr");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpBbr);
+
+namespace {
+/// Gains of the PROBE_BW cycle, one phase per minimum RTT
+const double g_probeBwGains[] = { 1.25, 0.75, 1, 1, 1, 1, 1, 1 };
+/// Number of phases of the PROBE_BW cycle
+const uint32_t g_probeBwPhases = sizeof (g_probeBwGains) / sizeof (g_probeBwGains[0]);
+} // anonymous namespace
+
+TypeId
+TcpBbr::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpBbr")
+    .SetParent<TcpNewReno> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpBbr> ()
+    .AddAttribute ("HighGain", "Gain applied to the bandwidth-delay product in STARTUP",
+                   DoubleValue (2.885),
+                   MakeDoubleAccessor (&TcpBbr::m_highGain),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("BwWindowLength", "Number of rounds over which the largest delivery rate is kept",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&TcpBbr::m_bwWindowLength),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("RttWindowLength", "Time over which the smallest RTT is kept",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&TcpBbr::m_rttWindowLength),
+                   MakeTimeChecker ())
+    .AddAttribute ("ProbeRttDuration", "Time spent in PROBE_RTT",
+                   TimeValue (MilliSeconds (200)),
+                   MakeTimeAccessor (&TcpBbr::m_probeRttDuration),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+TcpBbr::TcpBbr (void)
+  : m_highGain (2.885), // mute valgrind, actual value set by the attribute system
+    m_bwWindowLength (10),
+    m_mode (STARTUP),
+    m_delivered (0),
+    m_roundCount (0),
+    m_roundEnd (0),
+    m_roundStartDelivered (0),
+    m_fullBw (0),
+    m_fullBwCount (0),
+    m_filledPipe (false),
+    m_cycleIndex (0),
+    m_priorCwnd (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpBbr::TcpBbr (const TcpBbr& sock)
+  : TcpNewReno (sock),
+    m_highGain (sock.m_highGain),
+    m_bwWindowLength (sock.m_bwWindowLength),
+    m_rttWindowLength (sock.m_rttWindowLength),
+    m_probeRttDuration (sock.m_probeRttDuration),
+    m_mode (STARTUP),
+    m_delivered (0),
+    m_roundCount (0),
+    m_roundEnd (0),
+    m_roundStartDelivered (0),
+    m_fullBw (0),
+    m_fullBwCount (0),
+    m_filledPipe (false),
+    m_cycleIndex (0),
+    m_priorCwnd (0)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_LOGIC ("Invoked the copy constructor");
+}
+
+TcpBbr::~TcpBbr (void)
+{
+}
+
+Ptr<TcpSocketBase>
+TcpBbr::Fork (void)
+{
+  return CopyObject<TcpBbr> (this);
+}
+
+double
+TcpBbr::GetMaxBw (void) const
+{
+  double bw = 0;
+  for (std::deque<std::pair<uint32_t, double> >::const_iterator i = m_bwSamples.begin ();
+       i != m_bwSamples.end (); ++i)
+    {
+      bw = std::max (bw, i->second);
+    }
+  return bw;
+}
+
+uint32_t
+TcpBbr::GetBdp (void) const
+{
+  return static_cast<uint32_t> (GetMaxBw () * m_minRtt.GetSeconds ());
+}
+
+double
+TcpBbr::GetGain (void) const
+{
+  switch (m_mode)
+    {
+    case STARTUP:
+      return m_highGain;
+    case DRAIN:
+      return 1 / m_highGain;
+    case PROBE_BW:
+      return g_probeBwGains[m_cycleIndex];
+    default:
+      return 1;
+    }
+}
+
+void
+TcpBbr::EndRound (Time now)
+{
+  NS_LOG_FUNCTION (this << now);
+  if (!m_roundStart.IsZero () && now > m_roundStart)
+    { // Delivery rate over the round, kept for BwWindowLength rounds
+      double bw = (m_delivered - m_roundStartDelivered) / (now - m_roundStart).GetSeconds ();
+      m_bwSamples.push_back (std::make_pair (m_roundCount, bw));
+      while (m_bwSamples.front ().first + m_bwWindowLength <= m_roundCount)
+        {
+          m_bwSamples.pop_front ();
+        }
+      NS_LOG_LOGIC ("Round " << m_roundCount << " delivered " << bw << " B/s");
+    }
+  m_roundCount++;
+  m_roundEnd = m_highTxMark;
+  m_roundStart = now;
+  m_roundStartDelivered = m_delivered;
+
+  if (!m_filledPipe && !m_bwSamples.empty ())
+    { // The pipe is full when the delivery rate stops growing by 25%
+      double bw = GetMaxBw ();
+      if (bw >= m_fullBw * 1.25)
+        {
+          m_fullBw = bw;
+          m_fullBwCount = 0;
+        }
+      else if (++m_fullBwCount >= 3)
+        {
+          m_filledPipe = true;
+          NS_LOG_INFO ("Pipe filled at " << m_fullBw << " B/s");
+        }
+    }
+}
+
+void
+TcpBbr::UpdateMode (Time now)
+{
+  NS_LOG_FUNCTION (this << now);
+  if (m_mode == STARTUP && m_filledPipe)
+    {
+      NS_LOG_INFO ("STARTUP -> DRAIN");
+      m_mode = DRAIN;
+    }
+  if (m_mode == DRAIN && BytesInFlight () <= GetBdp ())
+    { // Start cruising: the probing phase comes at the end of the cycle
+      NS_LOG_INFO ("DRAIN -> PROBE_BW");
+      m_mode = PROBE_BW;
+      m_cycleIndex = 2;
+      m_cycleStamp = now;
+    }
+  if (m_mode == PROBE_BW && now - m_cycleStamp > m_minRtt)
+    {
+      m_cycleIndex = (m_cycleIndex + 1) % g_probeBwPhases;
+      m_cycleStamp = now;
+    }
+  if (m_mode == PROBE_RTT && now >= m_probeRttDone)
+    {
+      m_minRttStamp = now;
+      m_cWnd = std::max (m_cWnd.Get (), m_priorCwnd);
+      m_mode = m_filledPipe ? PROBE_BW : STARTUP;
+      m_cycleIndex = 2;
+      m_cycleStamp = now;
+      NS_LOG_INFO ("Leaving PROBE_RTT for " << (m_filledPipe ? "PROBE_BW" : "STARTUP"));
+    }
+}
+
+void
+TcpBbr::PktsAcked (SequenceNumber32 const& seq, uint32_t bytesAcked)
+{
+  NS_LOG_FUNCTION (this << seq << bytesAcked);
+  Time now = Simulator::Now ();
+  m_delivered += bytesAcked;
+  bool expired = now > m_minRttStamp + m_rttWindowLength;
+  if (!m_rttSample.IsZero () && (m_minRtt.IsZero () || m_rttSample <= m_minRtt || expired))
+    {
+      m_minRtt = m_rttSample;
+      m_minRttStamp = now;
+    }
+  if (expired && m_mode != PROBE_RTT)
+    { // Measure the smallest RTT again with empty queues
+      NS_LOG_INFO ("Smallest RTT expired, entering PROBE_RTT");
+      m_mode = PROBE_RTT;
+      m_priorCwnd = m_cWnd;
+      m_probeRttDone = now + m_probeRttDuration;
+    }
+  if (seq >= m_roundEnd)
+    {
+      EndRound (now);
+    }
+  UpdateMode (now);
+}
+
+void
+TcpBbr::IncreaseWindow (SequenceNumber32 const& seq, uint32_t bytesAcked)
+{
+  NS_LOG_FUNCTION (this << seq << bytesAcked);
+  if (m_mode == PROBE_RTT)
+    {
+      m_cWnd = 4 * m_segmentSize;
+      return;
+    }
+  uint32_t bdp = GetBdp ();
+  if (bdp == 0)
+    { // No model of the path yet
+      m_cWnd += bytesAcked;
+      return;
+    }
+  uint32_t target = std::max (static_cast<uint32_t> (GetGain () * bdp) + 3 * m_segmentSize,
+                              4 * m_segmentSize);
+  if (!m_filledPipe)
+    {
+      if (m_cWnd < target)
+        {
+          m_cWnd += bytesAcked;
+        }
+    }
+  else
+    {
+      m_cWnd = std::min (m_cWnd.Get () + bytesAcked, target);
+    }
+  NS_LOG_INFO ("BDP " << bdp << ", target " << target << ", cwnd " << m_cWnd);
+}
+
+uint32_t
+TcpBbr::GetSsThresh (void)
+{
+  // Do not reduce the window on losses, the model bounds it
+  return std::max (BytesInFlight (), 4 * m_segmentSize);
+}
+
+} // namespace ns3
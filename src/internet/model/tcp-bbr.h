@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_BBR_H
+#define TCP_BBR_H
+
+#include <deque>
+#include <utility>
+
+#include "tcp-newreno.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup socket
+ * \ingroup tcp
+ *
+ * \brief An implementation of the BBR congestion control.
+ *
+ * BBR models the path by the largest delivery rate measured over the last
+ * rounds and the smallest RTT measured over the last seconds, and keeps
+ * the data in flight around their product, the bandwidth-delay product
+ * (BDP), instead of reacting to losses.  Its states are:
+ * - STARTUP: the window grows as in slow start until the delivery rate
+ *   stops growing by 25% over three rounds;
+ * - DRAIN: the queue built by STARTUP is drained;
+ * - PROBE_BW: the window cycles around the BDP, a round above it to probe
+ *   for more bandwidth, a round below it to drain the queue so created,
+ *   then six rounds at it;
+ * - PROBE_RTT: the window is cut to four segments for ProbeRttDuration
+ *   when the smallest RTT was not refreshed for RttWindowLength, to
+ *   measure it with empty queues.
+ *
+ * As the sockets send at the pace of the acknowledgments, the gains that
+ * BBR applies to its pacing rate are applied to the window here, plus
+ * three segments of headroom for the delayed acknowledgments.  Losses are
+ * recovered as in TcpNewReno, without reducing the window below the data
+ * in flight, and ECN echoes are ignored.
+ */
+class TcpBbr : public TcpNewReno
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * Create an unbound tcp socket.
+   */
+  TcpBbr (void);
+  /**
+   * \brief Copy constructor
+   * \param sock the object to copy
+   */
+  TcpBbr (const TcpBbr& sock);
+  virtual ~TcpBbr (void);
+
+  /**
+   * \brief BBR states
+   */
+  enum BbrMode
+  {
+    STARTUP,   //!< Grow the window exponentially
+    DRAIN,     //!< Drain the queue built during STARTUP
+    PROBE_BW,  //!< Cycle around the bandwidth-delay product
+    PROBE_RTT  //!< Empty the queues to measure the RTT
+  };
+
+protected:
+  virtual Ptr<TcpSocketBase> Fork (void); // Call CopyObject<TcpBbr> to clone me
+  virtual void PktsAcked (SequenceNumber32 const& seq, uint32_t bytesAcked);
+  virtual void IncreaseWindow (SequenceNumber32 const& seq, uint32_t bytesAcked);
+  virtual uint32_t GetSsThresh (void);
+
+private:
+  /**
+   * \return the largest delivery rate of the last BwWindowLength rounds (bytes/s)
+   */
+  double GetMaxBw (void) const;
+  /**
+   * \return the estimated bandwidth-delay product (bytes), 0 if unknown
+   */
+  uint32_t GetBdp (void) const;
+  /**
+   * \return the gain applied to the bandwidth-delay product in the current state
+   */
+  double GetGain (void) const;
+  /**
+   * \brief Account for the end of a round trip
+   * \param now the current time
+   */
+  void EndRound (Time now);
+  /**
+   * \brief Move between the states
+   * \param now the current time
+   */
+  void UpdateMode (Time now);
+
+  // Attributes
+  double   m_highGain;          //!< Gain of STARTUP
+  uint32_t m_bwWindowLength;    //!< Number of rounds of the delivery rate filter
+  Time     m_rttWindowLength;   //!< Lifetime of the smallest RTT measured
+  Time     m_probeRttDuration;  //!< Time spent in PROBE_RTT
+
+  BbrMode  m_mode;              //!< Current state
+  std::deque<std::pair<uint32_t, double> > m_bwSamples; //!< Delivery rate of the last rounds
+  uint64_t         m_delivered;           //!< Bytes acknowledged since the start
+  uint32_t         m_roundCount;          //!< Number of rounds since the start
+  SequenceNumber32 m_roundEnd;            //!< Acknowledging it ends the current round
+  Time             m_roundStart;          //!< Start of the current round
+  uint64_t         m_roundStartDelivered; //!< m_delivered at the start of the current round
+  Time             m_minRtt;              //!< Smallest RTT measured recently
+  Time             m_minRttStamp;         //!< Time m_minRtt was measured
+  double           m_fullBw;              //!< Delivery rate at the last growth in STARTUP
+  uint32_t         m_fullBwCount;         //!< Rounds without growth of the delivery rate
+  bool             m_filledPipe;          //!< The delivery rate stopped growing
+  uint32_t         m_cycleIndex;          //!< Phase of the PROBE_BW gain cycle
+  Time             m_cycleStamp;          //!< Start of the current phase
+  Time             m_probeRttDone;        //!< End of PROBE_RTT
+  uint32_t         m_priorCwnd;           //!< Window before PROBE_RTT
+};
+
+} // namespace ns3
+
+#endif /* TCP_BBR_H */
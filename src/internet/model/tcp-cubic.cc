@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#define NS_LOG_APPEND_CONTEXT \
+  if (m_node) { std::clog << Simulator::Now ().GetSeconds () << " [node " << m_node->GetId () << "] "; }
+
+#include <cmath>
+
+#include "tcp-cubic.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpCubic");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpCubic);
+
+TypeId
+TcpCubic::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpCubic")
+    .SetParent<TcpNewReno> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpCubic> ()
+    .AddAttribute ("Beta", "Multiplicative decrease factor of the window on a congestion event",
+                   DoubleValue (0.7),
+                   MakeDoubleAccessor (&TcpCubic::m_beta),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("C", "Scaling constant of the cubic function (segments/s^3)",
+                   DoubleValue (0.4),
+                   MakeDoubleAccessor (&TcpCubic::m_c),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("FastConvergence", "Lower the plateau when the window shrinks between "
+                   "two congestion events, to release bandwidth to new flows",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpCubic::m_fastConvergence),
+                   MakeBooleanChecker ())
+    .AddAttribute ("TcpFriendliness", "Grow the window at least as fast as standard TCP would",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpCubic::m_tcpFriendliness),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+TcpCubic::TcpCubic (void)
+  : m_beta (0.7), // mute valgrind, actual value set by the attribute system
+    m_c (0.4),
+    m_fastConvergence (true),
+    m_tcpFriendliness (true),
+    m_wLastMax (0),
+    m_originPoint (0),
+    m_k (0),
+    m_wEst (0),
+    m_epochStart (Time (0)),
+    m_delayMin (Time (0))
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpCubic::TcpCubic (const TcpCubic& sock)
+  : TcpNewReno (sock),
+    m_beta (sock.m_beta),
+    m_c (sock.m_c),
+    m_fastConvergence (sock.m_fastConvergence),
+    m_tcpFriendliness (sock.m_tcpFriendliness),
+    m_wLastMax (sock.m_wLastMax),
+    m_originPoint (sock.m_originPoint),
+    m_k (sock.m_k),
+    m_wEst (sock.m_wEst),
+    m_epochStart (sock.m_epochStart),
+    m_delayMin (sock.m_delayMin)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_LOGIC ("Invoked the copy constructor");
+}
+
+TcpCubic::~TcpCubic (void)
+{
+}
+
+Ptr<TcpSocketBase>
+TcpCubic::Fork (void)
+{
+  return CopyObject<TcpCubic> (this);
+}
+
+void
+TcpCubic::PktsAcked (SequenceNumber32 const& seq, uint32_t bytesAcked)
+{
+  NS_LOG_FUNCTION (this << seq << bytesAcked);
+  if (!m_rttSample.IsZero () && (m_delayMin.IsZero () || m_rttSample < m_delayMin))
+    {
+      m_delayMin = m_rttSample;
+    }
+  TcpNewReno::PktsAcked (seq, bytesAcked);
+}
+
+void
+TcpCubic::IncreaseWindow (SequenceNumber32 const& seq, uint32_t bytesAcked)
+{
+  NS_LOG_FUNCTION (this << seq << bytesAcked);
+  if (m_cWnd < m_ssThresh)
+    {
+      TcpNewReno::IncreaseWindow (seq, bytesAcked);
+      return;
+    }
+
+  double segmentsAcked = std::max (1.0, static_cast<double> (bytesAcked) / m_segmentSize);
+  double cwnd = static_cast<double> (m_cWnd.Get ()) / m_segmentSize;
+  Time now = Simulator::Now ();
+  if (m_epochStart.IsZero ())
+    { // First acknowledgment of the congestion avoidance epoch (RFC8312 sec.4.1)
+      m_epochStart = now;
+      if (cwnd < m_wLastMax)
+        {
+          m_k = std::cbrt ((m_wLastMax - cwnd) / m_c);
+          m_originPoint = m_wLastMax;
+        }
+      else
+        {
+          m_k = 0;
+          m_originPoint = cwnd;
+        }
+      m_wEst = cwnd;
+    }
+
+  // Aim at the window of the cubic function one RTT ahead
+  double t = (now - m_epochStart + m_delayMin).GetSeconds ();
+  double target = m_originPoint + m_c * std::pow (t - m_k, 3);
+  if (m_tcpFriendliness)
+    { // Window of a standard TCP with the same decrease factor (RFC8312 sec.4.2)
+      m_wEst += 3 * (1 - m_beta) / (1 + m_beta) * segmentsAcked / cwnd;
+      target = std::max (target, m_wEst);
+    }
+  target = std::min (target, 1.5 * cwnd);
+
+  // Concave and convex regions (RFC8312 sec.4.3 and 4.4)
+  double increase = target > cwnd ? (target - cwnd) / cwnd : 0.01 / cwnd;
+  uint32_t adder = static_cast<uint32_t> (increase * segmentsAcked * m_segmentSize);
+  m_cWnd += std::max<uint32_t> (1, adder);
+  NS_LOG_INFO ("In CongAvoid, cubic target " << target << " segments, updated to cwnd " << m_cWnd);
+}
+
+uint32_t
+TcpCubic::GetSsThresh (void)
+{
+  NS_LOG_FUNCTION (this);
+  double cwnd = static_cast<double> (m_cWnd.Get ()) / m_segmentSize;
+  m_epochStart = Time (0);
+  if (m_fastConvergence && cwnd < m_wLastMax)
+    { // RFC8312 sec.4.6
+      m_wLastMax = cwnd * (1 + m_beta) / 2;
+    }
+  else
+    {
+      m_wLastMax = cwnd;
+    }
+  return std::max (2 * m_segmentSize, static_cast<uint32_t> (m_cWnd.Get () * m_beta));
+}
+
+} // namespace ns3
@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_CUBIC_H
+#define TCP_CUBIC_H
+
+#include "tcp-newreno.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup socket
+ * \ingroup tcp
+ *
+ * \brief An implementation of the CUBIC congestion control (\RFC{8312}).
+ *
+ * Out of slow start, the window follows a cubic function of the time
+ * since the last congestion event, centered on the window at that event,
+ * so that it grows fast far from it and slowly around it, independently
+ * of the round trip time.  The window is reduced by the factor Beta on a
+ * congestion event.  The loss recovery is the one of TcpNewReno.
+ */
+class TcpCubic : public TcpNewReno
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * Create an unbound tcp socket.
+   */
+  TcpCubic (void);
+  /**
+   * \brief Copy constructor
+   * \param sock the object to copy
+   */
+  TcpCubic (const TcpCubic& sock);
+  virtual ~TcpCubic (void);
+
+protected:
+  virtual Ptr<TcpSocketBase> Fork (void); // Call CopyObject<TcpCubic> to clone me
+  virtual void PktsAcked (SequenceNumber32 const& seq, uint32_t bytesAcked);
+  virtual void IncreaseWindow (SequenceNumber32 const& seq, uint32_t bytesAcked);
+  virtual uint32_t GetSsThresh (void);
+
+private:
+  double m_beta;             //!< Multiplicative decrease factor
+  double m_c;                //!< Scaling constant of the cubic function
+  bool   m_fastConvergence;  //!< Release bandwidth faster to new flows
+  bool   m_tcpFriendliness;  //!< Grow at least as fast as standard TCP
+
+  double m_wLastMax;         //!< Window before the last congestion event (segments)
+  double m_originPoint;      //!< Window at the plateau of the cubic function (segments)
+  double m_k;                //!< Time to reach the plateau from the epoch start (s)
+  double m_wEst;             //!< Window standard TCP would have (segments)
+  Time   m_epochStart;       //!< Start of the current congestion avoidance epoch, 0 if none
+  Time   m_delayMin;         //!< Smallest RTT measured
+};
+
+} // namespace ns3
+
+#endif /* TCP_CUBIC_H */
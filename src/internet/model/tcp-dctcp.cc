@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#define NS_LOG_APPEND_CONTEXT \
+  if (m_node) { std::clog << Simulator::Now ().GetSeconds () << " [node " << m_node->GetId () << "] "; }
+
+#include "tcp-dctcp.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/double.h"
+#include "ns3/trace-source-accessor.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpDctcp");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpDctcp);
+
+TypeId
+TcpDctcp::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpDctcp")
+    .SetParent<TcpNewReno> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpDctcp> ()
+    .AddAttribute ("G", "Weight of the fraction of marked bytes of the last window in alpha",
+                   DoubleValue (1.0 / 16),
+                   MakeDoubleAccessor (&TcpDctcp::m_g),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("AlphaOnInit", "Initial value of alpha",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&TcpDctcp::m_alpha),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddTraceSource ("Alpha",
+                     "Estimated fraction of the bytes marked",
+                     MakeTraceSourceAccessor (&TcpDctcp::m_alpha),
+                     "ns3::TracedValue::DoubleCallback")
+  ;
+  return tid;
+}
+
+TcpDctcp::TcpDctcp (void)
+  : m_g (1.0 / 16), // mute valgrind, actual value set by the attribute system
+    m_ackedBytesEcn (0),
+    m_ackedBytesTotal (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpDctcp::TcpDctcp (const TcpDctcp& sock)
+  : TcpNewReno (sock),
+    m_g (sock.m_g),
+    m_alpha (sock.m_alpha),
+    m_ackedBytesEcn (0),
+    m_ackedBytesTotal (0)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_LOGIC ("Invoked the copy constructor");
+}
+
+TcpDctcp::~TcpDctcp (void)
+{
+}
+
+int
+TcpDctcp::Listen (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_ecnEnabled = true;
+  return TcpNewReno::Listen ();
+}
+
+int
+TcpDctcp::Connect (const Address & address)
+{
+  NS_LOG_FUNCTION (this << address);
+  m_ecnEnabled = true;
+  return TcpNewReno::Connect (address);
+}
+
+Ptr<TcpSocketBase>
+TcpDctcp::Fork (void)
+{
+  return CopyObject<TcpDctcp> (this);
+}
+
+void
+TcpDctcp::PktsAcked (SequenceNumber32 const& seq, uint32_t bytesAcked)
+{
+  NS_LOG_FUNCTION (this << seq << bytesAcked);
+  m_ackedBytesTotal += bytesAcked;
+  if (m_ecnEchoReceived)
+    {
+      m_ackedBytesEcn += bytesAcked;
+    }
+  if (seq >= m_nextSeq)
+    { // End of the observation window: update alpha (RFC8257 sec.3.3)
+      double fraction = m_ackedBytesTotal ? static_cast<double> (m_ackedBytesEcn) / m_ackedBytesTotal : 0;
+      m_alpha = (1 - m_g) * m_alpha + m_g * fraction;
+      NS_LOG_INFO ("Fraction of marked bytes " << fraction << ", alpha updated to " << m_alpha);
+      m_ackedBytesEcn = 0;
+      m_ackedBytesTotal = 0;
+      m_nextSeq = m_highTxMark;
+    }
+  if (m_ecnEchoReceived && !m_inFastRec && seq > m_ecnRecover)
+    { // Reduce the window in proportion to the congestion, once per window
+      m_cWnd = std::max (2 * m_segmentSize, static_cast<uint32_t> (m_cWnd.Get () * (1 - m_alpha / 2)));
+      m_ssThresh = m_cWnd;
+      m_ecnRecover = m_highTxMark;
+      m_ecnCwrPending = true;
+      NS_LOG_INFO ("ECN echo. Reset cwnd to " << m_cWnd << " with alpha " << m_alpha);
+    }
+}
+
+void
+TcpDctcp::ProcessEcn (const TcpHeader& tcpHeader, bool ce)
+{
+  NS_LOG_FUNCTION (this << tcpHeader << ce);
+  if (ce != m_ecnEcho)
+    { // Acknowledge at once the segments received with the other codepoint,
+      // so that the echo is exact despite the delayed ACKs (RFC8257 sec.3.2)
+      if (m_delAckEvent.IsRunning ())
+        {
+          SendEmptyPacket (TcpHeader::ACK);
+        }
+      m_ecnEcho = ce;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,79 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_DCTCP_H
+#define TCP_DCTCP_H
+
+#include "tcp-newreno.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup socket
+ * \ingroup tcp
+ *
+ * \brief An implementation of Data Center TCP (\RFC{8257}).
+ *
+ * The sender estimates the fraction of its data marked by the switches
+ * with the congestion experienced codepoint, and reduces its window in
+ * proportion to it, at most once per window: cwnd = cwnd * (1 - alpha / 2).
+ * The receiver echoes the codepoint of each segment exactly, sending an
+ * acknowledgment as soon as the codepoint changes.
+ *
+ * DCTCP needs ECN at both ends and marking switches (e.g. a RedQueue with
+ * the same thresholds, a queue weight of 1, and UseEcn set), so ECN is
+ * always requested, whatever the Ecn attribute.  The loss recovery is the
+ * one of TcpNewReno.
+ */
+class TcpDctcp : public TcpNewReno
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * Create an unbound tcp socket.
+   */
+  TcpDctcp (void);
+  /**
+   * \brief Copy constructor
+   * \param sock the object to copy
+   */
+  TcpDctcp (const TcpDctcp& sock);
+  virtual ~TcpDctcp (void);
+
+  // From TcpSocketBase
+  virtual int Connect (const Address &address);
+  virtual int Listen (void);
+
+protected:
+  virtual Ptr<TcpSocketBase> Fork (void); // Call CopyObject<TcpDctcp> to clone me
+  virtual void PktsAcked (SequenceNumber32 const& seq, uint32_t bytesAcked);
+  virtual void ProcessEcn (const TcpHeader& tcpHeader, bool ce);
+
+private:
+  double                 m_g;              //!< Weight of the new fraction of marked bytes
+  TracedValue<double>    m_alpha;          //!< Estimated fraction of marked bytes
+  uint32_t               m_ackedBytesEcn;  //!< Bytes acknowledged with an ECN echo in this window
+  uint32_t               m_ackedBytesTotal; //!< Bytes acknowledged in this window
+  SequenceNumber32       m_nextSeq;        //!< End of the current observation window
+};
+
+} // namespace ns3
+
+#endif /* TCP_DCTCP_H */
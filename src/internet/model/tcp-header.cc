@@ -42,6 +42,7 @@ TcpHeader::TcpHeader ()
     m_windowSize (0xffff),
     m_urgentPointer (0),
     m_calcChecksum (false),
+    m_virtualChecksum (false),
     m_goodChecksum (true),
     m_optionsLen (0)
 {
@@ -57,6 +58,12 @@ TcpHeader::EnableChecksums (void)
   m_calcChecksum = true;
 }
 
+void
+TcpHeader::EnableVirtualChecksums (void)
+{
+  m_virtualChecksum = true;
+}
+
 void
 TcpHeader::SetSourcePort (uint16_t port)
 {
@@ -342,7 +349,8 @@ TcpHeader::Serialize (Buffer::Iterator start)  const
     {
       uint16_t headerChecksum = CalculateHeaderChecksum (start.GetSize ());
       i = start;
-      uint16_t checksum = i.CalculateIpChecksum (start.GetSize (), headerChecksum);
+      uint16_t size = m_virtualChecksum ? GetSerializedSize () : start.GetSize ();
+      uint16_t checksum = i.CalculateIpChecksum (size, headerChecksum);
 
       i = start;
       i.Next (16);
@@ -359,7 +367,7 @@ TcpHeader::Deserialize (Buffer::Iterator start)
   m_sequenceNumber = i.ReadNtohU32 ();
   m_ackNumber = i.ReadNtohU32 ();
   uint16_t field = i.ReadNtohU16 ();
-  m_flags = field & 0x3F;
+  m_flags = field & 0xFF;
   m_length = field>>12;
   m_windowSize = i.ReadNtohU16 ();
   i.Next (2);
@@ -425,7 +433,8 @@ TcpHeader::Deserialize (Buffer::Iterator start)
     {
       uint16_t headerChecksum = CalculateHeaderChecksum (start.GetSize ());
       i = start;
-      uint16_t checksum = i.CalculateIpChecksum (start.GetSize (), headerChecksum);
+      uint16_t size = m_virtualChecksum ? GetSerializedSize () : start.GetSize ();
+      uint16_t checksum = i.CalculateIpChecksum (size, headerChecksum);
       m_goodChecksum = (checksum == 0);
     }
 
@@ -352,6 +352,10 @@ TcpL4Protocol::Receive (Ptr<Packet> packet,
   if(Node::ChecksumEnabled ())
     {
       tcpHeader.EnableChecksums ();
+      if (Node::ChecksumVirtual ())
+        {
+          tcpHeader.EnableVirtualChecksums ();
+        }
       tcpHeader.InitializeChecksum (ipHeader.GetSource (), ipHeader.GetDestination (), PROT_NUMBER);
     }
 
@@ -446,6 +450,10 @@ TcpL4Protocol::Receive (Ptr<Packet> packet,
   if(Node::ChecksumEnabled ())
     {
       tcpHeader.EnableChecksums ();
+      if (Node::ChecksumVirtual ())
+        {
+          tcpHeader.EnableVirtualChecksums ();
+        }
       tcpHeader.InitializeChecksum (ipHeader.GetSourceAddress (), ipHeader.GetDestinationAddress (), PROT_NUMBER);
     }
 
@@ -524,6 +532,10 @@ TcpL4Protocol::Send (Ptr<Packet> packet,
   if(Node::ChecksumEnabled ())
     {
       tcpHeader.EnableChecksums ();
+      if (Node::ChecksumVirtual ())
+        {
+          tcpHeader.EnableVirtualChecksums ();
+        }
     }
   tcpHeader.InitializeChecksum (saddr,
                                 daddr,
@@ -568,6 +580,10 @@ TcpL4Protocol::Send (Ptr<Packet> packet,
   if(Node::ChecksumEnabled ())
     {
       tcpHeader.EnableChecksums ();
+      if (Node::ChecksumVirtual ())
+        {
+          tcpHeader.EnableVirtualChecksums ();
+        }
     }
   tcpHeader.InitializeChecksum (saddr,
                                 daddr,
@@ -617,6 +633,10 @@ TcpL4Protocol::SendPacket (Ptr<Packet> packet, const TcpHeader &outgoing,
   if(Node::ChecksumEnabled ())
     {
       outgoingHeader.EnableChecksums ();
+      if (Node::ChecksumVirtual ())
+        {
+          outgoingHeader.EnableVirtualChecksums ();
+        }
     }
   outgoingHeader.InitializeChecksum (saddr, daddr, PROT_NUMBER);
 
@@ -668,6 +688,10 @@ TcpL4Protocol::SendPacket (Ptr<Packet> packet, const TcpHeader &outgoing,
   if(Node::ChecksumEnabled ())
     {
       outgoingHeader.EnableChecksums ();
+      if (Node::ChecksumVirtual ())
+        {
+          outgoingHeader.EnableVirtualChecksums ();
+        }
     }
   outgoingHeader.InitializeChecksum (saddr, daddr, PROT_NUMBER);
 
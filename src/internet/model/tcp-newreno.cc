@@ -77,7 +77,8 @@ TcpNewReno::TcpNewReno (const TcpNewReno& sock)
     m_initialSsThresh (sock.m_initialSsThresh),
     m_retxThresh (sock.m_retxThresh),
     m_inFastRec (false),
-    m_limitedTx (sock.m_limitedTx)
+    m_limitedTx (sock.m_limitedTx),
+    m_ecnRecover (sock.m_ecnRecover)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_LOGIC ("Invoked the copy constructor");
@@ -128,8 +129,17 @@ TcpNewReno::NewAck (const SequenceNumber32& seq)
                 " cwnd " << m_cWnd <<
                 " ssthresh " << m_ssThresh);
 
+  uint32_t bytesAcked = seq - m_txBuffer->HeadSequence ();
+  PktsAcked (seq, bytesAcked);
+
   // Check for exit condition of fast recovery
-  if (m_inFastRec && seq < m_recover)
+  if (m_inFastRec && seq < m_recover && m_sackEnabled)
+    { // Partial ACK in SACK recovery: the holes to retransmit are in the scoreboard (RFC6675 sec.5)
+      TcpSocketBase::NewAck (seq);
+      SendSackRecoveryData (m_cWnd, m_retxThresh);
+      return;
+    }
+  else if (m_inFastRec && seq < m_recover)
     { // Partial ACK, partial window deflation (RFC2582 sec.3 bullet #5 paragraph 3)
       m_cWnd += m_segmentSize - (seq - m_txBuffer->HeadSequence ());
       NS_LOG_INFO ("Partial ACK for seq " << seq << " in fast recovery: cwnd set to " << m_cWnd);
@@ -145,6 +155,30 @@ TcpNewReno::NewAck (const SequenceNumber32& seq)
       NS_LOG_INFO ("Received full ACK for seq " << seq <<". Leaving fast recovery with cwnd set to " << m_cWnd);
     }
 
+  IncreaseWindow (seq, bytesAcked);
+
+  // Complete newAck processing
+  TcpSocketBase::NewAck (seq);
+}
+
+void
+TcpNewReno::PktsAcked (SequenceNumber32 const& seq, uint32_t bytesAcked)
+{
+  NS_LOG_FUNCTION (this << seq << bytesAcked);
+  if (m_ecnEchoReceived && !m_inFastRec && seq > m_ecnRecover)
+    { // Congestion experienced: reduce the window as for a loss, once per window (RFC3168 sec.6.1.2)
+      m_ssThresh = GetSsThresh ();
+      m_cWnd = m_ssThresh;
+      m_ecnRecover = m_highTxMark;
+      m_ecnCwrPending = true;
+      NS_LOG_INFO ("ECN echo. Reset cwnd to " << m_cWnd << ", ssthresh to " << m_ssThresh);
+    }
+}
+
+void
+TcpNewReno::IncreaseWindow (SequenceNumber32 const& seq, uint32_t bytesAcked)
+{
+  NS_LOG_FUNCTION (this << seq << bytesAcked);
   // Increase of cwnd based on current phase (slow start or congestion avoidance)
   if (m_cWnd < m_ssThresh)
     { // Slow start mode, add one segSize to cWnd. Default m_ssThresh is 65535. (RFC2001, sec.1)
@@ -159,9 +193,12 @@ TcpNewReno::NewAck (const SequenceNumber32& seq)
       m_cWnd += static_cast<uint32_t> (adder);
       NS_LOG_INFO ("In CongAvoid, updated to cwnd " << m_cWnd << " ssthresh " << m_ssThresh);
     }
+}
 
-  // Complete newAck processing
-  TcpSocketBase::NewAck (seq);
+uint32_t
+TcpNewReno::GetSsThresh (void)
+{
+  return std::max (2 * m_segmentSize, BytesInFlight () / 2);
 }
 
 /* Cut cwnd and enter fast recovery mode upon triple dupack */
@@ -169,15 +206,25 @@ void
 TcpNewReno::DupAck (const TcpHeader& t, uint32_t count)
 {
   NS_LOG_FUNCTION (this << count);
-  if (count == m_retxThresh && !m_inFastRec)
-    { // triple duplicate ack triggers fast retransmit (RFC2582 sec.3 bullet #1)
-      m_ssThresh = std::max (2 * m_segmentSize, BytesInFlight () / 2);
-      m_cWnd = m_ssThresh + 3 * m_segmentSize;
+  if ((count == m_retxThresh || IsHeadLost (m_retxThresh)) && !m_inFastRec)
+    { // triple duplicate ack triggers fast retransmit (RFC2582 sec.3 bullet #1),
+      // as does enough data SACKed above the first unacknowledged byte (RFC6675 sec.5 step 4)
+      m_ssThresh = GetSsThresh ();
+      m_cWnd = m_sackEnabled ? m_ssThresh.Get () : m_ssThresh.Get () + 3 * m_segmentSize;
       m_recover = m_highTxMark;
       m_inFastRec = true;
       NS_LOG_INFO ("Triple dupack. Enter fast recovery mode. Reset cwnd to " << m_cWnd <<
                    ", ssthresh to " << m_ssThresh << " at fast recovery seqnum " << m_recover);
+      m_highRxt = m_txBuffer->HeadSequence ();
       DoRetransmit ();
+      if (m_sackEnabled)
+        {
+          SendSackRecoveryData (m_cWnd, m_retxThresh);
+        }
+    }
+  else if (m_inFastRec && m_sackEnabled)
+    { // The dupack SACKed more data: send what the pipe allows (RFC6675 sec.5 step C)
+      SendSackRecoveryData (m_cWnd, m_retxThresh);
     }
   else if (m_inFastRec)
     { // Increase cwnd for every additional dupack (RFC2582, sec.3 bullet #3)
@@ -209,7 +256,7 @@ TcpNewReno::Retransmit (void)
   // According to RFC2581 sec.3.1, upon RTO, ssthresh is set to half of flight
   // size and cwnd is set to 1*MSS, then the lost packet is retransmitted and
   // TCP back to slow start
-  m_ssThresh = std::max (2 * m_segmentSize, BytesInFlight () / 2);
+  m_ssThresh = GetSsThresh ();
   m_cWnd = m_segmentSize;
   m_nextTxSequence = m_txBuffer->HeadSequence (); // Restart from highest Ack
   NS_LOG_INFO ("RTO. Reset cwnd to " << m_cWnd <<
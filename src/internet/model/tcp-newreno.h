@@ -32,6 +32,11 @@ namespace ns3 {
  * \brief An implementation of a stream socket using TCP.
  *
  * This class contains the NewReno implementation of TCP, as of \RFC{2582}.
+ *
+ * The loss recovery is shared with the subclasses, which define their
+ * congestion control through three hooks: PktsAcked () on every new
+ * acknowledgment, IncreaseWindow () to grow the window out of recovery,
+ * and GetSsThresh () on every congestion event.
  */
 class TcpNewReno : public TcpSocketBase
 {
@@ -63,6 +68,35 @@ protected:
   virtual void DupAck (const TcpHeader& t, uint32_t count);  // Halving cwnd and reset nextTxSequence
   virtual void Retransmit (void); // Exit fast recovery upon retransmit timeout
 
+  /**
+   * \brief Account for data newly acknowledged, before the window update
+   *
+   * The default reacts to an ECN echo like to a loss, at most once per
+   * window of data (\RFC{3168} section 6.1.2).
+   *
+   * \param seq the acknowledged sequence number
+   * \param bytesAcked the number of bytes newly acknowledged
+   */
+  virtual void PktsAcked (SequenceNumber32 const& seq, uint32_t bytesAcked);
+  /**
+   * \brief Grow the congestion window on a new acknowledgment out of recovery
+   *
+   * The default is the slow start and congestion avoidance of \RFC{2581}.
+   *
+   * \param seq the acknowledged sequence number
+   * \param bytesAcked the number of bytes newly acknowledged
+   */
+  virtual void IncreaseWindow (SequenceNumber32 const& seq, uint32_t bytesAcked);
+  /**
+   * \brief Get the slow start threshold after a congestion event
+   *
+   * Called once per loss, timeout or ECN echo reaction.  The default is
+   * half the data in flight (\RFC{2581} section 3.1).
+   *
+   * \return the new slow start threshold (bytes)
+   */
+  virtual uint32_t GetSsThresh (void);
+
   // Implementing ns3::TcpSocket -- Attribute get/set
   virtual void     SetSegSize (uint32_t size);
   virtual void     SetInitialSSThresh (uint32_t threshold);
@@ -84,6 +118,7 @@ protected:
   uint32_t               m_retxThresh;   //!< Fast Retransmit threshold
   bool                   m_inFastRec;    //!< currently in fast recovery
   bool                   m_limitedTx;    //!< perform limited transmit
+  SequenceNumber32       m_ecnRecover;   //!< Highest Tx seqnum when the window was last reduced on an ECN echo
 };
 
 } // namespace ns3
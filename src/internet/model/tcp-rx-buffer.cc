@@ -156,8 +156,14 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
+  // Remove overlapped bytes from packet.  The buffered packets do not
+  // overlap each other: the first one which may overlap the incoming one
+  // is the last one starting at or before headSeq.
+  BufIterator i = m_data.upper_bound (headSeq);
+  if (i != m_data.begin ())
+    {
+      --i;
+    }
   while (i != m_data.end () && i->first <= tailSeq)
     {
       SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
@@ -199,16 +205,12 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
   // Update variables
   m_size += p->GetSize ();      // Occupancy
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  if (headSeq > m_nextRxSeq)
+    { // Reported first in the SACK option
+      m_lastSeq = headSeq;
+    }
+  for (BufIterator i = m_data.lower_bound (m_nextRxSeq); i != m_data.end () && i->first == m_nextRxSeq; ++i)
     {
-      if (i->first < m_nextRxSeq)
-        {
-          continue;
-        }
-      else if (i->first > m_nextRxSeq)
-        {
-          break;
-        };
       m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
       m_availBytes += i->second->GetSize ();
     }
@@ -220,6 +222,36 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   return true;
 }
 
+TcpOptionSack::SackList
+TcpRxBuffer::GetSackList (uint32_t maxBlocks) const
+{
+  NS_LOG_FUNCTION (this << maxBlocks);
+  TcpOptionSack::SackList blocks;
+  std::map<SequenceNumber32, Ptr<Packet> >::const_iterator i = m_data.lower_bound (m_nextRxSeq);
+  while (i != m_data.end ())
+    {
+      // merge the contiguous packets in a block
+      TcpOptionSack::SackBlock block (i->first, i->first + SequenceNumber32 (i->second->GetSize ()));
+      for (++i; i != m_data.end () && i->first == block.second; ++i)
+        {
+          block.second = i->first + SequenceNumber32 (i->second->GetSize ());
+        }
+      if (block.first <= m_lastSeq && m_lastSeq < block.second)
+        {
+          blocks.push_front (block);
+        }
+      else
+        {
+          blocks.push_back (block);
+        }
+    }
+  while (blocks.size () > maxBlocks)
+    {
+      blocks.pop_back ();
+    }
+  return blocks;
+}
+
 Ptr<Packet>
 TcpRxBuffer::Extract (uint32_t maxSize)
 {
@@ -27,6 +27,7 @@
 #include "ns3/sequence-number.h"
 #include "ns3/ptr.h"
 #include "ns3/tcp-header.h"
+#include "ns3/tcp-option-sack.h"
 
 namespace ns3 {
 class Packet;
@@ -36,6 +37,12 @@ class Packet;
  *
  * \brief class for the reordering buffer that keeps the data from lower layer, i.e.
  *        TcpL4Protocol, sent to the application
+ *
+ * The buffered packets are disjoint intervals of sequence numbers, kept in
+ * a map by their first sequence number: an incoming packet is only
+ * compared with the intervals it may overlap, found by a search from its
+ * head, and the next expected sequence number only advances through the
+ * intervals following it.
  */
 class TcpRxBuffer : public Object
 {
@@ -124,6 +131,18 @@ public:
    * \returns a packet
    */
   Ptr<Packet> Extract (uint32_t maxSize);
+
+  /**
+   * \brief Get the blocks of data received beyond the next expected
+   * sequence number, to be reported in a SACK option (\RFC{2018})
+   *
+   * The block holding the most recently buffered data comes first, then
+   * the other ones in increasing sequence order.
+   *
+   * \param maxBlocks the largest number of blocks to report
+   * \returns the blocks, none if there is no hole in the data received
+   */
+  TcpOptionSack::SackList GetSackList (uint32_t maxBlocks) const;
 public:
   /// container for data stored in the buffer
   typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
@@ -134,6 +153,7 @@ public:
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
   std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+  SequenceNumber32 m_lastSeq;                //!< Seqnum of the last data buffered beyond a hole
 };
 
 } //namepsace ns3
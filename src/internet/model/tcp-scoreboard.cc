@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+
+#include "ns3/log.h"
+#include "tcp-scoreboard.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpScoreboard");
+
+TcpScoreboard::TcpScoreboard ()
+  : m_sacked (0)
+{
+}
+
+uint32_t
+TcpScoreboard::AddBlock (SequenceNumber32 start, SequenceNumber32 end,
+                         SequenceNumber32 head, SequenceNumber32 highData)
+{
+  NS_LOG_FUNCTION (this << start << end << head << highData);
+  if (start < head)
+    {
+      start = head;
+    }
+  if (end > highData)
+    {
+      end = highData;
+    }
+  if (end <= start)
+    {
+      NS_LOG_LOGIC ("Block outside of the data in flight, ignored");
+      return 0;
+    }
+
+  uint32_t sacked = m_sacked;
+  // merge with the intervals overlapping or touching the block
+  Blocks::iterator i = m_blocks.upper_bound (start);
+  if (i != m_blocks.begin ())
+    {
+      Blocks::iterator previous = i;
+      --previous;
+      if (previous->second >= start)
+        {
+          i = previous;
+        }
+    }
+  while (i != m_blocks.end () && i->first <= end)
+    {
+      start = std::min (start, i->first);
+      end = std::max (end, i->second);
+      m_sacked -= i->second - i->first;
+      m_blocks.erase (i++);
+    }
+  m_blocks[start] = end;
+  m_sacked += end - start;
+  NS_LOG_LOGIC ("SACKed [" << start << ";" << end << "), " << m_sacked << " bytes in "
+                           << m_blocks.size () << " intervals");
+  return m_sacked - sacked;
+}
+
+void
+TcpScoreboard::DiscardUpTo (SequenceNumber32 seq)
+{
+  NS_LOG_FUNCTION (this << seq);
+  while (!m_blocks.empty () && m_blocks.begin ()->first < seq)
+    {
+      Blocks::iterator first = m_blocks.begin ();
+      SequenceNumber32 end = first->second;
+      m_sacked -= end - first->first;
+      m_blocks.erase (first);
+      if (end > seq)
+        {
+          m_blocks[seq] = end;
+          m_sacked += end - seq;
+          break;
+        }
+    }
+}
+
+void
+TcpScoreboard::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_blocks.clear ();
+  m_sacked = 0;
+}
+
+bool
+TcpScoreboard::IsEmpty (void) const
+{
+  return m_blocks.empty ();
+}
+
+bool
+TcpScoreboard::IsSacked (SequenceNumber32 seq) const
+{
+  Blocks::const_iterator i = m_blocks.upper_bound (seq);
+  if (i == m_blocks.begin ())
+    {
+      return false;
+    }
+  --i;
+  return seq < i->second;
+}
+
+uint32_t
+TcpScoreboard::GetSackedBytes (void) const
+{
+  return m_sacked;
+}
+
+uint32_t
+TcpScoreboard::GetNBlocks (void) const
+{
+  return m_blocks.size ();
+}
+
+bool
+TcpScoreboard::IsLost (uint32_t sackedAbove, uint32_t blocksAbove,
+                       uint32_t dupThresh, uint32_t segmentSize)
+{
+  return blocksAbove >= dupThresh || sackedAbove > (dupThresh - 1) * segmentSize;
+}
+
+bool
+TcpScoreboard::IsLost (SequenceNumber32 seq, uint32_t dupThresh, uint32_t segmentSize) const
+{
+  uint32_t sackedAbove = 0;
+  uint32_t blocksAbove = 0;
+  for (Blocks::const_reverse_iterator i = m_blocks.rbegin (); i != m_blocks.rend () && i->first > seq; ++i)
+    {
+      sackedAbove += i->second - std::max (i->first, seq);
+      blocksAbove++;
+    }
+  return IsLost (sackedAbove, blocksAbove, dupThresh, segmentSize);
+}
+
+uint32_t
+TcpScoreboard::GetPipe (SequenceNumber32 head, SequenceNumber32 highData, SequenceNumber32 highRxt,
+                        uint32_t dupThresh, uint32_t segmentSize) const
+{
+  NS_LOG_FUNCTION (this << head << highData << highRxt);
+  uint32_t pipe = 0;
+  uint32_t sackedAbove = 0;
+  uint32_t blocksAbove = 0;
+  // the holes, from the highest one down to the one starting at head
+  SequenceNumber32 holeEnd = highData;
+  Blocks::const_reverse_iterator i = m_blocks.rbegin ();
+  while (true)
+    {
+      SequenceNumber32 holeStart = (i == m_blocks.rend ()) ? head : i->second;
+      if (holeStart < holeEnd)
+        {
+          if (!IsLost (sackedAbove, blocksAbove, dupThresh, segmentSize))
+            {
+              pipe += holeEnd - holeStart;
+            }
+          if (highRxt > holeStart)
+            {
+              pipe += std::min (holeEnd, highRxt) - holeStart;
+            }
+        }
+      if (i == m_blocks.rend ())
+        {
+          break;
+        }
+      sackedAbove += i->second - i->first;
+      blocksAbove++;
+      holeEnd = i->first;
+      ++i;
+    }
+  return pipe;
+}
+
+bool
+TcpScoreboard::GetNextHole (SequenceNumber32 head, SequenceNumber32 highRxt, uint32_t dupThresh,
+                            uint32_t segmentSize, bool lostOnly,
+                            SequenceNumber32 &seq, uint32_t &length) const
+{
+  NS_LOG_FUNCTION (this << head << highRxt << lostOnly);
+  uint32_t sackedAbove = m_sacked;
+  uint32_t blocksAbove = m_blocks.size ();
+  SequenceNumber32 holeStart = head;
+  for (Blocks::const_iterator i = m_blocks.begin (); i != m_blocks.end (); ++i)
+    {
+      if (lostOnly && !IsLost (sackedAbove, blocksAbove, dupThresh, segmentSize))
+        { // the holes above have even less data SACKed above them
+          return false;
+        }
+      SequenceNumber32 first = std::max (holeStart, highRxt);
+      if (first < i->first)
+        {
+          seq = first;
+          length = std::min<uint32_t> (segmentSize, i->first - first);
+          return true;
+        }
+      sackedAbove -= i->second - i->first;
+      blocksAbove--;
+      holeStart = i->second;
+    }
+  return false;
+}
+
+} // namespace ns3
@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_SCOREBOARD_H
+#define TCP_SCOREBOARD_H
+
+#include <map>
+#include <stdint.h>
+
+#include "ns3/sequence-number.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief The data of a TCP sender selectively acknowledged by the
+ * receiver, as in \RFC{6675}.
+ *
+ * The SACKed data are kept as disjoint, non adjacent intervals of sequence
+ * numbers in a map indexed by their first sequence number, so that the
+ * cost of the operations grows with the number of holes in the data
+ * received by the peer rather than with the number of segments in flight.
+ * The unSACKed sequence numbers between two intervals all have the same
+ * data SACKed above them, so IsLost () is decided for the whole hole at
+ * once, and GetPipe () and GetNextHole () visit every interval once.
+ *
+ * A sequence number is deemed lost when at least dupThresh SACK blocks or
+ * more than (dupThresh - 1) segments of data have been SACKed above it,
+ * the blocks standing for the discontiguous SACKed sequences of the RFC.
+ *
+ * The scoreboard is not a reference counted object.
+ */
+class TcpScoreboard
+{
+public:
+  TcpScoreboard ();
+
+  /**
+   * \brief Record a SACK block
+   *
+   * The part of the block outside [head, highData) is ignored.
+   *
+   * \param start the first sequence number of the block
+   * \param end the sequence number following the block
+   * \param head the first unacknowledged sequence number (HighACK)
+   * \param highData the sequence number following the highest one sent
+   * \return the number of bytes SACKed for the first time
+   */
+  uint32_t AddBlock (SequenceNumber32 start, SequenceNumber32 end,
+                     SequenceNumber32 head, SequenceNumber32 highData);
+
+  /**
+   * \brief Forget the data cumulatively acknowledged
+   * \param seq the new first unacknowledged sequence number
+   */
+  void DiscardUpTo (SequenceNumber32 seq);
+
+  /**
+   * \brief Forget all the SACKed data, as after a retransmission timeout
+   */
+  void Clear (void);
+
+  /**
+   * \return true if no data is SACKed
+   */
+  bool IsEmpty (void) const;
+
+  /**
+   * \param seq a sequence number
+   * \return true if seq is SACKed
+   */
+  bool IsSacked (SequenceNumber32 seq) const;
+
+  /**
+   * \return the number of bytes SACKed
+   */
+  uint32_t GetSackedBytes (void) const;
+
+  /**
+   * \return the number of disjoint SACKed intervals
+   */
+  uint32_t GetNBlocks (void) const;
+
+  /**
+   * \param seq a sequence number, not SACKed
+   * \param dupThresh the number of duplicate acknowledgments signalling a loss
+   * \param segmentSize the segment size
+   * \return true if seq is deemed lost (IsLost () of the RFC)
+   */
+  bool IsLost (SequenceNumber32 seq, uint32_t dupThresh, uint32_t segmentSize) const;
+
+  /**
+   * \brief Compute the number of bytes in flight (SetPipe () of the RFC)
+   *
+   * Every unSACKed byte not deemed lost counts once, and every unSACKed
+   * byte retransmitted counts once more.
+   *
+   * \param head the first unacknowledged sequence number (HighACK)
+   * \param highData the sequence number following the highest one sent
+   * \param highRxt the sequence number following the highest one retransmitted
+   * \param dupThresh the number of duplicate acknowledgments signalling a loss
+   * \param segmentSize the segment size
+   * \return the number of bytes in flight
+   */
+  uint32_t GetPipe (SequenceNumber32 head, SequenceNumber32 highData, SequenceNumber32 highRxt,
+                    uint32_t dupThresh, uint32_t segmentSize) const;
+
+  /**
+   * \brief Find the next unSACKed data to retransmit, rules (1) and (3)
+   * of NextSeg () in the RFC
+   *
+   * \param head the first unacknowledged sequence number (HighACK)
+   * \param highRxt the sequence number following the highest one retransmitted
+   * \param dupThresh the number of duplicate acknowledgments signalling a loss
+   * \param segmentSize the segment size
+   * \param lostOnly true to only consider the data deemed lost
+   * \param seq the first sequence number to retransmit
+   * \param length the number of bytes to retransmit, at most segmentSize
+   * \return false if there is nothing to retransmit below the highest
+   *         SACKed sequence number
+   */
+  bool GetNextHole (SequenceNumber32 head, SequenceNumber32 highRxt, uint32_t dupThresh,
+                    uint32_t segmentSize, bool lostOnly,
+                    SequenceNumber32 &seq, uint32_t &length) const;
+
+private:
+  /**
+   * \param sackedAbove the number of bytes SACKed above a sequence number
+   * \param blocksAbove the number of SACKed intervals above it
+   * \param dupThresh the number of duplicate acknowledgments signalling a loss
+   * \param segmentSize the segment size
+   * \return true if the sequence number is deemed lost
+   */
+  static bool IsLost (uint32_t sackedAbove, uint32_t blocksAbove,
+                      uint32_t dupThresh, uint32_t segmentSize);
+
+  /// the SACKed intervals: first sequence number, following sequence number
+  typedef std::map<SequenceNumber32, SequenceNumber32> Blocks;
+
+  Blocks m_blocks;   //!< the SACKed intervals
+  uint32_t m_sacked; //!< the number of bytes SACKed
+};
+
+} // namespace ns3
+
+#endif /* TCP_SCOREBOARD_H */
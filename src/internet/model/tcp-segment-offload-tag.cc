@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-segment-offload-tag.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpSegmentOffloadTag");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpSegmentOffloadTag);
+
+TcpSegmentOffloadTag::TcpSegmentOffloadTag ()
+  : m_segmentSize (0),
+    m_last (true)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TcpSegmentOffloadTag::SetSegmentSize (uint16_t segmentSize)
+{
+  NS_LOG_FUNCTION (this << segmentSize);
+  m_segmentSize = segmentSize;
+}
+
+uint16_t
+TcpSegmentOffloadTag::GetSegmentSize (void) const
+{
+  return m_segmentSize;
+}
+
+void
+TcpSegmentOffloadTag::SetLast (bool last)
+{
+  NS_LOG_FUNCTION (this << last);
+  m_last = last;
+}
+
+bool
+TcpSegmentOffloadTag::IsLast (void) const
+{
+  return m_last;
+}
+
+TypeId
+TcpSegmentOffloadTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpSegmentOffloadTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpSegmentOffloadTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+TcpSegmentOffloadTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+TcpSegmentOffloadTag::GetSerializedSize (void) const
+{
+  return sizeof (uint16_t) + sizeof (uint8_t);
+}
+
+void
+TcpSegmentOffloadTag::Serialize (TagBuffer i) const
+{
+  NS_LOG_FUNCTION (this << &i);
+  i.WriteU16 (m_segmentSize);
+  i.WriteU8 (m_last ? 1 : 0);
+}
+
+void
+TcpSegmentOffloadTag::Deserialize (TagBuffer i)
+{
+  NS_LOG_FUNCTION (this << &i);
+  m_segmentSize = i.ReadU16 ();
+  m_last = i.ReadU8 () != 0;
+}
+
+void
+TcpSegmentOffloadTag::Print (std::ostream &os) const
+{
+  os << "TSO [SegmentSize: " << m_segmentSize << ", Last: " << m_last << "] ";
+}
+
+} // namespace ns3
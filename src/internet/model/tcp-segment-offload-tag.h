@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_SEGMENT_OFFLOAD_TAG_H
+#define TCP_SEGMENT_OFFLOAD_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Mark a TCP segment carrying several segments worth of data.
+ *
+ * A TcpSocketBase whose TsoSegments attribute is greater than one sends
+ * up to TsoSegments segments of data in a single packet (a super-segment),
+ * tagged with the segment size of the connection.  Ipv4L3Protocol sends
+ * the super-segment as it is over an interface whose MTU is large enough,
+ * and splits it in segments of that size otherwise, as the segmentation
+ * offload of a NIC would do.  The segments split keep the tag with a zero
+ * segment size, the last one being flagged, so that the receiver can
+ * acknowledge them together, as generic receive offload would do.
+ */
+class TcpSegmentOffloadTag : public Tag
+{
+public:
+  TcpSegmentOffloadTag ();
+
+  /**
+   * \brief Set the size of the segments the packet is to be split in
+   * \param segmentSize the segment size, 0 if the packet was split already
+   */
+  void SetSegmentSize (uint16_t segmentSize);
+  /**
+   * \brief Get the size of the segments the packet is to be split in
+   * \returns the segment size, 0 if the packet was split already
+   */
+  uint16_t GetSegmentSize (void) const;
+
+  /**
+   * \brief Set whether the packet is the last piece of a super-segment
+   * \param last true for the last piece, or for a super-segment not split
+   */
+  void SetLast (bool last);
+  /**
+   * \brief Tell whether the packet is the last piece of a super-segment
+   * \returns true for the last piece, or for a super-segment not split
+   */
+  bool IsLast (void) const;
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual void Print (std::ostream &os) const;
+
+private:
+  uint16_t m_segmentSize; //!< the size of the segments, 0 once split
+  bool m_last;            //!< last piece of a super-segment
+};
+
+} // namespace ns3
+
+#endif /* TCP_SEGMENT_OFFLOAD_TAG_H */
@@ -42,6 +42,7 @@
 #include "ns3/pointer.h"
 #include "ns3/trace-source-accessor.h"
 #include "tcp-socket-base.h"
+#include "tcp-segment-offload-tag.h"
 #include "tcp-l4-protocol.h"
 #include "ipv4-end-point.h"
 #include "ipv6-end-point.h"
@@ -49,6 +50,8 @@
 #include "tcp-header.h"
 #include "tcp-option-winscale.h"
 #include "tcp-option-ts.h"
+#include "tcp-option-sack-permitted.h"
+#include "tcp-option-sack.h"
 #include "rtt-estimator.h"
 
 #include <math.h>
@@ -96,6 +99,17 @@ TcpSocketBase::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&TcpSocketBase::m_timestampEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("Sack", "Enable or disable the SACK option (RFC 2018) and "
+                   "the SACK based loss recovery of the subclasses supporting it (RFC 6675)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_sackEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Ecn", "Enable or disable ECN (RFC 3168): the data segments "
+                   "are ECN-capable and the peer is told of the congestion experienced "
+                   "codepoints received. The subclasses supporting it react to the echo.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_ecnEnabled),
+                   MakeBooleanChecker ())
     .AddAttribute ("MinRto",
                    "Minimum retransmit timeout value",
                    TimeValue (Seconds (1.0)), // RFC 6298 says min RTO=1 sec, but Linux uses 200ms. See http://www.postel.org/pipermail/end2end-interest/2004-November/004402.html
@@ -108,6 +122,13 @@ TcpSocketBase::GetTypeId (void)
                    MakeTimeAccessor (&TcpSocketBase::SetClockGranularity,
                                      &TcpSocketBase::GetClockGranularity),
                                      MakeTimeChecker ())
+    .AddAttribute ("TsoSegments",
+                   "Maximum number of segments sent in a single super-segment, "
+                   "split by the IPv4 layer of the nodes on the path where "
+                   "the MTU requires it (segmentation offload); 1 disables it",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&TcpSocketBase::m_tsoSegments),
+                   MakeUintegerChecker<uint32_t> (1))
     .AddAttribute ("TxBuffer",
                    "TCP Tx buffer",
                    PointerValue (),
@@ -167,12 +188,19 @@ TcpSocketBase::TcpSocketBase (void)
     m_shutdownRecv (false),
     m_connected (false),
     m_segmentSize (0),
+    m_tsoSegments (1),
     // For attribute initialization consistency (quiet valgrind)
     m_rWnd (0),
     m_sndScaleFactor (0),
     m_rcvScaleFactor (0),
     m_timestampEnabled (true),
-    m_timestampToEcho (0)
+    m_timestampToEcho (0),
+    m_sackEnabled (false),
+    m_ecnEnabled (false),
+    m_ecnActive (false),
+    m_ecnEcho (false),
+    m_ecnEchoReceived (false),
+    m_ecnCwrPending (false)
 
 {
   NS_LOG_FUNCTION (this);
@@ -207,13 +235,22 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_connected (sock.m_connected),
     m_msl (sock.m_msl),
     m_segmentSize (sock.m_segmentSize),
+    m_tsoSegments (sock.m_tsoSegments),
     m_maxWinSize (sock.m_maxWinSize),
     m_rWnd (sock.m_rWnd),
     m_winScalingEnabled (sock.m_winScalingEnabled),
     m_sndScaleFactor (sock.m_sndScaleFactor),
     m_rcvScaleFactor (sock.m_rcvScaleFactor),
     m_timestampEnabled (sock.m_timestampEnabled),
-    m_timestampToEcho (sock.m_timestampToEcho)
+    m_timestampToEcho (sock.m_timestampToEcho),
+    m_sackEnabled (sock.m_sackEnabled),
+    m_scoreboard (sock.m_scoreboard),
+    m_highRxt (sock.m_highRxt),
+    m_ecnEnabled (sock.m_ecnEnabled),
+    m_ecnActive (sock.m_ecnActive),
+    m_ecnEcho (false),
+    m_ecnEchoReceived (false),
+    m_ecnCwrPending (false)
 
 {
   NS_LOG_FUNCTION (this);
@@ -935,6 +972,7 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, Ipv4Header header, uint16_t port
       return; // Discard invalid packet
     }
 
+  ReadEcn (packet, tcpHeader, header.GetEcn () == Ipv4Header::ECN_CE);
   ReadOptions (tcpHeader);
 
   if (tcpHeader.GetFlags () & TcpHeader::ACK)
@@ -1039,6 +1077,7 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, Ipv6Header header, uint16_t port
       return; // Discard invalid packet
     }
 
+  ReadEcn (packet, tcpHeader, (header.GetTrafficClass () & 0x03) == 0x03);
   ReadOptions (tcpHeader);
 
   if (tcpHeader.GetFlags () & TcpHeader::ACK)
@@ -1696,7 +1735,7 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
       ++s;
     }
 
-  header.SetFlags (flags);
+  header.SetFlags (AddEcnFlags (flags));
   header.SetSequenceNumber (s);
   header.SetAckNumber (m_rxBuffer->NextRxSequence ());
   if (m_endPoint != 0)
@@ -1927,6 +1966,12 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
 
   Ptr<Packet> p = m_txBuffer->CopyFromSequence (maxSize, seq);
   uint32_t sz = p->GetSize (); // Size of packet
+  if (sz > m_segmentSize)
+    { // A super-segment, see SendPendingData
+      TcpSegmentOffloadTag tsoTag;
+      tsoTag.SetSegmentSize (m_segmentSize);
+      p->AddPacketTag (tsoTag);
+    }
   uint8_t flags = withAck ? TcpHeader::ACK : 0;
   uint32_t remainingData = m_txBuffer->SizeFromSequence (seq + SequenceNumber32 (sz));
 
@@ -1942,17 +1987,19 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
    * if both options are set. Once the packet got to layer three, only
    * the corresponding tags will be read.
    */
-  if (IsManualIpTos ())
+  // Retransmissions are not ECN-capable (RFC 3168 section 6.1.5)
+  bool ect = m_ecnActive && seq >= m_highTxMark;
+  if (IsManualIpTos () || ect)
     {
       SocketIpTosTag ipTosTag;
-      ipTosTag.SetTos (GetIpTos ());
+      ipTosTag.SetTos (ect ? (GetIpTos () & 0xfc) | Ipv4Header::ECN_ECT0 : GetIpTos ());
       p->AddPacketTag (ipTosTag);
     }
 
-  if (IsManualIpv6Tclass ())
+  if (IsManualIpv6Tclass () || ect)
     {
       SocketIpv6TclassTag ipTclassTag;
-      ipTclassTag.SetTclass (GetIpv6Tclass ());
+      ipTclassTag.SetTclass (ect ? (GetIpv6Tclass () & 0xfc) | Ipv4Header::ECN_ECT0 : GetIpv6Tclass ());
       p->AddPacketTag (ipTclassTag);
     }
 
@@ -1970,6 +2017,12 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
       p->AddPacketTag (ipHopLimitTag);
     }
 
+  if (m_ecnCwrPending && seq >= m_highTxMark)
+    { // Tell the peer the window was reduced (RFC 3168 section 6.1.2)
+      flags |= TcpHeader::CWR;
+      m_ecnCwrPending = false;
+    }
+
   if (m_closeOnEmpty && (remainingData == 0))
     {
       flags |= TcpHeader::FIN;
@@ -1985,7 +2038,7 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
         }
     }
   TcpHeader header;
-  header.SetFlags (flags);
+  header.SetFlags (AddEcnFlags (flags));
   header.SetSequenceNumber (seq);
   header.SetAckNumber (m_rxBuffer->NextRxSequence ());
   if (m_endPoint)
@@ -2097,6 +2150,13 @@ TcpSocketBase::SendPendingData (bool withAck)
           break;
         }
       uint32_t s = std::min (w, m_segmentSize);  // Send no more than window
+      if (m_tsoSegments > 1 && m_endPoint != 0 && w >= 2 * m_segmentSize)
+        { // Send several segments at once, as many as the IPv4 total length
+          // allows with the largest IP and TCP headers
+          uint32_t n = std::min (w / m_segmentSize, m_tsoSegments);
+          n = std::min (n, std::max<uint32_t> (1, (65535 - 60 - 60) / m_segmentSize));
+          s = n * m_segmentSize;
+        }
       uint32_t sz = SendDataPacket (m_nextTxSequence, s, withAck);
       nPacketsSent++;                             // Count sent this loop
       m_nextTxSequence += sz;                     // Advance next tx sequence
@@ -2161,6 +2221,10 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
                 " ack " << tcpHeader.GetAckNumber () <<
                 " pkt size " << p->GetSize () );
 
+  // A segment split from a super-segment is acknowledged with the last one
+  TcpSegmentOffloadTag tsoTag;
+  bool offloaded = p->RemovePacketTag (tsoTag);
+
   // Put into Rx buffer
   SequenceNumber32 expectedSeq = m_rxBuffer->NextRxSequence ();
   if (!m_rxBuffer->Add (p, tcpHeader))
@@ -2175,7 +2239,15 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
     }
   else
     { // In-sequence packet: ACK if delayed ack count allows
-      if (++m_delAckCount >= m_delAckMaxCount)
+      if (offloaded && !tsoTag.IsLast ())
+        { // More segments of the same super-segment follow back to back
+          if (m_delAckEvent.IsExpired ())
+            {
+              m_delAckEvent = Simulator::Schedule (m_delAckTimeout,
+                                                   &TcpSocketBase::DelAckTimeout, this);
+            }
+        }
+      else if (offloaded || ++m_delAckCount >= m_delAckMaxCount)
         {
           m_delAckEvent.Cancel ();
           m_delAckCount = 0;
@@ -2254,6 +2326,7 @@ TcpSocketBase::EstimateRtt (const TcpHeader& tcpHeader)
   if (!m.IsZero ())
     {
       m_rtt->Measurement (m);                // Log the measurement
+      m_rttSample = m;
       // RFC 6298, clause 2.4
       m_rto = Max (m_rtt->GetEstimate () + Max (m_clockGranularity, m_rtt->GetVariation ()*4), m_minRto);
       m_lastRtt = m_rtt->GetEstimate ();
@@ -2299,6 +2372,7 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack)
   NS_LOG_LOGIC ("TCP " << this << " NewAck " << ack <<
                 " numberAck " << (ack - m_txBuffer->HeadSequence ())); // Number bytes ack'ed
   m_txBuffer->DiscardUpTo (ack);
+  m_scoreboard.DiscardUpTo (ack);
   if (GetTxAvailable () > 0)
     {
       NotifySend (GetTxAvailable ());
@@ -2333,6 +2407,8 @@ TcpSocketBase::ReTxTimeout ()
     {
       return;
     }
+  // The SACK information is not trusted after a timeout (RFC 2018 section 8)
+  m_scoreboard.Clear ();
 
   Retransmit ();
 }
@@ -2440,6 +2516,7 @@ TcpSocketBase::DoRetransmit ()
   uint32_t sz = SendDataPacket (m_txBuffer->HeadSequence (), m_segmentSize, true);
   // In case of RTO, advance m_nextTxSequence
   m_nextTxSequence = std::max (m_nextTxSequence.Get (), m_txBuffer->HeadSequence () + sz);
+  m_highRxt = std::max (m_highRxt, m_txBuffer->HeadSequence () + SequenceNumber32 (sz));
 
 }
 
@@ -2607,6 +2684,12 @@ TcpSocketBase::ReadOptions (const TcpHeader& header)
               ProcessOptionWScale (header.GetOption (TcpOption::WINSCALE));
             }
         }
+      // SACK is used only if both ends sent the SACK-permitted option
+      m_sackEnabled = m_sackEnabled && header.HasOption (TcpOption::SACKPERMITTED);
+    }
+  else if (m_sackEnabled && header.HasOption (TcpOption::SACK))
+    {
+      ProcessOptionSack (header.GetOption (TcpOption::SACK));
     }
 
   m_timestampEnabled = false;
@@ -2633,6 +2716,18 @@ TcpSocketBase::AddOptions (TcpHeader& header)
     {
       AddOptionTimestamp (header);
     }
+
+  if (m_sackEnabled)
+    {
+      if (header.GetFlags () & TcpHeader::SYN)
+        {
+          AddOptionSackPermitted (header);
+        }
+      else
+        {
+          AddOptionSack (header);
+        }
+    }
 }
 
 void
@@ -2727,6 +2822,169 @@ TcpSocketBase::AddOptionTimestamp (TcpHeader& header)
                option->GetTimestamp () << " echo=" << m_timestampToEcho);
 }
 
+void
+TcpSocketBase::AddOptionSackPermitted (TcpHeader& header)
+{
+  NS_LOG_FUNCTION (this << header);
+  NS_ASSERT (header.GetFlags () & TcpHeader::SYN);
+
+  header.AppendOption (CreateObject<TcpOptionSackPermitted> ());
+}
+
+void
+TcpSocketBase::ProcessOptionSack (const Ptr<const TcpOption> option)
+{
+  NS_LOG_FUNCTION (this << option);
+
+  Ptr<const TcpOptionSack> sack = DynamicCast<const TcpOptionSack> (option);
+  const TcpOptionSack::SackList &blocks = sack->GetSackList ();
+  for (TcpOptionSack::SackList::const_iterator i = blocks.begin (); i != blocks.end (); ++i)
+    {
+      m_scoreboard.AddBlock (i->first, i->second, m_txBuffer->HeadSequence (), m_highTxMark);
+    }
+}
+
+void
+TcpSocketBase::AddOptionSack (TcpHeader& header)
+{
+  NS_LOG_FUNCTION (this << header);
+
+  // Room left in the 40 bytes of option space, each block taking 8 bytes
+  uint32_t room = 40 - (header.GetLength () * 4 - 20);
+  if (room < 10)
+    {
+      return;
+    }
+  TcpOptionSack::SackList blocks =
+    m_rxBuffer->GetSackList (std::min<uint32_t> ((room - 2) / 8, TcpOptionSack::MAX_SACK_BLOCKS));
+  if (blocks.empty ())
+    {
+      return;
+    }
+  Ptr<TcpOptionSack> option = CreateObject<TcpOptionSack> ();
+  for (TcpOptionSack::SackList::const_iterator i = blocks.begin (); i != blocks.end (); ++i)
+    {
+      option->AddSackBlock (*i);
+    }
+  header.AppendOption (option);
+  NS_LOG_INFO (m_node->GetId () << " Add option SACK with " << blocks.size () << " blocks");
+}
+
+bool
+TcpSocketBase::IsHeadLost (uint32_t dupThresh) const
+{
+  return m_sackEnabled && !m_scoreboard.IsEmpty ()
+         && m_scoreboard.IsLost (m_txBuffer->HeadSequence (), dupThresh, m_segmentSize);
+}
+
+void
+TcpSocketBase::SendSackRecoveryData (uint32_t cwnd, uint32_t dupThresh)
+{
+  NS_LOG_FUNCTION (this << cwnd << dupThresh);
+
+  uint32_t pipe = m_scoreboard.GetPipe (m_txBuffer->HeadSequence (), m_highTxMark, m_highRxt,
+                                        dupThresh, m_segmentSize);
+  NS_LOG_LOGIC ("SACK recovery: cwnd " << cwnd << " pipe " << pipe);
+  while (cwnd >= pipe + m_segmentSize)
+    {
+      SequenceNumber32 head = m_txBuffer->HeadSequence ();
+      SequenceNumber32 seq;
+      uint32_t length;
+      uint32_t sz;
+      if (m_scoreboard.GetNextHole (head, m_highRxt, dupThresh, m_segmentSize, true, seq, length))
+        { // NextSeg () rule 1: data deemed lost
+          NS_LOG_LOGIC ("Retransmit lost data at " << seq);
+          sz = SendDataPacket (seq, length, true);
+          m_highRxt = seq + SequenceNumber32 (sz);
+        }
+      else if (m_txBuffer->SizeFromSequence (m_highTxMark) > 0
+               && m_rWnd.Get () > static_cast<uint32_t> (m_highTxMark.Get () - head))
+        { // NextSeg () rule 2: new data, as allowed by the receiver window
+          length = std::min (m_segmentSize, m_rWnd.Get () - (m_highTxMark.Get () - head));
+          sz = SendDataPacket (m_highTxMark, length, true);
+          m_nextTxSequence = std::max (m_nextTxSequence.Get (), m_highTxMark.Get ());
+        }
+      else if (m_scoreboard.GetNextHole (head, m_highRxt, dupThresh, m_segmentSize, false, seq, length))
+        { // NextSeg () rule 3: unSACKed data not deemed lost yet
+          NS_LOG_LOGIC ("Retransmit unSACKed data at " << seq);
+          sz = SendDataPacket (seq, length, true);
+          m_highRxt = seq + SequenceNumber32 (sz);
+        }
+      else
+        {
+          break;
+        }
+      if (sz == 0)
+        {
+          break;
+        }
+      pipe += sz;
+    }
+}
+
+void
+TcpSocketBase::ReadEcn (Ptr<const Packet> packet, TcpHeader& tcpHeader, bool ce)
+{
+  NS_LOG_FUNCTION (this << tcpHeader << ce);
+  uint8_t flags = tcpHeader.GetFlags ();
+  if (flags & TcpHeader::SYN)
+    { // An ECN-setup SYN has both ECE and CWR, an ECN-setup SYN-ACK only ECE (RFC 3168 section 6.1.1)
+      uint8_t setup = (flags & TcpHeader::ACK) ? TcpHeader::ECE : (TcpHeader::ECE | TcpHeader::CWR);
+      m_ecnActive = m_ecnEnabled && (flags & (TcpHeader::ECE | TcpHeader::CWR)) == setup;
+      m_ecnEchoReceived = false;
+      NS_LOG_LOGIC (this << " ECN " << (m_ecnActive ? "negotiated" : "not negotiated"));
+    }
+  else if (m_ecnActive)
+    {
+      m_ecnEchoReceived = flags & TcpHeader::ECE;
+      if (packet->GetSize () > 0)
+        {
+          ProcessEcn (tcpHeader, ce);
+        }
+    }
+  tcpHeader.SetFlags (flags & ~(TcpHeader::ECE | TcpHeader::CWR));
+}
+
+uint8_t
+TcpSocketBase::AddEcnFlags (uint8_t flags)
+{
+  if (!m_ecnEnabled)
+    {
+      return flags;
+    }
+  if (flags & TcpHeader::SYN)
+    {
+      if (!(flags & TcpHeader::ACK))
+        {
+          flags |= TcpHeader::ECE | TcpHeader::CWR;
+        }
+      else if (m_ecnActive)
+        {
+          flags |= TcpHeader::ECE;
+        }
+    }
+  else if (m_ecnEcho && (flags & TcpHeader::ACK))
+    {
+      flags |= TcpHeader::ECE;
+    }
+  return flags;
+}
+
+void
+TcpSocketBase::ProcessEcn (const TcpHeader& tcpHeader, bool ce)
+{
+  NS_LOG_FUNCTION (this << tcpHeader << ce);
+  if (tcpHeader.GetFlags () & TcpHeader::CWR)
+    {
+      m_ecnEcho = false;
+    }
+  if (ce)
+    {
+      NS_LOG_LOGIC (this << " Congestion experienced by seq " << tcpHeader.GetSequenceNumber ());
+      m_ecnEcho = true;
+    }
+}
+
 void
 TcpSocketBase::SetMinRto (Time minRto)
 {
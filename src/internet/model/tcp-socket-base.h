@@ -35,6 +35,7 @@
 #include "ns3/event-id.h"
 #include "tcp-tx-buffer.h"
 #include "tcp-rx-buffer.h"
+#include "tcp-scoreboard.h"
 #include "rtt-estimator.h"
 
 namespace ns3 {
@@ -675,6 +676,73 @@ protected:
    */
   void AddOptionTimestamp (TcpHeader& header);
 
+  /**
+   * \brief Add the SACK-permitted option to a SYN header
+   * \param header TcpHeader to which add the option to
+   */
+  void AddOptionSackPermitted (TcpHeader& header);
+  /**
+   * \brief Record the blocks of a SACK option in the scoreboard
+   * \param option Option from the packet
+   */
+  void ProcessOptionSack (const Ptr<const TcpOption> option);
+  /**
+   * \brief Add a SACK option reporting the holes of the Rx buffer, if any,
+   * in the room left by the other options
+   * \param header TcpHeader to which add the option to
+   */
+  void AddOptionSack (TcpHeader& header);
+
+  /**
+   * \brief Send data during a SACK based loss recovery (\RFC{6675})
+   *
+   * As long as the congestion window leaves room for a segment besides
+   * the data in flight (the pipe), send the next segment chosen by the
+   * NextSeg () rules: the first unSACKed data deemed lost, then new data,
+   * then the first unSACKed data not deemed lost.
+   *
+   * \param cwnd the congestion window
+   * \param dupThresh the number of duplicate acknowledgments signalling a loss
+   */
+  void SendSackRecoveryData (uint32_t cwnd, uint32_t dupThresh);
+  /**
+   * \param dupThresh the number of duplicate acknowledgments signalling a loss
+   * \return true if SACK is in use and the first unacknowledged segment
+   *         is deemed lost by the scoreboard
+   */
+  bool IsHeadLost (uint32_t dupThresh) const;
+
+  /**
+   * \brief Negotiate ECN and take the ECN flags out of an incoming segment
+   *
+   * The ECN flags are recorded, then cleared from the header, so that the
+   * state machine only sees the flags it handles.
+   *
+   * \param packet the payload of the segment
+   * \param tcpHeader the TCP header of the segment
+   * \param ce whether the IP header of the segment has the congestion
+   *        experienced codepoint
+   */
+  void ReadEcn (Ptr<const Packet> packet, TcpHeader& tcpHeader, bool ce);
+  /**
+   * \brief Add the ECN flags to an outgoing segment
+   * \param flags the flags of the segment
+   * \return the flags with the ECN ones
+   */
+  uint8_t AddEcnFlags (uint8_t flags);
+  /**
+   * \brief Update the echo of the congestion experienced codepoint on a
+   * segment with data
+   *
+   * The echo is set on all the acknowledgments until the peer signals the
+   * reduction of its window with the CWR flag (\RFC{3168} section 6.1.3).
+   *
+   * \param tcpHeader the TCP header of the segment
+   * \param ce whether the IP header of the segment has the congestion
+   *        experienced codepoint
+   */
+  virtual void ProcessEcn (const TcpHeader& tcpHeader, bool ce);
+
 
 protected:
   // Counters and events
@@ -693,6 +761,7 @@ protected:
   Time              m_minRto;          //!< minimum value of the Retransmit timeout
   Time              m_clockGranularity; //!< Clock Granularity used in RTO calcs
   TracedValue<Time> m_lastRtt;         //!< Last RTT sample collected
+  Time              m_rttSample;       //!< Last raw RTT measurement
   Time              m_delAckTimeout;   //!< Time to delay an ACK
   Time              m_persistTimeout;  //!< Time between sending 1-byte probes
   Time              m_cnTimeout;       //!< Timeout for connection retry
@@ -726,6 +795,7 @@ protected:
 
   // Window management
   uint32_t              m_segmentSize; //!< Segment size
+  uint32_t              m_tsoSegments; //!< Maximum number of segments of a super-segment
   uint16_t              m_maxWinSize;  //!< Maximum window size to advertise
   TracedValue<uint32_t> m_rWnd;        //!< Flow control window at remote side
 
@@ -736,6 +806,17 @@ protected:
 
   bool     m_timestampEnabled;    //!< Timestamp option enabled
   uint32_t m_timestampToEcho;     //!< Timestamp to echo
+
+  bool             m_sackEnabled; //!< SACK option enabled
+  TcpScoreboard    m_scoreboard;  //!< Data SACKed by the peer
+  SequenceNumber32 m_highRxt;     //!< Seqnum following the highest one retransmitted in SACK recovery
+
+  // ECN (RFC 3168)
+  bool m_ecnEnabled;      //!< ECN requested
+  bool m_ecnActive;       //!< ECN negotiated with the peer
+  bool m_ecnEcho;         //!< Set the ECE flag on the acknowledgments sent
+  bool m_ecnEchoReceived; //!< The segment being processed has the ECE flag
+  bool m_ecnCwrPending;   //!< Set the CWR flag on the next new data segment
 };
 
 } // namespace ns3
@@ -21,7 +21,7 @@
 #ifndef TCP_TX_BUFFER_H
 #define TCP_TX_BUFFER_H
 
-#include <list>
+#include <deque>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/object.h"
@@ -36,6 +36,13 @@ class Packet;
  *
  * \brief class for keeping the data sent by the application to the TCP socket, i.e.
  *        the sending buffer.
+ *
+ * The packets given by the application are kept as they are in a queue,
+ * each one with the offset of its first byte in the stream.  The packet
+ * holding a sequence number is found by a binary search, and a segment
+ * lying in a single packet is a single fragment of it.  Acknowledged bytes
+ * only move the head offset: a packet leaves the queue once all its bytes
+ * are acknowledged, and is never fragmented to drop its head.
  */
 class TcpTxBuffer : public Object
 {
@@ -128,13 +135,25 @@ public:
   void DiscardUpTo (const SequenceNumber32& seq);
 
 private:
-  /// container for data stored in the buffer
-  typedef std::list<Ptr<Packet> >::iterator BufIterator;
+  /// A packet of the buffer and the offset of its first byte in the stream
+  struct Chunk
+  {
+    uint64_t offset;     //!< offset of the first byte of the packet
+    Ptr<Packet> packet;  //!< the packet
+  };
+
+  /**
+   * \param offset an offset in the stream
+   * \param chunk a chunk of the buffer
+   * \return true if the chunk starts after the offset
+   */
+  static bool StartsAfter (uint64_t offset, const Chunk &chunk);
 
   TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
   uint32_t m_size;                              //!< Number of data bytes
   uint32_t m_maxBuffer;                         //!< Max number of data bytes in buffer (SND.WND)
-  std::list<Ptr<Packet> > m_data;               //!< Corresponding data (may be null)
+  uint64_t m_headOffset;                        //!< Offset in the stream of the byte m_firstByteSeq
+  std::deque<Chunk> m_data;                     //!< Corresponding data, by offset
 };
 
 } // namepsace ns3
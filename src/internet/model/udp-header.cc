@@ -35,6 +35,7 @@ UdpHeader::UdpHeader ()
     m_payloadSize (0),
     m_checksum (0),
     m_calcChecksum (false),
+    m_virtualChecksum (false),
     m_goodChecksum (true)
 {
 }
@@ -51,6 +52,12 @@ UdpHeader::EnableChecksums (void)
   m_calcChecksum = true;
 }
 
+void
+UdpHeader::EnableVirtualChecksums (void)
+{
+  m_virtualChecksum = true;
+}
+
 void 
 UdpHeader::SetDestinationPort (uint16_t port)
 {
@@ -204,7 +211,8 @@ UdpHeader::Serialize (Buffer::Iterator start) const
         {
           uint16_t headerChecksum = CalculateHeaderChecksum (start.GetSize ());
           i = start;
-          uint16_t checksum = i.CalculateIpChecksum (start.GetSize (), headerChecksum);
+          uint16_t size = m_virtualChecksum ? GetSerializedSize () : start.GetSize ();
+          uint16_t checksum = i.CalculateIpChecksum (size, headerChecksum);
 
           i = start;
           i.Next (6);
@@ -229,7 +237,8 @@ UdpHeader::Deserialize (Buffer::Iterator start)
     {
       uint16_t headerChecksum = CalculateHeaderChecksum (start.GetSize ());
       i = start;
-      uint16_t checksum = i.CalculateIpChecksum (start.GetSize (), headerChecksum);
+      uint16_t size = m_virtualChecksum ? GetSerializedSize () : start.GetSize ();
+      uint16_t checksum = i.CalculateIpChecksum (size, headerChecksum);
 
       m_goodChecksum = (checksum == 0);
     }
@@ -52,6 +52,16 @@ public:
    * \brief Enable checksum calculation for UDP 
    */
   void EnableChecksums (void);
+  /**
+   * \brief Enable checksums which do not cover the payload
+   *
+   * The checksum is calculated over the pseudo-header and the UDP
+   * header only, so that the payload of the packet is never read.  Such
+   * checksums are checked consistently between ns-3 nodes, but they are
+   * wrong on the wire: they should not be used with emulated devices.
+   * This has no effect unless EnableChecksums is called too.
+   */
+  void EnableVirtualChecksums (void);
   /**
    * \param port the destination port for this UdpHeader
    */
@@ -182,6 +192,7 @@ private:
   uint8_t m_protocol;         //!< Protocol number
   uint16_t m_checksum;        //!< Forced Checksum value
   bool m_calcChecksum;        //!< Flag to calculate checksum
+  bool m_virtualChecksum;     //!< Flag to leave the payload out of the checksum
   bool m_goodChecksum;        //!< Flag to indicate that checksum is correct
 };
 
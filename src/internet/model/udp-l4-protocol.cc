@@ -320,6 +320,10 @@ UdpL4Protocol::Receive (Ptr<Packet> packet,
   if(Node::ChecksumEnabled ())
     {
       udpHeader.EnableChecksums ();
+      if (Node::ChecksumVirtual ())
+        {
+          udpHeader.EnableVirtualChecksums ();
+        }
     }
 
   udpHeader.InitializeChecksum (header.GetSource (), header.GetDestination (), PROT_NUMBER);
@@ -379,6 +383,10 @@ UdpL4Protocol::Receive (Ptr<Packet> packet,
   if(Node::ChecksumEnabled ())
     {
       udpHeader.EnableChecksums ();
+      if (Node::ChecksumVirtual ())
+        {
+          udpHeader.EnableVirtualChecksums ();
+        }
     }
 
   udpHeader.InitializeChecksum (header.GetSourceAddress (), header.GetDestinationAddress (), PROT_NUMBER);
@@ -419,6 +427,10 @@ UdpL4Protocol::Send (Ptr<Packet> packet,
   if(Node::ChecksumEnabled ())
     {
       udpHeader.EnableChecksums ();
+      if (Node::ChecksumVirtual ())
+        {
+          udpHeader.EnableVirtualChecksums ();
+        }
       udpHeader.InitializeChecksum (saddr,
                                     daddr,
                                     PROT_NUMBER);
@@ -442,6 +454,10 @@ UdpL4Protocol::Send (Ptr<Packet> packet,
   if(Node::ChecksumEnabled ())
     {
       udpHeader.EnableChecksums ();
+      if (Node::ChecksumVirtual ())
+        {
+          udpHeader.EnableVirtualChecksums ();
+        }
       udpHeader.InitializeChecksum (saddr,
                                     daddr,
                                     PROT_NUMBER);
@@ -465,6 +481,10 @@ UdpL4Protocol::Send (Ptr<Packet> packet,
   if(Node::ChecksumEnabled ())
     {
       udpHeader.EnableChecksums ();
+      if (Node::ChecksumVirtual ())
+        {
+          udpHeader.EnableVirtualChecksums ();
+        }
       udpHeader.InitializeChecksum (saddr,
                                     daddr,
                                     PROT_NUMBER);
@@ -488,6 +508,10 @@ UdpL4Protocol::Send (Ptr<Packet> packet,
   if(Node::ChecksumEnabled ())
     {
       udpHeader.EnableChecksums ();
+      if (Node::ChecksumVirtual ())
+        {
+          udpHeader.EnableVirtualChecksums ();
+        }
       udpHeader.InitializeChecksum (saddr,
                                     daddr,
                                     PROT_NUMBER);
@@ -0,0 +1,240 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/red-queue.h"
+#include "ns3/ecn-marker.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/socket.h"
+#include "ns3/global-value.h"
+#include "ns3/ipv4-header.h"
+
+using namespace ns3;
+
+/**
+ * \brief Test RED marking through a point-to-point device
+ *
+ * A burst of UDP packets goes through the RedQueue of a slow point-to-point
+ * link, where the packets carry their PPP header.  ECN-capable packets above
+ * the marking threshold are marked by EcnMarker::Mark and delivered, the
+ * other ones are dropped.
+ */
+class EcnMarkerPointToPointTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param ecn the ECN codepoint of the packets sent
+   */
+  EcnMarkerPointToPointTestCase (uint8_t ecn);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Send a burst of packets
+   * \param socket the sending socket
+   */
+  void SendBurst (Ptr<Socket> socket);
+
+  /**
+   * \brief Receive the packets and record their ECN codepoint
+   * \param socket the receiving socket
+   */
+  void Receive (Ptr<Socket> socket);
+
+  uint8_t m_ecn;          //!< ECN codepoint of the packets sent
+  uint32_t m_received;    //!< number of packets received
+  uint32_t m_receivedCe;  //!< number of packets received with the CE codepoint
+};
+
+EcnMarkerPointToPointTestCase::EcnMarkerPointToPointTestCase (uint8_t ecn)
+  : TestCase (ecn == 0 ? "Check that RED drops non-ECT packets queued on a point-to-point device"
+              : "Check that RED marks ECT packets queued on a point-to-point device"),
+    m_ecn (ecn),
+    m_received (0),
+    m_receivedCe (0)
+{
+}
+
+void
+EcnMarkerPointToPointTestCase::SendBurst (Ptr<Socket> socket)
+{
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      socket->Send (Create<Packet> (500));
+    }
+}
+
+void
+EcnMarkerPointToPointTestCase::Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      m_received++;
+      SocketIpTosTag tos;
+      NS_TEST_EXPECT_MSG_EQ (packet->RemovePacketTag (tos), true, "The packet has no TOS tag");
+      uint8_t ecn = tos.GetTos () & 0x03;
+      if (ecn == 0x03)
+        {
+          m_receivedCe++;
+        }
+      else
+        {
+          NS_TEST_EXPECT_MSG_EQ (static_cast<uint32_t> (ecn), static_cast<uint32_t> (m_ecn),
+                                 "The ECN codepoint was changed");
+        }
+    }
+}
+
+void
+EcnMarkerPointToPointTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  p2p.SetQueue ("ns3::RedQueue",
+                "MinTh", DoubleValue (5),
+                "MaxTh", DoubleValue (5),
+                "QW", DoubleValue (1),
+                "Gentle", BooleanValue (false));
+  NetDeviceContainer devices = p2p.Install (nodes);
+
+  Ptr<PointToPointNetDevice> device = DynamicCast<PointToPointNetDevice> (devices.Get (0));
+  Ptr<RedQueue> queue = DynamicCast<RedQueue> (device->GetQueue ());
+  queue->SetAttribute ("UseEcn", BooleanValue (true));
+  queue->SetAttribute ("UseHardDrop", BooleanValue (false));
+  queue->SetMarkCallback (MakeCallback (&EcnMarker::Mark));
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  Ptr<Socket> sink = Socket::CreateSocket (nodes.Get (1), UdpSocketFactory::GetTypeId ());
+  sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9));
+  sink->SetIpRecvTos (true);
+  sink->SetRecvCallback (MakeCallback (&EcnMarkerPointToPointTestCase::Receive, this));
+
+  Ptr<Socket> source = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  source->Connect (InetSocketAddress (interfaces.GetAddress (1), 9));
+  source->SetIpTos (m_ecn);
+
+  Simulator::Schedule (Seconds (1.0), &EcnMarkerPointToPointTestCase::SendBurst, this, source);
+  Simulator::Run ();
+
+  RedQueue::Stats stats = queue->GetStats ();
+  if (m_ecn == 0)
+    {
+      NS_TEST_EXPECT_MSG_GT (stats.forcedDrop, 0, "No packet was dropped");
+      NS_TEST_EXPECT_MSG_EQ (stats.forcedMark + stats.unforcedMark, 0, "Non-ECT packets were marked");
+      NS_TEST_EXPECT_MSG_EQ (m_received + stats.forcedDrop, 20, "Packets were lost");
+      NS_TEST_EXPECT_MSG_EQ (m_receivedCe, 0, "Non-ECT packets were received with the CE codepoint");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_GT (stats.forcedMark, 0, "No packet was marked");
+      NS_TEST_EXPECT_MSG_EQ (stats.forcedDrop + stats.unforcedDrop + stats.qLimDrop, 0, "ECT packets were dropped");
+      NS_TEST_EXPECT_MSG_EQ (m_received, 20, "Not all the packets were received");
+      NS_TEST_EXPECT_MSG_EQ (m_receivedCe, stats.forcedMark + stats.unforcedMark,
+                             "The marked packets were not received with the CE codepoint");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Test the IPv4 checksum of the packets marked by EcnMarker::Mark
+ *
+ * With the checksums enabled, the checksum of a marked packet must still
+ * match its header once the ECN field is changed.
+ */
+class EcnMarkerChecksumTestCase : public TestCase
+{
+public:
+  EcnMarkerChecksumTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EcnMarkerChecksumTestCase::EcnMarkerChecksumTestCase ()
+  : TestCase ("Check the IPv4 checksum of marked packets")
+{
+}
+
+void
+EcnMarkerChecksumTestCase::DoRun (void)
+{
+  GlobalValue::Bind ("ChecksumEnabled", BooleanValue (true));
+
+  Ipv4Header header;
+  header.EnableChecksum ();
+  header.SetSource (Ipv4Address ("10.1.1.1"));
+  header.SetDestination (Ipv4Address ("10.1.1.2"));
+  header.SetProtocol (17);
+  header.SetPayloadSize (100);
+  header.SetTtl (64);
+  header.SetEcn (Ipv4Header::ECN_ECT0);
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddHeader (header);
+
+  NS_TEST_EXPECT_MSG_EQ (EcnMarker::Mark (p), true, "The ECT packet was not marked");
+
+  Ipv4Header marked;
+  marked.EnableChecksum ();
+  p->RemoveHeader (marked);
+  NS_TEST_EXPECT_MSG_EQ (marked.GetEcn (), Ipv4Header::ECN_CE, "The packet does not carry the CE codepoint");
+  NS_TEST_EXPECT_MSG_EQ (marked.IsChecksumOk (), true, "The checksum of the marked packet is wrong");
+
+  GlobalValue::Bind ("ChecksumEnabled", BooleanValue (false));
+}
+
+/**
+ * \brief EcnMarker TestSuite
+ */
+class EcnMarkerTestSuite : public TestSuite
+{
+public:
+  EcnMarkerTestSuite ();
+};
+
+EcnMarkerTestSuite::EcnMarkerTestSuite ()
+  : TestSuite ("ecn-marker", UNIT)
+{
+  AddTestCase (new EcnMarkerPointToPointTestCase (0x00), TestCase::QUICK);
+  AddTestCase (new EcnMarkerPointToPointTestCase (0x02), TestCase::QUICK);
+  AddTestCase (new EcnMarkerChecksumTestCase, TestCase::QUICK);
+}
+
+static EcnMarkerTestSuite g_ecnMarkerTestSuite;
@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/private/ipv4-end-point-demux.h"
+#include "ns3/private/ipv6-end-point.h"
+#include "ns3/private/ipv6-end-point-demux.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv4EndPointDemux test: the most exact end points are found,
+ * in the order they were allocated, including after their peer or local
+ * address changed.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Ipv4EndPointDemux lookups")
+{
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv4EndPointDemux demux;
+  Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface> ();
+  interface->AddAddress (Ipv4InterfaceAddress (Ipv4Address ("10.0.0.1"), Ipv4Mask ("255.255.255.0")));
+  Ipv4Address local ("10.0.0.1");
+  Ipv4Address peer ("10.0.0.2");
+
+  Ipv4EndPoint *listener = demux.Allocate (80);
+  Ipv4EndPoint *bound = demux.Allocate (local, 80);
+  Ipv4EndPoint *conn = demux.Allocate (local, 80, peer, 1000);
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate (local, 80), 0, "Duplicate address and port allocated");
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate (local, 80, peer, 1000), 0, "Duplicate four-tuple allocated");
+
+  Ipv4EndPointDemux::EndPoints found = demux.Lookup (local, 80, peer, 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Exact match not found");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), conn, "Exact match not found");
+  found = demux.Lookup (local, 80, Ipv4Address ("10.0.0.3"), 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Local address match not found");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), bound, "Local address match not found");
+  found = demux.Lookup (Ipv4Address ("10.0.0.9"), 80, peer, 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Local port match not found");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), listener, "Local port match not found");
+  found = demux.Lookup (Ipv4Address ("10.0.0.255"), 80, Ipv4Address ("10.0.0.3"), 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 2, "Broadcast matches not found");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), listener, "Broadcast matches out of order");
+  NS_TEST_ASSERT_MSG_EQ (found.back (), bound, "Broadcast matches out of order");
+  found = demux.Lookup (local, 81, peer, 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.empty (), true, "Match found on a port without end points");
+
+  NS_TEST_ASSERT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1000), conn, "Exact match not found");
+  NS_TEST_ASSERT_MSG_EQ (demux.SimpleLookup (Ipv4Address ("10.0.0.9"), 80, peer, 1), conn,
+                         "Least generic end point not found");
+
+  // end points found in the order of allocation, whatever the order in
+  // which they got their tuple
+  Ipv4EndPoint *first = demux.Allocate (local, 81, Ipv4Address ("10.0.0.3"), 5);
+  Ipv4EndPoint *second = demux.Allocate (local, 81, peer, 5);
+  first->SetPeer (peer, 5);
+  found = demux.Lookup (local, 81, peer, 5, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 2, "Matches not found");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), first, "Matches out of order");
+  NS_TEST_ASSERT_MSG_EQ (found.back (), second, "Matches out of order");
+
+  // an end point connected after its allocation, like a TCP socket
+  Ipv4EndPoint *client = demux.Allocate ();
+  uint16_t port = client->GetLocalPort ();
+  client->SetPeer (peer, 80);
+  NS_TEST_ASSERT_MSG_EQ (demux.SimpleLookup (Ipv4Address::GetAny (), port, peer, 80), client,
+                         "Connected end point not found");
+  client->SetLocalAddress (local);
+  found = demux.Lookup (local, port, peer, 80, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Connected end point not found");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), client, "Connected end point not found");
+  found = demux.Lookup (local, port, peer, 81, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.empty (), true, "End point found with its former tuple");
+
+  demux.DeAllocate (conn);
+  found = demux.Lookup (local, 80, peer, 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.front (), bound, "Deallocated end point found");
+  demux.DeAllocate (bound);
+  demux.DeAllocate (listener);
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (80), false, "Port still used");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (81), true, "Port not used");
+  NS_TEST_ASSERT_MSG_EQ (demux.GetAllEndPoints ().size (), 3, "Wrong number of end points");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv6EndPointDemux test: the most exact end points are found,
+ * including after their peer changed.
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : TestCase ("Ipv6EndPointDemux lookups")
+{
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv6EndPointDemux demux;
+  Ipv6Address local ("2001:db8::1");
+  Ipv6Address peer ("2001:db8::2");
+
+  Ipv6EndPoint *listener = demux.Allocate (80);
+  Ipv6EndPoint *bound = demux.Allocate (local, 80);
+  Ipv6EndPoint *routers = demux.Allocate (Ipv6Address::GetAllRoutersMulticast (), 80);
+  Ipv6EndPoint *conn = demux.Allocate (local, 80, Ipv6Address ("2001:db8::3"), 1000);
+  conn->SetPeer (peer, 1000);
+
+  Ipv6EndPointDemux::EndPoints found = demux.Lookup (local, 80, peer, 1000, 0);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Exact match not found");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), conn, "Exact match not found");
+  found = demux.Lookup (local, 80, Ipv6Address ("2001:db8::3"), 1000, 0);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Local address match not found");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), bound, "Local address match not found");
+  found = demux.Lookup (Ipv6Address::GetAllRoutersMulticast (), 80, peer, 1000, 0);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "All-routers match not found");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), routers, "All-routers match not found");
+  found = demux.Lookup (Ipv6Address ("2001:db8::9"), 80, peer, 1000, 0);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Local port match not found");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), listener, "Local port match not found");
+
+  demux.DeAllocate (conn);
+  NS_TEST_ASSERT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1000), bound, "Least generic end point not found");
+  NS_TEST_ASSERT_MSG_EQ (demux.GetEndPoints ().size (), 3, "Wrong number of end points");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief End point demultiplexers test suite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite ()
+    : TestSuite ("end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv6EndPointDemuxTestCase, TestCase::QUICK);
+  }
+};
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite; //!< Static variable for test initialization
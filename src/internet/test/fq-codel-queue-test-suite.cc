@@ -0,0 +1,321 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <set>
+
+#include "ns3/test.h"
+#include "ns3/fq-codel-queue.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv6-header.h"
+#include "ns3/udp-header.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * \brief Build a UDP over IPv4 packet
+ * \param src the source port, which tells the flows apart
+ * \param size the payload size
+ * \param ethernet whether to put an Ethernet header in front
+ * \return the packet
+ */
+static Ptr<Packet>
+CreateUdpPacket (uint16_t src, uint32_t size, bool ethernet = false)
+{
+  Ptr<Packet> p = Create<Packet> (size);
+  UdpHeader udp;
+  udp.SetSourcePort (src);
+  udp.SetDestinationPort (9);
+  p->AddHeader (udp);
+  Ipv4Header ip;
+  ip.SetSource (Ipv4Address ("10.1.1.1"));
+  ip.SetDestination (Ipv4Address ("10.1.2.1"));
+  ip.SetProtocol (17);
+  ip.SetPayloadSize (p->GetSize ());
+  p->AddHeader (ip);
+  if (ethernet)
+    {
+      EthernetHeader eth (false);
+      eth.SetLengthType (0x0800);
+      p->AddHeader (eth);
+    }
+  return p;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief FQ-CoDel classification test: a flow maps to a single flow queue
+ * whatever the link header, and flows spread over the flow queues.
+ */
+class FqCoDelQueueClassifyTestCase : public TestCase
+{
+public:
+  FqCoDelQueueClassifyTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+FqCoDelQueueClassifyTestCase::FqCoDelQueueClassifyTestCase ()
+  : TestCase ("FQ-CoDel flow classification")
+{
+}
+
+void
+FqCoDelQueueClassifyTestCase::DoRun (void)
+{
+  Ptr<FqCoDelQueue> queue = CreateObject<FqCoDelQueue> ();
+  std::set<uint32_t> flows;
+  for (uint16_t port = 1000; port < 1100; port++)
+    {
+      uint32_t flow = queue->Classify (CreateUdpPacket (port, 100));
+      NS_TEST_EXPECT_MSG_EQ (queue->Classify (CreateUdpPacket (port, 1000)), flow,
+                             "The flow queue depends on the packet size");
+      NS_TEST_EXPECT_MSG_EQ (queue->Classify (CreateUdpPacket (port, 100, true)), flow,
+                             "The flow queue depends on the link header");
+      flows.insert (flow);
+    }
+  NS_TEST_EXPECT_MSG_GT (flows.size (), 90, "The flows collide too often");
+
+  Ptr<Packet> v6 = Create<Packet> (100);
+  UdpHeader udp;
+  udp.SetSourcePort (1000);
+  udp.SetDestinationPort (9);
+  v6->AddHeader (udp);
+  Ipv6Header ip6;
+  ip6.SetSourceAddress (Ipv6Address ("2001:1::1"));
+  ip6.SetDestinationAddress (Ipv6Address ("2001:2::1"));
+  ip6.SetNextHeader (17);
+  ip6.SetPayloadLength (v6->GetSize ());
+  v6->AddHeader (ip6);
+  uint32_t flow = queue->Classify (v6);
+  udp.SetSourcePort (1001);
+  Ptr<Packet> other = Create<Packet> (100);
+  other->AddHeader (udp);
+  other->AddHeader (ip6);
+  NS_TEST_EXPECT_MSG_NE (queue->Classify (other), flow, "IPv6 ports are not hashed");
+
+  NS_TEST_EXPECT_MSG_EQ (queue->Classify (Create<Packet> (100)), 0,
+                         "A non IP packet is not in the first flow queue");
+
+  queue->SetAttribute ("Perturbation", UintegerValue (1));
+  uint32_t moved = 0;
+  for (uint16_t port = 1000; port < 1100; port++)
+    {
+      Ptr<FqCoDelQueue> reference = CreateObject<FqCoDelQueue> ();
+      if (queue->Classify (CreateUdpPacket (port, 100)) != reference->Classify (CreateUdpPacket (port, 100)))
+        {
+          moved++;
+        }
+    }
+  NS_TEST_EXPECT_MSG_GT (moved, 90, "The perturbation does not change the hash");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief FQ-CoDel scheduling test: deficit round robin shares the bytes
+ * between backlogged flows, a new sparse flow goes first, and a full queue
+ * drops from the longest flow queue.
+ */
+class FqCoDelQueueSchedulingTestCase : public TestCase
+{
+public:
+  FqCoDelQueueSchedulingTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+FqCoDelQueueSchedulingTestCase::FqCoDelQueueSchedulingTestCase ()
+  : TestCase ("FQ-CoDel deficit round robin and overflow")
+{
+}
+
+void
+FqCoDelQueueSchedulingTestCase::DoRun (void)
+{
+  Ptr<FqCoDelQueue> queue = CreateObject<FqCoDelQueue> ();
+  queue->SetAttribute ("MaxPackets", UintegerValue (150));
+
+  // find three source ports hashed to different flow queues
+  uint16_t ports[3];
+  std::set<uint32_t> used;
+  uint16_t port = 1000;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      while (used.count (queue->Classify (CreateUdpPacket (port, 100))))
+        {
+          port++;
+        }
+      ports[i] = port;
+      used.insert (queue->Classify (CreateUdpPacket (port, 100)));
+    }
+  uint32_t flowA = queue->Classify (CreateUdpPacket (ports[0], 100));
+  uint32_t flowB = queue->Classify (CreateUdpPacket (ports[1], 100));
+
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      queue->Enqueue (CreateUdpPacket (ports[0], 1000));
+    }
+  for (uint32_t i = 0; i < 60; i++)
+    {
+      queue->Enqueue (CreateUdpPacket (ports[1], 300));
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 150, "The queue holds more than MaxPackets");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetDropOverLimit (), 10, "Wrong number of overflow drops");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetFlowPackets (flowA), 90, "The overflow did not drop from the fattest flow");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetFlowPackets (flowB), 60, "The overflow dropped from a thin flow");
+
+  uint32_t bytesA = 0;
+  uint32_t bytesB = 0;
+  for (uint32_t i = 0; i < 80; i++)
+    {
+      Ptr<Packet> p = queue->Dequeue ();
+      uint32_t flow = queue->Classify (p);
+      if (flow == flowA)
+        {
+          bytesA += p->GetSize ();
+        }
+      else
+        {
+          bytesB += p->GetSize ();
+        }
+    }
+  NS_TEST_EXPECT_MSG_GT (bytesB, 0, "The second flow was not served");
+  uint32_t difference = bytesA > bytesB ? bytesA - bytesB : bytesB - bytesA;
+  NS_TEST_EXPECT_MSG_LT (difference, 2 * 1514, "The flows did not get the same share of bytes");
+
+  queue->Enqueue (CreateUdpPacket (ports[2], 100));
+  bool sparseFirst = false;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<Packet> p = queue->Dequeue ();
+      if (p->GetSize () < 200)
+        {
+          sparseFirst = true;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (sparseFirst, true, "The new sparse flow was not served first");
+
+  uint32_t remaining = 0;
+  while (queue->Dequeue ())
+    {
+      remaining++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (remaining + 80 + 2, 151, "Packets were lost by the scheduler");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 0, "The queue is not empty");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief FQ-CoDel drop test: a standing queue gets CoDel drops while a
+ * flow sending slower than its share keeps all of its packets.
+ */
+class FqCoDelQueueCoDelTestCase : public TestCase
+{
+public:
+  FqCoDelQueueCoDelTestCase ();
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Enqueue a packet of each flow and dequeue some packets
+   * \param queue the queue
+   */
+  void Step (Ptr<FqCoDelQueue> queue);
+
+  uint16_t m_bulk;          //!< source port of the bulk flow
+  uint16_t m_sparse;        //!< source port of the sparse flow
+  uint32_t m_steps;         //!< steps done
+  uint32_t m_sparseSent;    //!< sparse packets enqueued
+  uint32_t m_sparseRcvd;    //!< sparse packets dequeued
+};
+
+FqCoDelQueueCoDelTestCase::FqCoDelQueueCoDelTestCase ()
+  : TestCase ("FQ-CoDel per-flow CoDel drops"),
+    m_bulk (1000),
+    m_sparse (1001),
+    m_steps (0),
+    m_sparseSent (0),
+    m_sparseRcvd (0)
+{
+}
+
+void
+FqCoDelQueueCoDelTestCase::Step (Ptr<FqCoDelQueue> queue)
+{
+  // the bulk flow sends two packets per millisecond, the link takes one
+  queue->Enqueue (CreateUdpPacket (m_bulk, 1000));
+  queue->Enqueue (CreateUdpPacket (m_bulk, 1000));
+  if (m_steps % 10 == 0)
+    {
+      queue->Enqueue (CreateUdpPacket (m_sparse, 100));
+      m_sparseSent++;
+    }
+  Ptr<Packet> p = queue->Dequeue ();
+  if (p && p->GetSize () < 200)
+    {
+      m_sparseRcvd++;
+    }
+  if (++m_steps < 500)
+    {
+      Simulator::Schedule (MilliSeconds (1), &FqCoDelQueueCoDelTestCase::Step, this, queue);
+    }
+}
+
+void
+FqCoDelQueueCoDelTestCase::DoRun (void)
+{
+  Ptr<FqCoDelQueue> queue = CreateObject<FqCoDelQueue> ();
+  while (queue->Classify (CreateUdpPacket (m_sparse, 100)) == queue->Classify (CreateUdpPacket (m_bulk, 100)))
+    {
+      m_sparse++;
+    }
+  Simulator::Schedule (Seconds (0), &FqCoDelQueueCoDelTestCase::Step, this, queue);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_GT (queue->GetDropCount (), 0, "CoDel did not drop from the standing queue");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetDropOverLimit (), 0, "The queue overflowed");
+  NS_TEST_EXPECT_MSG_EQ (m_sparseRcvd, m_sparseSent, "The sparse flow lost packets or was delayed");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief FQ-CoDel TestSuite
+ */
+class FqCoDelQueueTestSuite : public TestSuite
+{
+public:
+  FqCoDelQueueTestSuite ()
+    : TestSuite ("fq-codel-queue", UNIT)
+  {
+    AddTestCase (new FqCoDelQueueClassifyTestCase (), TestCase::QUICK);
+    AddTestCase (new FqCoDelQueueSchedulingTestCase (), TestCase::QUICK);
+    AddTestCase (new FqCoDelQueueCoDelTestCase (), TestCase::QUICK);
+  }
+};
+
+static FqCoDelQueueTestSuite g_fqCoDelQueueTestSuite; //!< Static variable for test initialization
@@ -24,9 +24,7 @@
 
 #include "ns3/test.h"
 #include "ns3/global-route-manager-impl.h"
-#include "ns3/candidate-queue.h"
 #include "ns3/simulator.h"
-#include <cstdlib> // for rand()
 
 using namespace ns3;
 
@@ -44,22 +42,6 @@ GlobalRouteManagerImplTestCase::GlobalRouteManagerImplTestCase()
 void
 GlobalRouteManagerImplTestCase::DoRun (void)
 {
-  CandidateQueue candidate;
-
-  for (int i = 0; i < 100; ++i)
-    {
-      SPFVertex *v = new SPFVertex;
-      v->SetDistanceFromRoot (std::rand () % 100);
-      candidate.Push (v);
-    }
-
-  for (int i = 0; i < 100; ++i)
-    {
-      SPFVertex *v = candidate.Pop ();
-      delete v;
-      v = 0;
-    }
-
   // Build fake link state database; four routers (0-3), 3 point-to-point
   // links
   //
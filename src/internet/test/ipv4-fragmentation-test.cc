@@ -89,6 +89,7 @@ class Ipv4FragmentationTest: public TestCase
   uint8_t *m_data;
   uint32_t m_size;
   uint8_t m_icmpType;
+  uint32_t m_memoryDrops;
 
 public:
   virtual void DoRun (void);
@@ -108,6 +109,9 @@ public:
   void SetFill (uint8_t *fill, uint32_t fillSize, uint32_t dataSize);
   Ptr<Packet> SendClient (void);
 
+  void HandleDropServer (const Ipv4Header &header, Ptr<const Packet> packet,
+                         Ipv4L3Protocol::DropReason reason, Ptr<Ipv4> ipv4, uint32_t interface);
+
 };
 
 
@@ -117,6 +121,7 @@ Ipv4FragmentationTest::Ipv4FragmentationTest ()
   m_socketServer = 0;
   m_data = 0;
   m_dataSize = 0;
+  m_memoryDrops = 0;
 }
 
 Ipv4FragmentationTest::~Ipv4FragmentationTest ()
@@ -253,6 +258,16 @@ Ptr<Packet> Ipv4FragmentationTest::SendClient (void)
   return p;
 }
 
+void
+Ipv4FragmentationTest::HandleDropServer (const Ipv4Header &header, Ptr<const Packet> packet,
+                                         Ipv4L3Protocol::DropReason reason, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  if (reason == Ipv4L3Protocol::DROP_FRAGMENT_MEMORY)
+    {
+      m_memoryDrops++;
+    }
+}
+
 void
 Ipv4FragmentationTest::DoRun (void)
 {
@@ -449,6 +464,31 @@ Ipv4FragmentationTest::DoRun (void)
       NS_TEST_EXPECT_MSG_EQ (end, m_receivedPacketServer->GetSize (), "trivial");
     }
 
+  // Fifth test: normal channel, no errors, no delays, bounded reassembly memory.
+  // The fragments of a packet larger than the bound are discarded to make room
+  // for the next ones, so that it is never reassembled, while smaller packets are.
+  Ptr<Ipv4L3Protocol> serverIpv4 = serverNode->GetObject<Ipv4L3Protocol> ();
+  serverIpv4->SetAttribute ("FragmentsMaxBytes", UintegerValue (20000));
+  serverIpv4->TraceConnectWithoutContext ("Drop", MakeCallback (&Ipv4FragmentationTest::HandleDropServer, this));
+  for (int i = 3; i < 5; i++)
+    {
+      uint32_t packetSize = packetSizes[i];
+
+      SetFill (fillData, 78, packetSize);
+
+      m_receivedPacketServer = Create<Packet> ();
+      m_memoryDrops = 0;
+      Simulator::ScheduleWithContext (m_socketClient->GetNode ()->GetId (), Seconds (0),
+                                      &Ipv4FragmentationTest::SendClient, this);
+      Simulator::Run ();
+
+      uint16_t recvSize = m_receivedPacketServer->GetSize ();
+      bool fits = packetSize < 20000;
+
+      NS_TEST_EXPECT_MSG_EQ (recvSize, (fits ? packetSize : 0), "Packet size not correct");
+      NS_TEST_EXPECT_MSG_EQ ((m_memoryDrops == 0), fits, "Fragments not discarded as expected");
+    }
+
 
   Simulator::Destroy ();
 }
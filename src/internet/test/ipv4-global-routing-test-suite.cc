@@ -14,6 +14,10 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+#include <map>
+#include <set>
+#include <sstream>
 #include <vector>
 #include "ns3/boolean.h"
 #include "ns3/config.h"
@@ -36,6 +40,11 @@
 #include "ns3/simple-channel.h"
 #include "ns3/socket-factory.h"
 #include "ns3/udp-socket-factory.h"
+#include "ns3/udp-header.h"
+#include "ns3/global-router-interface.h"
+#include "ns3/global-route-manager.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-routing-table-entry.h"
 
 using namespace ns3;
 
@@ -420,6 +429,568 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun (void)
 }
 
 
+/**
+ * \brief Check that the routes installed in the table shared by all the
+ * nodes are the same as the ones installed in the table of every node.
+ */
+class Ipv4GlobalRoutingSharedTableTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingSharedTableTestCase ();
+  virtual ~Ipv4GlobalRoutingSharedTableTestCase ();
+
+private:
+  /**
+   * \param nodes the nodes
+   * \param addresses the addresses to look up
+   * \return for each node, its routes, sorted, and the route chosen to
+   *         each address
+   */
+  std::vector<std::string> GetRoutes (NodeContainer nodes, std::vector<Ipv4Address> addresses);
+  virtual void DoRun (void);
+};
+
+Ipv4GlobalRoutingSharedTableTestCase::Ipv4GlobalRoutingSharedTableTestCase ()
+  : TestCase ("Global routes in a table shared by all the nodes")
+{
+}
+
+Ipv4GlobalRoutingSharedTableTestCase::~Ipv4GlobalRoutingSharedTableTestCase ()
+{
+}
+
+std::vector<std::string>
+Ipv4GlobalRoutingSharedTableTestCase::GetRoutes (NodeContainer nodes, std::vector<Ipv4Address> addresses)
+{
+  std::vector<std::string> routes;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> gr = nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      // the shared table groups the routes by destination
+      std::vector<std::string> entries;
+      for (uint32_t j = 0; j < gr->GetNRoutes (); j++)
+        {
+          std::ostringstream entry;
+          entry << *gr->GetRoute (j);
+          entries.push_back (entry.str ());
+        }
+      std::sort (entries.begin (), entries.end ());
+      std::ostringstream os;
+      for (uint32_t j = 0; j < entries.size (); j++)
+        {
+          os << entries[j] << std::endl;
+        }
+      for (uint32_t j = 0; j < addresses.size (); j++)
+        {
+          Ipv4Header header;
+          header.SetDestination (addresses[j]);
+          Socket::SocketErrno error;
+          Ptr<Ipv4Route> route = gr->RouteOutput (Create<Packet> (), header, 0, error);
+          if (route != 0)
+            {
+              os << addresses[j] << " via " << route->GetGateway () << " " << route->GetOutputDevice () << std::endl;
+            }
+        }
+      routes.push_back (os.str ());
+    }
+  return routes;
+}
+
+// Six routers on a ring, with a chord, so that some of them have several
+// paths of the same cost to the others.
+void
+Ipv4GlobalRoutingSharedTableTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (6);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper devHelper;
+  devHelper.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  std::vector<Ipv4Address> addresses;
+  for (uint32_t i = 0; i < 7; i++)
+    {
+      NodeContainer link = i < 6 ? NodeContainer (nodes.Get (i), nodes.Get ((i + 1) % 6))
+        : NodeContainer (nodes.Get (1), nodes.Get (4));
+      Ipv4InterfaceContainer interfaces = ipv4.Assign (devHelper.Install (link));
+      addresses.push_back (interfaces.GetAddress (0));
+      addresses.push_back (interfaces.GetAddress (1));
+      ipv4.NewNetwork ();
+    }
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  std::vector<std::string> expected = GetRoutes (nodes, addresses);
+  Ptr<Ipv4GlobalRouting> gr = nodes.Get (0)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+  NS_TEST_ASSERT_MSG_EQ ((gr->GetSharedTable () == 0), true, "Shared table used by default");
+  uint32_t nRoutes = 0;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      nRoutes += nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ()->GetNRoutes ();
+    }
+
+  Config::SetGlobal ("GlobalRoutingSharedTable", BooleanValue (true));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::vector<std::string> shared = GetRoutes (nodes, addresses);
+  Ptr<Ipv4GlobalFib> table = gr->GetSharedTable ();
+  NS_TEST_ASSERT_MSG_NE (table, 0, "Shared table not used");
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (shared[i], expected[i], "Routes of node " << i << " differ");
+      Ptr<Ipv4GlobalRouting> other = nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      NS_TEST_EXPECT_MSG_EQ (other->GetSharedTable (), table, "Node " << i << " uses another table");
+    }
+  NS_TEST_EXPECT_MSG_LT (table->GetNDestinations (), nRoutes, "Destinations not shared");
+  NS_TEST_EXPECT_MSG_LT (table->GetNNextHopSets (), nRoutes, "Sets of next hops not shared");
+
+  uint32_t n = gr->GetNRoutes ();
+  Ipv4RoutingTableEntry second = *gr->GetRoute (1);
+  gr->RemoveRoute (0);
+  NS_TEST_EXPECT_MSG_EQ (gr->GetNRoutes (), n - 1, "Route not removed");
+  std::ostringstream expectedFirst, first;
+  expectedFirst << second;
+  first << *gr->GetRoute (0);
+  NS_TEST_EXPECT_MSG_EQ (first.str (), expectedFirst.str (), "Wrong route removed");
+
+  // the sets of next hops no node uses anymore are freed
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      table->RemoveRoutes (nodes.Get (i)->GetId ());
+    }
+  NS_TEST_EXPECT_MSG_EQ (table->GetNNextHopSets (), 0, "Sets of next hops not freed");
+  NS_TEST_EXPECT_MSG_EQ (gr->GetNRoutes (), 0, "Routes not removed");
+
+  Config::SetGlobal ("GlobalRoutingSharedTable", BooleanValue (false));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  NS_TEST_EXPECT_MSG_EQ ((gr->GetSharedTable () == 0), true, "Shared table still used");
+  std::vector<std::string> recomputed = GetRoutes (nodes, addresses);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (recomputed[i], expected[i], "Routes of node " << i << " differ once recomputed");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Check that updating the routes after a change of the topology
+ * gives the routes a full computation gives, whatever the number of
+ * threads computing them.
+ */
+class Ipv4GlobalRoutingUpdateTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingUpdateTestCase ();
+  virtual ~Ipv4GlobalRoutingUpdateTestCase ();
+
+private:
+  /**
+   * \param nodes the nodes
+   * \return for each node, its routes
+   */
+  std::vector<std::string> GetRoutes (NodeContainer nodes);
+  virtual void DoRun (void);
+};
+
+Ipv4GlobalRoutingUpdateTestCase::Ipv4GlobalRoutingUpdateTestCase ()
+  : TestCase ("Global routes updated after a change of the topology")
+{
+}
+
+Ipv4GlobalRoutingUpdateTestCase::~Ipv4GlobalRoutingUpdateTestCase ()
+{
+}
+
+std::vector<std::string>
+Ipv4GlobalRoutingUpdateTestCase::GetRoutes (NodeContainer nodes)
+{
+  std::vector<std::string> routes;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> gr = nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      std::ostringstream os;
+      for (uint32_t j = 0; j < gr->GetNRoutes (); j++)
+        {
+          os << *gr->GetRoute (j) << std::endl;
+        }
+      routes.push_back (os.str ());
+    }
+  return routes;
+}
+
+// Six routers on a ring with a chord, and two routers linked together
+// but not to the ring.
+void
+Ipv4GlobalRoutingUpdateTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (8);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper devHelper;
+  devHelper.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      NodeContainer link = i < 6 ? NodeContainer (nodes.Get (i), nodes.Get ((i + 1) % 6))
+        : i == 6 ? NodeContainer (nodes.Get (1), nodes.Get (4))
+        : NodeContainer (nodes.Get (6), nodes.Get (7));
+      ipv4.Assign (devHelper.Install (link));
+      ipv4.NewNetwork ();
+    }
+  NodeContainer ring;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      ring.Add (nodes.Get (i));
+    }
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  // a route added by the user to a node which no change affects
+  Ptr<Ipv4GlobalRouting> isolated = nodes.Get (6)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+  isolated->AddHostRouteTo (Ipv4Address ("192.168.0.1"), 1);
+  uint32_t nIsolated = isolated->GetNRoutes ();
+
+  // a longer path between nodes 2 and 3
+  Ptr<Ipv4> ipv4Node2 = nodes.Get (2)->GetObject<Ipv4> ();
+  ipv4Node2->SetMetric (2, 5);
+  GlobalRouteManager::UpdateRoutes ();
+  std::vector<std::string> updated = GetRoutes (ring);
+  NS_TEST_EXPECT_MSG_EQ (isolated->GetNRoutes (), nIsolated, "Routes of an unaffected node changed");
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::vector<std::string> expected = GetRoutes (ring);
+  for (uint32_t i = 0; i < ring.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (updated[i], expected[i], "Routes of node " << i << " differ after a metric change");
+    }
+
+  // the chord goes down
+  Ptr<Ipv4> ipv4Node1 = nodes.Get (1)->GetObject<Ipv4> ();
+  ipv4Node1->SetDown (3);
+  GlobalRouteManager::UpdateRoutes ();
+  updated = GetRoutes (ring);
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  expected = GetRoutes (ring);
+  for (uint32_t i = 0; i < ring.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (updated[i], expected[i], "Routes of node " << i << " differ after a link failure");
+    }
+
+  Config::SetGlobal ("GlobalRoutingThreads", UintegerValue (4));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::vector<std::string> threaded = GetRoutes (ring);
+  Config::SetGlobal ("GlobalRoutingThreads", UintegerValue (1));
+  for (uint32_t i = 0; i < ring.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (threaded[i], expected[i], "Routes of node " << i << " differ with several threads");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Check that the routes computed on demand are the ones computed
+ * up front, and that they are only computed when looked up.
+ */
+class Ipv4GlobalRoutingOnDemandTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingOnDemandTestCase ();
+  virtual ~Ipv4GlobalRoutingOnDemandTestCase ();
+
+private:
+  /**
+   * \param nodes the nodes
+   * \param addresses the addresses to look up
+   * \return for each node, the route chosen to each address
+   */
+  std::vector<std::string> LookupRoutes (NodeContainer nodes, std::vector<Ipv4Address> addresses);
+  /**
+   * \param nodes the nodes
+   * \return for each node, its routes
+   */
+  std::vector<std::string> GetRoutes (NodeContainer nodes);
+  virtual void DoRun (void);
+};
+
+Ipv4GlobalRoutingOnDemandTestCase::Ipv4GlobalRoutingOnDemandTestCase ()
+  : TestCase ("Global routes computed on demand")
+{
+}
+
+Ipv4GlobalRoutingOnDemandTestCase::~Ipv4GlobalRoutingOnDemandTestCase ()
+{
+}
+
+std::vector<std::string>
+Ipv4GlobalRoutingOnDemandTestCase::LookupRoutes (NodeContainer nodes, std::vector<Ipv4Address> addresses)
+{
+  std::vector<std::string> routes;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> gr = nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      std::ostringstream os;
+      for (uint32_t j = 0; j < addresses.size (); j++)
+        {
+          Ipv4Header header;
+          header.SetDestination (addresses[j]);
+          Socket::SocketErrno error;
+          Ptr<Ipv4Route> route = gr->RouteOutput (Create<Packet> (), header, 0, error);
+          if (route != 0)
+            {
+              os << addresses[j] << " via " << route->GetGateway () << " " << route->GetOutputDevice () << std::endl;
+            }
+        }
+      routes.push_back (os.str ());
+    }
+  return routes;
+}
+
+std::vector<std::string>
+Ipv4GlobalRoutingOnDemandTestCase::GetRoutes (NodeContainer nodes)
+{
+  std::vector<std::string> routes;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> gr = nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      std::ostringstream os;
+      for (uint32_t j = 0; j < gr->GetNRoutes (); j++)
+        {
+          os << *gr->GetRoute (j) << std::endl;
+        }
+      routes.push_back (os.str ());
+    }
+  return routes;
+}
+
+// Six routers on a ring, with a chord.
+void
+Ipv4GlobalRoutingOnDemandTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (6);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper devHelper;
+  devHelper.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  std::vector<Ipv4Address> addresses;
+  for (uint32_t i = 0; i < 7; i++)
+    {
+      NodeContainer link = i < 6 ? NodeContainer (nodes.Get (i), nodes.Get ((i + 1) % 6))
+        : NodeContainer (nodes.Get (1), nodes.Get (4));
+      Ipv4InterfaceContainer interfaces = ipv4.Assign (devHelper.Install (link));
+      addresses.push_back (interfaces.GetAddress (0));
+      addresses.push_back (interfaces.GetAddress (1));
+      ipv4.NewNetwork ();
+    }
+  Ptr<Ipv4GlobalRouting> gr = nodes.Get (0)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  std::vector<std::string> expected = LookupRoutes (nodes, addresses);
+  std::vector<std::string> expectedRoutes = GetRoutes (nodes);
+  NS_TEST_ASSERT_MSG_EQ ((gr->GetRouteCache () == 0), true, "Routes computed on demand by default");
+
+  Config::SetGlobal ("GlobalRoutingOnDemand", BooleanValue (true));
+  Config::SetGlobal ("GlobalRoutingCacheSize", UintegerValue (8));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  Ptr<Ipv4GlobalRouteCache> cache = gr->GetRouteCache ();
+  NS_TEST_ASSERT_MSG_NE (cache, 0, "Route cache not used");
+  NS_TEST_EXPECT_MSG_EQ (cache->GetNCalculations (), 0, "Routes computed up front");
+  std::vector<std::string> onDemand = LookupRoutes (nodes, addresses);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (onDemand[i], expected[i], "Routes of node " << i << " differ");
+    }
+  // the lookups of a node follow each other: one calculation per node
+  NS_TEST_EXPECT_MSG_EQ (cache->GetNCalculations (), nodes.GetN (), "Routes computed more than once");
+  NS_TEST_EXPECT_MSG_EQ (cache->GetNEntries (), 8, "Cache not bounded");
+  // lookups alternating between two nodes reuse their calculations
+  uint32_t nCalculations = cache->GetNCalculations ();
+  cache->Clear ();
+  for (uint32_t i = 0; i < addresses.size (); i++)
+    {
+      std::vector<Ipv4RoutingTableEntry> routes;
+      cache->Lookup (i % 2, Ipv4GlobalFib::HOST_ROUTE, addresses[i], routes);
+    }
+  NS_TEST_EXPECT_MSG_EQ (cache->GetNCalculations (), nCalculations + 2, "Routes of alternating nodes computed again");
+  std::vector<std::string> onDemandRoutes = GetRoutes (nodes);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (onDemandRoutes[i], expectedRoutes[i], "Route list of node " << i << " differs");
+    }
+
+  // a longer path between nodes 2 and 3 invalidates the cached routes
+  Ptr<Ipv4> ipv4Node2 = nodes.Get (2)->GetObject<Ipv4> ();
+  ipv4Node2->SetMetric (2, 5);
+  GlobalRouteManager::UpdateRoutes ();
+  NS_TEST_EXPECT_MSG_EQ (gr->GetRouteCache (), cache, "Route cache replaced");
+  onDemand = LookupRoutes (nodes, addresses);
+  Config::SetGlobal ("GlobalRoutingOnDemand", BooleanValue (false));
+  Config::SetGlobal ("GlobalRoutingCacheSize", UintegerValue (65536));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  NS_TEST_EXPECT_MSG_EQ ((gr->GetRouteCache () == 0), true, "Route cache still used");
+  expected = LookupRoutes (nodes, addresses);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (onDemand[i], expected[i], "Routes of node " << i << " differ after a metric change");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Check that flow ECMP routing keeps the packets of each flow on
+ * one route, spreads the flows over all the routes, and follows the
+ * weights of the interfaces.
+ */
+class Ipv4GlobalRoutingFlowEcmpTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingFlowEcmpTestCase ();
+  virtual ~Ipv4GlobalRoutingFlowEcmpTestCase ();
+
+private:
+  /**
+   * \brief Record the router a UDP packet went through
+   * \param context the index of the router
+   * \param p the packet, with its IPv4 header
+   * \param ipv4 the IPv4 stack of the router
+   * \param interface the input interface
+   */
+  void Rx (std::string context, Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+  /**
+   * \brief Send a packet
+   * \param socket the socket of the flow
+   * \param to the destination
+   */
+  void SendPacket (Ptr<Socket> socket, Ipv4Address to);
+  /**
+   * \brief Send flows from A to E
+   * \param weight the weight of the interface of B towards C
+   */
+  void RunFlows (uint32_t weight);
+  virtual void DoRun (void);
+
+  /// the routers each flow went through, by source port
+  std::map<uint16_t, std::set<std::string> > m_paths;
+};
+
+Ipv4GlobalRoutingFlowEcmpTestCase::Ipv4GlobalRoutingFlowEcmpTestCase ()
+  : TestCase ("Flow hashed and weighted ECMP")
+{
+}
+
+Ipv4GlobalRoutingFlowEcmpTestCase::~Ipv4GlobalRoutingFlowEcmpTestCase ()
+{
+}
+
+void
+Ipv4GlobalRoutingFlowEcmpTestCase::Rx (std::string context, Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  Ptr<Packet> copy = p->Copy ();
+  Ipv4Header header;
+  copy->RemoveHeader (header);
+  if (header.GetProtocol () != 17)
+    {
+      return;
+    }
+  UdpHeader udp;
+  copy->RemoveHeader (udp);
+  m_paths[udp.GetSourcePort ()].insert (context);
+}
+
+void
+Ipv4GlobalRoutingFlowEcmpTestCase::SendPacket (Ptr<Socket> socket, Ipv4Address to)
+{
+  socket->SendTo (Create<Packet> (100), 0, InetSocketAddress (to, 9));
+}
+
+// Two equal-cost paths between A and E, which B chooses from
+//
+//         +--C--+
+//   A----B       E
+//         +--D--+
+//
+void
+Ipv4GlobalRoutingFlowEcmpTestCase::RunFlows (uint32_t weight)
+{
+  m_paths.clear ();
+  NodeContainer nodes;
+  nodes.Create (5);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper devHelper;
+  devHelper.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  uint32_t links[5][2] = { { 0, 1 }, { 1, 2 }, { 1, 3 }, { 2, 4 }, { 3, 4 } };
+  Ipv4Address destination;
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Ipv4InterfaceContainer interfaces = ipv4.Assign (devHelper.Install (NodeContainer (nodes.Get (links[i][0]), nodes.Get (links[i][1]))));
+      destination = interfaces.GetAddress (1);
+      ipv4.NewNetwork ();
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  // interface 2 of B leads to C
+  nodes.Get (1)->GetObject<GlobalRouter> ()->GetRoutingProtocol ()->SetEcmpWeight (2, weight);
+  nodes.Get (2)->GetObject<Ipv4> ()->TraceConnect ("Rx", "C", MakeCallback (&Ipv4GlobalRoutingFlowEcmpTestCase::Rx, this));
+  nodes.Get (3)->GetObject<Ipv4> ()->TraceConnect ("Rx", "D", MakeCallback (&Ipv4GlobalRoutingFlowEcmpTestCase::Rx, this));
+
+  Ptr<SocketFactory> factory = nodes.Get (0)->GetObject<UdpSocketFactory> ();
+  for (uint16_t port = 1000; port < 1100; port++)
+    {
+      Ptr<Socket> socket = factory->CreateSocket ();
+      socket->Bind (InetSocketAddress (Ipv4Address::GetAny (), port));
+      for (uint32_t i = 0; i < 5; i++)
+        {
+          Simulator::ScheduleWithContext (nodes.Get (0)->GetId (), MilliSeconds (i * 100 + port - 1000),
+                                          &Ipv4GlobalRoutingFlowEcmpTestCase::SendPacket, this, socket, destination);
+        }
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+Ipv4GlobalRoutingFlowEcmpTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::Ipv4GlobalRouting::FlowEcmpRouting", BooleanValue (true));
+
+  RunFlows (1);
+  NS_TEST_ASSERT_MSG_EQ (m_paths.size (), 100, "Flows lost");
+  uint32_t viaC = 0;
+  for (std::map<uint16_t, std::set<std::string> >::const_iterator i = m_paths.begin (); i != m_paths.end (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (i->second.size (), 1, "Flow " << i->first << " split over both paths");
+      viaC += i->second.count ("C");
+    }
+  NS_TEST_EXPECT_MSG_GT (viaC, 30, "Too few flows through C");
+  NS_TEST_EXPECT_MSG_LT (viaC, 70, "Too few flows through D");
+
+  // three quarters of the flows through C
+  RunFlows (3);
+  NS_TEST_ASSERT_MSG_EQ (m_paths.size (), 100, "Flows lost");
+  viaC = 0;
+  for (std::map<uint16_t, std::set<std::string> >::const_iterator i = m_paths.begin (); i != m_paths.end (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (i->second.size (), 1, "Flow " << i->first << " split over both paths");
+      viaC += i->second.count ("C");
+    }
+  NS_TEST_EXPECT_MSG_GT (viaC, 60, "Weight of C not applied");
+  NS_TEST_EXPECT_MSG_LT (viaC, 90, "Weight of D not applied");
+
+  Config::SetDefault ("ns3::Ipv4GlobalRouting::FlowEcmpRouting", BooleanValue (false));
+}
+
 class Ipv4GlobalRoutingTestSuite : public TestSuite
 {
 public:
@@ -431,6 +1002,10 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite ()
 {
   AddTestCase (new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
   AddTestCase (new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4GlobalRoutingSharedTableTestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4GlobalRoutingUpdateTestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4GlobalRoutingOnDemandTestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4GlobalRoutingFlowEcmpTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
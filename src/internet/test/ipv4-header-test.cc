@@ -255,6 +255,73 @@ Ipv4HeaderTest::DoRun (void)
  
   Simulator::Destroy ();
 }
+//-----------------------------------------------------------------------------
+class Ipv4HeaderChecksumTest : public TestCase
+{
+public:
+  Ipv4HeaderChecksumTest ();
+  virtual void DoRun (void);
+};
+
+Ipv4HeaderChecksumTest::Ipv4HeaderChecksumTest ()
+  : TestCase ("IPv4 header incremental checksum")
+{
+}
+
+void
+Ipv4HeaderChecksumTest::DoRun (void)
+{
+  Ipv4Header sent;
+  sent.EnableChecksum ();
+  sent.SetSource (Ipv4Address ("10.1.2.3"));
+  sent.SetDestination (Ipv4Address ("10.4.5.6"));
+  sent.SetProtocol (17);
+  sent.SetTtl (64);
+  sent.SetPayloadSize (100);
+  sent.SetIdentification (0x1234);
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddHeader (sent);
+
+  // a forwarder rewrites the header of the received packet
+  Ipv4Header forwarded;
+  forwarded.EnableChecksum ();
+  p->RemoveHeader (forwarded);
+  NS_TEST_ASSERT_MSG_EQ (forwarded.IsChecksumOk (), true, "Bad checksum from the fields");
+  forwarded.SetTtl (63);
+  forwarded.SetEcn (Ipv4Header::ECN_CE);
+  forwarded.SetSource (Ipv4Address ("192.168.0.1"));
+  forwarded.SetDestination (Ipv4Address ("172.16.255.254"));
+  forwarded.SetFragmentOffset (64);
+  forwarded.SetMoreFragments ();
+  forwarded.SetPayloadSize (64);
+  p->AddHeader (forwarded);
+
+  Ipv4Header received;
+  received.EnableChecksum ();
+  p->PeekHeader (received);
+  NS_TEST_ASSERT_MSG_EQ (received.IsChecksumOk (), true, "Bad incrementally updated checksum");
+
+  // the updated checksum is the checksum of the new fields
+  Ipv4Header rebuilt;
+  rebuilt.EnableChecksum ();
+  rebuilt.SetSource (Ipv4Address ("192.168.0.1"));
+  rebuilt.SetDestination (Ipv4Address ("172.16.255.254"));
+  rebuilt.SetProtocol (17);
+  rebuilt.SetTtl (63);
+  rebuilt.SetEcn (Ipv4Header::ECN_CE);
+  rebuilt.SetPayloadSize (64);
+  rebuilt.SetIdentification (0x1234);
+  rebuilt.SetFragmentOffset (64);
+  rebuilt.SetMoreFragments ();
+  Ptr<Packet> q = Create<Packet> (100);
+  q->AddHeader (rebuilt);
+  uint8_t updated[20];
+  uint8_t full[20];
+  p->CopyData (updated, 20);
+  q->CopyData (full, 20);
+  NS_TEST_ASSERT_MSG_EQ (memcmp (updated, full, 20), 0, "Incremental and full checksums differ");
+}
+
 //-----------------------------------------------------------------------------
 class Ipv4HeaderTestSuite : public TestSuite
 {
@@ -262,5 +329,6 @@ public:
   Ipv4HeaderTestSuite () : TestSuite ("ipv4-header", UNIT)
   {
     AddTestCase (new Ipv4HeaderTest, TestCase::QUICK);
+    AddTestCase (new Ipv4HeaderChecksumTest, TestCase::QUICK);
   }
 } g_ipv4HeaderTestSuite;
@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/ipv4-route-trie.h"
+#include "ns3/ipv4-routing-table-entry.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv4RouteTrie test: the routes found by the trie must be the
+ * ones, and in the order, found by walking the routes one by one.
+ */
+class Ipv4RouteTrieTestCase : public TestCase
+{
+public:
+  Ipv4RouteTrieTestCase ();
+  virtual ~Ipv4RouteTrieTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \return the next number of a pseudo-random sequence
+   */
+  uint32_t Next (void);
+
+  uint32_t m_seed; //!< state of the pseudo-random sequence
+};
+
+Ipv4RouteTrieTestCase::Ipv4RouteTrieTestCase ()
+  : TestCase ("Ipv4RouteTrie lookups match a linear search"),
+    m_seed (12345)
+{
+}
+
+Ipv4RouteTrieTestCase::~Ipv4RouteTrieTestCase ()
+{
+}
+
+uint32_t
+Ipv4RouteTrieTestCase::Next (void)
+{
+  m_seed = m_seed * 1103515245 + 12345;
+  return m_seed >> 8;
+}
+
+void
+Ipv4RouteTrieTestCase::DoRun (void)
+{
+  // a few base addresses, so that prefixes overlap and repeat
+  std::vector<uint32_t> bases;
+  for (uint32_t i = 0; i < 16; i++)
+    {
+      bases.push_back ((Next () << 8) ^ Next ());
+    }
+
+  std::vector<Ipv4RoutingTableEntry *> entries;
+  std::vector<uint32_t> metrics;
+  Ipv4RouteTrie trie;
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      Ipv4Address network (bases[Next () % bases.size ()] ^ (Next () % 4));
+      Ipv4Mask mask;
+      if (i % 100 == 99)
+        {
+          mask = Ipv4Mask (0xff00ff00);
+        }
+      else
+        {
+          uint32_t length = Next () % 33;
+          mask = Ipv4Mask (length == 0 ? 0 : 0xffffffffU << (32 - length));
+        }
+      Ipv4RoutingTableEntry *entry = new Ipv4RoutingTableEntry ();
+      *entry = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network, mask, i % 7);
+      entries.push_back (entry);
+      metrics.push_back (i);
+      trie.Insert (network, mask, entry, i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (trie.GetNRoutes (), entries.size (), "Unexpected number of routes");
+
+  bool ok = true;
+  for (uint32_t i = 0; i < 5000 && ok; i++)
+    {
+      uint32_t address = bases[Next () % bases.size ()];
+      address ^= Next () >> (Next () % 32);
+      Ipv4Address dest (address);
+
+      std::vector<Ipv4RouteTrie::Route> routes;
+      trie.Lookup (dest, routes);
+      std::vector<Ipv4RouteTrie::Route>::const_iterator r = routes.begin ();
+      for (uint32_t j = 0; j < entries.size (); j++)
+        {
+          if (!entries[j]->GetDestNetworkMask ().IsMatch (dest, entries[j]->GetDestNetwork ()))
+            {
+              continue;
+            }
+          if (r == routes.end () || r->entry != entries[j] || r->metric != metrics[j])
+            {
+              ok = false;
+              break;
+            }
+          r++;
+        }
+      NS_TEST_EXPECT_MSG_EQ (ok && r == routes.end (), true, "Lookup of " << dest << " does not match");
+      ok = ok && r == routes.end ();
+    }
+
+  trie.Clear ();
+  std::vector<Ipv4RouteTrie::Route> routes;
+  trie.Lookup (Ipv4Address (bases[0]), routes);
+  NS_TEST_EXPECT_MSG_EQ (routes.size (), 0, "Routes left after Clear");
+  NS_TEST_EXPECT_MSG_EQ (trie.GetNRoutes (), 0, "Routes left after Clear");
+
+  for (uint32_t i = 0; i < entries.size (); i++)
+    {
+      delete entries[i];
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv4RouteTrie TestSuite
+ */
+class Ipv4RouteTrieTestSuite : public TestSuite
+{
+public:
+  Ipv4RouteTrieTestSuite ();
+};
+
+Ipv4RouteTrieTestSuite::Ipv4RouteTrieTestSuite ()
+  : TestSuite ("ipv4-route-trie", UNIT)
+{
+  AddTestCase (new Ipv4RouteTrieTestCase, TestCase::QUICK);
+}
+
+static Ipv4RouteTrieTestSuite g_ipv4RouteTrieTestSuite;
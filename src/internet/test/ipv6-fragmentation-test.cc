@@ -55,6 +55,8 @@
 
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/icmpv6-l4-protocol.h"
+#include "ns3/ipv6-extension-demux.h"
+#include "ns3/ipv6-extension.h"
 
 #include <string>
 #include <limits>
@@ -125,6 +127,7 @@ class Ipv6FragmentationTest : public TestCase
   uint32_t m_size;
   uint8_t m_icmpType;
   uint8_t m_icmpCode;
+  uint32_t m_memoryDrops;
 
 public:
   virtual void DoRun (void);
@@ -144,6 +147,9 @@ public:
   void SetFill (uint8_t *fill, uint32_t fillSize, uint32_t dataSize);
   Ptr<Packet> SendClient (void);
 
+  void HandleDropServer (const Ipv6Header &header, Ptr<const Packet> packet,
+                         Ipv6L3Protocol::DropReason reason, Ptr<Ipv6> ipv6, uint32_t interface);
+
 };
 
 
@@ -153,6 +159,7 @@ Ipv6FragmentationTest::Ipv6FragmentationTest ()
   m_socketServer = 0;
   m_data = 0;
   m_dataSize = 0;
+  m_memoryDrops = 0;
 }
 
 Ipv6FragmentationTest::~Ipv6FragmentationTest ()
@@ -285,6 +292,16 @@ Ptr<Packet> Ipv6FragmentationTest::SendClient (void)
   return p;
 }
 
+void
+Ipv6FragmentationTest::HandleDropServer (const Ipv6Header &header, Ptr<const Packet> packet,
+                                         Ipv6L3Protocol::DropReason reason, Ptr<Ipv6> ipv6, uint32_t interface)
+{
+  if (reason == Ipv6L3Protocol::DROP_FRAGMENT_MEMORY)
+    {
+      m_memoryDrops++;
+    }
+}
+
 void
 Ipv6FragmentationTest::DoRun (void)
 {
@@ -482,6 +499,32 @@ Ipv6FragmentationTest::DoRun (void)
       NS_TEST_EXPECT_MSG_EQ (end, m_receivedPacketServer->GetSize (), "trivial");
     }
 
+  // Fifth test: normal channel, no errors, no delays, bounded reassembly memory.
+  // The fragments of a packet larger than the bound are discarded to make room
+  // for the next ones, so that it is never reassembled, while smaller packets are.
+  Ptr<Ipv6ExtensionDemux> extensions = serverNode->GetObject<Ipv6ExtensionDemux> ();
+  extensions->GetExtension (Ipv6ExtensionFragment::EXT_NUMBER)->SetAttribute ("FragmentsMaxBytes", UintegerValue (20000));
+  serverNode->GetObject<Ipv6L3Protocol> ()->TraceConnectWithoutContext (
+    "Drop", MakeCallback (&Ipv6FragmentationTest::HandleDropServer, this));
+  for (int i = 3; i < 5; i++)
+    {
+      uint32_t packetSize = packetSizes[i];
+
+      SetFill (fillData, 78, packetSize);
+
+      m_receivedPacketServer = Create<Packet> ();
+      m_memoryDrops = 0;
+      Simulator::ScheduleWithContext (m_socketClient->GetNode ()->GetId (), Seconds (0),
+                                      &Ipv6FragmentationTest::SendClient, this);
+      Simulator::Run ();
+
+      uint16_t recvSize = m_receivedPacketServer->GetSize ();
+      bool fits = packetSize < 20000;
+
+      NS_TEST_EXPECT_MSG_EQ (recvSize, (fits ? packetSize : 0), "Packet size not correct");
+      NS_TEST_EXPECT_MSG_EQ ((m_memoryDrops == 0), fits, "Fragments not discarded as expected");
+    }
+
   Simulator::Destroy ();
 }
 //-----------------------------------------------------------------------------
@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/tcp-rx-buffer.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the bytes of a packet against a stream whose byte of
+ * offset n is n modulo 251.
+ * \param p the packet
+ * \param offset the offset in the stream of the first byte of the packet
+ * \return true if the bytes match
+ */
+static bool
+CheckBytes (Ptr<Packet> p, uint32_t offset)
+{
+  std::vector<uint8_t> bytes (p->GetSize ());
+  p->CopyData (&bytes[0], bytes.size ());
+  for (uint32_t i = 0; i < bytes.size (); i++)
+    {
+      if (bytes[i] != (offset + i) % 251)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ * \param offset the offset in the stream of the first byte
+ * \param size the number of bytes
+ * \return a packet holding bytes of the stream checked by CheckBytes
+ */
+static Ptr<Packet>
+MakeBytes (uint32_t offset, uint32_t size)
+{
+  std::vector<uint8_t> bytes (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      bytes[i] = (offset + i) % 251;
+    }
+  return Create<Packet> (&bytes[0], size);
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpTxBuffer test: segments copied across the packets written
+ * and after partial acknowledgements hold the right bytes.
+ */
+class TcpTxBufferTestCase : public TestCase
+{
+public:
+  TcpTxBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpTxBufferTestCase::TcpTxBufferTestCase ()
+  : TestCase ("TcpTxBuffer segments")
+{
+}
+
+void
+TcpTxBufferTestCase::DoRun (void)
+{
+  Ptr<TcpTxBuffer> buffer = CreateObject<TcpTxBuffer> (1000);
+  buffer->SetMaxBufferSize (100000);
+  uint32_t written = 0;
+  for (uint32_t size = 1; written + size <= 20000; size = size * 3 % 1009 + 1)
+    {
+      NS_TEST_ASSERT_MSG_EQ (buffer->Add (MakeBytes (written, size)), true, "Packet not buffered");
+      written += size;
+    }
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), written, "Wrong buffer size");
+
+  uint32_t acked = 0;
+  for (uint32_t offset = 0; offset < written; offset += 536)
+    {
+      Ptr<Packet> p = buffer->CopyFromSequence (536, SequenceNumber32 (1000 + offset));
+      NS_TEST_ASSERT_MSG_EQ (p->GetSize (), std::min (536U, written - offset), "Wrong segment size");
+      NS_TEST_ASSERT_MSG_EQ (CheckBytes (p, offset), true, "Wrong segment bytes");
+      if (offset % 3 == 0)
+        {
+          // acknowledge up to the middle of the segment
+          acked = offset + 100;
+          buffer->DiscardUpTo (SequenceNumber32 (1000 + acked));
+          NS_TEST_ASSERT_MSG_EQ (buffer->HeadSequence (), SequenceNumber32 (1000 + acked), "Wrong head");
+          NS_TEST_ASSERT_MSG_EQ (buffer->Size (), written - acked, "Wrong size after acknowledgement");
+          // a retransmission from the new head
+          p = buffer->CopyFromSequence (1000, SequenceNumber32 (1000 + acked));
+          NS_TEST_ASSERT_MSG_EQ (CheckBytes (p, acked), true, "Wrong retransmitted bytes");
+        }
+    }
+  // acknowledging the data and a FIN empties the buffer
+  buffer->DiscardUpTo (SequenceNumber32 (1000 + written + 1));
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), 0, "Buffer not empty");
+  NS_TEST_ASSERT_MSG_EQ (buffer->HeadSequence (), SequenceNumber32 (1000 + written + 1), "Wrong head");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpRxBuffer test: overlapping segments received out of order
+ * are read back in order.
+ */
+class TcpRxBufferTestCase : public TestCase
+{
+public:
+  TcpRxBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Add a segment of the stream to the buffer
+   * \param buffer the buffer
+   * \param offset the offset of the segment in the stream
+   * \param size the size of the segment
+   */
+  void Receive (Ptr<TcpRxBuffer> buffer, uint32_t offset, uint32_t size);
+};
+
+TcpRxBufferTestCase::TcpRxBufferTestCase ()
+  : TestCase ("TcpRxBuffer reordering")
+{
+}
+
+void
+TcpRxBufferTestCase::Receive (Ptr<TcpRxBuffer> buffer, uint32_t offset, uint32_t size)
+{
+  TcpHeader header;
+  header.SetSequenceNumber (SequenceNumber32 (500 + offset));
+  buffer->Add (MakeBytes (offset, size), header);
+}
+
+void
+TcpRxBufferTestCase::DoRun (void)
+{
+  Ptr<TcpRxBuffer> buffer = CreateObject<TcpRxBuffer> (500);
+  buffer->SetMaxBufferSize (100000);
+  uint32_t read = 0;
+  // segments of 1000 bytes, each one preceded by the next one and a
+  // segment overlapping both
+  for (uint32_t offset = 0; offset < 50000; offset += 2000)
+    {
+      SequenceNumber32 next = buffer->NextRxSequence ();
+      Receive (buffer, offset + 1000, 1000);
+      Receive (buffer, offset + 1500, 1000);
+      Receive (buffer, offset + 200, 300);
+      NS_TEST_ASSERT_MSG_EQ (buffer->NextRxSequence (), next, "RCV.NXT moved before the hole is filled");
+      Receive (buffer, offset, 1000);
+      NS_TEST_ASSERT_MSG_EQ (buffer->NextRxSequence (), SequenceNumber32 (500 + offset + 2500), "Wrong RCV.NXT");
+      Ptr<Packet> p = buffer->Extract (offset % 4000 == 0 ? 1200 : 100000);
+      NS_TEST_ASSERT_MSG_EQ (CheckBytes (p, read), true, "Wrong bytes read");
+      read += p->GetSize ();
+    }
+  Ptr<Packet> p = buffer->Extract (100000);
+  NS_TEST_ASSERT_MSG_EQ (CheckBytes (p, read), true, "Wrong bytes read");
+  read += p->GetSize ();
+  NS_TEST_ASSERT_MSG_EQ (read, 50500, "Wrong number of bytes read");
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), 0, "Buffer not empty");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP buffers test suite
+ */
+class TcpBufferTestSuite : public TestSuite
+{
+public:
+  TcpBufferTestSuite ()
+    : TestSuite ("tcp-buffer", UNIT)
+  {
+    AddTestCase (new TcpTxBufferTestCase, TestCase::QUICK);
+    AddTestCase (new TcpRxBufferTestCase, TestCase::QUICK);
+  }
+};
+
+static TcpBufferTestSuite g_tcpBufferTestSuite; //!< Static variable for test initialization
@@ -22,6 +22,8 @@
 #include "ns3/tcp-option.h"
 #include "ns3/private/tcp-option-winscale.h"
 #include "ns3/private/tcp-option-ts.h"
+#include "ns3/private/tcp-option-sack-permitted.h"
+#include "ns3/tcp-option-sack.h"
 
 #include <string.h>
 
@@ -164,6 +166,60 @@ TcpOptionTSTestCase::DoTeardown ()
 {
 }
 
+class TcpOptionSackTestCase : public TestCase
+{
+public:
+  TcpOptionSackTestCase (std::string name, uint32_t nBlocks);
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_nBlocks;
+};
+
+
+TcpOptionSackTestCase::TcpOptionSackTestCase (std::string name, uint32_t nBlocks)
+  : TestCase (name),
+    m_nBlocks (nBlocks)
+{
+}
+
+void
+TcpOptionSackTestCase::DoRun ()
+{
+  TcpOptionSack opt;
+  for (uint32_t i = 0; i < m_nBlocks; ++i)
+    {
+      opt.AddSackBlock (std::make_pair (SequenceNumber32 (1000 * i + 500),
+                                        SequenceNumber32 (1000 * i + 900)));
+    }
+  NS_TEST_EXPECT_MSG_EQ (opt.GetSerializedSize (), 2 + 8 * m_nBlocks, "Wrong size");
+
+  Buffer buffer;
+  buffer.AddAtStart (opt.GetSerializedSize ());
+  opt.Serialize (buffer.Begin ());
+
+  Buffer::Iterator start = buffer.Begin ();
+  NS_TEST_EXPECT_MSG_EQ (start.PeekU8 (), TcpOption::SACK, "Different kind found");
+
+  TcpOptionSack read;
+  NS_TEST_EXPECT_MSG_EQ (read.Deserialize (start), 2 + 8 * m_nBlocks, "Wrong deserialized size");
+  NS_TEST_EXPECT_MSG_EQ (read.GetNumSackBlocks (), m_nBlocks, "Different number of blocks found");
+  TcpOptionSack::SackList::const_iterator j = read.GetSackList ().begin ();
+  for (uint32_t i = 0; i < m_nBlocks; ++i, ++j)
+    {
+      NS_TEST_EXPECT_MSG_EQ (j->first, SequenceNumber32 (1000 * i + 500), "Different block start found");
+      NS_TEST_EXPECT_MSG_EQ (j->second, SequenceNumber32 (1000 * i + 900), "Different block end found");
+    }
+
+  TcpOptionSackPermitted permitted;
+  Buffer permittedBuffer;
+  permittedBuffer.AddAtStart (permitted.GetSerializedSize ());
+  permitted.Serialize (permittedBuffer.Begin ());
+  NS_TEST_EXPECT_MSG_EQ (permittedBuffer.Begin ().PeekU8 (), TcpOption::SACKPERMITTED, "Different kind found");
+  NS_TEST_EXPECT_MSG_EQ (permitted.Deserialize (permittedBuffer.Begin ()), 2, "Wrong deserialized size");
+}
+
 static class TcpOptionTestSuite : public TestSuite
 {
 public:
@@ -176,6 +232,10 @@ public:
                                               "scale value", i), TestCase::QUICK);
       }
     AddTestCase (new TcpOptionTSTestCase ("Testing serialization of random values for timestamp"), TestCase::QUICK);
+    for (uint32_t i = 1; i <= TcpOptionSack::MAX_SACK_BLOCKS; ++i)
+      {
+        AddTestCase (new TcpOptionSackTestCase ("Testing serialization of SACK blocks", i), TestCase::QUICK);
+      }
   }
 
 } g_TcpOptionTestSuite;
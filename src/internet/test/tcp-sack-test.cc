@@ -0,0 +1,397 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <set>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/error-model.h"
+#include "ns3/socket.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/tcp-scoreboard.h"
+#include "ns3/tcp-rx-buffer.h"
+#include "ns3/tcp-header.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpScoreboard test: intervals are merged and trimmed, and the
+ * pipe and the holes to retransmit follow RFC 6675.
+ */
+class TcpScoreboardTestCase : public TestCase
+{
+public:
+  TcpScoreboardTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpScoreboardTestCase::TcpScoreboardTestCase ()
+  : TestCase ("Check the SACK scoreboard")
+{
+}
+
+void
+TcpScoreboardTestCase::DoRun (void)
+{
+  // ten segments of 100 bytes in flight, from 1000 to 2000
+  SequenceNumber32 head (1000);
+  SequenceNumber32 highData (2000);
+  TcpScoreboard scoreboard;
+
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.AddBlock (SequenceNumber32 (1200), SequenceNumber32 (1300), head, highData),
+                         100, "New block not counted");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.AddBlock (SequenceNumber32 (1400), SequenceNumber32 (1500), head, highData),
+                         100, "New block not counted");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.AddBlock (SequenceNumber32 (1400), SequenceNumber32 (1500), head, highData),
+                         0, "Block SACKed twice counted");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.AddBlock (SequenceNumber32 (500), SequenceNumber32 (900), head, highData),
+                         0, "Block below head counted");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetNBlocks (), 2, "Wrong number of intervals");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSacked (SequenceNumber32 (1250)), true, "Byte not SACKed");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSacked (SequenceNumber32 (1300)), false, "Byte SACKed");
+
+  // two blocks, two segments above head: head is not lost yet
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsLost (head, 3, 100), false, "Head deemed lost too early");
+  // every unSACKed byte is in flight
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetPipe (head, highData, head, 3, 100), 800, "Wrong pipe");
+
+  // a third block makes the holes below it lost
+  scoreboard.AddBlock (SequenceNumber32 (1600), SequenceNumber32 (1700), head, highData);
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsLost (head, 3, 100), true, "Head not deemed lost");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsLost (SequenceNumber32 (1300), 3, 100), false, "Hole deemed lost");
+  // [1000;1200) is lost, [1300;1400), [1500;1600) and [1700;2000) are in flight
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetPipe (head, highData, head, 3, 100), 500, "Wrong pipe with a loss");
+
+  SequenceNumber32 seq;
+  uint32_t length;
+  bool found = scoreboard.GetNextHole (head, head, 3, 100, true, seq, length);
+  NS_TEST_EXPECT_MSG_EQ (found, true, "No lost data found");
+  NS_TEST_EXPECT_MSG_EQ (seq, head, "Wrong lost data");
+  NS_TEST_EXPECT_MSG_EQ (length, 100, "Wrong length");
+  // once [1000;1200) is retransmitted, it counts in the pipe again
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetPipe (head, highData, SequenceNumber32 (1200), 3, 100), 700,
+                         "Wrong pipe after a retransmission");
+  found = scoreboard.GetNextHole (head, SequenceNumber32 (1200), 3, 100, true, seq, length);
+  NS_TEST_EXPECT_MSG_EQ (found, false, "Data not lost to retransmit");
+  found = scoreboard.GetNextHole (head, SequenceNumber32 (1200), 3, 100, false, seq, length);
+  NS_TEST_EXPECT_MSG_EQ (found, true, "No unSACKed data found");
+  NS_TEST_EXPECT_MSG_EQ (seq, SequenceNumber32 (1300), "Wrong unSACKed data");
+
+  // blocks touching each other merge
+  scoreboard.AddBlock (SequenceNumber32 (1300), SequenceNumber32 (1400), head, highData);
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetNBlocks (), 2, "Intervals not merged");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetSackedBytes (), 400, "Wrong SACKed bytes");
+
+  // a cumulative acknowledgment in the middle of an interval trims it
+  scoreboard.DiscardUpTo (SequenceNumber32 (1250));
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetSackedBytes (), 350, "Wrong SACKed bytes after an ACK");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSacked (SequenceNumber32 (1250)), true, "Trimmed interval lost");
+  scoreboard.DiscardUpTo (SequenceNumber32 (2000));
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsEmpty (), true, "Acknowledged intervals kept");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpRxBuffer SACK test: the blocks beyond a hole are reported,
+ * the most recent one first.
+ */
+class TcpRxBufferSackTestCase : public TestCase
+{
+public:
+  TcpRxBufferSackTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpRxBufferSackTestCase::TcpRxBufferSackTestCase ()
+  : TestCase ("Check the SACK blocks of the Rx buffer")
+{
+}
+
+void
+TcpRxBufferSackTestCase::DoRun (void)
+{
+  TcpRxBuffer buffer (0);
+  buffer.SetMaxBufferSize (10000);
+  TcpHeader header;
+
+  header.SetSequenceNumber (SequenceNumber32 (0));
+  buffer.Add (Create<Packet> (100), header);
+  NS_TEST_EXPECT_MSG_EQ (buffer.GetSackList (4).empty (), true, "Blocks without a hole");
+
+  header.SetSequenceNumber (SequenceNumber32 (300));
+  buffer.Add (Create<Packet> (100), header);
+  header.SetSequenceNumber (SequenceNumber32 (400));
+  buffer.Add (Create<Packet> (100), header);
+  header.SetSequenceNumber (SequenceNumber32 (700));
+  buffer.Add (Create<Packet> (100), header);
+  header.SetSequenceNumber (SequenceNumber32 (200));
+  buffer.Add (Create<Packet> (50), header);
+
+  TcpOptionSack::SackList blocks = buffer.GetSackList (4);
+  NS_TEST_ASSERT_MSG_EQ (blocks.size (), 3, "Wrong number of blocks");
+  TcpOptionSack::SackList::const_iterator i = blocks.begin ();
+  NS_TEST_EXPECT_MSG_EQ (i->first, SequenceNumber32 (200), "The most recent block is not first");
+  NS_TEST_EXPECT_MSG_EQ (i->second, SequenceNumber32 (250), "Wrong block end");
+  ++i;
+  NS_TEST_EXPECT_MSG_EQ (i->first, SequenceNumber32 (300), "Contiguous packets not merged");
+  NS_TEST_EXPECT_MSG_EQ (i->second, SequenceNumber32 (500), "Contiguous packets not merged");
+  ++i;
+  NS_TEST_EXPECT_MSG_EQ (i->first, SequenceNumber32 (700), "Wrong block start");
+
+  NS_TEST_EXPECT_MSG_EQ (buffer.GetSackList (2).size (), 2, "Too many blocks");
+
+  // filling the first hole makes the block above it in sequence
+  header.SetSequenceNumber (SequenceNumber32 (100));
+  buffer.Add (Create<Packet> (100), header);
+  blocks = buffer.GetSackList (4);
+  NS_TEST_ASSERT_MSG_EQ (blocks.size (), 2, "Wrong number of blocks after filling a hole");
+  NS_TEST_EXPECT_MSG_EQ (blocks.begin ()->first, SequenceNumber32 (300), "Wrong block start");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief An error model dropping given data packets, counted from the
+ * first one it sees.
+ */
+class TcpSackDropModel : public ErrorModel
+{
+public:
+  /**
+   * \param drops the indexes of the data packets to drop
+   */
+  TcpSackDropModel (std::set<uint32_t> drops)
+    : m_drops (drops),
+      m_count (0)
+  {
+  }
+
+private:
+  virtual bool DoCorrupt (Ptr<Packet> p)
+  {
+    if (p->GetSize () < 100)
+      {
+        return false;
+      }
+    return m_drops.find (m_count++) != m_drops.end ();
+  }
+  virtual void DoReset (void)
+  {
+    m_count = 0;
+  }
+
+  std::set<uint32_t> m_drops; //!< the indexes of the data packets to drop
+  uint32_t m_count;           //!< the number of data packets seen
+};
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP SACK recovery test.
+ *
+ * Several segments of a window are lost.  NewReno without SACK recovers
+ * one of them per round trip, while with SACK all the holes are
+ * retransmitted in the first round trip of the recovery, so the receiver
+ * gets the data past the last hole earlier.
+ */
+class TcpSackRecoveryTestCase : public TestCase
+{
+public:
+  TcpSackRecoveryTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Transfer the stream
+   * \param sack whether SACK is enabled
+   * \param drops the indexes of the data packets to drop
+   * \return the time the data past the last hole was received
+   */
+  Time Transfer (bool sack, std::set<uint32_t> drops);
+  /**
+   * \brief Write as much of the stream as the socket takes
+   * \param socket the sending socket
+   * \param available the room in the Tx buffer
+   */
+  void SendData (Ptr<Socket> socket, uint32_t available);
+  /**
+   * \brief Accept a connection
+   * \param socket the new socket
+   * \param from the peer
+   */
+  void Accept (Ptr<Socket> socket, const Address &from);
+  /**
+   * \brief Read the data received
+   * \param socket the receiving socket
+   */
+  void ReceiveData (Ptr<Socket> socket);
+
+  uint32_t m_total;    //!< the number of bytes of the stream
+  uint32_t m_sent;     //!< the number of bytes written
+  uint32_t m_received; //!< the number of bytes read
+  uint32_t m_mark;     //!< the number of bytes past the last hole
+  Time m_markTime;     //!< the time m_mark bytes were read
+};
+
+TcpSackRecoveryTestCase::TcpSackRecoveryTestCase ()
+  : TestCase ("Check the recovery of several losses with SACK"),
+    m_total (300000),
+    m_mark (60000)
+{
+}
+
+void
+TcpSackRecoveryTestCase::SendData (Ptr<Socket> socket, uint32_t available)
+{
+  while (m_sent < m_total && socket->GetTxAvailable () > 0)
+    {
+      uint32_t size = std::min (m_total - m_sent, socket->GetTxAvailable ());
+      int sent = socket->Send (Create<Packet> (size));
+      if (sent <= 0)
+        {
+          break;
+        }
+      m_sent += sent;
+    }
+}
+
+void
+TcpSackRecoveryTestCase::Accept (Ptr<Socket> socket, const Address &from)
+{
+  socket->SetRecvCallback (MakeCallback (&TcpSackRecoveryTestCase::ReceiveData, this));
+}
+
+void
+TcpSackRecoveryTestCase::ReceiveData (Ptr<Socket> socket)
+{
+  Ptr<Packet> p;
+  while ((p = socket->Recv ()))
+    {
+      m_received += p->GetSize ();
+    }
+  if (m_received >= m_mark && m_markTime.IsZero ())
+    {
+      m_markTime = Simulator::Now ();
+    }
+}
+
+Time
+TcpSackRecoveryTestCase::Transfer (bool sack, std::set<uint32_t> drops)
+{
+  m_sent = 0;
+  m_received = 0;
+  m_markTime = Seconds (0);
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper simple;
+  simple.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  simple.SetChannelAttribute ("Delay", StringValue ("20ms"));
+  NetDeviceContainer devices = simple.Install (nodes);
+  Ptr<TcpSackDropModel> errorModel = CreateObject<TcpSackDropModel> (drops);
+  DynamicCast<SimpleNetDevice> (devices.Get (1))->SetReceiveErrorModel (errorModel);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  Ptr<Socket> server = Socket::CreateSocket (nodes.Get (1), TcpSocketFactory::GetTypeId ());
+  server->SetAttribute ("Sack", BooleanValue (sack));
+  server->Bind (InetSocketAddress (Ipv4Address::GetAny (), 5000));
+  server->Listen ();
+  server->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                             MakeCallback (&TcpSackRecoveryTestCase::Accept, this));
+
+  Ptr<Socket> client = Socket::CreateSocket (nodes.Get (0), TcpSocketFactory::GetTypeId ());
+  client->SetAttribute ("Sack", BooleanValue (sack));
+  client->SetAttribute ("SegmentSize", UintegerValue (1000));
+  client->SetAttribute ("SndBufSize", UintegerValue (m_total));
+  client->SetAttribute ("RcvBufSize", UintegerValue (m_total));
+  client->SetSendCallback (MakeCallback (&TcpSackRecoveryTestCase::SendData, this));
+  client->Connect (InetSocketAddress (interfaces.GetAddress (1), 5000));
+
+  Simulator::Stop (Seconds (20));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, m_total, "The whole stream was not received");
+  return m_markTime;
+}
+
+void
+TcpSackRecoveryTestCase::DoRun (void)
+{
+  std::set<uint32_t> drops;
+  drops.insert (40);
+  drops.insert (43);
+  drops.insert (46);
+  drops.insert (49);
+
+  Time withoutSack = Transfer (false, drops);
+  Time withSack = Transfer (true, drops);
+  Time lossless = Transfer (true, std::set<uint32_t> ());
+
+  // NewReno takes about one more round trip of 40 ms per lost segment
+  NS_TEST_EXPECT_MSG_GT (withoutSack, withSack + MilliSeconds (60), "SACK did not shorten the recovery");
+  // with SACK, the holes are filled in about one round trip
+  NS_TEST_EXPECT_MSG_LT (withSack, lossless + MilliSeconds (60), "SACK recovery took too long");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP SACK TestSuite
+ */
+class TcpSackTestSuite : public TestSuite
+{
+public:
+  TcpSackTestSuite ()
+    : TestSuite ("tcp-sack", UNIT)
+  {
+    AddTestCase (new TcpScoreboardTestCase, TestCase::QUICK);
+    AddTestCase (new TcpRxBufferSackTestCase, TestCase::QUICK);
+    AddTestCase (new TcpSackRecoveryTestCase, TestCase::QUICK);
+  }
+};
+
+static TcpSackTestSuite g_tcpSackTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,256 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/global-value.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/socket.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP segmentation offload test.
+ *
+ * A sender sends super-segments of up to eight segments to a router
+ * over a link with a large MTU, and the router splits them over a link
+ * with an MTU of 1500 bytes toward the receiver.  The whole stream must
+ * get through in order, with fewer packets on the first link than on the
+ * second one.
+ */
+class TcpSegmentOffloadTestCase : public TestCase
+{
+public:
+  /**
+   * \param checksums whether the checksums are computed
+   */
+  TcpSegmentOffloadTestCase (bool checksums);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Write as much of the stream as the socket takes
+   * \param socket the sending socket
+   * \param available the room in the Tx buffer
+   */
+  void SendData (Ptr<Socket> socket, uint32_t available);
+  /**
+   * \brief Accept a connection
+   * \param socket the new socket
+   * \param from the peer
+   */
+  void Accept (Ptr<Socket> socket, const Address &from);
+  /**
+   * \brief Read the data received and check it
+   * \param socket the receiving socket
+   */
+  void ReceiveData (Ptr<Socket> socket);
+  /**
+   * \brief Count the data packets sent by the sender
+   * \param p the packet
+   * \param ipv4 the IPv4 object
+   * \param interface the interface
+   */
+  void SenderTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+  /**
+   * \brief Count the data packets forwarded by the router toward the receiver
+   * \param p the packet
+   * \param ipv4 the IPv4 object
+   * \param interface the interface
+   */
+  void RouterTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+
+  bool m_checksums;         //!< whether the checksums are computed
+  uint32_t m_total;         //!< the number of bytes of the stream
+  uint32_t m_sent;          //!< the number of bytes written
+  uint32_t m_received;      //!< the number of bytes read
+  bool m_inOrder;           //!< whether the bytes read were the right ones
+  uint32_t m_senderTx;      //!< data packets sent by the sender
+  uint32_t m_routerTx;      //!< data packets sent by the router to the receiver
+  uint32_t m_largest;       //!< the largest packet sent by the router to the receiver
+};
+
+TcpSegmentOffloadTestCase::TcpSegmentOffloadTestCase (bool checksums)
+  : TestCase (checksums ? "TCP super-segments split by a router, with checksums"
+              : "TCP super-segments split by a router"),
+    m_checksums (checksums),
+    m_total (200000),
+    m_sent (0),
+    m_received (0),
+    m_inOrder (true),
+    m_senderTx (0),
+    m_routerTx (0),
+    m_largest (0)
+{
+}
+
+void
+TcpSegmentOffloadTestCase::SendData (Ptr<Socket> socket, uint32_t available)
+{
+  while (m_sent < m_total && socket->GetTxAvailable () > 0)
+    {
+      uint32_t size = std::min (std::min (m_total - m_sent, socket->GetTxAvailable ()), 10000U);
+      std::vector<uint8_t> bytes (size);
+      for (uint32_t i = 0; i < size; i++)
+        {
+          bytes[i] = (m_sent + i) % 251;
+        }
+      int sent = socket->Send (&bytes[0], size, 0);
+      if (sent <= 0)
+        {
+          break;
+        }
+      m_sent += sent;
+    }
+}
+
+void
+TcpSegmentOffloadTestCase::Accept (Ptr<Socket> socket, const Address &from)
+{
+  socket->SetRecvCallback (MakeCallback (&TcpSegmentOffloadTestCase::ReceiveData, this));
+}
+
+void
+TcpSegmentOffloadTestCase::ReceiveData (Ptr<Socket> socket)
+{
+  Ptr<Packet> p;
+  while ((p = socket->Recv ()))
+    {
+      std::vector<uint8_t> bytes (p->GetSize ());
+      p->CopyData (&bytes[0], bytes.size ());
+      for (uint32_t i = 0; i < bytes.size (); i++)
+        {
+          if (bytes[i] != (m_received + i) % 251)
+            {
+              m_inOrder = false;
+            }
+        }
+      m_received += p->GetSize ();
+    }
+}
+
+void
+TcpSegmentOffloadTestCase::SenderTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  if (p->GetSize () > 100)
+    {
+      m_senderTx++;
+    }
+}
+
+void
+TcpSegmentOffloadTestCase::RouterTx (Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  if (interface == 2 && p->GetSize () > 100)
+    {
+      m_routerTx++;
+      m_largest = std::max (m_largest, p->GetSize ());
+    }
+}
+
+void
+TcpSegmentOffloadTestCase::DoRun (void)
+{
+  GlobalValue::Bind ("ChecksumEnabled", BooleanValue (m_checksums));
+
+  NodeContainer nodes;
+  nodes.Create (3);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper simple;
+  simple.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  simple.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer jumbo = simple.Install (NodeContainer (nodes.Get (0), nodes.Get (1)));
+  NetDeviceContainer ethernet = simple.Install (NodeContainer (nodes.Get (1), nodes.Get (2)));
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      DynamicCast<SimpleNetDevice> (ethernet.Get (i))->SetMtu (1500);
+    }
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  address.Assign (jumbo);
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer receiverInterfaces = address.Assign (ethernet);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  nodes.Get (0)->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext (
+    "Tx", MakeCallback (&TcpSegmentOffloadTestCase::SenderTx, this));
+  nodes.Get (1)->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext (
+    "Tx", MakeCallback (&TcpSegmentOffloadTestCase::RouterTx, this));
+
+  Ptr<Socket> server = Socket::CreateSocket (nodes.Get (2), TcpSocketFactory::GetTypeId ());
+  server->Bind (InetSocketAddress (Ipv4Address::GetAny (), 5000));
+  server->Listen ();
+  server->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                             MakeCallback (&TcpSegmentOffloadTestCase::Accept, this));
+
+  Ptr<Socket> client = Socket::CreateSocket (nodes.Get (0), TcpSocketFactory::GetTypeId ());
+  client->SetAttribute ("SegmentSize", UintegerValue (1400));
+  client->SetAttribute ("TsoSegments", UintegerValue (8));
+  client->SetAttribute ("SndBufSize", UintegerValue (65535));
+  client->SetSendCallback (MakeCallback (&TcpSegmentOffloadTestCase::SendData, this));
+  client->Connect (InetSocketAddress (receiverInterfaces.GetAddress (1), 5000));
+
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  GlobalValue::Bind ("ChecksumEnabled", BooleanValue (false));
+
+  NS_TEST_EXPECT_MSG_EQ (m_sent, m_total, "The whole stream was not written");
+  NS_TEST_EXPECT_MSG_EQ (m_received, m_total, "The whole stream was not received");
+  NS_TEST_EXPECT_MSG_EQ (m_inOrder, true, "The stream was corrupted");
+  NS_TEST_EXPECT_MSG_LT (m_senderTx, m_routerTx / 2, "The sender did not send super-segments");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (m_largest, 1500, "The router sent packets larger than the MTU");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP segmentation offload TestSuite
+ */
+class TcpSegmentOffloadTestSuite : public TestSuite
+{
+public:
+  TcpSegmentOffloadTestSuite ()
+    : TestSuite ("tcp-segment-offload", UNIT)
+  {
+    AddTestCase (new TcpSegmentOffloadTestCase (false), TestCase::QUICK);
+    AddTestCase (new TcpSegmentOffloadTestCase (true), TestCase::QUICK);
+  }
+};
+
+static TcpSegmentOffloadTestSuite g_tcpSegmentOffloadTestSuite; //!< Static variable for test initialization
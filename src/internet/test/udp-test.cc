@@ -45,6 +45,7 @@
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/udp-l4-protocol.h"
+#include "ns3/udp-header.h"
 #include "ns3/tcp-l4-protocol.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/ipv4-static-routing.h"
@@ -505,6 +506,61 @@ Udp6SocketImplTest::DoRun (void)
 }
 
 
+class UdpVirtualChecksumTest : public TestCase
+{
+public:
+  UdpVirtualChecksumTest ();
+  virtual void DoRun (void);
+};
+
+UdpVirtualChecksumTest::UdpVirtualChecksumTest ()
+  : TestCase ("UDP virtual checksums")
+{
+}
+
+void
+UdpVirtualChecksumTest::DoRun (void)
+{
+  Ipv4Address src ("10.0.0.1");
+  Ipv4Address dst ("10.0.0.2");
+  uint8_t payload[64];
+  for (uint32_t i = 0; i < sizeof (payload); i++)
+    {
+      payload[i] = i + 1;
+    }
+  Ptr<Packet> p = Create<Packet> (payload, sizeof (payload));
+
+  UdpHeader sent;
+  sent.EnableChecksums ();
+  sent.EnableVirtualChecksums ();
+  sent.InitializeChecksum (src, dst, UdpL4Protocol::PROT_NUMBER);
+  sent.SetSourcePort (1234);
+  sent.SetDestinationPort (5678);
+  p->AddHeader (sent);
+
+  UdpHeader received;
+  received.EnableChecksums ();
+  received.EnableVirtualChecksums ();
+  received.InitializeChecksum (src, dst, UdpL4Protocol::PROT_NUMBER);
+  p->PeekHeader (received);
+  NS_TEST_EXPECT_MSG_EQ (received.IsChecksumOk (), true, "Bad virtual checksum");
+
+  // the pseudo-header is still covered
+  UdpHeader misrouted;
+  misrouted.EnableChecksums ();
+  misrouted.EnableVirtualChecksums ();
+  misrouted.InitializeChecksum (src, Ipv4Address ("10.0.0.3"), UdpL4Protocol::PROT_NUMBER);
+  p->PeekHeader (misrouted);
+  NS_TEST_EXPECT_MSG_EQ (misrouted.IsChecksumOk (), false, "The virtual checksum misses the pseudo-header");
+
+  // but the payload is not
+  UdpHeader real;
+  real.EnableChecksums ();
+  real.InitializeChecksum (src, dst, UdpL4Protocol::PROT_NUMBER);
+  p->PeekHeader (real);
+  NS_TEST_EXPECT_MSG_EQ (real.IsChecksumOk (), false, "The virtual checksum covers the payload");
+}
+
 //-----------------------------------------------------------------------------
 class UdpTestSuite : public TestSuite
 {
@@ -515,5 +571,6 @@ public:
     AddTestCase (new UdpSocketLoopbackTest, TestCase::QUICK);
     AddTestCase (new Udp6SocketImplTest, TestCase::QUICK);
     AddTestCase (new Udp6SocketLoopbackTest, TestCase::QUICK);
+    AddTestCase (new UdpVirtualChecksumTest, TestCase::QUICK);
   }
 } g_udpTestSuite;
@@ -28,6 +28,8 @@
 #include "ns3/names.h"
 #include "ns3/net-device.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
 
 #include "trace-helper.h"
 
@@ -35,6 +37,17 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 
+/**
+ * \brief The zlib compression level of the ascii traces.
+ */
+static GlobalValue g_asciiTraceCompression =
+  GlobalValue ("AsciiTraceCompression",
+               "The zlib compression level, from 1 (fastest) to 9 (best), of the files "
+               "created by AsciiTraceHelper::CreateFileStream, or 0 for no compression "
+               "(file names ending in .gz still get a gzip stream, of uncompressed blocks)",
+               UintegerValue (0),
+               MakeUintegerChecker<uint32_t> (0, 9));
+
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -56,6 +69,19 @@ PcapHelper::CreateFile (
   NS_LOG_FUNCTION (filename << filemode << dataLinkType << snapLen << tzCorrection);
 
   Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  Ptr<PcapngFileWrapper> pcapng = GetPcapng ();
+  if (pcapng != 0)
+    {
+      std::string name = filename;
+      std::string::size_type dot = name.rfind (".pcap");
+      if (dot != std::string::npos && dot + 5 == name.size ())
+        {
+          name.erase (dot);
+        }
+      file->Redirect (pcapng, pcapng->AddInterface (dataLinkType, name, snapLen));
+      return file;
+    }
+
   file->Open (filename, filemode);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for mode " << filemode);
 
@@ -76,6 +102,46 @@ PcapHelper::CreateFile (
   return file;
 }
 
+Ptr<PcapngFileWrapper> &
+PcapHelper::GetPcapng (void)
+{
+  static Ptr<PcapngFileWrapper> pcapng;
+  return pcapng;
+}
+
+void
+PcapHelper::EnablePcapng (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  DisablePcapng ();
+
+  Ptr<PcapngFileWrapper> pcapng = CreateObject<PcapngFileWrapper> ();
+  pcapng->Open (filename);
+  NS_ABORT_MSG_IF (pcapng->Fail (), "Unable to Open " << filename);
+  GetPcapng () = pcapng;
+  //
+  // Successive calls share a single destroy event; it expires when the
+  // simulator runs it, so that the next simulation schedules its own.
+  //
+  static EventId disableEvent;
+  if (disableEvent.IsExpired ())
+    {
+      disableEvent = Simulator::ScheduleDestroy (&PcapHelper::DisablePcapng);
+    }
+}
+
+void
+PcapHelper::DisablePcapng (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Ptr<PcapngFileWrapper> &pcapng = GetPcapng ();
+  if (pcapng != 0)
+    {
+      pcapng->Close ();
+      pcapng = 0;
+    }
+}
+
 std::string
 PcapHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -185,7 +251,23 @@ AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode fil
 {
   NS_LOG_FUNCTION (filename << filemode);
 
-  Ptr<OutputStreamWrapper> StreamWrapper = Create<OutputStreamWrapper> (filename, filemode);
+  UintegerValue level;
+  g_asciiTraceCompression.GetValue (level);
+  uint32_t compressionLevel = level.Get ();
+  bool gz = filename.size () > 3 && filename.compare (filename.size () - 3, 3, ".gz") == 0;
+  Ptr<OutputStreamWrapper> StreamWrapper;
+  if (compressionLevel != 0 || gz)
+    {
+      if (!gz)
+        {
+          filename += ".gz";
+        }
+      StreamWrapper = Create<OutputStreamWrapper> (filename, filemode, compressionLevel);
+    }
+  else
+    {
+      StreamWrapper = Create<OutputStreamWrapper> (filename, filemode);
+    }
 
   //
   // Note that the ascii trace helper promptly forgets all about the trace file.
@@ -434,6 +516,20 @@ PcapHelperForDevice::EnablePcapAll (std::string prefix, bool promiscuous)
   EnablePcap (prefix, NodeContainer::GetGlobal (), promiscuous);
 }
 
+void
+PcapHelperForDevice::EnablePcapngAll (std::string filename, bool promiscuous)
+{
+  std::string prefix = filename;
+  std::string::size_type dot = prefix.rfind ('.');
+  std::string::size_type slash = prefix.rfind ('/');
+  if (dot != std::string::npos && dot > 0 && (slash == std::string::npos || dot > slash + 1))
+    {
+      prefix.erase (dot);
+    }
+  PcapHelper::EnablePcapng (filename);
+  EnablePcapAll (prefix, promiscuous);
+}
+
 void 
 PcapHelperForDevice::EnablePcap (std::string prefix, uint32_t nodeid, uint32_t deviceid, bool promiscuous)
 {
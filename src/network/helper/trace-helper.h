@@ -24,6 +24,7 @@
 #include "ns3/node-container.h"
 #include "ns3/simulator.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/pcapng-file-wrapper.h"
 #include "ns3/output-stream-wrapper.h"
 
 namespace ns3 {
@@ -101,6 +102,24 @@ public:
    */
   Ptr<PcapFileWrapper> CreateFile (std::string filename, std::ios::openmode filemode,
                                    uint32_t dataLinkType,  uint32_t snapLen = std::numeric_limits<uint32_t>::max (), int32_t tzCorrection = 0);
+
+  /**
+   * @brief Gather the pcap traces of the simulation in a single pcapng file.
+   *
+   * Until DisablePcapng () is called, the files created by CreateFile ()
+   * are not opened: each of them becomes an interface of the pcapng file,
+   * named after the file.  The pcapng file is configured through the
+   * attributes of ns3::PcapngFileWrapper and is closed when the simulator
+   * is destroyed.
+   *
+   * @param filename the name of the pcapng file
+   */
+  static void EnablePcapng (std::string filename);
+
+  /**
+   * @brief Stop gathering the pcap traces in a pcapng file, and close it.
+   */
+  static void DisablePcapng (void);
   /**
    * @brief Hook a trace source to the default trace sink
    * 
@@ -111,6 +130,11 @@ public:
   template <typename T> void HookDefaultSink (Ptr<T> object, std::string traceName, Ptr<PcapFileWrapper> file);
 
 private:
+  /**
+   * @returns the pcapng file the pcap files are redirected to, if any
+   */
+  static Ptr<PcapngFileWrapper> &GetPcapng (void);
+
   /**
    * The basic default trace sink.
    *
@@ -194,6 +218,12 @@ public:
    * run into object lifetime issues.  Ns-3 has a nice reference counted object
    * that can solve the problem so we use one of those to carry the stream
    * around and deal with the lifetime issues.
+   *
+   * When the "AsciiTraceCompression" global value is not zero, or when the
+   * file name ends with ".gz", the file is gzip-compressed on the fly by a
+   * background thread (see CompressedOutputStream); ".gz" is appended to
+   * the file name if it is missing.  A ".gz" file created while the global
+   * value is zero is a gzip stream of uncompressed blocks.
    * 
    * @param filename file name
    * @param filemode file mode
@@ -612,6 +642,17 @@ public:
    * @param promiscuous If true capture all possible packets available at the device.
    */
   void EnablePcapAll (std::string prefix, bool promiscuous = false);
+
+  /**
+   * @brief Enable pcap output on each device (which is of the appropriate type)
+   * in the set of all nodes created in the simulation, in a single pcapng
+   * file with one interface per device.
+   *
+   * @param filename the name of the pcapng file; the interfaces are named
+   *        after it, without its extension, the node id and the device id.
+   * @param promiscuous If true capture all possible packets available at the device.
+   */
+  void EnablePcapngAll (std::string filename, bool promiscuous = false);
 };
 
 /**
@@ -1152,6 +1152,19 @@ void
 Buffer::Iterator::Read (uint8_t *buffer, uint32_t size)
 {
   NS_LOG_FUNCTION (this << &buffer << size);
+  // copy at once when the bytes do not cross the zero area
+  if (m_current >= m_dataStart && m_current + size <= m_zeroStart)
+    {
+      memcpy (buffer, &m_data[m_current], size);
+      m_current += size;
+      return;
+    }
+  if (m_current >= m_zeroEnd && m_current + size <= m_dataEnd)
+    {
+      memcpy (buffer, &m_data[m_current - (m_zeroEnd - m_zeroStart)], size);
+      m_current += size;
+      return;
+    }
   for (uint32_t i = 0; i < size; i++)
     {
       buffer[i] = ReadU8 ();
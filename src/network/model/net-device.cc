@@ -21,6 +21,8 @@
 #include "ns3/object.h"
 #include "ns3/log.h"
 #include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/packet-batch.h"
 #include "net-device.h"
 
 namespace ns3 {
@@ -43,4 +45,16 @@ NetDevice::~NetDevice ()
   NS_LOG_FUNCTION (this);
 }
 
+bool
+NetDevice::SendBatch (Ptr<PacketBatch> batch, const Address& dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << batch << dest << protocolNumber);
+  bool result = true;
+  for (std::vector<Ptr<Packet> >::const_iterator i = batch->Begin (); i != batch->End (); ++i)
+    {
+      result = Send (*i, dest, protocolNumber) && result;
+    }
+  return result;
+}
+
 } // namespace ns3
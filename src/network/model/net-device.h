@@ -35,6 +35,7 @@ namespace ns3 {
 class Node;
 class Channel;
 class Packet;
+class PacketBatch;
 
 /**
  * \ingroup network
@@ -236,6 +237,24 @@ public:
    * \return whether the Send operation succeeded 
    */
   virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber) = 0;
+  /**
+   * \param batch packets sent from above down to Network Device
+   * \param dest mac address of the destination (already resolved)
+   * \param protocolNumber identifies the type of payload contained in
+   *        the packets of the batch.
+   *
+   *  Called from higher layer to send a batch of back-to-back packets
+   *  into the Network Device to the specified destination Address.
+   *  Devices which support batching serialize the packets back to back
+   *  with one transmit complete event per batch; the peers still receive
+   *  each packet at its own arrival time, with one event per packet.
+   *  See PacketBatch for the timestamp semantics.
+   *
+   *  The default implementation calls Send for each packet of the batch.
+   *
+   * \return whether the Send operation succeeded for every packet
+   */
+  virtual bool SendBatch (Ptr<PacketBatch> batch, const Address& dest, uint16_t protocolNumber);
   /**
    * \returns the node base class which contains this network
    *          interface.
@@ -46,6 +46,17 @@ static GlobalValue g_checksumEnabled  = GlobalValue ("ChecksumEnabled",
                                                      BooleanValue (false),
                                                      MakeBooleanChecker ());
 
+/**
+ * \brief A global switch to leave the payload out of the transport checksums.
+ */
+static GlobalValue g_checksumVirtual  = GlobalValue ("ChecksumVirtual",
+                                                     "When checksums are enabled, compute the transport checksums "
+                                                     "over the headers and the pseudo-header only, so that the "
+                                                     "payload of the packets is never read. The checksums are "
+                                                     "consistent between simulated nodes but wrong on the wire.",
+                                                     BooleanValue (false),
+                                                     MakeBooleanChecker ());
+
 TypeId 
 Node::GetTypeId (void)
 {
@@ -274,6 +285,15 @@ Node::ChecksumEnabled (void)
   return val.Get ();
 }
 
+bool
+Node::ChecksumVirtual (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  BooleanValue val;
+  g_checksumVirtual.GetValue (val);
+  return val.Get ();
+}
+
 bool
 Node::PromiscReceiveFromDevice (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
                                 const Address &from, const Address &to, NetDevice::PacketType packetType)
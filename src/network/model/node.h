@@ -198,6 +198,12 @@ public:
    */
   static bool ChecksumEnabled (void);
 
+  /**
+   * \returns true if the transport checksums leave the payload out,
+   * when checksums are enabled.
+   */
+  static bool ChecksumVirtual (void);
+
 
 protected:
   /**
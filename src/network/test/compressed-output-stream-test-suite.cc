@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <zlib.h>
+
+#include "ns3/test.h"
+#include "ns3/compressed-output-stream.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/trace-helper.h"
+
+using namespace ns3;
+
+/**
+ * \param filename a gzip file
+ * \return the decompressed contents of the file
+ */
+static std::string
+ReadGzipFile (std::string filename)
+{
+  std::string contents;
+  gzFile f = gzopen (filename.c_str (), "rb");
+  if (f == 0)
+    {
+      return contents;
+    }
+  char buffer[4096];
+  int n;
+  while ((n = gzread (f, buffer, sizeof (buffer))) > 0)
+    {
+      contents.append (buffer, n);
+    }
+  gzclose (f);
+  return contents;
+}
+
+// ===========================================================================
+// Test case to make sure that the text written to a compressed stream, line
+// by line as ascii traces do, reads back identical, including when the file
+// is appended to.
+// ===========================================================================
+class CompressedOutputStreamTestCase : public TestCase
+{
+public:
+  CompressedOutputStreamTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+CompressedOutputStreamTestCase::CompressedOutputStreamTestCase ()
+  : TestCase ("Check that compressed streams read back identical")
+{
+}
+
+void
+CompressedOutputStreamTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("compressed.tr.gz");
+  std::ostringstream expected;
+
+  {
+    Ptr<OutputStreamWrapper> stream = Create<OutputStreamWrapper> (filename, std::ios::out, 6);
+    for (uint32_t i = 0; i < 100000; ++i)
+      {
+        *stream->GetStream () << "+ " << i << " ns3::PppHeader (Point-to-Point Protocol: IP (0x0021))" << std::endl;
+        expected << "+ " << i << " ns3::PppHeader (Point-to-Point Protocol: IP (0x0021))" << std::endl;
+      }
+    NS_TEST_ASSERT_MSG_EQ (stream->GetStream ()->good (), true, "Unexpected stream error");
+  }
+  NS_TEST_ASSERT_MSG_EQ (ReadGzipFile (filename), expected.str (), "Unexpected decompressed contents");
+
+  {
+    CompressedOutputStream stream (filename, std::ios::out | std::ios::app, 1, false);
+    NS_TEST_ASSERT_MSG_EQ (stream.IsOpen (), true, "Unable to open " << filename);
+    stream << "appended" << std::endl;
+    expected << "appended" << std::endl;
+  }
+  NS_TEST_ASSERT_MSG_EQ (ReadGzipFile (filename), expected.str (), "Unexpected contents after append");
+
+  std::remove (filename.c_str ());
+
+  // the "AsciiTraceCompression" level of 0 is kept for a .gz file name:
+  // the gzip stream stores the text uncompressed
+  AsciiTraceHelper helper;
+  filename = CreateTempDirFilename ("helper.tr.gz");
+  Ptr<OutputStreamWrapper> stream = helper.CreateFileStream (filename);
+  std::string text;
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      *stream->GetStream () << "r 1.5 packet" << std::endl;
+      text += "r 1.5 packet\n";
+    }
+  stream = 0;
+  NS_TEST_ASSERT_MSG_EQ (ReadGzipFile (filename), text, "Helper did not create a gzip stream");
+  std::ifstream file (filename.c_str (), std::ios::binary | std::ios::ate);
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (static_cast<uint64_t> (file.tellg ()), text.size (), "Helper compressed at level 0");
+  file.close ();
+
+  std::remove (filename.c_str ());
+}
+
+class CompressedOutputStreamTestSuite : public TestSuite
+{
+public:
+  CompressedOutputStreamTestSuite ();
+};
+
+CompressedOutputStreamTestSuite::CompressedOutputStreamTestSuite ()
+  : TestSuite ("compressed-output-stream", UNIT)
+{
+  AddTestCase (new CompressedOutputStreamTestCase, TestCase::QUICK);
+}
+
+static CompressedOutputStreamTestSuite compressedOutputStreamTestSuite;
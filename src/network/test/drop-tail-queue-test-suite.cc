@@ -18,6 +18,7 @@
 
 #include "ns3/test.h"
 #include "ns3/drop-tail-queue.h"
+#include "ns3/packet-ring.h"
 #include "ns3/uinteger.h"
 
 using namespace ns3;
@@ -77,6 +78,73 @@ DropTailQueueTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ ((p == 0), true, "There are really no packets in there");
 }
 
+class PacketRingTestCase : public TestCase
+{
+public:
+  PacketRingTestCase ();
+  virtual void DoRun (void);
+};
+
+PacketRingTestCase::PacketRingTestCase ()
+  : TestCase ("Sanity check on the packet ring under the queues")
+{
+}
+void
+PacketRingTestCase::DoRun (void)
+{
+  PacketRing ring;
+  NS_TEST_EXPECT_MSG_EQ (ring.GetCapacity (), 0, "The ring allocated before the first packet");
+  ring.Reserve (20);
+  NS_TEST_EXPECT_MSG_EQ (ring.GetCapacity (), 32, "The capacity is not the next power of two");
+
+  // go around the ring several times, then make it grow while wrapped
+  uint32_t pushed = 0;
+  uint32_t popped = 0;
+  bool inOrder = true;
+  for (uint32_t round = 0; round < 10; round++)
+    {
+      for (uint32_t i = 0; i < 25; i++)
+        {
+          ring.Push (Create<Packet> (pushed++ % 100));
+        }
+      while (ring.GetNPackets () > 5)
+        {
+          Ptr<Packet> p = ring.Pop ();
+          inOrder = inOrder && p->GetSize () == popped++ % 100;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (ring.GetCapacity (), 32, "The ring grew without being full");
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      ring.Push (Create<Packet> (pushed++ % 100));
+    }
+  NS_TEST_EXPECT_MSG_EQ (ring.GetCapacity (), 128, "The ring did not double when full");
+  uint32_t bytes = 0;
+  while (!ring.IsEmpty ())
+    {
+      bytes += ring.Front ()->GetSize ();
+      Ptr<Packet> p = ring.Pop ();
+      inOrder = inOrder && p->GetSize () == popped++ % 100;
+    }
+  NS_TEST_EXPECT_MSG_EQ (inOrder, true, "The packets came out of order");
+  NS_TEST_EXPECT_MSG_EQ (popped, pushed, "Packets were lost");
+  NS_TEST_EXPECT_MSG_EQ (ring.GetNBytes (), 0, "The byte count is wrong");
+  NS_TEST_EXPECT_MSG_EQ ((ring.Pop () == 0), true, "An empty ring returned a packet");
+
+  // the ring holds its own reference, and counts the bytes pushed
+  Ptr<Packet> p = Create<Packet> (100);
+  ring.Push (p);
+  p->RemoveAtEnd (40);
+  NS_TEST_EXPECT_MSG_EQ (ring.GetNBytes (), 100, "The byte count changed with the packet");
+  p = 0;
+  p = ring.Pop ();
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 60, "The ring did not keep the packet");
+  NS_TEST_EXPECT_MSG_EQ (ring.GetNBytes (), 0, "The byte count is not exact");
+  ring.Push (p);
+  ring.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (ring.GetNPackets (), 0, "The ring was not cleared");
+}
+
 static class DropTailQueueTestSuite : public TestSuite
 {
 public:
@@ -84,5 +152,6 @@ public:
     : TestSuite ("drop-tail-queue", UNIT)
   {
     AddTestCase (new DropTailQueueTestCase (), TestCase::QUICK);
+    AddTestCase (new PacketRingTestCase (), TestCase::QUICK);
   }
 } g_dropTailQueueTestSuite;
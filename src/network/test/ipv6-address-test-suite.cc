@@ -91,6 +91,51 @@ Ipv6AddressTestCase1::DoRun (void)
 
 }
 
+class Ipv6AddressCompareTestCase : public TestCase
+{
+public:
+  Ipv6AddressCompareTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv6AddressCompareTestCase::Ipv6AddressCompareTestCase ()
+  : TestCase ("comparisons and classification")
+{
+}
+
+void
+Ipv6AddressCompareTestCase::DoRun (void)
+{
+  // the order is the order of the bytes, whichever half differs
+  NS_TEST_ASSERT_MSG_EQ ((Ipv6Address ("2001:db8::1") < Ipv6Address ("2001:db8::2")), true, "Wrong order in the low half");
+  NS_TEST_ASSERT_MSG_EQ ((Ipv6Address ("2001:db8::ff") < Ipv6Address ("2001:db8::100")), true, "Wrong order across bytes");
+  NS_TEST_ASSERT_MSG_EQ ((Ipv6Address ("2001:db8::ffff") < Ipv6Address ("2001:db9::")), true, "Wrong order in the high half");
+  NS_TEST_ASSERT_MSG_EQ ((Ipv6Address ("ff02::1") < Ipv6Address ("2001:db8::1")), false, "Wrong order of the first byte");
+  NS_TEST_ASSERT_MSG_EQ ((Ipv6Address ("2001:db8::1") < Ipv6Address ("2001:db8::1")), false, "An address is less than itself");
+
+  NS_TEST_ASSERT_MSG_EQ ((Ipv6Address ("2001:db8::1") == Ipv6Address ("2001:db8:0:0::1")), true, "Equal addresses differ");
+  NS_TEST_ASSERT_MSG_EQ ((Ipv6Address ("2001:db8::1") != Ipv6Address ("2001:db8:1::1")), true, "Different addresses are equal");
+  NS_TEST_ASSERT_MSG_EQ (Ipv6Address ("2001:db8::1").IsEqual (Ipv6Address ("2001:db8::1")), true, "IsEqual failed");
+
+  Ipv6AddressHash hash;
+  NS_TEST_ASSERT_MSG_EQ (hash (Ipv6Address ("2001:db8::1")), hash (Ipv6Address ("2001:db8::1")), "Equal addresses hash differently");
+  NS_TEST_ASSERT_MSG_NE (hash (Ipv6Address ("2001:db8::1")), hash (Ipv6Address ("2001:db8::2")), "Neighbour addresses collide");
+  NS_TEST_ASSERT_MSG_NE (hash (Ipv6Address ("2001:db8::1")), hash (Ipv6Address ("2001:db9::1")), "Neighbour prefixes collide");
+
+  NS_TEST_ASSERT_MSG_EQ (Ipv6Address ("::").IsAny (), true, "IsAny failed");
+  NS_TEST_ASSERT_MSG_EQ (Ipv6Address ("::1").IsAny (), false, "IsAny failed");
+  NS_TEST_ASSERT_MSG_EQ (Ipv6Address ("::1").IsLocalhost (), true, "IsLocalhost failed");
+  NS_TEST_ASSERT_MSG_EQ (Ipv6Address ("ff02::1").IsAllNodesMulticast (), true, "IsAllNodesMulticast failed");
+  NS_TEST_ASSERT_MSG_EQ (Ipv6Address ("ff02::2").IsAllNodesMulticast (), false, "IsAllNodesMulticast failed");
+  NS_TEST_ASSERT_MSG_EQ (Ipv6Address ("ff02::2").IsAllRoutersMulticast (), true, "IsAllRoutersMulticast failed");
+  NS_TEST_ASSERT_MSG_EQ (Ipv6Address ("fe80::200:ff:fe00:1").IsLinkLocal (), true, "IsLinkLocal failed");
+  NS_TEST_ASSERT_MSG_EQ (Ipv6Address ("fe80:0:0:1::1").IsLinkLocal (), false, "IsLinkLocal failed");
+  NS_TEST_ASSERT_MSG_EQ (Ipv6Address ("fe81::1").IsLinkLocal (), false, "IsLinkLocal failed");
+  NS_TEST_ASSERT_MSG_EQ (Ipv6Address ("ff02::1").IsLinkLocal (), false, "IsLinkLocal failed");
+}
+
 class Ipv6AddressTestSuite : public TestSuite
 {
 public:
@@ -101,6 +146,7 @@ Ipv6AddressTestSuite::Ipv6AddressTestSuite ()
   : TestSuite ("ipv6-address", UNIT)
 {
   AddTestCase (new Ipv6AddressTestCase1, TestCase::QUICK);
+  AddTestCase (new Ipv6AddressCompareTestCase, TestCase::QUICK);
 }
 
 static Ipv6AddressTestSuite ipv6AddressTestSuite;
@@ -20,11 +20,15 @@
 #include <cstdio>
 #include <cstdlib>
 #include <sstream>
+#include <fstream>
 #include <cstring>
 
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/mapped-pcap-file.h"
+#include "ns3/packet-trace-file.h"
+#include "ns3/buffered-stream-writer.h"
 
 using namespace ns3;
 
@@ -1120,6 +1124,265 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+// ===========================================================================
+// Test case to make sure that MappedPcapFile reads out the same contents of
+// a known good pcap file as PcapFile.
+// ===========================================================================
+class MappedReadFileTestCase : public TestCase
+{
+public:
+  MappedReadFileTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MappedReadFileTestCase::MappedReadFileTestCase ()
+  : TestCase ("Check to see that MappedPcapFile can read out a known good pcap file")
+{
+}
+
+void
+MappedReadFileTestCase::DoRun (void)
+{
+  MappedPcapFile f;
+
+  std::string filename = CreateDataDirFilename ("known.pcap");
+  f.Open (filename);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ") returns error");
+  NS_TEST_ASSERT_MSG_EQ (f.GetDataLinkType (), 1, "Incorrectly read data link type from known good pcap file");
+
+  PcapFile ref;
+  ref.Open (filename, std::ios::in);
+  NS_TEST_ASSERT_MSG_EQ (ref.Fail (), false, "Open (" << filename << ", \"std::ios::in\") returns error");
+
+  uint8_t refData[2048];
+  uint8_t const *data = 0;
+  uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+
+  for (uint32_t round = 0; round < 2; ++round)
+    {
+      for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+        {
+          PacketEntry const & p = knownPackets[i];
+
+          bool ok = f.Read (tsSec, tsUsec, inclLen, origLen, data);
+          NS_TEST_ASSERT_MSG_EQ (ok, true, "Read() of known good pcap file returns error");
+          NS_TEST_ASSERT_MSG_EQ (tsSec, p.tsSec, "Incorrectly read seconds timestap from known good pcap file");
+          NS_TEST_ASSERT_MSG_EQ (tsUsec, p.tsUsec, "Incorrectly read microseconds timestap from known good pcap file");
+          NS_TEST_ASSERT_MSG_EQ (inclLen, p.inclLen, "Incorrectly read included length from known good packet");
+          NS_TEST_ASSERT_MSG_EQ (origLen, p.origLen, "Incorrectly read original length from known good packet");
+
+          if (round == 0)
+            {
+              ref.Read (refData, sizeof(refData), tsSec, tsUsec, inclLen, origLen, readLen);
+              NS_TEST_ASSERT_MSG_EQ (readLen, p.inclLen, "Incorrect actual read length from known good packet");
+              NS_TEST_ASSERT_MSG_EQ (std::memcmp (data, refData, readLen), 0, "Mapped data differs from read data");
+            }
+        }
+
+      bool ok = f.Read (tsSec, tsUsec, inclLen, origLen, data);
+      NS_TEST_ASSERT_MSG_EQ (ok, false, "Read() past the last record must fail");
+      NS_TEST_ASSERT_MSG_EQ (f.Eof (), true, "Read() past the last record must set EOF");
+      NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Read() past the last record of a good file must not fail");
+      f.Rewind ();
+    }
+
+  f.Close ();
+  ref.Close ();
+}
+
+// ===========================================================================
+// Test case to make sure that records written through the write buffer end
+// up in the file exactly as records written directly.
+// ===========================================================================
+class BufferedWriteTestCase : public TestCase
+{
+public:
+  BufferedWriteTestCase ();
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Write the known packets to a file
+   * \param filename the name of the file
+   * \param pageSize the size of the write buffer pages, 0 for no buffering
+   * \param async whether the pages are written by a background thread
+   */
+  void WriteKnownPackets (std::string filename, uint32_t pageSize, bool async);
+
+  std::string m_directFilename;
+  std::string m_syncFilename;
+  std::string m_asyncFilename;
+};
+
+BufferedWriteTestCase::BufferedWriteTestCase ()
+  : TestCase ("Check that PcapFile::SetWriteBuffer does not change the file")
+{
+}
+
+void
+BufferedWriteTestCase::DoSetup (void)
+{
+  std::stringstream filename;
+  uint32_t n = rand ();
+  filename << n;
+  m_directFilename = CreateTempDirFilename (filename.str () + "-direct.pcap");
+  m_syncFilename = CreateTempDirFilename (filename.str () + "-sync.pcap");
+  m_asyncFilename = CreateTempDirFilename (filename.str () + "-async.pcap");
+}
+
+void
+BufferedWriteTestCase::DoTeardown (void)
+{
+  remove (m_directFilename.c_str ());
+  remove (m_syncFilename.c_str ());
+  remove (m_asyncFilename.c_str ());
+}
+
+void
+BufferedWriteTestCase::WriteKnownPackets (std::string filename, uint32_t pageSize, bool async)
+{
+  PcapFile f;
+
+  f.Open (filename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ", \"std::ios::out\") returns error");
+  f.Init (1, N_PACKET_BYTES);
+  if (pageSize > 0)
+    {
+      // pages smaller than a record, and only two of them
+      f.SetWriteBuffer (pageSize, 2, async);
+    }
+
+  for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+    {
+      PacketEntry const & p = knownPackets[i];
+
+      f.Write (p.tsSec, p.tsUsec, (uint8_t const *)p.data, p.origLen);
+      NS_TEST_EXPECT_MSG_EQ (f.Fail (), false, "Write must not fail");
+    }
+  f.Close ();
+}
+
+void
+BufferedWriteTestCase::DoRun (void)
+{
+  WriteKnownPackets (m_directFilename, 0, false);
+  WriteKnownPackets (m_syncFilename, 37, false);
+  WriteKnownPackets (m_asyncFilename, 37, true);
+
+  uint32_t sec (0), usec (0);
+  bool diff = PcapFile::Diff (m_directFilename, m_syncFilename, sec, usec);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "Synchronous buffered write must not change the file");
+  diff = PcapFile::Diff (m_directFilename, m_asyncFilename, sec, usec);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "Asynchronous buffered write must not change the file");
+
+  // the state of a stream written by the background thread is reported
+  std::ofstream closed;
+  BufferedStreamWriter writer (&closed, 37, 2, true);
+  NS_TEST_EXPECT_MSG_EQ (writer.Fail (), false, "Stream failed before any write");
+  char data[100] = { 0 };
+  writer.Write (data, sizeof (data));
+  writer.Flush ();
+  NS_TEST_EXPECT_MSG_EQ (writer.Fail (), true, "Write to a closed file must fail");
+}
+
+// ===========================================================================
+// Test case to make sure that PacketTraceFile reads back the records it
+// wrote, sequentially and at saved offsets.
+// ===========================================================================
+class PacketTraceFileTestCase : public TestCase
+{
+public:
+  PacketTraceFileTestCase ();
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  std::string m_testFilename;
+};
+
+PacketTraceFileTestCase::PacketTraceFileTestCase ()
+  : TestCase ("Check that PacketTraceFile reads back the records it writes")
+{
+}
+
+void
+PacketTraceFileTestCase::DoSetup (void)
+{
+  std::stringstream filename;
+  uint32_t n = rand ();
+  filename << n;
+  m_testFilename = CreateTempDirFilename (filename.str () + ".ns3t");
+}
+
+void
+PacketTraceFileTestCase::DoTeardown (void)
+{
+  remove (m_testFilename.c_str ());
+}
+
+void
+PacketTraceFileTestCase::DoRun (void)
+{
+  PacketTraceFile f;
+  f.Open (m_testFilename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << m_testFilename << ", \"std::ios::out\") returns error");
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      PacketTraceFile::Record r;
+      r.timestamp = 5000000000ULL + i * 1000;
+      r.size = 40 + i;
+      r.source = 0x0a000001 + (i % 7);
+      r.destination = 0xc0a80001;
+      r.sourcePort = 1024 + i;
+      r.destinationPort = 80;
+      r.protocol = 6;
+      f.Write (r);
+    }
+  f.Close ();
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Write must not fail");
+
+  f.Open (m_testFilename, std::ios::in);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << m_testFilename << ", \"std::ios::in\") returns error");
+  NS_TEST_ASSERT_MSG_EQ (f.GetNRecords (), 100, "Wrong number of records");
+
+  uint64_t offset50 = 0;
+  PacketTraceFile::Record r;
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      if (i == 50)
+        {
+          offset50 = f.GetOffset ();
+        }
+      NS_TEST_ASSERT_MSG_EQ (f.Read (r), true, "Unable to read record " << i);
+      NS_TEST_EXPECT_MSG_EQ (r.timestamp, 5000000000ULL + i * 1000, "Wrong timestamp in record " << i);
+      NS_TEST_EXPECT_MSG_EQ (r.size, 40 + i, "Wrong size in record " << i);
+      NS_TEST_EXPECT_MSG_EQ (r.source, 0x0a000001 + (i % 7), "Wrong source in record " << i);
+      NS_TEST_EXPECT_MSG_EQ (r.destination, 0xc0a80001, "Wrong destination in record " << i);
+      NS_TEST_EXPECT_MSG_EQ (r.sourcePort, 1024 + i, "Wrong source port in record " << i);
+      NS_TEST_EXPECT_MSG_EQ (r.destinationPort, 80, "Wrong destination port in record " << i);
+      NS_TEST_EXPECT_MSG_EQ (r.protocol, 6, "Wrong protocol in record " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (f.Read (r), false, "Read past the last record");
+  NS_TEST_ASSERT_MSG_EQ (f.Eof (), true, "End of file not reached");
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "End of file is not a failure");
+
+  f.Seek (offset50);
+  NS_TEST_ASSERT_MSG_EQ (f.Read (r), true, "Unable to read a record at a saved offset");
+  NS_TEST_EXPECT_MSG_EQ (r.size, 90, "Wrong record at a saved offset");
+  f.Close ();
+
+  MappedPcapFile pcap;
+  pcap.Open (m_testFilename);
+  NS_TEST_ASSERT_MSG_EQ (pcap.Fail (), true, "A packet trace is not a pcap file");
+}
+
 class PcapFileTestSuite : public TestSuite
 {
 public:
@@ -1137,6 +1400,9 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new MappedReadFileTestCase, TestCase::QUICK);
+  AddTestCase (new BufferedWriteTestCase, TestCase::QUICK);
+  AddTestCase (new PacketTraceFileTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite;
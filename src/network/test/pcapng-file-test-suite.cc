@@ -0,0 +1,347 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/packet-metadata.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/pcapng-file.h"
+#include "ns3/pcapng-file-wrapper.h"
+#include "ns3/trace-helper.h"
+
+using namespace ns3;
+
+static const uint32_t SECTION_HEADER_BLOCK = 0x0A0D0D0A;
+static const uint32_t INTERFACE_DESCRIPTION_BLOCK = 0x1;
+static const uint32_t ENHANCED_PACKET_BLOCK = 0x6;
+
+/**
+ * A pcapng file read back in memory, walked one block at a time.
+ */
+class PcapngReader
+{
+public:
+  /**
+   * \param filename the file to read
+   */
+  PcapngReader (std::string filename)
+    : m_offset (0)
+  {
+    std::ifstream in (filename.c_str (), std::ios::in | std::ios::binary);
+    m_data.assign (std::istreambuf_iterator<char> (in), std::istreambuf_iterator<char> ());
+  }
+  /**
+   * \return the 32 bits word at the given offset of the current block
+   * \param offset an offset in bytes
+   */
+  uint32_t Get32 (uint32_t offset) const
+  {
+    uint32_t value = 0;
+    if (m_offset + offset + 4 <= m_data.size ())
+      {
+        std::memcpy (&value, &m_data[m_offset + offset], 4);
+      }
+    return value;
+  }
+  /**
+   * \return the bytes at the given offset of the current block, as a string
+   * \param offset an offset in bytes
+   * \param length the number of bytes
+   */
+  std::string GetString (uint32_t offset, uint32_t length) const
+  {
+    if (m_offset + offset + length > m_data.size ())
+      {
+        return "";
+      }
+    return std::string (&m_data[m_offset + offset], length);
+  }
+  /**
+   * \return the type of the current block
+   */
+  uint32_t GetType (void) const
+  {
+    return Get32 (0);
+  }
+  /**
+   * \return the length of the current block, or 0 if it is inconsistent
+   */
+  uint32_t GetLength (void) const
+  {
+    uint32_t length = Get32 (4);
+    if (length < 12 || length % 4 != 0 || m_offset + length > m_data.size ()
+        || Get32 (length - 4) != length)
+      {
+        return 0;
+      }
+    return length;
+  }
+  /**
+   * Move to the next block
+   */
+  void Next (void)
+  {
+    m_offset += GetLength ();
+  }
+  /**
+   * \return true if all the blocks have been read
+   */
+  bool End (void) const
+  {
+    return m_offset >= m_data.size ();
+  }
+private:
+  std::vector<char> m_data; //!< file contents
+  uint32_t m_offset;        //!< offset of the current block
+};
+
+// ===========================================================================
+// Test case to make sure that the blocks of a pcapng file are laid out as
+// expected, with one interface description per interface and packets
+// truncated to the snap length of their interface.
+// ===========================================================================
+class PcapngFileBlocksTestCase : public TestCase
+{
+public:
+  PcapngFileBlocksTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapngFileBlocksTestCase::PcapngFileBlocksTestCase ()
+  : TestCase ("Check the block structure of a pcapng file")
+{
+}
+
+void
+PcapngFileBlocksTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("blocks.pcapng");
+  uint8_t data[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+  PcapngFile f;
+  f.Open (filename);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ") fails");
+  NS_TEST_ASSERT_MSG_EQ (f.AddInterface (PcapHelper::DLT_EN10MB, 65535, "n0-d1"), 0, "Unexpected interface id");
+  NS_TEST_ASSERT_MSG_EQ (f.AddInterface (PcapHelper::DLT_PPP, 8, ""), 1, "Unexpected interface id");
+  NS_TEST_ASSERT_MSG_EQ (f.GetNInterfaces (), 2, "Unexpected number of interfaces");
+  f.Write (0, 0x100000002ULL, data, sizeof (data));
+  f.Write (1, 3000, data, sizeof (data));
+  f.Write (0, 4000, data, sizeof (data), 2);
+  f.Close ();
+
+  PcapngReader r (filename);
+  NS_TEST_ASSERT_MSG_EQ (r.GetType (), SECTION_HEADER_BLOCK, "Missing section header");
+  NS_TEST_ASSERT_MSG_EQ (r.GetLength (), 28, "Unexpected section header length");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (8), 0x1A2B3C4D, "Unexpected byte order magic");
+
+  r.Next ();
+  NS_TEST_ASSERT_MSG_EQ (r.GetType (), INTERFACE_DESCRIPTION_BLOCK, "Missing first interface");
+  NS_TEST_ASSERT_MSG_EQ (r.GetLength (), 44, "Unexpected interface description length");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (8), PcapHelper::DLT_EN10MB, "Unexpected link type");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (12), 65535, "Unexpected snap length");
+  uint32_t nameOption = (5 << 16) | 2;
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (16), nameOption, "Missing if_name option");
+  NS_TEST_ASSERT_MSG_EQ (r.GetString (20, 5), "n0-d1", "Unexpected interface name");
+
+  r.Next ();
+  NS_TEST_ASSERT_MSG_EQ (r.GetType (), INTERFACE_DESCRIPTION_BLOCK, "Missing second interface");
+  NS_TEST_ASSERT_MSG_EQ (r.GetLength (), 32, "Unexpected interface description length");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (8), PcapHelper::DLT_PPP, "Unexpected link type");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (12), 8, "Unexpected snap length");
+
+  r.Next ();
+  NS_TEST_ASSERT_MSG_EQ (r.GetType (), ENHANCED_PACKET_BLOCK, "Missing first packet");
+  NS_TEST_ASSERT_MSG_EQ (r.GetLength (), 44, "Unexpected packet block length");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (8), 0, "Unexpected interface");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (12), 1, "Unexpected timestamp (high)");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (16), 2, "Unexpected timestamp (low)");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (20), 10, "Unexpected captured length");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (24), 10, "Unexpected original length");
+  NS_TEST_ASSERT_MSG_EQ (r.GetString (28, 10), std::string (data, data + 10), "Unexpected packet data");
+
+  r.Next ();
+  NS_TEST_ASSERT_MSG_EQ (r.GetType (), ENHANCED_PACKET_BLOCK, "Missing second packet");
+  NS_TEST_ASSERT_MSG_EQ (r.GetLength (), 40, "Unexpected packet block length");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (8), 1, "Unexpected interface");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (16), 3000, "Unexpected timestamp");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (20), 8, "Packet not truncated to the snap length");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (24), 10, "Unexpected original length");
+
+  r.Next ();
+  NS_TEST_ASSERT_MSG_EQ (r.GetType (), ENHANCED_PACKET_BLOCK, "Missing third packet");
+  NS_TEST_ASSERT_MSG_EQ (r.GetLength (), 36, "Unexpected packet block length");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (8), 0, "Unexpected interface");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (20), 2, "Packet not truncated to the requested length");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (24), 10, "Unexpected original length");
+
+  r.Next ();
+  NS_TEST_ASSERT_MSG_EQ (r.End (), true, "Unexpected trailing data");
+
+  std::remove (filename.c_str ());
+
+  std::string missing = CreateTempDirFilename ("missing-dir/blocks.pcapng");
+  f.Open (missing);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), true, "Open (" << missing << ") does not fail");
+  f.Close ();
+  f.Open (filename);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ") fails after a failed Open");
+  f.Close ();
+
+  std::remove (filename.c_str ());
+}
+
+// ===========================================================================
+// Test case to make sure that header-only capture saves the headers of the
+// packets and nothing else, through the write buffer.
+// ===========================================================================
+class PcapngHeaderOnlyTestCase : public TestCase
+{
+public:
+  PcapngHeaderOnlyTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapngHeaderOnlyTestCase::PcapngHeaderOnlyTestCase ()
+  : TestCase ("Check header-only capture in a pcapng file")
+{
+}
+
+void
+PcapngHeaderOnlyTestCase::DoRun (void)
+{
+  PacketMetadata::Enable ();
+  std::string filename = CreateTempDirFilename ("header-only.pcapng");
+
+  Ptr<PcapngFileWrapper> f = CreateObject<PcapngFileWrapper> ();
+  f->SetAttribute ("HeaderOnly", BooleanValue (true));
+  f->SetAttribute ("WriteBufferSize", UintegerValue (64));
+  f->Open (filename);
+  uint32_t interfaceId = f->AddInterface (PcapHelper::DLT_EN10MB, "eth");
+
+  Ptr<Packet> p = Create<Packet> (100);
+  EthernetHeader header;
+  p->AddHeader (header);
+  f->Write (interfaceId, MicroSeconds (1), p);
+  Ptr<Packet> payload = Create<Packet> (50);
+  f->Write (interfaceId, MicroSeconds (2), header, payload);
+  f->Close ();
+
+  PcapngReader r (filename);
+  r.Next ();
+  r.Next ();
+  NS_TEST_ASSERT_MSG_EQ (r.GetType (), ENHANCED_PACKET_BLOCK, "Missing first packet");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (16), 1000, "Unexpected timestamp");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (20), header.GetSerializedSize (), "Unexpected captured length");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (24), p->GetSize (), "Unexpected original length");
+
+  r.Next ();
+  NS_TEST_ASSERT_MSG_EQ (r.GetType (), ENHANCED_PACKET_BLOCK, "Missing second packet");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (20), header.GetSerializedSize (), "Unexpected captured length");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (24), header.GetSerializedSize () + 50, "Unexpected original length");
+
+  r.Next ();
+  NS_TEST_ASSERT_MSG_EQ (r.End (), true, "Unexpected trailing data");
+
+  std::remove (filename.c_str ());
+}
+
+// ===========================================================================
+// Test case to make sure that the pcap files created by PcapHelper end up
+// as interfaces of a single pcapng file when it is enabled.
+// ===========================================================================
+class PcapngHelperTestCase : public TestCase
+{
+public:
+  PcapngHelperTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapngHelperTestCase::PcapngHelperTestCase ()
+  : TestCase ("Check that PcapHelper redirects pcap files to a pcapng file")
+{
+}
+
+void
+PcapngHelperTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("helper.pcapng");
+
+  PcapHelper helper;
+  PcapHelper::EnablePcapng (filename);
+  Ptr<PcapFileWrapper> a = helper.CreateFile ("trace-0-0.pcap", std::ios::out, PcapHelper::DLT_EN10MB);
+  Ptr<PcapFileWrapper> b = helper.CreateFile ("trace-1-0.pcap", std::ios::out, PcapHelper::DLT_PPP);
+  NS_TEST_ASSERT_MSG_EQ (a->Fail (), false, "Redirected file fails");
+  b->Write (Seconds (1), Create<Packet> (20));
+  a->Write (Seconds (2), Create<Packet> (30));
+  Simulator::Destroy ();
+
+  PcapngReader r (filename);
+  r.Next ();
+  NS_TEST_ASSERT_MSG_EQ (r.GetType (), INTERFACE_DESCRIPTION_BLOCK, "Missing first interface");
+  NS_TEST_ASSERT_MSG_EQ (r.GetString (20, 9), "trace-0-0", "Unexpected interface name");
+  r.Next ();
+  NS_TEST_ASSERT_MSG_EQ (r.GetType (), INTERFACE_DESCRIPTION_BLOCK, "Missing second interface");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (8), PcapHelper::DLT_PPP, "Unexpected link type");
+  r.Next ();
+  NS_TEST_ASSERT_MSG_EQ (r.GetType (), ENHANCED_PACKET_BLOCK, "Missing first packet");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (8), 1, "Unexpected interface");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (24), 20, "Unexpected original length");
+  r.Next ();
+  NS_TEST_ASSERT_MSG_EQ (r.GetType (), ENHANCED_PACKET_BLOCK, "Missing second packet");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (8), 0, "Unexpected interface");
+  NS_TEST_ASSERT_MSG_EQ (r.Get32 (24), 30, "Unexpected original length");
+  r.Next ();
+  NS_TEST_ASSERT_MSG_EQ (r.End (), true, "Unexpected trailing data");
+
+  std::string pcapFilename = CreateTempDirFilename ("trace-2-0.pcap");
+  Ptr<PcapFileWrapper> c = helper.CreateFile (pcapFilename, std::ios::out, PcapHelper::DLT_EN10MB);
+  NS_TEST_ASSERT_MSG_EQ (c->GetDataLinkType (), PcapHelper::DLT_EN10MB, "Pcapng still enabled after Simulator::Destroy");
+  c->Close ();
+
+  std::remove (pcapFilename.c_str ());
+  std::remove (filename.c_str ());
+}
+
+class PcapngFileTestSuite : public TestSuite
+{
+public:
+  PcapngFileTestSuite ();
+};
+
+PcapngFileTestSuite::PcapngFileTestSuite ()
+  : TestSuite ("pcapng-file", UNIT)
+{
+  AddTestCase (new PcapngFileBlocksTestCase, TestCase::QUICK);
+  AddTestCase (new PcapngHeaderOnlyTestCase, TestCase::QUICK);
+  AddTestCase (new PcapngHelperTestCase, TestCase::QUICK);
+}
+
+static PcapngFileTestSuite pcapngFileTestSuite;
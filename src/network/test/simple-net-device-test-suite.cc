@@ -0,0 +1,246 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/packet-batch.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/uinteger.h"
+#include "ns3/mac48-address.h"
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+
+using namespace ns3;
+
+/**
+ * \brief Test class for PacketBatch transmission over a SimpleChannel
+ *
+ * It sends a batch of packets from one SimpleNetDevice to another and
+ * checks that they are delivered in order, each one at the time it would
+ * have been delivered had the packets been sent one by one.
+ */
+class SimpleNetDeviceBatchTestCase : public TestCase
+{
+public:
+  SimpleNetDeviceBatchTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send a batch of packets to the device specified
+   *
+   * \param device NetDevice to send to
+   */
+  void SendBatch (Ptr<SimpleNetDevice> device);
+
+  /**
+   * \brief Receive callback of the destination device
+   *
+   * \param device the receiving device
+   * \param packet the received packet
+   * \param protocol the protocol number
+   * \param sender the address of the sender
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &sender);
+
+  std::vector<uint32_t> m_rxSizes; //!< sizes of the received packets
+  std::vector<Time> m_rxTimes;     //!< times at which the packets were received
+};
+
+SimpleNetDeviceBatchTestCase::SimpleNetDeviceBatchTestCase ()
+  : TestCase ("Check the arrival times of the packets of a batch")
+{
+}
+
+void
+SimpleNetDeviceBatchTestCase::SendBatch (Ptr<SimpleNetDevice> device)
+{
+  Ptr<PacketBatch> batch = CreateObject<PacketBatch> ();
+  batch->AddPacket (Create<Packet> (100));
+  batch->AddPacket (Create<Packet> (200));
+  batch->AddPacket (Create<Packet> (300));
+  device->SendBatch (batch, device->GetBroadcast (), 0x800);
+}
+
+bool
+SimpleNetDeviceBatchTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &sender)
+{
+  m_rxSizes.push_back (packet->GetSize ());
+  m_rxTimes.push_back (Simulator::Now ());
+  return true;
+}
+
+void
+SimpleNetDeviceBatchTestCase::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<SimpleNetDevice> devA = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> devB = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (2)));
+
+  devA->SetAttribute ("DataRate", DataRateValue (DataRate ("8Mbps")));
+  devA->SetChannel (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devB->SetChannel (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  // Node::AddDevice installs its own receive callback
+  devB->SetReceiveCallback (MakeCallback (&SimpleNetDeviceBatchTestCase::Receive, this));
+
+  Simulator::Schedule (Seconds (1.0), &SimpleNetDeviceBatchTestCase::SendBatch, this, devA);
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxSizes.size (), 3, "Not all the packets of the batch were received");
+  NS_TEST_ASSERT_MSG_EQ (m_rxSizes[0], 100, "Packets of the batch received out of order");
+  NS_TEST_ASSERT_MSG_EQ (m_rxSizes[1], 200, "Packets of the batch received out of order");
+  NS_TEST_ASSERT_MSG_EQ (m_rxSizes[2], 300, "Packets of the batch received out of order");
+
+  // the simple device hands a packet to the channel when it starts
+  // transmitting it, so each packet arrives one channel delay after the
+  // transmission of its predecessors
+  DataRate rate ("8Mbps");
+  Time arrival = Seconds (1.0) + MilliSeconds (2);
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[0], arrival, "First packet of the batch not received at its arrival time");
+  arrival += rate.CalculateBytesTxTime (100);
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[1], arrival, "Second packet of the batch not received at its arrival time");
+  arrival += rate.CalculateBytesTxTime (200);
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[2], arrival, "Third packet of the batch not received at its arrival time");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Test class for the queue limits of PacketBatch transmission
+ *
+ * It sends a batch of packets through a SimpleNetDevice whose queue holds
+ * a single packet and checks that the packets the queue cannot hold are
+ * dropped, as if the packets had been sent one by one.
+ */
+class SimpleNetDeviceBatchQueueTestCase : public TestCase
+{
+public:
+  SimpleNetDeviceBatchQueueTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Receive callback of the destination device
+   *
+   * \param device the receiving device
+   * \param packet the received packet
+   * \param protocol the protocol number
+   * \param sender the address of the sender
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &sender);
+
+  /**
+   * \brief Drop trace of the queue of the source device
+   *
+   * \param packet the dropped packet
+   */
+  void Drop (Ptr<const Packet> packet);
+
+  uint32_t m_received; //!< number of packets received
+  uint32_t m_dropped;  //!< number of packets dropped by the queue
+};
+
+SimpleNetDeviceBatchQueueTestCase::SimpleNetDeviceBatchQueueTestCase ()
+  : TestCase ("Check that the packets of a batch go through the device queue"),
+    m_received (0),
+    m_dropped (0)
+{
+}
+
+bool
+SimpleNetDeviceBatchQueueTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &sender)
+{
+  m_received++;
+  return true;
+}
+
+void
+SimpleNetDeviceBatchQueueTestCase::Drop (Ptr<const Packet> packet)
+{
+  m_dropped++;
+}
+
+void
+SimpleNetDeviceBatchQueueTestCase::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<SimpleNetDevice> devA = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> devB = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+
+  Ptr<DropTailQueue> queue = CreateObject<DropTailQueue> ();
+  queue->SetAttribute ("MaxPackets", UintegerValue (1));
+  queue->TraceConnectWithoutContext ("Drop", MakeCallback (&SimpleNetDeviceBatchQueueTestCase::Drop, this));
+  devA->SetQueue (queue);
+  devA->SetAttribute ("DataRate", DataRateValue (DataRate ("8Mbps")));
+  devA->SetChannel (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devB->SetChannel (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  devB->SetReceiveCallback (MakeCallback (&SimpleNetDeviceBatchQueueTestCase::Receive, this));
+
+  // the first packet goes straight to the wire and the second one fills
+  // the queue, which drops the third one
+  Ptr<PacketBatch> batch = CreateObject<PacketBatch> ();
+  batch->AddPacket (Create<Packet> (100));
+  batch->AddPacket (Create<Packet> (200));
+  batch->AddPacket (Create<Packet> (300));
+  bool sent = devA->SendBatch (batch, devA->GetBroadcast (), 0x800);
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (sent, false, "The batch was accepted beyond the queue limit");
+  NS_TEST_ASSERT_MSG_EQ (m_dropped, 1, "The queue did not drop the packet it could not hold");
+  NS_TEST_ASSERT_MSG_EQ (m_received, 2, "The packets accepted by the queue were not all received");
+
+  Simulator::Destroy ();
+}
+
+class SimpleNetDeviceTestSuite : public TestSuite
+{
+public:
+  SimpleNetDeviceTestSuite ();
+};
+
+SimpleNetDeviceTestSuite::SimpleNetDeviceTestSuite ()
+  : TestSuite ("simple-net-device", UNIT)
+{
+  AddTestCase (new SimpleNetDeviceBatchTestCase, TestCase::QUICK);
+  AddTestCase (new SimpleNetDeviceBatchQueueTestCase, TestCase::QUICK);
+}
+
+static SimpleNetDeviceTestSuite g_simpleNetDeviceTestSuite;
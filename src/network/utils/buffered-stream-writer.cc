@@ -0,0 +1,243 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "buffered-stream-writer.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BufferedStreamWriter");
+
+BufferedStreamWriter::BufferedStreamWriter (std::ostream *os, uint32_t pageSize,
+                                            uint32_t maxPages, bool async)
+  : m_os (os),
+    m_pageSize (pageSize),
+    m_maxPages (maxPages),
+    m_async (false),
+    m_current (0),
+    m_nPages (0),
+    m_inFlight (0)
+{
+  NS_LOG_FUNCTION (this << os << pageSize << maxPages << async);
+  NS_ASSERT_MSG (m_pageSize > 0, "BufferedStreamWriter::BufferedStreamWriter(): null page size");
+  NS_ASSERT_MSG (m_maxPages > 0, "BufferedStreamWriter::BufferedStreamWriter(): null number of pages");
+#ifdef HAVE_PTHREAD_H
+  m_stop = false;
+  m_failed = m_os->fail ();
+  pthread_mutex_init (&m_mutex, 0);
+  pthread_cond_init (&m_pageReady, 0);
+  pthread_cond_init (&m_pageWritten, 0);
+  //
+  // With a single page, the simulation would have to wait for each page to
+  // be written anyway, so we do not bother with a thread.
+  //
+  if (async && m_maxPages > 1)
+    {
+      m_async = true;
+      m_thread = Create<SystemThread> (MakeCallback (&BufferedStreamWriter::Run, this));
+      m_thread->Start ();
+    }
+#endif /* HAVE_PTHREAD_H */
+}
+
+BufferedStreamWriter::~BufferedStreamWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+#ifdef HAVE_PTHREAD_H
+  if (m_async)
+    {
+      pthread_mutex_lock (&m_mutex);
+      m_stop = true;
+      pthread_cond_signal (&m_pageReady);
+      pthread_mutex_unlock (&m_mutex);
+      m_thread->Join ();
+      m_thread = 0;
+    }
+  pthread_cond_destroy (&m_pageWritten);
+  pthread_cond_destroy (&m_pageReady);
+  pthread_mutex_destroy (&m_mutex);
+#endif /* HAVE_PTHREAD_H */
+  delete m_current;
+  for (std::vector<Page *>::iterator i = m_free.begin (); i != m_free.end (); ++i)
+    {
+      delete *i;
+    }
+  m_free.clear ();
+}
+
+bool
+BufferedStreamWriter::IsAsync (void) const
+{
+  return m_async;
+}
+
+bool
+BufferedStreamWriter::Fail (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_async)
+    {
+      //
+      // The background thread only touches the stream while pages are in
+      // flight; otherwise the stream is ours to look at.
+      //
+      pthread_mutex_lock (&m_mutex);
+      bool failed = m_inFlight == 0 ? m_os->fail () : m_failed;
+      pthread_mutex_unlock (&m_mutex);
+      return failed;
+    }
+#endif /* HAVE_PTHREAD_H */
+  return m_os->fail ();
+}
+
+BufferedStreamWriter::Page *
+BufferedStreamWriter::AcquirePage (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&m_mutex);
+  while (m_free.empty () && m_nPages == m_maxPages)
+    {
+      NS_LOG_LOGIC ("All the pages are in use, waiting for the writer");
+      pthread_cond_wait (&m_pageWritten, &m_mutex);
+    }
+#endif /* HAVE_PTHREAD_H */
+  NS_ASSERT (!m_free.empty () || m_nPages < m_maxPages);
+  Page *page;
+  if (!m_free.empty ())
+    {
+      page = m_free.back ();
+      m_free.pop_back ();
+    }
+  else
+    {
+      m_nPages++;
+      page = new Page ();
+      page->reserve (m_pageSize);
+    }
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock (&m_mutex);
+#endif /* HAVE_PTHREAD_H */
+  return page;
+}
+
+void
+BufferedStreamWriter::Submit (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_current == 0 || m_current->empty ())
+    {
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (m_async)
+    {
+      pthread_mutex_lock (&m_mutex);
+      m_queue.push_back (m_current);
+      m_inFlight++;
+      pthread_cond_signal (&m_pageReady);
+      pthread_mutex_unlock (&m_mutex);
+      m_current = 0;
+      return;
+    }
+#endif /* HAVE_PTHREAD_H */
+  m_os->write (&(*m_current)[0], m_current->size ());
+  m_current->clear ();
+}
+
+void
+BufferedStreamWriter::Write (const void *data, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << data << size);
+  const char *p = static_cast<const char *> (data);
+  while (size > 0)
+    {
+      if (m_current == 0)
+        {
+          m_current = AcquirePage ();
+        }
+      uint32_t room = m_pageSize - m_current->size ();
+      uint32_t n = std::min (room, size);
+      m_current->insert (m_current->end (), p, p + n);
+      p += n;
+      size -= n;
+      if (m_current->size () == m_pageSize)
+        {
+          Submit ();
+        }
+    }
+}
+
+void
+BufferedStreamWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  Submit ();
+#ifdef HAVE_PTHREAD_H
+  if (m_async)
+    {
+      pthread_mutex_lock (&m_mutex);
+      while (m_inFlight > 0)
+        {
+          pthread_cond_wait (&m_pageWritten, &m_mutex);
+        }
+      pthread_mutex_unlock (&m_mutex);
+    }
+#endif /* HAVE_PTHREAD_H */
+  m_os->flush ();
+}
+
+void
+BufferedStreamWriter::Run (void)
+{
+  //
+  // No logging here: this runs outside of the simulation thread.
+  //
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock (&m_mutex);
+  while (true)
+    {
+      while (m_queue.empty () && !m_stop)
+        {
+          pthread_cond_wait (&m_pageReady, &m_mutex);
+        }
+      if (m_queue.empty ())
+        {
+          break;
+        }
+      Page *page = m_queue.front ();
+      m_queue.pop_front ();
+      pthread_mutex_unlock (&m_mutex);
+
+      m_os->write (&(*page)[0], page->size ());
+      bool failed = m_os->fail ();
+      page->clear ();
+
+      pthread_mutex_lock (&m_mutex);
+      m_free.push_back (page);
+      m_inFlight--;
+      m_failed = failed;
+      pthread_cond_signal (&m_pageWritten);
+    }
+  pthread_mutex_unlock (&m_mutex);
+#endif /* HAVE_PTHREAD_H */
+}
+
+} // namespace ns3
@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BUFFERED_STREAM_WRITER_H
+#define BUFFERED_STREAM_WRITER_H
+
+#include <ostream>
+#include <vector>
+#include <deque>
+#include <stdint.h>
+#include "ns3/core-config.h"
+#include "ns3/ptr.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#include "ns3/system-thread.h"
+#endif /* HAVE_PTHREAD_H */
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Accumulate small writes into large pages and hand them to an
+ * output stream, optionally from a background thread.
+ *
+ * Trace files are written record by record, with several small writes
+ * per record.  This class gathers those writes into pages of a
+ * configurable size and only touches the underlying stream once per
+ * page.  In asynchronous mode, full pages are queued and written by a
+ * dedicated SystemThread so that the simulation does not wait for the
+ * disk; the number of pages alive at any time is bounded, so a writer
+ * that falls behind eventually blocks the simulation instead of using
+ * unbounded memory.
+ *
+ * While the writer exists, the underlying stream must not be accessed
+ * directly by anybody else, except after a call to Flush () and before
+ * the next call to Write ().  Its state is read through Fail () instead.
+ *
+ * If ns-3 was built without thread support, asynchronous mode silently
+ * falls back to synchronous page writes.
+ */
+class BufferedStreamWriter
+{
+public:
+  static const uint32_t PAGE_SIZE_DEFAULT = 1 << 20; //!< Default size of a page, in bytes
+  static const uint32_t MAX_PAGES_DEFAULT = 8;       //!< Default maximum number of pages
+
+  /**
+   * \param os the stream the pages are written to
+   * \param pageSize the size of a page, in bytes
+   * \param maxPages the maximum number of pages (filling, queued or
+   *        being written) that can be allocated at any time
+   * \param async whether pages are written by a background thread
+   */
+  BufferedStreamWriter (std::ostream *os,
+                        uint32_t pageSize = PAGE_SIZE_DEFAULT,
+                        uint32_t maxPages = MAX_PAGES_DEFAULT,
+                        bool async = true);
+  /**
+   * Flush the pending data and stop the background thread, if any.
+   */
+  ~BufferedStreamWriter ();
+
+  /**
+   * \brief Append data to the stream
+   * \param data the data to write
+   * \param size the number of bytes to write
+   */
+  void Write (const void *data, uint32_t size);
+
+  /**
+   * \brief Write every pending page to the stream and flush it.
+   *
+   * When this method returns, all the data given to Write () has been
+   * handed to the underlying stream.
+   */
+  void Flush (void);
+
+  /**
+   * \brief Get the state of the underlying stream.
+   *
+   * While pages are being written, this is the state of the stream after
+   * the last page written.
+   *
+   * \return true if the 'fail' bit of the underlying stream is set
+   */
+  bool Fail (void);
+
+  /**
+   * \return true if the pages are written by a background thread
+   */
+  bool IsAsync (void) const;
+
+private:
+  /// A page of buffered data
+  typedef std::vector<char> Page;
+
+  /**
+   * \brief Get an empty page, waiting for the background thread to
+   * release one if the maximum number of pages has been reached.
+   * \return an empty page
+   */
+  Page * AcquirePage (void);
+  /**
+   * \brief Hand the current page over to be written.
+   */
+  void Submit (void);
+  /**
+   * \brief Body of the background thread.
+   */
+  void Run (void);
+
+  std::ostream *m_os;          //!< the stream the pages are written to
+  uint32_t m_pageSize;         //!< the size of a page, in bytes
+  uint32_t m_maxPages;         //!< the maximum number of pages
+  bool m_async;                //!< pages written by the background thread
+  Page *m_current;             //!< the page being filled
+  std::deque<Page *> m_queue;  //!< full pages waiting to be written
+  std::vector<Page *> m_free;  //!< written pages available for reuse
+  uint32_t m_nPages;           //!< the number of allocated pages
+  uint32_t m_inFlight;         //!< pages queued or being written
+#ifdef HAVE_PTHREAD_H
+  bool m_stop;                     //!< ask the background thread to exit
+  bool m_failed;                   //!< the stream failed writing the last page
+  Ptr<SystemThread> m_thread;      //!< the background thread
+  pthread_mutex_t m_mutex;         //!< protects the pages, the counters and the stream state
+  pthread_cond_t m_pageReady;      //!< signaled when a page is queued or on exit
+  pthread_cond_t m_pageWritten;    //!< signaled when a page was written
+#endif /* HAVE_PTHREAD_H */
+};
+
+} // namespace ns3
+
+#endif /* BUFFERED_STREAM_WRITER_H */
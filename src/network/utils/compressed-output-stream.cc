@@ -0,0 +1,252 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <streambuf>
+#include <sstream>
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+#include "buffered-stream-writer.h"
+#include "compressed-output-stream.h"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif /* HAVE_ZLIB */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CompressedOutputStream");
+
+/**
+ * \ingroup network
+ *
+ * \brief A stream buffer compressing everything written to it into a
+ * gzip file.
+ *
+ * It has no buffer of its own: it is only given whole pages by a
+ * BufferedStreamWriter.
+ */
+class GzipStreamBuffer : public std::streambuf
+{
+public:
+  /**
+   * \param filename the name of the file
+   * \param append whether to append a gzip member to an existing file
+   * \param level the zlib compression level
+   */
+  GzipStreamBuffer (std::string filename, bool append, uint32_t level);
+  ~GzipStreamBuffer ();
+  /**
+   * \return true if the file could be opened
+   */
+  bool IsOpen (void) const;
+
+protected:
+  virtual int_type overflow (int_type c);
+  virtual std::streamsize xsputn (const char *s, std::streamsize n);
+
+private:
+#ifdef HAVE_ZLIB
+  gzFile m_file; //!< the compressed file
+#endif /* HAVE_ZLIB */
+};
+
+GzipStreamBuffer::GzipStreamBuffer (std::string filename, bool append, uint32_t level)
+{
+  NS_LOG_FUNCTION (this << filename << append << level);
+#ifdef HAVE_ZLIB
+  std::ostringstream mode;
+  mode << (append ? "ab" : "wb") << level;
+  m_file = gzopen (filename.c_str (), mode.str ().c_str ());
+#else /* HAVE_ZLIB */
+  NS_FATAL_ERROR ("ns-3 was built without zlib, unable to compress " << filename);
+#endif /* HAVE_ZLIB */
+}
+
+GzipStreamBuffer::~GzipStreamBuffer ()
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_ZLIB
+  if (m_file != 0)
+    {
+      gzclose (m_file);
+    }
+#endif /* HAVE_ZLIB */
+}
+
+bool
+GzipStreamBuffer::IsOpen (void) const
+{
+#ifdef HAVE_ZLIB
+  return m_file != 0;
+#else /* HAVE_ZLIB */
+  return false;
+#endif /* HAVE_ZLIB */
+}
+
+GzipStreamBuffer::int_type
+GzipStreamBuffer::overflow (int_type c)
+{
+  if (traits_type::eq_int_type (c, traits_type::eof ()))
+    {
+      return traits_type::not_eof (c);
+    }
+  char ch = traits_type::to_char_type (c);
+  return xsputn (&ch, 1) == 1 ? c : traits_type::eof ();
+}
+
+std::streamsize
+GzipStreamBuffer::xsputn (const char *s, std::streamsize n)
+{
+#ifdef HAVE_ZLIB
+  if (m_file == 0 || n == 0)
+    {
+      return 0;
+    }
+  return gzwrite (m_file, s, n);
+#else /* HAVE_ZLIB */
+  return 0;
+#endif /* HAVE_ZLIB */
+}
+
+/**
+ * \ingroup network
+ *
+ * \brief The stream buffer of a CompressedOutputStream.
+ *
+ * Text is gathered in a small buffer which is handed over to a
+ * BufferedStreamWriter when it is full or when the stream is flushed:
+ * ascii traces flush the stream after every line, which must stay cheap.
+ */
+class CompressedStreamBuffer : public std::streambuf
+{
+public:
+  /**
+   * \param writer the writer the text is handed over to
+   */
+  CompressedStreamBuffer (BufferedStreamWriter *writer);
+
+protected:
+  virtual int_type overflow (int_type c);
+  virtual int sync (void);
+
+private:
+  /**
+   * \brief Hand the buffered text over to the writer.
+   */
+  void Push (void);
+
+  BufferedStreamWriter *m_writer; //!< the writer the text is handed over to
+  char m_data[4096];              //!< the buffered text
+};
+
+CompressedStreamBuffer::CompressedStreamBuffer (BufferedStreamWriter *writer)
+  : m_writer (writer)
+{
+  setp (m_data, m_data + sizeof (m_data));
+}
+
+void
+CompressedStreamBuffer::Push (void)
+{
+  if (pptr () != pbase ())
+    {
+      m_writer->Write (pbase (), pptr () - pbase ());
+      setp (m_data, m_data + sizeof (m_data));
+    }
+}
+
+CompressedStreamBuffer::int_type
+CompressedStreamBuffer::overflow (int_type c)
+{
+  Push ();
+  if (!traits_type::eq_int_type (c, traits_type::eof ()))
+    {
+      *pptr () = traits_type::to_char_type (c);
+      pbump (1);
+    }
+  return traits_type::not_eof (c);
+}
+
+int
+CompressedStreamBuffer::sync (void)
+{
+  Push ();
+  return m_writer->Fail () ? -1 : 0;
+}
+
+
+CompressedOutputStream::CompressedOutputStream (std::string filename, std::ios::openmode filemode,
+                                                uint32_t level, bool async)
+  : std::ostream (0)
+{
+  NS_LOG_FUNCTION (this << filename << filemode << level << async);
+  m_gzip = new GzipStreamBuffer (filename, (filemode & std::ios::app) != 0, level);
+  m_sink = new std::ostream (m_gzip);
+  m_writer = new BufferedStreamWriter (m_sink, BufferedStreamWriter::PAGE_SIZE_DEFAULT,
+                                       BufferedStreamWriter::MAX_PAGES_DEFAULT, async);
+  m_buffer = new CompressedStreamBuffer (m_writer);
+  rdbuf (m_buffer);
+  if (!m_gzip->IsOpen ())
+    {
+      setstate (std::ios::failbit);
+    }
+}
+
+CompressedOutputStream::~CompressedOutputStream ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+CompressedOutputStream::IsOpen (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_gzip != 0 && m_gzip->IsOpen ();
+}
+
+void
+CompressedOutputStream::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_gzip == 0)
+    {
+      return;
+    }
+  m_buffer->pubsync ();
+  rdbuf (0);
+  // the writer hands its last pages over to m_gzip before it goes away
+  delete m_writer;
+  delete m_buffer;
+  delete m_sink;
+  delete m_gzip;
+  m_writer = 0;
+  m_buffer = 0;
+  m_sink = 0;
+  m_gzip = 0;
+}
+
+bool
+CompressedOutputStream::IsAvailable (void)
+{
+#ifdef HAVE_ZLIB
+  return true;
+#else /* HAVE_ZLIB */
+  return false;
+#endif /* HAVE_ZLIB */
+}
+
+} // namespace ns3
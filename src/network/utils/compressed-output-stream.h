@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COMPRESSED_OUTPUT_STREAM_H
+#define COMPRESSED_OUTPUT_STREAM_H
+
+#include <ostream>
+#include <string>
+#include <stdint.h>
+
+namespace ns3 {
+
+class BufferedStreamWriter;
+class CompressedStreamBuffer;
+class GzipStreamBuffer;
+
+/**
+ * \ingroup network
+ *
+ * \brief An output stream writing a gzip-compressed file.
+ *
+ * The text written to the stream is gathered in large pages, which are
+ * compressed and written to the file by a background thread (see
+ * BufferedStreamWriter), so that the simulation does not wait for zlib.
+ * Flushing the stream, e.g. with std::endl, only hands the pending text
+ * over to the page being filled; the file is complete once the stream is
+ * closed or destroyed.
+ *
+ * Opening the file in append mode adds a new gzip member to it, which
+ * gzip readers decompress as the concatenation of all the members.
+ *
+ * This stream is only available when ns-3 is built with zlib; see
+ * IsAvailable ().
+ */
+class CompressedOutputStream : public std::ostream
+{
+public:
+  /**
+   * \param filename the name of the file
+   * \param filemode std::ios::openmode flags; only std::ios::app is taken
+   *        into account, the file is truncated otherwise
+   * \param level the zlib compression level, from 1 (fastest) to 9 (best),
+   *        or 0 to store the data uncompressed in the gzip stream
+   * \param async whether the pages are compressed by a background thread
+   */
+  CompressedOutputStream (std::string filename, std::ios::openmode filemode,
+                          uint32_t level = 6, bool async = true);
+  /**
+   * Compress the pending text, if any, and close the file.
+   */
+  ~CompressedOutputStream ();
+
+  /**
+   * \return true if the file could be opened
+   */
+  bool IsOpen (void) const;
+
+  /**
+   * \brief Compress the pending text and close the file.
+   */
+  void Close (void);
+
+  /**
+   * \return true if ns-3 was built with zlib
+   */
+  static bool IsAvailable (void);
+
+private:
+  GzipStreamBuffer *m_gzip;           //!< writes compressed data to the file
+  std::ostream *m_sink;               //!< stream over m_gzip
+  BufferedStreamWriter *m_writer;     //!< gathers text in pages
+  CompressedStreamBuffer *m_buffer;   //!< the buffer of this stream
+};
+
+} // namespace ns3
+
+#endif /* COMPRESSED_OUTPUT_STREAM_H */
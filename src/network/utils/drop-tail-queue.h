@@ -19,9 +19,9 @@
 #ifndef DROPTAIL_H
 #define DROPTAIL_H
 
-#include <queue>
 #include "ns3/packet.h"
 #include "ns3/queue.h"
+#include "ns3/packet-ring.h"
 
 namespace ns3 {
 
@@ -68,10 +68,9 @@ private:
   virtual Ptr<Packet> DoDequeue (void);
   virtual Ptr<const Packet> DoPeek (void) const;
 
-  std::queue<Ptr<Packet> > m_packets; //!< the packets in the queue
+  PacketRing m_packets;               //!< the packets in the queue
   uint32_t m_maxPackets;              //!< max packets in the queue
   uint32_t m_maxBytes;                //!< max bytes in the queue
-  uint32_t m_bytesInQueue;            //!< actual bytes in the queue
   QueueMode m_mode;                   //!< queue mode (packets or bytes limited)
 };
 
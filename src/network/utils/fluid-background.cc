@@ -0,0 +1,210 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "fluid-background.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FluidBackground");
+
+NS_OBJECT_ENSURE_REGISTERED (FluidBackground);
+
+TypeId
+FluidBackground::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FluidBackground")
+    .SetParent<Object> ()
+    .SetGroupName ("Network")
+    .AddConstructor<FluidBackground> ()
+    .AddAttribute ("MaxShare",
+                   "The largest fraction of the link capacity served to the background traffic.",
+                   DoubleValue (0.95),
+                   MakeDoubleAccessor (&FluidBackground::m_maxShare),
+                   MakeDoubleChecker<double> (0.0, 0.99))
+    .AddAttribute ("BufferSize",
+                   "The size in bytes of the output buffer shared by the background traffic and the packets.",
+                   UintegerValue (100 * 1500),
+                   MakeUintegerAccessor (&FluidBackground::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+FluidBackground::FluidBackground ()
+  : m_rate (0),
+    m_backlog (0),
+    m_lastUpdate (Seconds (0)),
+    m_lastArrival (Seconds (0))
+{
+  NS_LOG_FUNCTION (this);
+  m_uv = CreateObject<UniformRandomVariable> ();
+}
+
+FluidBackground::~FluidBackground ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FluidBackground::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_uv = 0;
+  m_changes.clear ();
+  Object::DoDispose ();
+}
+
+void
+FluidBackground::AddFlows (DataRate rate, Time start, Time stop, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << rate << start << stop << n);
+  NS_ASSERT (start <= stop);
+  double bps = static_cast<double> (rate.GetBitRate ()) * n;
+  // a change at the current time is applied by the next Update, after
+  // the backlog was integrated up to now at the old rate
+  Time now = Simulator::Now ();
+  if (start <= now)
+    {
+      start = now;
+    }
+  if (stop <= now)
+    {
+      return;
+    }
+  m_changes[start] += bps;
+  m_changes[stop] -= bps;
+}
+
+void
+FluidBackground::Integrate (Time until, double service)
+{
+  if (until <= m_lastUpdate)
+    {
+      return;
+    }
+  double dt = (until - m_lastUpdate).GetSeconds ();
+  m_backlog += (m_rate - service) / 8 * dt;
+  m_backlog = std::max (0.0, std::min (m_backlog, static_cast<double> (m_bufferSize)));
+  m_lastUpdate = until;
+}
+
+void
+FluidBackground::Update (DataRate capacity)
+{
+  Time now = Simulator::Now ();
+  double service = m_maxShare * capacity.GetBitRate ();
+  while (!m_changes.empty () && m_changes.begin ()->first <= now)
+    {
+      Integrate (m_changes.begin ()->first, service);
+      m_rate += m_changes.begin ()->second;
+      if (m_rate < 1e-6)
+        {
+          // cancel the rounding errors when the last flows stop
+          m_rate = 0;
+        }
+      m_changes.erase (m_changes.begin ());
+    }
+  Integrate (now, service);
+}
+
+DataRate
+FluidBackground::GetRate (void)
+{
+  Time now = Simulator::Now ();
+  double rate = m_rate;
+  for (std::map<Time, double>::const_iterator i = m_changes.begin ();
+       i != m_changes.end () && i->first <= now; ++i)
+    {
+      rate += i->second;
+    }
+  return DataRate (static_cast<uint64_t> (std::max (0.0, rate)));
+}
+
+double
+FluidBackground::GetBacklog (DataRate capacity)
+{
+  Update (capacity);
+  return m_backlog;
+}
+
+double
+FluidBackground::GetUtilization (DataRate capacity)
+{
+  Update (capacity);
+  double service = m_maxShare * capacity.GetBitRate ();
+  double used = m_backlog > 0 ? service : std::min (m_rate, service);
+  return used / capacity.GetBitRate ();
+}
+
+Time
+FluidBackground::GetTransmissionTime (DataRate capacity, uint32_t bytes)
+{
+  double residual = (1 - GetUtilization (capacity)) * capacity.GetBitRate ();
+  return Seconds (bytes * 8 / residual);
+}
+
+Time
+FluidBackground::GetQueueingDelay (DataRate capacity, Time txTime)
+{
+  Update (capacity);
+  Time now = Simulator::Now ();
+  Time delay = Seconds (0);
+  if (m_backlog > 0)
+    {
+      delay = Seconds (m_backlog * 8 / (m_maxShare * capacity.GetBitRate ()));
+    }
+  if (now + txTime + delay < m_lastArrival)
+    {
+      delay = m_lastArrival - now - txTime;
+    }
+  m_lastArrival = now + txTime + delay;
+  NS_LOG_LOGIC ("Backlog " << m_backlog << " bytes, delay " << delay);
+  return delay;
+}
+
+bool
+FluidBackground::Admit (DataRate capacity, uint32_t bytes, uint32_t queuedBytes)
+{
+  NS_LOG_FUNCTION (this << bytes << queuedBytes);
+  Update (capacity);
+  if (m_backlog + queuedBytes + bytes <= m_bufferSize)
+    {
+      return true;
+    }
+  double service = m_maxShare * capacity.GetBitRate ();
+  if (m_rate > service)
+    {
+      // the fluid keeps the buffer full: the tail drops hit the packets
+      // as often as the fluid, which loses what exceeds the service rate
+      return m_uv->GetValue () < service / m_rate;
+    }
+  return false;
+}
+
+int64_t
+FluidBackground::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_uv->SetStream (stream);
+  return 1;
+}
+
+} // namespace ns3
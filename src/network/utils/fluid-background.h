@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLUID_BACKGROUND_H
+#define FLUID_BACKGROUND_H
+
+#include <map>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Background traffic of a transmitter, modelled as a fluid
+ *
+ * A FluidBackground stands for the aggregate of many flows that are not
+ * simulated packet by packet: their offered rate is a piecewise constant
+ * function of time, built from the start and stop times of the flows, and
+ * it goes through the same output buffer as the packets of the device it
+ * is attached to (see PointToPointNetDevice::SetFluidBackground and
+ * CsmaNetDevice::SetFluidBackground).  The backlog of the fluid is
+ * integrated lazily, from one query of the device to the next, so the
+ * cost does not depend on the number of background flows nor on their
+ * rate.
+ *
+ * The fluid is served at up to MaxShare of the link capacity, and the
+ * packets get the rest:
+ *  - a packet is transmitted at the capacity left by the fluid (see
+ *    GetTransmissionTime);
+ *  - it reaches the peer later by the time needed to drain the fluid
+ *    backlog standing in the buffer when it was sent (see GetQueueingDelay);
+ *  - it is refused when the buffer, shared with the fluid backlog, cannot
+ *    hold it, and with the loss rate of the fluid when the fluid keeps the
+ *    buffer full (see Admit).
+ *
+ * The fluid backlog is kept here, not in the Queue of the device: the
+ * byte and packet counts of the queue, and so the decisions of active
+ * queue management (RedQueue, CoDelQueue, FqCoDelQueue), only reflect the
+ * packets.  The background load shows up in the delays and in the tail
+ * drops of Admit, but an AQM queue neither marks nor drops early because
+ * of it; use GetBacklog to observe the occupancy it adds to the buffer.
+ */
+class FluidBackground : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  FluidBackground ();
+  virtual ~FluidBackground ();
+
+  /**
+   * \brief Add background flows
+   *
+   * \param rate the rate of each flow
+   * \param start the time at which the flows start
+   * \param stop the time at which the flows stop
+   * \param n the number of flows
+   */
+  void AddFlows (DataRate rate, Time start, Time stop, uint32_t n = 1);
+
+  /**
+   * \return the current offered rate of the background flows
+   */
+  DataRate GetRate (void);
+
+  /**
+   * \param capacity the rate of the link
+   * \return the bytes of background traffic standing in the buffer
+   */
+  double GetBacklog (DataRate capacity);
+
+  /**
+   * \param capacity the rate of the link
+   * \return the fraction of the link currently used by the background flows
+   */
+  double GetUtilization (DataRate capacity);
+
+  /**
+   * \param capacity the rate of the link
+   * \param bytes the size of a packet
+   * \return the time to transmit the packet on what the fluid leaves of the link
+   */
+  Time GetTransmissionTime (DataRate capacity, uint32_t bytes);
+
+  /**
+   * \brief Get the time the packet starting its transmission now spends
+   * behind the fluid backlog
+   *
+   * The delay never lets a packet reach the peer before the packet
+   * transmitted before it.
+   *
+   * \param capacity the rate of the link
+   * \param txTime the transmission time of the packet
+   * \return the delay to add to the propagation delay of the packet
+   */
+  Time GetQueueingDelay (DataRate capacity, Time txTime);
+
+  /**
+   * \brief Decide whether the buffer takes a packet
+   *
+   * \param capacity the rate of the link
+   * \param bytes the size of the packet
+   * \param queuedBytes the bytes of the packets already in the buffer
+   * \return true if the packet can be queued, false if it is lost
+   */
+  bool Admit (DataRate capacity, uint32_t bytes, uint32_t queuedBytes);
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Bring the rate and the backlog up to the current time
+   * \param capacity the rate of the link
+   */
+  void Update (DataRate capacity);
+
+  /**
+   * \brief Integrate the backlog at the current rate
+   * \param until the end of the integration
+   * \param service the rate at which the fluid is served, in bit/s
+   */
+  void Integrate (Time until, double service);
+
+  double m_maxShare;                  //!< the largest fraction of the link given to the fluid
+  uint32_t m_bufferSize;              //!< the size of the buffer shared with the packets, in bytes
+  std::map<Time, double> m_changes;   //!< the future changes of the rate, in bit/s
+  double m_rate;                      //!< the current offered rate, in bit/s
+  double m_backlog;                   //!< the fluid in the buffer, in bytes
+  Time m_lastUpdate;                  //!< the time up to which the backlog is integrated
+  Time m_lastArrival;                 //!< the arrival at the peer of the last packet
+  Ptr<UniformRandomVariable> m_uv;    //!< the random variable for the losses
+};
+
+} // namespace ns3
+
+#endif /* FLUID_BACKGROUND_H */
@@ -56,86 +56,6 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv6Address");
 
-#ifdef __cplusplus
-extern "C"
-{ /* } */
-#endif
-
-/**
- * \brief Get a hash key.
- * \param k the key
- * \param length the length of the key
- * \param level the previous hash, or an arbitrary value
- * \return hash
- * \note Adapted from Jens Jakobsen implementation (chillispot).
- */
-static uint32_t lookuphash (unsigned char* k, uint32_t length, uint32_t level)
-{
-  NS_LOG_FUNCTION (k << length << level);
-#define mix(a, b, c) \
-  ({ \
-     (a) -= (b); (a) -= (c); (a) ^= ((c) >> 13); \
-     (b) -= (c); (b) -= (a); (b) ^= ((a) << 8);  \
-     (c) -= (a); (c) -= (b); (c) ^= ((b) >> 13); \
-     (a) -= (b); (a) -= (c); (a) ^= ((c) >> 12); \
-     (b) -= (c); (b) -= (a); (b) ^= ((a) << 16); \
-     (c) -= (a); (c) -= (b); (c) ^= ((b) >> 5);  \
-     (a) -= (b); (a) -= (c); (a) ^= ((c) >> 3);  \
-     (b) -= (c); (b) -= (a); (b) ^= ((a) << 10); \
-     (c) -= (a); (c) -= (b); (c) ^= ((b) >> 15); \
-   })
-
-  typedef uint32_t  ub4;   /* unsigned 4-byte quantities */
-  uint32_t a = 0;
-  uint32_t b = 0;
-  uint32_t c = 0;
-  uint32_t len = 0;
-
-  /* Set up the internal state */
-  len = length;
-  a = b = 0x9e3779b9;  /* the golden ratio; an arbitrary value */
-  c = level;           /* the previous hash value */
-
-  /* handle most of the key */
-  while (len >= 12)
-    {
-      a += (k[0] + ((ub4)k[1] << 8) + ((ub4)k[2] << 16) + ((ub4)k[3] << 24));
-      b += (k[4] + ((ub4)k[5] << 8) + ((ub4)k[6] << 16) + ((ub4)k[7] << 24));
-      c += (k[8] + ((ub4)k[9] << 8) + ((ub4)k[10] << 16) + ((ub4)k[11] << 24));
-      mix (a, b, c);
-      k += 12; 
-      len -= 12;
-    }
-
-  /* handle the last 11 bytes */
-  c += length;
-  switch (len) /* all the case statements fall through */
-    {
-    case 11: c += ((ub4)k[10] << 24);
-    case 10: c += ((ub4)k[9] << 16);
-    case 9: c += ((ub4)k[8] << 8);  /* the first byte of c is reserved for the length */
-    case 8: b += ((ub4)k[7] << 24);
-    case 7: b += ((ub4)k[6] << 16);
-    case 6: b += ((ub4)k[5] << 8);
-    case 5: b += k[4];
-    case 4: a += ((ub4)k[3] << 24);
-    case 3: a += ((ub4)k[2] << 16);
-    case 2: a += ((ub4)k[1] << 8);
-    case 1: a += k[0];
-      /* case 0: nothing left to add */
-    }
-  mix (a, b, c);
-
-#undef mix
-
-  /* report the result */
-  return c;
-}
-
-#ifdef __cplusplus
-}
-#endif
-
 /**
  * \brief Convert an IPv6 C-string into a 128-bit representation.
  *
@@ -595,8 +515,7 @@ void Ipv6Address::Print (std::ostream& os) const
 bool Ipv6Address::IsLocalhost () const
 {
   NS_LOG_FUNCTION (this);
-  static Ipv6Address localhost ("::1");
-  return (*this == localhost);
+  return GetWord (0) == 0 && GetWord (1) == 1;
 }
 
 bool Ipv6Address::IsMulticast () const
@@ -671,15 +590,13 @@ bool Ipv6Address::IsSolicitedMulticast () const
 bool Ipv6Address::IsAllNodesMulticast () const
 {
   NS_LOG_FUNCTION (this);
-  static Ipv6Address allnodes ("ff02::1");
-  return (*this == allnodes);
+  return GetWord (0) == 0xff02000000000000ULL && GetWord (1) == 1;
 }
 
 bool Ipv6Address::IsAllRoutersMulticast () const
 {
   NS_LOG_FUNCTION (this);
-  static Ipv6Address allrouters ("ff02::2");
-  return (*this == allrouters);
+  return GetWord (0) == 0xff02000000000000ULL && GetWord (1) == 2;
 }
 
 bool Ipv6Address::IsAllHostsMulticast () const
@@ -692,8 +609,7 @@ bool Ipv6Address::IsAllHostsMulticast () const
 bool Ipv6Address::IsAny () const
 {
   NS_LOG_FUNCTION (this);
-  static Ipv6Address any ("::");
-  return (*this == any);
+  return GetWord (0) == 0 && GetWord (1) == 0;
 }
 
 
@@ -802,22 +718,14 @@ void Ipv6Address::GetBytes (uint8_t buf[16]) const
 bool Ipv6Address::IsLinkLocal () const
 {
   NS_LOG_FUNCTION (this);
-  Ipv6Address linkLocal ("fe80::0");
-  if (!IsMulticast () && ((Ipv6Address*)this)->CombinePrefix (Ipv6Prefix (64)) == linkLocal)
-    {
-      return true;
-    }
-  return false;
+  // fe80::/64
+  return GetWord (0) == 0xfe80000000000000ULL;
 }
 
 bool Ipv6Address::IsEqual (const Ipv6Address& other) const
 {
   NS_LOG_FUNCTION (this << other);
-  if (!memcmp (m_address, other.m_address, 16))
-    {
-      return true;
-    }
-  return false;
+  return *this == other;
 }
 
 std::ostream& operator << (std::ostream& os, Ipv6Address const& address)
@@ -1003,11 +911,12 @@ std::istream& operator >> (std::istream& is, Ipv6Prefix& prefix)
 
 size_t Ipv6AddressHash::operator () (Ipv6Address const &x) const
 {
-  uint8_t buf[16];
-
-  x.GetBytes (buf);
-
-  return lookuphash (buf, sizeof (buf), 0);
+  // mix the two halves, then fold the high bits into the low ones
+  uint64_t h = x.GetWord (0) ^ (x.GetWord (1) * 0x9e3779b97f4a7c15ULL);
+  h ^= h >> 32;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 29;
+  return static_cast<size_t> (h);
 }
 
 ATTRIBUTE_HELPER_CPP (Ipv6Address);
@@ -346,6 +346,24 @@ private:
    */
   static uint8_t GetType (void);
 
+  /**
+   * \brief Get one of the two 64-bit halves of the address.
+   *
+   * The comparisons work on the halves rather than on the sixteen bytes;
+   * as the halves are read in network order, they sort like the bytes.
+   *
+   * \param i the index of the half, 0 for the most significant one
+   * \return the half of the address, in host order
+   */
+  uint64_t GetWord (uint8_t i) const
+  {
+    const uint8_t *p = m_address + 8 * i;
+    return (static_cast<uint64_t> (p[0]) << 56) | (static_cast<uint64_t> (p[1]) << 48)
+           | (static_cast<uint64_t> (p[2]) << 40) | (static_cast<uint64_t> (p[3]) << 32)
+           | (static_cast<uint64_t> (p[4]) << 24) | (static_cast<uint64_t> (p[5]) << 16)
+           | (static_cast<uint64_t> (p[6]) << 8) | static_cast<uint64_t> (p[7]);
+  }
+
   /**
    * \brief The address representation on 128 bits (16 bytes).
    */
@@ -377,6 +395,8 @@ private:
    * \returns true if the first operand is less than the second
    */
   friend bool operator < (Ipv6Address const &a, Ipv6Address const &b);
+
+  friend class Ipv6AddressHash;
 };
 
 /**
@@ -549,17 +569,19 @@ std::istream & operator >> (std::istream &is, Ipv6Prefix &prefix);
 
 inline bool operator == (const Ipv6Address& a, const Ipv6Address& b)
 {
-  return (!std::memcmp (a.m_address, b.m_address, 16));
+  return a.GetWord (0) == b.GetWord (0) && a.GetWord (1) == b.GetWord (1);
 }
 
 inline bool operator != (const Ipv6Address& a, const Ipv6Address& b)
 {
-  return std::memcmp (a.m_address, b.m_address, 16);
+  return !(a == b);
 }
 
 inline bool operator < (const Ipv6Address& a, const Ipv6Address& b)
 {
-  return (std::memcmp (a.m_address, b.m_address, 16) < 0);
+  uint64_t a0 = a.GetWord (0);
+  uint64_t b0 = b.GetWord (0);
+  return a0 < b0 || (a0 == b0 && a.GetWord (1) < b.GetWord (1));
 }
 
 inline bool operator == (const Ipv6Prefix& a, const Ipv6Prefix& b)
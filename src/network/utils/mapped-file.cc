@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include "ns3/core-config.h"
+#include "ns3/log.h"
+#include "mapped-file.h"
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif /* HAVE_SYS_MMAN_H */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MappedFile");
+
+MappedFile::MappedFile ()
+  : m_data (0),
+    m_size (0),
+    m_mapped (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MappedFile::~MappedFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+MappedFile::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+
+#ifdef HAVE_SYS_MMAN_H
+  int fd = open (filename.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_LOG_LOGIC ("Unable to open " << filename);
+      return false;
+    }
+  struct stat st;
+  if (fstat (fd, &st) == 0 && st.st_size > 0)
+    {
+      void *p = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p != MAP_FAILED)
+        {
+          // Traces are read front to back.
+          madvise (p, st.st_size, MADV_SEQUENTIAL);
+          m_data = static_cast<uint8_t const *> (p);
+          m_size = st.st_size;
+          m_mapped = true;
+        }
+    }
+  close (fd);
+#endif /* HAVE_SYS_MMAN_H */
+
+  if (!m_mapped)
+    {
+      std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+      if (!file.good ())
+        {
+          NS_LOG_LOGIC ("Unable to open " << filename);
+          return false;
+        }
+      file.seekg (0, std::ios::end);
+      m_copy.resize (file.tellg ());
+      file.seekg (0, std::ios::beg);
+      if (!m_copy.empty ())
+        {
+          file.read (reinterpret_cast<char *> (&m_copy[0]), m_copy.size ());
+          m_data = &m_copy[0];
+        }
+      m_size = m_copy.size ();
+    }
+  return true;
+}
+
+void
+MappedFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_SYS_MMAN_H
+  if (m_mapped)
+    {
+      munmap (const_cast<uint8_t *> (m_data), m_size);
+    }
+#endif /* HAVE_SYS_MMAN_H */
+  m_mapped = false;
+  m_copy.clear ();
+  m_data = 0;
+  m_size = 0;
+}
+
+uint8_t const *
+MappedFile::GetData (void) const
+{
+  return m_data;
+}
+
+uint64_t
+MappedFile::GetSize (void) const
+{
+  return m_size;
+}
+
+} // namespace ns3
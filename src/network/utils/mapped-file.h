@@ -0,0 +1,84 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief The content of a file, mapped read-only in memory.
+ *
+ * This is the storage of the memory-mapped trace readers (see
+ * MappedPcapFile and PacketTraceFile).  On systems without mmap, the
+ * file is read in memory at once; the interface is the same.
+ */
+class MappedFile
+{
+public:
+  MappedFile ();
+  ~MappedFile ();
+
+  /**
+   * \brief Map a file in memory.
+   *
+   * \param filename the name of the file
+   * \return false if the file could not be opened
+   */
+  bool Open (std::string const &filename);
+
+  /**
+   * \brief Unmap the file.  The pointers returned by GetData () are not
+   * valid anymore.
+   */
+  void Close (void);
+
+  /**
+   * \return the content of the file, or 0 if it is not open or empty
+   */
+  uint8_t const *GetData (void) const;
+
+  /**
+   * \return the size of the file, in bytes
+   */
+  uint64_t GetSize (void) const;
+
+private:
+  /**
+   * \brief Copy constructor, unimplemented: the mapping is not shared.
+   */
+  MappedFile (MappedFile const &);
+  /**
+   * \brief Assignment operator, unimplemented: the mapping is not shared.
+   * \returns the object
+   */
+  MappedFile &operator = (MappedFile const &);
+
+  uint8_t const *m_data;        //!< the content of the file
+  uint64_t m_size;              //!< the size of the file, in bytes
+  bool m_mapped;                //!< m_data was obtained by mmap
+  std::vector<uint8_t> m_copy;  //!< the content of the file, if not mapped
+};
+
+} // namespace ns3
+
+#endif /* MAPPED_FILE_H */
@@ -0,0 +1,308 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "mapped-pcap-file.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MappedPcapFile");
+
+static const uint32_t MAGIC = 0xa1b2c3d4;            /**< Magic number identifying standard pcap file format */
+static const uint32_t SWAPPED_MAGIC = 0xd4c3b2a1;    /**< Looks this way if byte swapping is required */
+
+static const uint32_t NS_MAGIC = 0xa1b23cd4;         /**< Magic number identifying nanosec resolution pcap file format */
+static const uint32_t NS_SWAPPED_MAGIC = 0xd43cb2a1; /**< Looks this way if byte swapping is required */
+
+static const uint16_t VERSION_MAJOR = 2;             /**< Major version of supported pcap file format */
+static const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pcap file format */
+
+static const uint32_t FILE_HEADER_SIZE = 24;         /**< Size of the pcap file header */
+static const uint32_t RECORD_HEADER_SIZE = 16;       /**< Size of a pcap record header */
+
+MappedPcapFile::MappedPcapFile ()
+  : m_data (0),
+    m_size (0),
+    m_offset (0),
+    m_fail (false),
+    m_eof (false),
+    m_swapMode (false),
+    m_magicNumber (0),
+    m_versionMajor (0),
+    m_versionMinor (0),
+    m_zone (0),
+    m_sigFigs (0),
+    m_snapLen (0),
+    m_type (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MappedPcapFile::~MappedPcapFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+MappedPcapFile::Fail (void) const
+{
+  return m_fail;
+}
+
+bool
+MappedPcapFile::Eof (void) const
+{
+  return m_eof;
+}
+
+void
+MappedPcapFile::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+  m_fail = false;
+  m_eof = false;
+
+  if (!m_file.Open (filename))
+    {
+      m_fail = true;
+      return;
+    }
+  m_data = m_file.GetData ();
+  m_size = m_file.GetSize ();
+
+  ReadAndVerifyFileHeader ();
+  if (m_fail)
+    {
+      Close ();
+    }
+}
+
+void
+MappedPcapFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_file.Close ();
+  m_data = 0;
+  m_size = 0;
+  m_offset = 0;
+}
+
+void
+MappedPcapFile::Rewind (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_data != 0)
+    {
+      m_offset = FILE_HEADER_SIZE;
+      m_eof = false;
+    }
+}
+
+uint64_t
+MappedPcapFile::GetOffset (void) const
+{
+  return m_offset;
+}
+
+void
+MappedPcapFile::Seek (uint64_t offset)
+{
+  NS_LOG_FUNCTION (this << offset);
+  if (m_data != 0)
+    {
+      NS_ASSERT (offset >= FILE_HEADER_SIZE && offset <= m_size);
+      m_offset = offset;
+      m_eof = false;
+    }
+}
+
+uint32_t
+MappedPcapFile::Read32 (uint64_t offset) const
+{
+  uint32_t val;
+  //
+  // Records are not aligned in the file, so copy the bytes out rather than
+  // dereferencing a uint32_t pointer.
+  //
+  std::memcpy (&val, m_data + offset, sizeof (val));
+  if (m_swapMode)
+    {
+      val = ((val >> 24) & 0x000000ff) | ((val >> 8) & 0x0000ff00)
+        | ((val << 8) & 0x00ff0000) | ((val << 24) & 0xff000000);
+    }
+  return val;
+}
+
+uint16_t
+MappedPcapFile::Read16 (uint64_t offset) const
+{
+  uint16_t val;
+  std::memcpy (&val, m_data + offset, sizeof (val));
+  if (m_swapMode)
+    {
+      val = ((val >> 8) & 0x00ff) | ((val << 8) & 0xff00);
+    }
+  return val;
+}
+
+void
+MappedPcapFile::ReadAndVerifyFileHeader (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_size < FILE_HEADER_SIZE)
+    {
+      m_fail = true;
+      return;
+    }
+
+  std::memcpy (&m_magicNumber, m_data, sizeof (m_magicNumber));
+  if (m_magicNumber != MAGIC && m_magicNumber != SWAPPED_MAGIC
+      && m_magicNumber != NS_MAGIC && m_magicNumber != NS_SWAPPED_MAGIC)
+    {
+      m_fail = true;
+      return;
+    }
+
+  //
+  // If the magic number is swapped, then we can assume that everything else we read
+  // is swapped.
+  //
+  m_swapMode = m_magicNumber == SWAPPED_MAGIC || m_magicNumber == NS_SWAPPED_MAGIC;
+
+  m_magicNumber = Read32 (0);
+  m_versionMajor = Read16 (4);
+  m_versionMinor = Read16 (6);
+  m_zone = static_cast<int32_t> (Read32 (8));
+  m_sigFigs = Read32 (12);
+  m_snapLen = Read32 (16);
+  m_type = Read32 (20);
+
+  //
+  // Same sanity checks as PcapFile.
+  //
+  if (m_versionMajor != VERSION_MAJOR || m_versionMinor != VERSION_MINOR
+      || m_zone < -12 || m_zone > 12)
+    {
+      m_fail = true;
+      return;
+    }
+
+  m_offset = FILE_HEADER_SIZE;
+}
+
+bool
+MappedPcapFile::Read (uint32_t &tsSec,
+                      uint32_t &tsUsec,
+                      uint32_t &inclLen,
+                      uint32_t &origLen,
+                      uint8_t const * &data)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_data == 0 || m_eof)
+    {
+      m_eof = true;
+      return false;
+    }
+  if (m_offset == m_size)
+    {
+      m_eof = true;
+      return false;
+    }
+  if (m_size - m_offset < RECORD_HEADER_SIZE)
+    {
+      NS_LOG_LOGIC ("Truncated record header at offset " << m_offset);
+      m_eof = true;
+      m_fail = true;
+      return false;
+    }
+
+  uint32_t len = Read32 (m_offset + 8);
+  if (m_size - m_offset - RECORD_HEADER_SIZE < len)
+    {
+      NS_LOG_LOGIC ("Truncated record data at offset " << m_offset);
+      m_eof = true;
+      m_fail = true;
+      return false;
+    }
+
+  tsSec = Read32 (m_offset);
+  tsUsec = Read32 (m_offset + 4);
+  inclLen = len;
+  origLen = Read32 (m_offset + 12);
+  data = m_data + m_offset + RECORD_HEADER_SIZE;
+  m_offset += RECORD_HEADER_SIZE + len;
+  return true;
+}
+
+bool
+MappedPcapFile::GetSwapMode (void) const
+{
+  return m_swapMode;
+}
+
+bool
+MappedPcapFile::IsNanoSecondMode (void) const
+{
+  return m_magicNumber == NS_MAGIC;
+}
+
+uint32_t
+MappedPcapFile::GetMagic (void) const
+{
+  return m_magicNumber;
+}
+
+uint16_t
+MappedPcapFile::GetVersionMajor (void) const
+{
+  return m_versionMajor;
+}
+
+uint16_t
+MappedPcapFile::GetVersionMinor (void) const
+{
+  return m_versionMinor;
+}
+
+int32_t
+MappedPcapFile::GetTimeZoneOffset (void) const
+{
+  return m_zone;
+}
+
+uint32_t
+MappedPcapFile::GetSigFigs (void) const
+{
+  return m_sigFigs;
+}
+
+uint32_t
+MappedPcapFile::GetSnapLen (void) const
+{
+  return m_snapLen;
+}
+
+uint32_t
+MappedPcapFile::GetDataLinkType (void) const
+{
+  return m_type;
+}
+
+} // namespace ns3
@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MAPPED_PCAP_FILE_H
+#define MAPPED_PCAP_FILE_H
+
+#include <string>
+#include <stdint.h>
+#include "mapped-file.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief A read-only pcap file, mapped in memory.
+ *
+ * PcapFile::Read copies every record through an std::fstream into a
+ * buffer provided by the caller.  This class maps the whole file in
+ * memory instead and Read () returns pointers into the mapping, so
+ * that iterating over a large capture does not copy any packet data.
+ * The pointers remain valid until the file is closed.
+ *
+ * The same pcap formats as PcapFile are accepted: version 2.4, in both
+ * byte orders, with microsecond or nanosecond timestamps.
+ *
+ * On systems without mmap, the file is read in memory at once; the
+ * interface is the same.
+ */
+class MappedPcapFile
+{
+public:
+  MappedPcapFile ();
+  ~MappedPcapFile ();
+
+  /**
+   * \return true if the file could not be opened, has an invalid header
+   * or ends in the middle of a record.
+   */
+  bool Fail (void) const;
+  /**
+   * \return true if every record of the file has been read.
+   */
+  bool Eof (void) const;
+
+  /**
+   * \brief Map a pcap file in memory and check its file header.
+   *
+   * On success, the next call to Read () returns the first record of the
+   * file.  Check Fail () to find out whether this method succeeded.
+   *
+   * \param filename the name of the file
+   */
+  void Open (std::string const &filename);
+
+  /**
+   * \brief Unmap the file.  The data pointers returned by Read () are
+   * not valid anymore.
+   */
+  void Close (void);
+
+  /**
+   * \brief Go back to the first record of the file.
+   */
+  void Rewind (void);
+
+  /**
+   * \return the offset in the file of the record the next call to Read ()
+   * returns, to come back to it later with Seek ()
+   */
+  uint64_t GetOffset (void) const;
+
+  /**
+   * \brief Go to a record of the file
+   * \param offset the offset of the record, as returned by GetOffset ()
+   */
+  void Seek (uint64_t offset);
+
+  /**
+   * \brief Read the next record of the file, without copying its data.
+   *
+   * \param tsSec [out] the seconds part of the timestamp
+   * \param tsUsec [out] the sub-second part of the timestamp, in
+   *        microseconds (or nanoseconds, see IsNanoSecondMode)
+   * \param inclLen [out] the number of bytes of the packet saved in the file
+   * \param origLen [out] the original length of the packet
+   * \param data [out] the inclLen bytes of the packet
+   * \return false if there are no more records (or the file is truncated)
+   */
+  bool Read (uint32_t &tsSec,
+             uint32_t &tsUsec,
+             uint32_t &inclLen,
+             uint32_t &origLen,
+             uint8_t const * &data);
+
+  /**
+   * \return true if the records of the file have to be byte swapped
+   */
+  bool GetSwapMode (void) const;
+  /**
+   * \return true if the sub-second part of timestamps is in nanoseconds
+   */
+  bool IsNanoSecondMode (void) const;
+  /**
+   * \return the magic number of the file, in host byte order
+   */
+  uint32_t GetMagic (void) const;
+  /**
+   * \return the major version of the file
+   */
+  uint16_t GetVersionMajor (void) const;
+  /**
+   * \return the minor version of the file
+   */
+  uint16_t GetVersionMinor (void) const;
+  /**
+   * \return the time zone offset of the file
+   */
+  int32_t GetTimeZoneOffset (void) const;
+  /**
+   * \return the accuracy of the timestamps of the file
+   */
+  uint32_t GetSigFigs (void) const;
+  /**
+   * \return the maximum length of saved packets
+   */
+  uint32_t GetSnapLen (void) const;
+  /**
+   * \return the data link type of the file
+   */
+  uint32_t GetDataLinkType (void) const;
+
+private:
+  /**
+   * \brief Read a 32 bits value of the file, in host byte order
+   * \param offset the offset of the value in the file
+   * \return the value
+   */
+  uint32_t Read32 (uint64_t offset) const;
+  /**
+   * \brief Read a 16 bits value of the file, in host byte order
+   * \param offset the offset of the value in the file
+   * \return the value
+   */
+  uint16_t Read16 (uint64_t offset) const;
+  /**
+   * \brief Check the file header and fill the header fields.
+   */
+  void ReadAndVerifyFileHeader (void);
+
+  MappedFile m_file;            //!< the mapping of the file
+  uint8_t const *m_data;        //!< the content of the file
+  uint64_t m_size;              //!< the size of the file, in bytes
+  uint64_t m_offset;            //!< the offset of the next record
+  bool m_fail;                  //!< fail state
+  bool m_eof;                   //!< end of file state
+  bool m_swapMode;              //!< swap mode
+  uint32_t m_magicNumber;       //!< magic number, in host byte order
+  uint16_t m_versionMajor;      //!< major version
+  uint16_t m_versionMinor;      //!< minor version
+  int32_t m_zone;               //!< time zone offset
+  uint32_t m_sigFigs;           //!< accuracy of the timestamps
+  uint32_t m_snapLen;           //!< maximum length of saved packets
+  uint32_t m_type;              //!< data link type
+};
+
+} // namespace ns3
+
+#endif /* MAPPED_PCAP_FILE_H */
@@ -17,6 +17,7 @@
  */
 
 #include "output-stream-wrapper.h"
+#include "compressed-output-stream.h"
 #include "ns3/log.h"
 #include "ns3/fatal-impl.h"
 #include "ns3/abort.h"
@@ -38,6 +39,17 @@ OutputStreamWrapper::OutputStreamWrapper (std::string filename, std::ios::openmo
                        "Unable to Open " << filename << " for mode " << filemode);
 }
 
+OutputStreamWrapper::OutputStreamWrapper (std::string filename, std::ios::openmode filemode,
+                                          uint32_t compressionLevel)
+  : m_destroyable (true)
+{
+  NS_LOG_FUNCTION (this << filename << filemode << compressionLevel);
+  m_ostream = new CompressedOutputStream (filename, filemode, compressionLevel);
+  FatalImpl::RegisterStream (m_ostream);
+  NS_ABORT_MSG_UNLESS (m_ostream->good (), "AsciiTraceHelper::CreateFileStream():  " <<
+                       "Unable to Open " << filename << " for mode " << filemode);
+}
+
 OutputStreamWrapper::OutputStreamWrapper (std::ostream* os)
   : m_ostream (os), m_destroyable (false)
 {
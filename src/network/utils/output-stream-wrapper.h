@@ -20,6 +20,7 @@
 #define OUTPUT_STREAM_WRAPPER_H
 
 #include <fstream>
+#include <stdint.h>
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
@@ -76,6 +77,16 @@ public:
    * \param filemode std::ios::openmode flags
    */
   OutputStreamWrapper (std::string filename, std::ios::openmode filemode);
+  /**
+   * Constructor of a wrapper around a gzip-compressed file
+   * \param filename file name
+   * \param filemode std::ios::openmode flags
+   * \param compressionLevel the zlib compression level, from 1 (fastest)
+   *        to 9 (best); 0 stores the data in the gzip stream uncompressed
+   *
+   * \see CompressedOutputStream
+   */
+  OutputStreamWrapper (std::string filename, std::ios::openmode filemode, uint32_t compressionLevel);
   /**
    * Constructor
    * \param os output stream
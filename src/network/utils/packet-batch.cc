@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "packet-batch.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PacketBatch");
+
+NS_OBJECT_ENSURE_REGISTERED (PacketBatch);
+
+TypeId
+PacketBatch::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PacketBatch")
+    .SetParent<Object> ()
+    .SetGroupName ("Network")
+    .AddConstructor<PacketBatch> ()
+  ;
+  return tid;
+}
+
+PacketBatch::PacketBatch (void)
+  : m_size (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PacketBatch::~PacketBatch (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+PacketBatch::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+  Object::DoDispose ();
+}
+
+Ptr<PacketBatch>
+PacketBatch::Copy (void) const
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<PacketBatch> batch = CreateObject<PacketBatch> ();
+  for (uint32_t i = 0; i < m_packets.size (); ++i)
+    {
+      batch->AddPacket (m_packets[i]->Copy (), m_timestamps[i]);
+    }
+  return batch;
+}
+
+void
+PacketBatch::AddPacket (Ptr<Packet> packet)
+{
+  NS_LOG_FUNCTION (this << packet);
+  AddPacket (packet, Simulator::Now ());
+}
+
+void
+PacketBatch::AddPacket (Ptr<Packet> packet, Time timestamp)
+{
+  NS_LOG_FUNCTION (this << packet << timestamp);
+  if (packet)
+    {
+      m_packets.push_back (packet);
+      m_timestamps.push_back (timestamp);
+      m_size += packet->GetSize ();
+    }
+}
+
+Ptr<Packet>
+PacketBatch::GetPacket (uint32_t i) const
+{
+  NS_ASSERT_MSG (i < m_packets.size (), "PacketBatch::GetPacket(): index out of range");
+  return m_packets[i];
+}
+
+Time
+PacketBatch::GetTimestamp (uint32_t i) const
+{
+  NS_ASSERT_MSG (i < m_timestamps.size (), "PacketBatch::GetTimestamp(): index out of range");
+  return m_timestamps[i];
+}
+
+void
+PacketBatch::SetTimestamp (uint32_t i, Time timestamp)
+{
+  NS_LOG_FUNCTION (this << i << timestamp);
+  NS_ASSERT_MSG (i < m_timestamps.size (), "PacketBatch::SetTimestamp(): index out of range");
+  m_timestamps[i] = timestamp;
+}
+
+uint32_t
+PacketBatch::GetNPackets (void) const
+{
+  return m_packets.size ();
+}
+
+bool
+PacketBatch::IsEmpty (void) const
+{
+  return m_packets.empty ();
+}
+
+uint32_t
+PacketBatch::GetSize (void) const
+{
+  return m_size;
+}
+
+void
+PacketBatch::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_packets.clear ();
+  m_timestamps.clear ();
+  m_size = 0;
+}
+
+std::vector<Ptr<Packet> >::const_iterator
+PacketBatch::Begin (void) const
+{
+  return m_packets.begin ();
+}
+
+std::vector<Ptr<Packet> >::const_iterator
+PacketBatch::End (void) const
+{
+  return m_packets.end ();
+}
+
+} // namespace ns3
@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_BATCH_H
+#define PACKET_BATCH_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup network
+ *
+ * \brief A sequence of packets handed to a NetDevice as a single unit.
+ *
+ * A PacketBatch is modelled on PacketBurst, but it is meant to cross
+ * the NetDevice and Channel boundaries: devices that support batching
+ * (see NetDevice::SendBatch) serialize the packets of a batch back to
+ * back with a single transmit complete event instead of one per packet.
+ * The receiving devices still get one reception event per packet, when
+ * the last bit of that packet arrives.
+ *
+ * Each packet carries a timestamp, set by the sending device, from which
+ * the channel schedules the reception of the packet: the time at which
+ * its last bit leaves the device for the point-to-point and CSMA devices,
+ * and the time at which its transmission starts for SimpleNetDevice,
+ * which hands single packets to its channel at that time too.
+ */
+class PacketBatch : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  PacketBatch (void);
+  virtual ~PacketBatch (void);
+  /**
+   * \return a deep copy of the batch (packets are copied, timestamps kept)
+   */
+  Ptr<PacketBatch> Copy (void) const;
+  /**
+   * \brief append a packet to the batch, timestamped with the current
+   * simulation time
+   * \param packet the packet to add
+   */
+  void AddPacket (Ptr<Packet> packet);
+  /**
+   * \brief append a packet to the batch
+   * \param packet the packet to add
+   * \param timestamp the timestamp associated to the packet
+   */
+  void AddPacket (Ptr<Packet> packet, Time timestamp);
+  /**
+   * \param i the index of the packet
+   * \return the i-th packet of the batch
+   */
+  Ptr<Packet> GetPacket (uint32_t i) const;
+  /**
+   * \param i the index of the packet
+   * \return the timestamp of the i-th packet of the batch
+   */
+  Time GetTimestamp (uint32_t i) const;
+  /**
+   * \param i the index of the packet
+   * \param timestamp the new timestamp of the i-th packet of the batch
+   */
+  void SetTimestamp (uint32_t i, Time timestamp);
+  /**
+   * \return the number of packets in the batch
+   */
+  uint32_t GetNPackets (void) const;
+  /**
+   * \return true if the batch contains no packet
+   */
+  bool IsEmpty (void) const;
+  /**
+   * \return the size of the batch in byte (the size of all packets)
+   */
+  uint32_t GetSize (void) const;
+  /**
+   * \brief Remove all the packets from the batch.
+   */
+  void Clear (void);
+
+  /**
+   * \brief Returns an iterator to the begin of the batch
+   * \return iterator to the batch start
+   */
+  std::vector<Ptr<Packet> >::const_iterator Begin (void) const;
+  /**
+   * \brief Returns an iterator to the end of the batch
+   * \return iterator to the batch end
+   */
+  std::vector<Ptr<Packet> >::const_iterator End (void) const;
+
+  /**
+   * TracedCallback signature for Ptr<PacketBatch>
+   *
+   * \param [in] batch The PacketBatch
+   */
+  typedef void (* TracedCallback)(const Ptr<const PacketBatch> batch);
+
+private:
+  virtual void DoDispose (void);
+  std::vector<Ptr<Packet> > m_packets; //!< the packets in the batch
+  std::vector<Time> m_timestamps;      //!< the per-packet timestamps
+  uint32_t m_size;                     //!< the total size of the packets, in bytes
+};
+
+} // namespace ns3
+
+#endif /* PACKET_BATCH_H */
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "packet-ring.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PacketRing");
+
+PacketRing::PacketRing ()
+  : m_entries (0),
+    m_mask (0),
+    m_head (0),
+    m_packets (0),
+    m_bytes (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PacketRing::~PacketRing ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+  delete [] m_entries;
+}
+
+void
+PacketRing::Reserve (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  uint32_t capacity = 16;
+  while (capacity < n && capacity < MAX_RESERVE)
+    {
+      capacity *= 2;
+    }
+  if (m_entries == 0 || capacity > m_mask + 1)
+    {
+      Grow (capacity);
+    }
+}
+
+void
+PacketRing::Grow (uint32_t capacity)
+{
+  NS_LOG_FUNCTION (this << capacity);
+  NS_ASSERT ((capacity & (capacity - 1)) == 0 && capacity >= m_packets);
+  Entry *entries = new Entry[capacity];
+  for (uint32_t i = 0; i < m_packets; i++)
+    {
+      entries[i] = m_entries[(m_head + i) & m_mask];
+    }
+  delete [] m_entries;
+  m_entries = entries;
+  m_mask = capacity - 1;
+  m_head = 0;
+}
+
+void
+PacketRing::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_packets; i++)
+    {
+      m_entries[(m_head + i) & m_mask].packet->Unref ();
+    }
+  m_head = 0;
+  m_packets = 0;
+  m_bytes = 0;
+}
+
+uint32_t
+PacketRing::GetCapacity (void) const
+{
+  return m_entries == 0 ? 0 : m_mask + 1;
+}
+
+} // namespace ns3
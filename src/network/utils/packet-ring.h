@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_RING_H
+#define PACKET_RING_H
+
+#include <stdint.h>
+#include "ns3/packet.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup queue
+ *
+ * \brief A FIFO of packets stored in a ring buffer
+ *
+ * This is the packet storage of the Queue subclasses.  The ring is an
+ * array whose capacity is a power of two: it is allocated once (see
+ * Reserve) and only doubles when it is full, so that a queue in steady
+ * state enqueues and dequeues without allocating.  The ring holds one
+ * reference on each packet, taken on Push and handed over to the caller
+ * on Pop, and the size of each packet is recorded on Push so that the
+ * byte count stays exact whatever happens to the packet while queued.
+ */
+class PacketRing
+{
+public:
+  /// Largest number of packets allocated by Reserve
+  static const uint32_t MAX_RESERVE = 65536;
+
+  PacketRing ();
+  ~PacketRing ();
+
+  /**
+   * \brief Make room for a number of packets
+   *
+   * Beyond MAX_RESERVE packets, the ring is left to grow when needed
+   * rather than allocated up front for a limit which may never be hit.
+   *
+   * \param n the number of packets the ring can hold without growing
+   */
+  void Reserve (uint32_t n);
+  /**
+   * \brief Append a packet
+   * \param p the packet
+   */
+  void Push (Ptr<Packet> p);
+  /**
+   * \brief Remove the first packet
+   * \return the packet, or 0 if the ring is empty
+   */
+  Ptr<Packet> Pop (void);
+  /**
+   * \return the first packet, or 0 if the ring is empty
+   */
+  Ptr<Packet> Front (void) const;
+  /**
+   * \brief Remove all the packets
+   */
+  void Clear (void);
+
+  /**
+   * \return true if the ring holds no packet
+   */
+  bool IsEmpty (void) const;
+  /**
+   * \return the number of packets in the ring
+   */
+  uint32_t GetNPackets (void) const;
+  /**
+   * \return the number of bytes in the ring, as they were when pushed
+   */
+  uint32_t GetNBytes (void) const;
+  /**
+   * \return the number of packets the ring can hold without growing
+   */
+  uint32_t GetCapacity (void) const;
+
+private:
+  /**
+   * \brief Copy constructor, disabled
+   * \param o the ring
+   */
+  PacketRing (const PacketRing &o);
+  /**
+   * \brief Assignment operator, disabled
+   * \param o the ring
+   * \return the ring
+   */
+  PacketRing &operator = (const PacketRing &o);
+
+  /**
+   * \brief Move the packets to an array of a given capacity
+   * \param capacity the new capacity, a power of two
+   */
+  void Grow (uint32_t capacity);
+
+  /// A packet in the ring
+  struct Entry
+  {
+    Packet *packet;  //!< the packet, with a reference held by the ring
+    uint32_t size;   //!< the size of the packet when pushed
+  };
+
+  Entry *m_entries;     //!< the ring
+  uint32_t m_mask;      //!< capacity - 1
+  uint32_t m_head;      //!< index of the first packet
+  uint32_t m_packets;   //!< number of packets
+  uint32_t m_bytes;     //!< number of bytes
+};
+
+} // namespace ns3
+
+/****************************************************
+ *      Implementation of the inline methods.
+ ***************************************************/
+
+namespace ns3 {
+
+inline void
+PacketRing::Push (Ptr<Packet> p)
+{
+  if (m_entries == 0 || m_packets > m_mask)
+    {
+      Grow (m_entries == 0 ? 16 : 2 * (m_mask + 1));
+    }
+  Entry &e = m_entries[(m_head + m_packets) & m_mask];
+  e.packet = PeekPointer (p);
+  e.packet->Ref ();
+  e.size = p->GetSize ();
+  m_packets++;
+  m_bytes += e.size;
+}
+
+inline Ptr<Packet>
+PacketRing::Pop (void)
+{
+  if (m_packets == 0)
+    {
+      return 0;
+    }
+  Entry &e = m_entries[m_head];
+  m_head = (m_head + 1) & m_mask;
+  m_packets--;
+  NS_ASSERT (m_bytes >= e.size);
+  m_bytes -= e.size;
+  // the reference of the ring goes to the caller
+  return Ptr<Packet> (e.packet, false);
+}
+
+inline Ptr<Packet>
+PacketRing::Front (void) const
+{
+  if (m_packets == 0)
+    {
+      return 0;
+    }
+  return m_entries[m_head].packet;
+}
+
+inline bool
+PacketRing::IsEmpty (void) const
+{
+  return m_packets == 0;
+}
+
+inline uint32_t
+PacketRing::GetNPackets (void) const
+{
+  return m_packets;
+}
+
+inline uint32_t
+PacketRing::GetNBytes (void) const
+{
+  return m_bytes;
+}
+
+} // namespace ns3
+
+#endif /* PACKET_RING_H */
@@ -0,0 +1,234 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "packet-trace-file.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PacketTraceFile");
+
+static const uint32_t MAGIC = 0x6e733374;            /**< Magic number identifying the format, "ns3t" */
+static const uint16_t VERSION_MAJOR = 1;             /**< Major version of the format */
+static const uint16_t VERSION_MINOR = 0;             /**< Minor version of the format */
+
+static const uint32_t FILE_HEADER_SIZE = 16;         /**< Size of the file header */
+static const uint32_t RECORD_SIZE = 32;              /**< Size of a record */
+
+namespace {
+
+/**
+ * \brief Read a big endian value
+ * \param p the first byte of the value
+ * \param n the size of the value, in bytes
+ * \return the value
+ */
+uint64_t
+ReadBigEndian (uint8_t const *p, uint32_t n)
+{
+  uint64_t v = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      v = (v << 8) | p[i];
+    }
+  return v;
+}
+
+/**
+ * \brief Write a big endian value
+ * \param p the first byte of the value
+ * \param n the size of the value, in bytes
+ * \param v the value
+ */
+void
+WriteBigEndian (uint8_t *p, uint32_t n, uint64_t v)
+{
+  for (uint32_t i = n; i > 0; i--)
+    {
+      p[i - 1] = v & 0xff;
+      v >>= 8;
+    }
+}
+
+} // anonymous namespace
+
+PacketTraceFile::PacketTraceFile ()
+  : m_offset (0),
+    m_fail (false),
+    m_eof (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PacketTraceFile::~PacketTraceFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+PacketTraceFile::Fail (void) const
+{
+  return m_fail;
+}
+
+bool
+PacketTraceFile::Eof (void) const
+{
+  return m_eof;
+}
+
+void
+PacketTraceFile::Open (std::string const &filename, std::ios::openmode mode)
+{
+  NS_LOG_FUNCTION (this << filename << mode);
+  Close ();
+  m_fail = false;
+  m_eof = false;
+
+  uint8_t header[FILE_HEADER_SIZE] = { 0 };
+  if (mode & std::ios::out)
+    {
+      m_out.open (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+      WriteBigEndian (header, 4, MAGIC);
+      WriteBigEndian (header + 4, 2, VERSION_MAJOR);
+      WriteBigEndian (header + 6, 2, VERSION_MINOR);
+      WriteBigEndian (header + 8, 4, RECORD_SIZE);
+      m_out.write (reinterpret_cast<char const *> (header), FILE_HEADER_SIZE);
+      m_fail = !m_out.good ();
+      return;
+    }
+
+  if (!m_file.Open (filename))
+    {
+      m_fail = true;
+      return;
+    }
+  uint8_t const *data = m_file.GetData ();
+  if (m_file.GetSize () < FILE_HEADER_SIZE
+      || ReadBigEndian (data, 4) != MAGIC
+      || ReadBigEndian (data + 4, 2) != VERSION_MAJOR
+      || ReadBigEndian (data + 8, 4) != RECORD_SIZE)
+    {
+      NS_LOG_LOGIC (filename << " is not a packet trace");
+      m_fail = true;
+      m_file.Close ();
+      return;
+    }
+  m_offset = FILE_HEADER_SIZE;
+}
+
+void
+PacketTraceFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_out.is_open ())
+    {
+      m_out.close ();
+      m_fail = m_fail || m_out.fail ();
+    }
+  m_file.Close ();
+  m_offset = 0;
+}
+
+void
+PacketTraceFile::Rewind (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file.GetData () != 0)
+    {
+      m_offset = FILE_HEADER_SIZE;
+      m_eof = false;
+    }
+}
+
+uint64_t
+PacketTraceFile::GetNRecords (void) const
+{
+  if (m_file.GetData () == 0)
+    {
+      return 0;
+    }
+  return (m_file.GetSize () - FILE_HEADER_SIZE) / RECORD_SIZE;
+}
+
+uint64_t
+PacketTraceFile::GetOffset (void) const
+{
+  return m_offset;
+}
+
+void
+PacketTraceFile::Seek (uint64_t offset)
+{
+  NS_LOG_FUNCTION (this << offset);
+  if (m_file.GetData () != 0)
+    {
+      NS_ASSERT (offset >= FILE_HEADER_SIZE && offset <= m_file.GetSize ());
+      m_offset = offset;
+      m_eof = false;
+    }
+}
+
+bool
+PacketTraceFile::Read (Record &record)
+{
+  NS_LOG_FUNCTION (this);
+  uint64_t size = m_file.GetSize ();
+  if (m_file.GetData () == 0 || m_eof || m_offset == size)
+    {
+      m_eof = true;
+      return false;
+    }
+  if (size - m_offset < RECORD_SIZE)
+    {
+      NS_LOG_LOGIC ("Truncated record at offset " << m_offset);
+      m_eof = true;
+      m_fail = true;
+      return false;
+    }
+
+  uint8_t const *p = m_file.GetData () + m_offset;
+  record.timestamp = ReadBigEndian (p, 8);
+  record.size = ReadBigEndian (p + 8, 4);
+  record.source = ReadBigEndian (p + 12, 4);
+  record.destination = ReadBigEndian (p + 16, 4);
+  record.sourcePort = ReadBigEndian (p + 20, 2);
+  record.destinationPort = ReadBigEndian (p + 22, 2);
+  record.protocol = p[24];
+  m_offset += RECORD_SIZE;
+  return true;
+}
+
+void
+PacketTraceFile::Write (Record const &record)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_out.is_open (), "PacketTraceFile::Write(): file not opened for writing");
+  uint8_t p[RECORD_SIZE] = { 0 };
+  WriteBigEndian (p, 8, record.timestamp);
+  WriteBigEndian (p + 8, 4, record.size);
+  WriteBigEndian (p + 12, 4, record.source);
+  WriteBigEndian (p + 16, 4, record.destination);
+  WriteBigEndian (p + 20, 2, record.sourcePort);
+  WriteBigEndian (p + 22, 2, record.destinationPort);
+  p[24] = record.protocol;
+  m_out.write (reinterpret_cast<char const *> (p), RECORD_SIZE);
+  m_fail = m_fail || !m_out.good ();
+}
+
+} // namespace ns3
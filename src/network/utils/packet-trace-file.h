@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_TRACE_FILE_H
+#define PACKET_TRACE_FILE_H
+
+#include <string>
+#include <fstream>
+#include <stdint.h>
+#include "mapped-file.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief A compact binary packet trace: one fixed-size record per
+ * packet, with its timestamp, size and 5-tuple.
+ *
+ * Traces of backbone links hold billions of packets of which only the
+ * headers matter; this format keeps 32 bytes per packet, without any
+ * packet data, so that they can be mapped in memory and replayed (see
+ * TraceReplayApplication).  The file starts with a 16 bytes header:
+ *
+ * - the magic number 0x6e733374 ("ns3t"),
+ * - the major (1) and minor (0) version numbers, 16 bits each,
+ * - the size of the records (32), and 32 reserved bits.
+ *
+ * Each record then holds, in this order, the timestamp of the packet in
+ * nanoseconds (64 bits), the size of its IP packet, its IPv4 source and
+ * destination addresses (32 bits each), its source and destination ports
+ * (16 bits each), its IP protocol number (8 bits) and 7 reserved bytes.
+ * All the values are in network byte order.
+ *
+ * Files are read through a mapping, like MappedPcapFile, and written
+ * through a buffered stream.
+ */
+class PacketTraceFile
+{
+public:
+  /// A packet of the trace
+  struct Record
+  {
+    uint64_t timestamp;         //!< the time of the packet, in nanoseconds
+    uint32_t size;              //!< the size of the IP packet
+    uint32_t source;            //!< the IPv4 source address
+    uint32_t destination;       //!< the IPv4 destination address
+    uint16_t sourcePort;        //!< the source port
+    uint16_t destinationPort;   //!< the destination port
+    uint8_t protocol;           //!< the IP protocol number
+  };
+
+  PacketTraceFile ();
+  ~PacketTraceFile ();
+
+  /**
+   * \return true if the file could not be opened, has an invalid header,
+   * ends in the middle of a record or could not be written.
+   */
+  bool Fail (void) const;
+  /**
+   * \return true if every record of the file has been read.
+   */
+  bool Eof (void) const;
+
+  /**
+   * \brief Open a trace file.
+   *
+   * In std::ios::in mode, the file is mapped in memory and its header is
+   * checked; in std::ios::out mode, the file is created and its header is
+   * written.  Check Fail () to find out whether this method succeeded.
+   *
+   * \param filename the name of the file
+   * \param mode std::ios::in or std::ios::out
+   */
+  void Open (std::string const &filename, std::ios::openmode mode);
+
+  /**
+   * \brief Close the file, writing out the buffered records if any.
+   */
+  void Close (void);
+
+  /**
+   * \brief Go back to the first record of the file.
+   */
+  void Rewind (void);
+
+  /**
+   * \return the number of records of the file opened for reading
+   */
+  uint64_t GetNRecords (void) const;
+
+  /**
+   * \return the offset in the file of the record the next call to Read ()
+   * returns, to come back to it later with Seek ()
+   */
+  uint64_t GetOffset (void) const;
+
+  /**
+   * \brief Go to a record of the file
+   * \param offset the offset of the record, as returned by GetOffset ()
+   */
+  void Seek (uint64_t offset);
+
+  /**
+   * \brief Read the next record of the file.
+   *
+   * \param record [out] the record
+   * \return false if there are no more records (or the file is truncated)
+   */
+  bool Read (Record &record);
+
+  /**
+   * \brief Append a record to the file opened for writing.
+   *
+   * \param record the record
+   */
+  void Write (Record const &record);
+
+private:
+  MappedFile m_file;            //!< the mapping of the file read
+  std::ofstream m_out;          //!< the file written
+  uint64_t m_offset;            //!< the offset of the next record
+  bool m_fail;                  //!< fail state
+  bool m_eof;                   //!< end of file state
+};
+
+} // namespace ns3
+
+#endif /* PACKET_TRACE_FILE_H */
@@ -18,6 +18,8 @@
 
 #include "ns3/log.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
 #include "pcap-file-wrapper.h"
@@ -40,12 +42,29 @@ PcapFileWrapper::GetTypeId (void)
                    UintegerValue (PcapFile::SNAPLEN_DEFAULT),
                    MakeUintegerAccessor (&PcapFileWrapper::m_snapLen),
                    MakeUintegerChecker<uint32_t> (0, PcapFile::SNAPLEN_DEFAULT))
+    .AddAttribute ("WriteBufferSize",
+                   "Size of the memory pages in which records are gathered "
+                   "before being written to the file (0 disables buffering)",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_writeBufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MaxWriteBuffers",
+                   "Maximum number of write buffer pages allocated at any time",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_maxWriteBuffers),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("AsyncWrite",
+                   "Whether the write buffer pages are written by a background thread",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_asyncWrite),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_pcapngInterface (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -61,6 +80,10 @@ bool
 PcapFileWrapper::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_pcapng != 0)
+    {
+      return m_pcapng->Fail ();
+    }
   return m_file.Fail ();
 }
 bool 
@@ -80,7 +103,16 @@ void
 PcapFileWrapper::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_flushEvent);
   m_file.Close ();
+  m_pcapng = 0;
+}
+
+void
+PcapFileWrapper::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_file.Flush ();
 }
 
 void
@@ -107,12 +139,28 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
     {
       m_file.Init (dataLinkType, m_snapLen, tzCorrection);
     } 
+
+  if (m_writeBufferSize > 0)
+    {
+      m_file.SetWriteBuffer (m_writeBufferSize, m_maxWriteBuffers, m_asyncWrite);
+      //
+      // Whoever holds this wrapper may outlive the simulation, so make sure
+      // the buffered records reach the file when the simulation ends.
+      //
+      Simulator::Cancel (m_flushEvent);
+      m_flushEvent = Simulator::ScheduleDestroy (&PcapFileWrapper::Flush, this);
+    }
 }
 
 void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
+  if (m_pcapng != 0)
+    {
+      m_pcapng->Write (m_pcapngInterface, t, p);
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -124,6 +172,11 @@ void
 PcapFileWrapper::Write (Time t, Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
+  if (m_pcapng != 0)
+    {
+      m_pcapng->Write (m_pcapngInterface, t, header, p);
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -135,6 +188,11 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
+  if (m_pcapng != 0)
+    {
+      m_pcapng->Write (m_pcapngInterface, t, buffer, length);
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -142,6 +200,14 @@ PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
   m_file.Write (s, us, buffer, length);
 }
 
+void
+PcapFileWrapper::Redirect (Ptr<PcapngFileWrapper> file, uint32_t interfaceId)
+{
+  NS_LOG_FUNCTION (this << file << interfaceId);
+  m_pcapng = file;
+  m_pcapngInterface = interfaceId;
+}
+
 uint32_t
 PcapFileWrapper::GetMagic (void)
 {
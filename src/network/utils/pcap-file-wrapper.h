@@ -26,7 +26,9 @@
 #include "ns3/packet.h"
 #include "ns3/object.h"
 #include "ns3/nstime.h"
+#include "ns3/event-id.h"
 #include "pcap-file.h"
+#include "pcapng-file-wrapper.h"
 
 namespace ns3 {
 
@@ -35,6 +37,16 @@ namespace ns3 {
  * ns-3 interface to the low-level public methods of PcapFile.  Users are
  * encouraged to use this object instead of class ns3::PcapFile in ns-3
  * public APIs.
+ *
+ * When the "WriteBufferSize" attribute is not zero, the records of a file
+ * initialized with Init () are gathered in memory pages of that size and
+ * written by a background thread (see PcapFile::SetWriteBuffer).  The
+ * buffered data is flushed when the file is closed and, at the latest,
+ * when Simulator::Destroy is called.
+ *
+ * A wrapper can also be redirected to an interface of a pcapng file with
+ * Redirect (), in which case the packets written to it end up in that
+ * pcapng file instead of in a pcap file of their own.
  */
 class PcapFileWrapper : public Object
 {
@@ -82,6 +94,11 @@ public:
    */
   void Close (void);
 
+  /**
+   * Write the buffered records, if any, to the underlying pcap file.
+   */
+  void Flush (void);
+
   /**
    * Initialize the pcap file associated with this wrapper.  This file must have
    * been previously opened with write permissions.
@@ -142,6 +159,17 @@ public:
    */
   void Write (Time t, uint8_t const *buffer, uint32_t length);
 
+  /**
+   * \brief Send the packets written to this wrapper to a pcapng file.
+   *
+   * The wrapper does not need to be opened nor initialized in that case.
+   *
+   * \param file the pcapng file
+   * \param interfaceId the interface of the pcapng file to write to, as
+   *        returned by PcapngFileWrapper::AddInterface ()
+   */
+  void Redirect (Ptr<PcapngFileWrapper> file, uint32_t interfaceId);
+
   /**
    * \brief Returns the magic number of the pcap file as defined by the magic_number
    * field in the pcap global header.
@@ -215,6 +243,12 @@ public:
 private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
+  uint32_t m_writeBufferSize; //!< size of a write buffer page, 0 if unbuffered
+  uint32_t m_maxWriteBuffers; //!< max number of write buffer pages
+  bool m_asyncWrite; //!< write buffer pages from a background thread
+  EventId m_flushEvent; //!< flush at Simulator::Destroy
+  Ptr<PcapngFileWrapper> m_pcapng; //!< pcapng file to redirect packets to, if any
+  uint32_t m_pcapngInterface; //!< interface of the pcapng file
 };
 
 } // namespace ns3
@@ -19,6 +19,7 @@
  */
 
 #include <iostream>
+#include <algorithm>
 #include <cstring>
 #include "ns3/assert.h"
 #include "ns3/packet.h"
@@ -27,6 +28,8 @@
 #include "ns3/header.h"
 #include "ns3/buffer.h"
 #include "pcap-file.h"
+#include "buffered-stream-writer.h"
+#include "mapped-pcap-file.h"
 #include "ns3/log.h"
 //
 // This file is used as part of the ns-3 test framework, so please refrain from 
@@ -48,7 +51,8 @@ const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pc
 
 PcapFile::PcapFile ()
   : m_file (),
-    m_swapMode (false)
+    m_swapMode (false),
+    m_writer (0)
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file);
@@ -66,6 +70,10 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer != 0)
+    {
+      return m_writer->Fail ();
+    }
   return m_file.fail ();
 }
 bool 
@@ -86,9 +94,46 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  delete m_writer;
+  m_writer = 0;
   m_file.close ();
 }
 
+void
+PcapFile::SetWriteBuffer (uint32_t pageSize, uint32_t maxPages, bool async)
+{
+  NS_LOG_FUNCTION (this << pageSize << maxPages << async);
+  delete m_writer;
+  m_writer = new BufferedStreamWriter (&m_file, pageSize, maxPages, async);
+}
+
+void
+PcapFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_writer != 0)
+    {
+      m_writer->Flush ();
+    }
+  else
+    {
+      m_file.flush ();
+    }
+}
+
+void
+PcapFile::WriteBytes (const void *data, uint32_t size)
+{
+  if (m_writer != 0)
+    {
+      m_writer->Write (data, size);
+    }
+  else
+    {
+      m_file.write (static_cast<const char *> (data), size);
+    }
+}
+
 uint32_t
 PcapFile::GetMagic (void)
 {
@@ -195,8 +240,13 @@ PcapFile::WriteFileHeader (void)
   NS_LOG_FUNCTION (this);
   //
   // If we're initializing the file, we need to write the pcap file header
-  // at the start of the file.
+  // at the start of the file.  Pending buffered data must reach the file
+  // before we move its write position.
   //
+  if (m_writer != 0)
+    {
+      m_writer->Flush ();
+    }
   m_file.seekp (0, std::ios::beg);
  
   //
@@ -225,13 +275,13 @@ PcapFile::WriteFileHeader (void)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-  m_file.write ((const char *)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-  m_file.write ((const char *)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-  m_file.write ((const char *)&headerOut->m_zone, sizeof(headerOut->m_zone));
-  m_file.write ((const char *)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-  m_file.write ((const char *)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-  m_file.write ((const char *)&headerOut->m_type, sizeof(headerOut->m_type));
+  WriteBytes (&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
+  WriteBytes (&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
+  WriteBytes (&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
+  WriteBytes (&headerOut->m_zone, sizeof(headerOut->m_zone));
+  WriteBytes (&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
+  WriteBytes (&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
+  WriteBytes (&headerOut->m_type, sizeof(headerOut->m_type));
 }
 
 void
@@ -374,7 +424,7 @@ uint32_t
 PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << totalLen);
-  NS_ASSERT (m_file.good ());
+  NS_ASSERT (!Fail ());
 
   uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
@@ -393,10 +443,10 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
-  m_file.write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
-  m_file.write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
-  m_file.write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
+  WriteBytes (&header.m_tsSec, sizeof(header.m_tsSec));
+  WriteBytes (&header.m_tsUsec, sizeof(header.m_tsUsec));
+  WriteBytes (&header.m_inclLen, sizeof(header.m_inclLen));
+  WriteBytes (&header.m_origLen, sizeof(header.m_origLen));
   return inclLen;
 }
 
@@ -405,7 +455,7 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, ui
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
-  m_file.write ((const char *)data, inclLen);
+  WriteBytes (data, inclLen);
 }
 
 void 
@@ -413,6 +463,16 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
+  if (m_writer != 0)
+    {
+      if (inclLen > 0)
+        {
+          m_scratch.resize (std::max<size_t> (m_scratch.size (), inclLen));
+          p->CopyData (&m_scratch[0], inclLen);
+          m_writer->Write (&m_scratch[0], inclLen);
+        }
+      return;
+    }
   p->CopyData (&m_file, inclLen);
 }
 
@@ -428,6 +488,17 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Header &header, Ptr<const Pack
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
+  if (m_writer != 0)
+    {
+      if (inclLen > 0)
+        {
+          m_scratch.resize (std::max<size_t> (m_scratch.size (), inclLen));
+          headerBuffer.CopyData (&m_scratch[0], toCopy);
+          p->CopyData (&m_scratch[0] + toCopy, inclLen - toCopy);
+          m_writer->Write (&m_scratch[0], inclLen);
+        }
+      return;
+    }
   headerBuffer.CopyData (&m_file, toCopy);
   inclLen -= toCopy;
   p->CopyData (&m_file, inclLen);
@@ -498,17 +569,21 @@ PcapFile::Diff (std::string const & f1, std::string const & f2,
                 uint32_t snapLen)
 {
   NS_LOG_FUNCTION (f1 << f2 << sec << usec << snapLen);
-  PcapFile pcap1, pcap2;
-  pcap1.Open (f1, std::ios::in);
-  pcap2.Open (f2, std::ios::in);
+  //
+  // Test suites diff every pcap file they produce, so walk both files in
+  // place rather than copying each record out of an fstream.
+  //
+  MappedPcapFile pcap1, pcap2;
+  pcap1.Open (f1);
+  pcap2.Open (f2);
   bool bad = pcap1.Fail () || pcap2.Fail ();
   if (bad)
     {
       return true;
     }
 
-  uint8_t *data1 = new uint8_t [snapLen] ();
-  uint8_t *data2 = new uint8_t [snapLen] ();
+  uint8_t const *data1 = 0;
+  uint8_t const *data2 = 0;
   uint32_t tsSec1 = 0;
   uint32_t tsSec2 = 0;
   uint32_t tsUsec1 = 0;
@@ -517,22 +592,19 @@ PcapFile::Diff (std::string const & f1, std::string const & f2,
   uint32_t inclLen2 = 0;
   uint32_t origLen1 = 0;
   uint32_t origLen2 = 0;
-  uint32_t readLen1 = 0;
-  uint32_t readLen2 = 0;
   bool diff = false;
 
-  while (!pcap1.Eof () && !pcap2.Eof ())
+  while (true)
     {
-      pcap1.Read (data1, snapLen, tsSec1, tsUsec1, inclLen1, origLen1, readLen1);
-      pcap2.Read (data2, snapLen, tsSec2, tsUsec2, inclLen2, origLen2, readLen2);
+      bool more1 = pcap1.Read (tsSec1, tsUsec1, inclLen1, origLen1, data1);
+      bool more2 = pcap2.Read (tsSec2, tsUsec2, inclLen2, origLen2, data2);
 
-      bool same = pcap1.Fail () == pcap2.Fail ();
-      if (!same)
+      if (more1 != more2)
         {
-          diff = true;
+          diff = true; // One file has more packets than the other
           break;
         }
-      if (pcap1.Eof ())
+      if (!more1)
         {
           break;
         }
@@ -543,6 +615,8 @@ PcapFile::Diff (std::string const & f1, std::string const & f2,
           break;
         }
 
+      uint32_t readLen1 = std::min (snapLen, inclLen1);
+      uint32_t readLen2 = std::min (snapLen, inclLen2);
       if (readLen1 != readLen2)
         {
           diff = true; // Packet lengths do not match
@@ -558,16 +632,11 @@ PcapFile::Diff (std::string const & f1, std::string const & f2,
   sec = tsSec1;
   usec = tsUsec1;
 
-  bad = pcap1.Fail () || pcap2.Fail ();
-  bool eof = pcap1.Eof () && pcap2.Eof ();
-  if (bad && !eof)
+  if (pcap1.Fail () != pcap2.Fail ())
     {
-      diff = true;
+      diff = true; // One of the files is truncated
     }
 
-  delete[] data1;
-  delete[] data2;
-
   return diff;
 }
 
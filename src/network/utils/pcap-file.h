@@ -23,6 +23,7 @@
 
 #include <string>
 #include <fstream>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ptr.h"
 
@@ -30,6 +31,7 @@ namespace ns3 {
 
 class Packet;
 class Header;
+class BufferedStreamWriter;
 
 
 /**
@@ -81,10 +83,34 @@ public:
   void Open (std::string const &filename, std::ios::openmode mode);
 
   /**
-   * Close the underlying file.
+   * Close the underlying file.  Buffered data, if any, is written first.
    */
   void Close (void);
 
+  /**
+   * \brief Gather the records written to the file in large pages.
+   *
+   * By default, every record results in several small writes to the
+   * underlying file stream.  Once this method has been called, records
+   * are accumulated in pages of pageSize bytes which are written to the
+   * file as a whole, either directly or, if async is true, by a
+   * background thread.  At most maxPages pages are allocated at any
+   * time, so memory usage stays bounded if the disk cannot keep up.
+   *
+   * Buffering lasts until the file is closed.  Data still in memory is
+   * only guaranteed to be on disk after a call to Flush () or Close ().
+   *
+   * \param pageSize the size of a page, in bytes
+   * \param maxPages the maximum number of pages
+   * \param async whether the pages are written by a background thread
+   */
+  void SetWriteBuffer (uint32_t pageSize, uint32_t maxPages, bool async);
+
+  /**
+   * \brief Write the buffered records, if any, to the underlying file.
+   */
+  void Flush (void);
+
   /**
    * Initialize the pcap file associated with this object.  This file must have
    * been previously opened with write permissions.
@@ -349,10 +375,19 @@ private:
    */
   void ReadAndVerifyFileHeader (void);
 
+  /**
+   * \brief Write data to the file, through the write buffer if there is one.
+   * \param data the data to write
+   * \param size the number of bytes to write
+   */
+  void WriteBytes (const void *data, uint32_t size);
+
   std::string    m_filename;    //!< file name
   std::fstream   m_file;        //!< file stream
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
+  BufferedStreamWriter *m_writer;  //!< write buffer, if any
+  std::vector<uint8_t> m_scratch;  //!< packet bytes on their way to the write buffer
 };
 
 } // namespace ns3
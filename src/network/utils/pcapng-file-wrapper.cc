@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <limits>
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/header.h"
+#include "ns3/packet-metadata.h"
+#include "pcap-file.h"
+#include "pcapng-file-wrapper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapngFileWrapper");
+
+NS_OBJECT_ENSURE_REGISTERED (PcapngFileWrapper);
+
+TypeId
+PcapngFileWrapper::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PcapngFileWrapper")
+    .SetParent<Object> ()
+    .SetGroupName("Network")
+    .AddConstructor<PcapngFileWrapper> ()
+    .AddAttribute ("CaptureSize",
+                   "Maximum length of captured packets (cf. pcap snaplen)",
+                   UintegerValue (PcapFile::SNAPLEN_DEFAULT),
+                   MakeUintegerAccessor (&PcapngFileWrapper::m_snapLen),
+                   MakeUintegerChecker<uint32_t> (0, PcapFile::SNAPLEN_DEFAULT))
+    .AddAttribute ("HeaderOnly",
+                   "Only capture the headers of the packets, not their payload "
+                   "(requires packet metadata)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapngFileWrapper::m_headerOnly),
+                   MakeBooleanChecker ())
+    .AddAttribute ("WriteBufferSize",
+                   "Size of the memory pages in which blocks are gathered "
+                   "before being written to the file (0 disables buffering)",
+                   UintegerValue (1 << 20),
+                   MakeUintegerAccessor (&PcapngFileWrapper::m_writeBufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MaxWriteBuffers",
+                   "Maximum number of write buffer pages allocated at any time",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&PcapngFileWrapper::m_maxWriteBuffers),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("AsyncWrite",
+                   "Whether the write buffer pages are written by a background thread",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&PcapngFileWrapper::m_asyncWrite),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+
+PcapngFileWrapper::PcapngFileWrapper ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapngFileWrapper::~PcapngFileWrapper ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+PcapngFileWrapper::Fail (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_file.Fail ();
+}
+
+void
+PcapngFileWrapper::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_file.Open (filename);
+  //
+  // As in PcapFileWrapper, the pages only gather what follows the section
+  // header, once the file is known to be open.
+  //
+  if (m_writeBufferSize > 0 && !m_file.Fail ())
+    {
+      m_file.SetWriteBuffer (m_writeBufferSize, m_maxWriteBuffers, m_asyncWrite);
+      Simulator::Cancel (m_flushEvent);
+      m_flushEvent = Simulator::ScheduleDestroy (&PcapngFileWrapper::Flush, this);
+    }
+}
+
+void
+PcapngFileWrapper::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_flushEvent);
+  m_file.Close ();
+}
+
+void
+PcapngFileWrapper::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_file.Flush ();
+}
+
+uint32_t
+PcapngFileWrapper::AddInterface (uint32_t dataLinkType, std::string name, uint32_t snapLen)
+{
+  NS_LOG_FUNCTION (this << dataLinkType << name << snapLen);
+  return m_file.AddInterface (dataLinkType, std::min (snapLen, m_snapLen), name);
+}
+
+uint32_t
+PcapngFileWrapper::GetCaptureLength (Ptr<const Packet> p) const
+{
+  if (!m_headerOnly)
+    {
+      return std::numeric_limits<uint32_t>::max ();
+    }
+  PacketMetadata::ItemIterator i = p->BeginItem ();
+  if (!i.HasNext ())
+    {
+      // no metadata, we cannot tell the headers from the payload
+      return std::numeric_limits<uint32_t>::max ();
+    }
+  uint32_t length = 0;
+  while (i.HasNext ())
+    {
+      PacketMetadata::Item item = i.Next ();
+      if (item.type != PacketMetadata::Item::HEADER)
+        {
+          break;
+        }
+      length += item.currentSize;
+    }
+  return length;
+}
+
+void
+PcapngFileWrapper::Write (uint32_t interfaceId, Time t, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interfaceId << t << p);
+  m_file.Write (interfaceId, t.GetNanoSeconds (), p, GetCaptureLength (p));
+}
+
+void
+PcapngFileWrapper::Write (uint32_t interfaceId, Time t, Header &header, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interfaceId << t << &header << p);
+  uint32_t length = GetCaptureLength (p);
+  if (length != std::numeric_limits<uint32_t>::max ())
+    {
+      length += header.GetSerializedSize ();
+    }
+  m_file.Write (interfaceId, t.GetNanoSeconds (), header, p, length);
+}
+
+void
+PcapngFileWrapper::Write (uint32_t interfaceId, Time t, uint8_t const *buffer, uint32_t length)
+{
+  NS_LOG_FUNCTION (this << interfaceId << t << &buffer << length);
+  m_file.Write (interfaceId, t.GetNanoSeconds (), buffer, length);
+}
+
+} // namespace ns3
@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAPNG_FILE_WRAPPER_H
+#define PCAPNG_FILE_WRAPPER_H
+
+#include <limits>
+#include <string>
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "pcapng-file.h"
+
+namespace ns3 {
+
+/**
+ * A class that wraps a PcapngFile as an ns3::Object, in the same way as
+ * PcapFileWrapper wraps a PcapFile.
+ *
+ * Blocks are buffered in memory and written by a background thread
+ * unless the "WriteBufferSize" attribute is set to zero; the buffered
+ * data is flushed when the file is closed and, at the latest, when
+ * Simulator::Destroy is called.
+ *
+ * The amount of data saved per packet is bounded by the "CaptureSize"
+ * attribute.  With "HeaderOnly", only the headers of each packet are
+ * saved; this needs packet metadata (see Packet::EnablePrinting), and
+ * packets without metadata are saved up to the capture size.
+ */
+class PcapngFileWrapper : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  PcapngFileWrapper ();
+  ~PcapngFileWrapper ();
+
+  /**
+   * \return true if the 'fail' bit is set in the underlying iostream, false otherwise.
+   */
+  bool Fail (void) const;
+
+  /**
+   * Create a new pcapng file.
+   *
+   * \param filename String containing the name of the file.
+   */
+  void Open (std::string const &filename);
+
+  /**
+   * Close the underlying pcapng file.
+   */
+  void Close (void);
+
+  /**
+   * Write the buffered blocks, if any, to the underlying pcapng file.
+   */
+  void Flush (void);
+
+  /**
+   * \brief Describe a new interface of the file.
+   *
+   * \param dataLinkType the data link type of the interface
+   * \param name the name of the interface
+   * \param snapLen an optional maximum size for packets written on this
+   *        interface; defaults to the "CaptureSize" attribute.
+   * \return the identifier of the interface
+   */
+  uint32_t AddInterface (uint32_t dataLinkType, std::string name,
+                         uint32_t snapLen = std::numeric_limits<uint32_t>::max ());
+
+  /**
+   * \brief Write the next packet of an interface to file
+   *
+   * \param interfaceId the identifier returned by AddInterface ()
+   * \param t Packet timestamp as ns3::Time.
+   * \param p Packet to write to the pcapng file.
+   */
+  void Write (uint32_t interfaceId, Time t, Ptr<const Packet> p);
+
+  /**
+   * \brief Write the provided header along with the packet to the pcapng file.
+   *
+   * \param interfaceId the identifier returned by AddInterface ()
+   * \param t Packet timestamp as ns3::Time.
+   * \param header The Header to prepend to the packet.
+   * \param p Packet to write to the pcapng file.
+   */
+  void Write (uint32_t interfaceId, Time t, Header &header, Ptr<const Packet> p);
+
+  /**
+   * \brief Write the provided data buffer to the pcapng file.
+   *
+   * \param interfaceId the identifier returned by AddInterface ()
+   * \param t Packet timestamp as ns3::Time.
+   * \param buffer The buffer to write.
+   * \param length The size of the buffer.
+   */
+  void Write (uint32_t interfaceId, Time t, uint8_t const *buffer, uint32_t length);
+
+private:
+  /**
+   * \param p a packet
+   * \return the number of bytes of the packet to save
+   */
+  uint32_t GetCaptureLength (Ptr<const Packet> p) const;
+
+  PcapngFile m_file; //!< Pcapng file
+  uint32_t m_snapLen; //!< max length of saved packets
+  bool m_headerOnly; //!< only save the headers of the packets
+  uint32_t m_writeBufferSize; //!< size of a write buffer page, 0 if unbuffered
+  uint32_t m_maxWriteBuffers; //!< max number of write buffer pages
+  bool m_asyncWrite; //!< write buffer pages from a background thread
+  EventId m_flushEvent; //!< flush at Simulator::Destroy
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_FILE_WRAPPER_H */
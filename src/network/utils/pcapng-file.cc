@@ -0,0 +1,274 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/assert.h"
+#include "ns3/packet.h"
+#include "ns3/fatal-impl.h"
+#include "ns3/header.h"
+#include "ns3/buffer.h"
+#include "ns3/log.h"
+#include "pcapng-file.h"
+#include "buffered-stream-writer.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapngFile");
+
+static const uint32_t SECTION_HEADER_BLOCK = 0x0A0D0D0A;     /**< Section Header Block type */
+static const uint32_t INTERFACE_DESCRIPTION_BLOCK = 0x1;     /**< Interface Description Block type */
+static const uint32_t ENHANCED_PACKET_BLOCK = 0x6;           /**< Enhanced Packet Block type */
+static const uint32_t BYTE_ORDER_MAGIC = 0x1A2B3C4D;         /**< Identifies the byte order of a section */
+static const uint16_t VERSION_MAJOR = 1;                     /**< Major version of the pcapng format */
+static const uint16_t VERSION_MINOR = 0;                     /**< Minor version of the pcapng format */
+
+static const uint16_t OPT_ENDOFOPT = 0;                      /**< End of the options */
+static const uint16_t IF_NAME = 2;                           /**< Interface name option */
+static const uint16_t IF_TSRESOL = 9;                        /**< Interface timestamp resolution option */
+static const uint8_t TSRESOL_NS = 9;                         /**< Timestamps in 10^-9 s */
+
+/**
+ * \param length a length in bytes
+ * \return the length rounded up to a multiple of 32 bits
+ */
+static uint32_t
+Pad32 (uint32_t length)
+{
+  return (length + 3) & ~3U;
+}
+
+PcapngFile::PcapngFile ()
+  : m_writer (0)
+{
+  NS_LOG_FUNCTION (this);
+  FatalImpl::RegisterStream (&m_file);
+}
+
+PcapngFile::~PcapngFile ()
+{
+  NS_LOG_FUNCTION (this);
+  FatalImpl::UnregisterStream (&m_file);
+  Close ();
+}
+
+bool
+PcapngFile::Fail (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_writer != 0)
+    {
+      return m_writer->Fail ();
+    }
+  return m_file.fail ();
+}
+
+void
+PcapngFile::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_file.clear ();
+  m_file.open (filename.c_str (), std::ios::out | std::ios::binary);
+  m_snapLens.clear ();
+  if (m_file.fail ())
+    {
+      // leave the fail bit set for the caller to check, as PcapFile does
+      return;
+    }
+
+  //
+  // Section Header Block, without options and with an unspecified section
+  // length since we do not know it yet.
+  //
+  uint32_t blockLen = 28;
+  Write32 (SECTION_HEADER_BLOCK);
+  Write32 (blockLen);
+  Write32 (BYTE_ORDER_MAGIC);
+  uint16_t version[2] = { VERSION_MAJOR, VERSION_MINOR };
+  WriteBytes (version, sizeof (version));
+  Write32 (0xffffffff);
+  Write32 (0xffffffff);
+  Write32 (blockLen);
+}
+
+void
+PcapngFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  delete m_writer;
+  m_writer = 0;
+  m_file.close ();
+}
+
+void
+PcapngFile::SetWriteBuffer (uint32_t pageSize, uint32_t maxPages, bool async)
+{
+  NS_LOG_FUNCTION (this << pageSize << maxPages << async);
+  delete m_writer;
+  m_writer = new BufferedStreamWriter (&m_file, pageSize, maxPages, async);
+}
+
+void
+PcapngFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_writer != 0)
+    {
+      m_writer->Flush ();
+    }
+  else
+    {
+      m_file.flush ();
+    }
+}
+
+void
+PcapngFile::WriteBytes (const void *data, uint32_t size)
+{
+  if (m_writer != 0)
+    {
+      m_writer->Write (data, size);
+    }
+  else
+    {
+      m_file.write (static_cast<const char *> (data), size);
+    }
+}
+
+void
+PcapngFile::Write32 (uint32_t value)
+{
+  WriteBytes (&value, sizeof (value));
+}
+
+void
+PcapngFile::WriteOption (uint16_t code, void const *value, uint16_t length)
+{
+  uint16_t header[2] = { code, length };
+  WriteBytes (header, sizeof (header));
+  if (length > 0)
+    {
+      WriteBytes (value, length);
+      uint32_t zero = 0;
+      WriteBytes (&zero, Pad32 (length) - length);
+    }
+}
+
+uint32_t
+PcapngFile::AddInterface (uint32_t dataLinkType, uint32_t snapLen, std::string name)
+{
+  NS_LOG_FUNCTION (this << dataLinkType << snapLen << name);
+  NS_ASSERT_MSG (name.size () < 0xffff, "PcapngFile::AddInterface(): interface name too long");
+
+  // block header, link type and snap length, if_tsresol, end of options, block trailer
+  uint32_t blockLen = 8 + 8 + 8 + 4 + 4;
+  if (!name.empty ())
+    {
+      blockLen += 4 + Pad32 (name.size ());
+    }
+  Write32 (INTERFACE_DESCRIPTION_BLOCK);
+  Write32 (blockLen);
+  uint16_t linkType[2] = { static_cast<uint16_t> (dataLinkType), 0 };
+  WriteBytes (linkType, sizeof (linkType));
+  Write32 (snapLen);
+  if (!name.empty ())
+    {
+      WriteOption (IF_NAME, name.data (), name.size ());
+    }
+  WriteOption (IF_TSRESOL, &TSRESOL_NS, sizeof (TSRESOL_NS));
+  WriteOption (OPT_ENDOFOPT, 0, 0);
+  Write32 (blockLen);
+
+  m_snapLens.push_back (snapLen);
+  return m_snapLens.size () - 1;
+}
+
+uint32_t
+PcapngFile::GetNInterfaces (void) const
+{
+  return m_snapLens.size ();
+}
+
+uint32_t
+PcapngFile::WritePacketBlockHeader (uint32_t interfaceId, uint64_t ts, uint32_t totalLen, uint32_t maxLen)
+{
+  NS_LOG_FUNCTION (this << interfaceId << ts << totalLen << maxLen);
+  NS_ASSERT_MSG (interfaceId < m_snapLens.size (), "PcapngFile::Write(): unknown interface " << interfaceId);
+  NS_ASSERT (!Fail ());
+
+  uint32_t inclLen = std::min (totalLen, std::min (m_snapLens[interfaceId], maxLen));
+  uint32_t blockLen = 32 + Pad32 (inclLen);
+  Write32 (ENHANCED_PACKET_BLOCK);
+  Write32 (blockLen);
+  Write32 (interfaceId);
+  Write32 (static_cast<uint32_t> (ts >> 32));
+  Write32 (static_cast<uint32_t> (ts));
+  Write32 (inclLen);
+  Write32 (totalLen);
+  return inclLen;
+}
+
+void
+PcapngFile::WritePacketBlockTrailer (uint32_t inclLen)
+{
+  uint32_t zero = 0;
+  WriteBytes (&zero, Pad32 (inclLen) - inclLen);
+  Write32 (32 + Pad32 (inclLen));
+}
+
+void
+PcapngFile::Write (uint32_t interfaceId, uint64_t ts, uint8_t const *data, uint32_t totalLen, uint32_t maxLen)
+{
+  NS_LOG_FUNCTION (this << interfaceId << ts << &data << totalLen << maxLen);
+  uint32_t inclLen = WritePacketBlockHeader (interfaceId, ts, totalLen, maxLen);
+  WriteBytes (data, inclLen);
+  WritePacketBlockTrailer (inclLen);
+}
+
+void
+PcapngFile::Write (uint32_t interfaceId, uint64_t ts, Ptr<const Packet> p, uint32_t maxLen)
+{
+  NS_LOG_FUNCTION (this << interfaceId << ts << p << maxLen);
+  uint32_t inclLen = WritePacketBlockHeader (interfaceId, ts, p->GetSize (), maxLen);
+  if (inclLen > 0)
+    {
+      m_scratch.resize (std::max<size_t> (m_scratch.size (), inclLen));
+      p->CopyData (&m_scratch[0], inclLen);
+      WriteBytes (&m_scratch[0], inclLen);
+    }
+  WritePacketBlockTrailer (inclLen);
+}
+
+void
+PcapngFile::Write (uint32_t interfaceId, uint64_t ts, Header &header, Ptr<const Packet> p, uint32_t maxLen)
+{
+  NS_LOG_FUNCTION (this << interfaceId << ts << &header << p << maxLen);
+  uint32_t headerSize = header.GetSerializedSize ();
+  uint32_t inclLen = WritePacketBlockHeader (interfaceId, ts, headerSize + p->GetSize (), maxLen);
+  if (inclLen > 0)
+    {
+      Buffer headerBuffer;
+      headerBuffer.AddAtStart (headerSize);
+      header.Serialize (headerBuffer.Begin ());
+      uint32_t toCopy = std::min (headerSize, inclLen);
+      m_scratch.resize (std::max<size_t> (m_scratch.size (), inclLen));
+      headerBuffer.CopyData (&m_scratch[0], toCopy);
+      p->CopyData (&m_scratch[0] + toCopy, inclLen - toCopy);
+      WriteBytes (&m_scratch[0], inclLen);
+    }
+  WritePacketBlockTrailer (inclLen);
+}
+
+} // namespace ns3
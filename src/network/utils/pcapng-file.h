@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAPNG_FILE_H
+#define PCAPNG_FILE_H
+
+#include <string>
+#include <fstream>
+#include <vector>
+#include <limits>
+#include <stdint.h>
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+class Packet;
+class Header;
+class BufferedStreamWriter;
+
+/**
+ * \ingroup network
+ *
+ * \brief A pcapng file, holding the packets of many interfaces.
+ *
+ * Where a pcap file describes a single link, a pcapng file starts with a
+ * Section Header Block and can then describe any number of interfaces,
+ * each with an Interface Description Block giving its link type, snap
+ * length and name.  Every packet is stored in an Enhanced Packet Block
+ * which refers to its interface, so a whole simulation can be captured
+ * in a single file.
+ *
+ * Blocks are written in host byte order, which pcapng readers detect
+ * from the byte-order magic of the section header; timestamps are
+ * written with a nanosecond resolution.
+ *
+ * See https://github.com/pcapng/pcapng for the format.  Only writing is
+ * supported.
+ */
+class PcapngFile
+{
+public:
+  PcapngFile ();
+  ~PcapngFile ();
+
+  /**
+   * \return true if the 'fail' bit is set in the underlying iostream, false otherwise.
+   */
+  bool Fail (void) const;
+
+  /**
+   * \brief Create a new pcapng file and write its section header.
+   *
+   * If the file cannot be created, nothing is written and Fail () returns
+   * true.
+   *
+   * \param filename String containing the name of the file.
+   */
+  void Open (std::string const &filename);
+
+  /**
+   * \brief Close the underlying file.  Buffered data, if any, is written first.
+   */
+  void Close (void);
+
+  /**
+   * \brief Gather the blocks written to the file in large pages.
+   *
+   * See PcapFile::SetWriteBuffer.
+   *
+   * \param pageSize the size of a page, in bytes
+   * \param maxPages the maximum number of pages
+   * \param async whether the pages are written by a background thread
+   */
+  void SetWriteBuffer (uint32_t pageSize, uint32_t maxPages, bool async);
+
+  /**
+   * \brief Write the buffered blocks, if any, to the underlying file.
+   */
+  void Flush (void);
+
+  /**
+   * \brief Describe a new interface.
+   *
+   * \param dataLinkType the data link type of the interface, as in a
+   *        pcap file header
+   * \param snapLen the maximum number of bytes saved per packet
+   * \param name the name of the interface
+   * \return the identifier of the interface, to be given to Write ()
+   */
+  uint32_t AddInterface (uint32_t dataLinkType, uint32_t snapLen, std::string name);
+
+  /**
+   * \return the number of interfaces described so far
+   */
+  uint32_t GetNInterfaces (void) const;
+
+  /**
+   * \brief Write a packet captured on an interface.
+   *
+   * \param interfaceId the identifier returned by AddInterface ()
+   * \param ts the timestamp of the packet, in nanoseconds
+   * \param data the packet data
+   * \param totalLen the size of the packet
+   * \param maxLen the maximum number of bytes to save, on top of the
+   *        snap length of the interface
+   */
+  void Write (uint32_t interfaceId, uint64_t ts, uint8_t const *data, uint32_t totalLen,
+              uint32_t maxLen = std::numeric_limits<uint32_t>::max ());
+  /**
+   * \brief Write a packet captured on an interface.
+   *
+   * \param interfaceId the identifier returned by AddInterface ()
+   * \param ts the timestamp of the packet, in nanoseconds
+   * \param p the packet
+   * \param maxLen the maximum number of bytes to save, on top of the
+   *        snap length of the interface
+   */
+  void Write (uint32_t interfaceId, uint64_t ts, Ptr<const Packet> p,
+              uint32_t maxLen = std::numeric_limits<uint32_t>::max ());
+  /**
+   * \brief Write a header and a packet captured on an interface.
+   *
+   * \param interfaceId the identifier returned by AddInterface ()
+   * \param ts the timestamp of the packet, in nanoseconds
+   * \param header the header to prepend to the packet
+   * \param p the packet
+   * \param maxLen the maximum number of bytes to save, on top of the
+   *        snap length of the interface
+   */
+  void Write (uint32_t interfaceId, uint64_t ts, Header &header, Ptr<const Packet> p,
+              uint32_t maxLen = std::numeric_limits<uint32_t>::max ());
+
+private:
+  /**
+   * \brief Write the first part of an Enhanced Packet Block.
+   * \param interfaceId the interface of the packet
+   * \param ts the timestamp of the packet, in nanoseconds
+   * \param totalLen the size of the packet
+   * \param maxLen the maximum number of bytes to save
+   * \return the number of bytes of the packet to write
+   */
+  uint32_t WritePacketBlockHeader (uint32_t interfaceId, uint64_t ts, uint32_t totalLen, uint32_t maxLen);
+  /**
+   * \brief Write the padding and the trailer of an Enhanced Packet Block.
+   * \param inclLen the number of bytes of the packet that were written
+   */
+  void WritePacketBlockTrailer (uint32_t inclLen);
+  /**
+   * \brief Write an option to the file.
+   * \param code the code of the option
+   * \param value the value of the option
+   * \param length the length of the value
+   */
+  void WriteOption (uint16_t code, void const *value, uint16_t length);
+  /**
+   * \brief Write a 32 bits value to the file, in host byte order.
+   * \param value the value
+   */
+  void Write32 (uint32_t value);
+  /**
+   * \brief Write data to the file, through the write buffer if there is one.
+   * \param data the data to write
+   * \param size the number of bytes to write
+   */
+  void WriteBytes (const void *data, uint32_t size);
+
+  std::fstream m_file;                 //!< file stream
+  BufferedStreamWriter *m_writer;      //!< write buffer, if any
+  std::vector<uint32_t> m_snapLens;    //!< snap length of each interface
+  std::vector<uint8_t> m_scratch;      //!< packet bytes on their way to the file
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_FILE_H */
@@ -133,6 +133,17 @@ TypeId RedQueue::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&RedQueue::m_isNs1Compat),
                    MakeBooleanChecker ())
+    .AddAttribute ("UseEcn",
+                   "True to mark ECN-capable packets instead of dropping them, "
+                   "through the callback set with SetMarkCallback",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RedQueue::m_useEcn),
+                   MakeBooleanChecker ())
+    .AddAttribute ("UseHardDrop",
+                   "True to always drop packets above the max threshold, even with UseEcn",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&RedQueue::m_useHardDrop),
+                   MakeBooleanChecker ())
     .AddAttribute ("LinkBandwidth", 
                    "The RED link bandwidth",
                    DataRateValue (DataRate ("1.5Mbps")),
@@ -151,7 +162,6 @@ TypeId RedQueue::GetTypeId (void)
 RedQueue::RedQueue () :
   Queue (),
   m_packets (),
-  m_bytesInQueue (0),
   m_hasRedStarted (false)
 {
   NS_LOG_FUNCTION (this);
@@ -184,6 +194,13 @@ RedQueue::SetQueueLimit (uint32_t lim)
   m_queueLimit = lim;
 }
 
+void
+RedQueue::SetMarkCallback (MarkCallback mark)
+{
+  NS_LOG_FUNCTION (this);
+  m_mark = mark;
+}
+
 void
 RedQueue::SetTh (double minTh, double maxTh)
 {
@@ -218,6 +235,10 @@ RedQueue::DoEnqueue (Ptr<Packet> p)
       NS_LOG_INFO ("Initializing RED params.");
       InitializeParams ();
       m_hasRedStarted = true;
+      if (GetMode () == QUEUE_MODE_PACKETS)
+        {
+          m_packets.Reserve (m_queueLimit);
+        }
     }
 
   uint32_t nQueued = 0;
@@ -225,12 +246,12 @@ RedQueue::DoEnqueue (Ptr<Packet> p)
   if (GetMode () == QUEUE_MODE_BYTES)
     {
       NS_LOG_DEBUG ("Enqueue in bytes mode");
-      nQueued = m_bytesInQueue;
+      nQueued = m_packets.GetNBytes ();
     }
   else if (GetMode () == QUEUE_MODE_PACKETS)
     {
       NS_LOG_DEBUG ("Enqueue in packets mode");
-      nQueued = m_packets.size ();
+      nQueued = m_packets.GetNPackets ();
     }
 
   // simulate number of packets arrival during idle period
@@ -256,8 +277,8 @@ RedQueue::DoEnqueue (Ptr<Packet> p)
 
   m_qAvg = Estimator (nQueued, m + 1, m_qAvg, m_qW);
 
-  NS_LOG_DEBUG ("\t bytesInQueue  " << m_bytesInQueue << "\tQavg " << m_qAvg);
-  NS_LOG_DEBUG ("\t packetsInQueue  " << m_packets.size () << "\tQavg " << m_qAvg);
+  NS_LOG_DEBUG ("\t bytesInQueue  " << m_packets.GetNBytes () << "\tQavg " << m_qAvg);
+  NS_LOG_DEBUG ("\t packetsInQueue  " << m_packets.GetNPackets () << "\tQavg " << m_qAvg);
 
   m_count++;
   m_countBytes += p->GetSize ();
@@ -302,6 +323,18 @@ RedQueue::DoEnqueue (Ptr<Packet> p)
       dropType = DTYPE_FORCED;
       m_stats.qLimDrop++;
     }
+  else if (dropType == DTYPE_UNFORCED && m_useEcn && !m_mark.IsNull () && m_mark (p))
+    {
+      NS_LOG_DEBUG ("\t Marking due to Prob Mark " << m_qAvg);
+      m_stats.unforcedMark++;
+      dropType = DTYPE_NONE;
+    }
+  else if (dropType == DTYPE_FORCED && m_useEcn && !m_useHardDrop && !m_mark.IsNull () && m_mark (p))
+    {
+      NS_LOG_DEBUG ("\t Marking due to Hard Mark " << m_qAvg);
+      m_stats.forcedMark++;
+      dropType = DTYPE_NONE;
+    }
 
   if (dropType == DTYPE_UNFORCED)
     {
@@ -323,11 +356,10 @@ RedQueue::DoEnqueue (Ptr<Packet> p)
       return false;
     }
 
-  m_bytesInQueue += p->GetSize ();
-  m_packets.push_back (p);
+  m_packets.Push (p);
 
-  NS_LOG_LOGIC ("Number packets " << m_packets.size ());
-  NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
+  NS_LOG_LOGIC ("Number packets " << m_packets.GetNPackets ());
+  NS_LOG_LOGIC ("Number bytes " << m_packets.GetNBytes ());
 
   return true;
 }
@@ -347,6 +379,8 @@ RedQueue::InitializeParams (void)
   m_stats.forcedDrop = 0;
   m_stats.unforcedDrop = 0;
   m_stats.qLimDrop = 0;
+  m_stats.unforcedMark = 0;
+  m_stats.forcedMark = 0;
 
   m_cautious = 0;
   m_ptc = m_linkBandwidth.GetBitRate () / (8.0 * m_meanPktSize);
@@ -597,11 +631,11 @@ RedQueue::GetQueueSize (void)
   NS_LOG_FUNCTION (this);
   if (GetMode () == QUEUE_MODE_BYTES)
     {
-      return m_bytesInQueue;
+      return m_packets.GetNBytes ();
     }
   else if (GetMode () == QUEUE_MODE_PACKETS)
     {
-      return m_packets.size ();
+      return m_packets.GetNPackets ();
     }
   else
     {
@@ -614,7 +648,7 @@ RedQueue::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_packets.empty ())
+  if (m_packets.IsEmpty ())
     {
       NS_LOG_LOGIC ("Queue empty");
       m_idle = 1;
@@ -625,14 +659,12 @@ RedQueue::DoDequeue (void)
   else
     {
       m_idle = 0;
-      Ptr<Packet> p = m_packets.front ();
-      m_packets.pop_front ();
-      m_bytesInQueue -= p->GetSize ();
+      Ptr<Packet> p = m_packets.Pop ();
 
       NS_LOG_LOGIC ("Popped " << p);
 
-      NS_LOG_LOGIC ("Number packets " << m_packets.size ());
-      NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
+      NS_LOG_LOGIC ("Number packets " << m_packets.GetNPackets ());
+      NS_LOG_LOGIC ("Number bytes " << m_packets.GetNBytes ());
 
       return p;
     }
@@ -642,16 +674,16 @@ Ptr<const Packet>
 RedQueue::DoPeek (void) const
 {
   NS_LOG_FUNCTION (this);
-  if (m_packets.empty ())
+  if (m_packets.IsEmpty ())
     {
       NS_LOG_LOGIC ("Queue empty");
       return 0;
     }
 
-  Ptr<Packet> p = m_packets.front ();
+  Ptr<Packet> p = m_packets.Front ();
 
-  NS_LOG_LOGIC ("Number packets " << m_packets.size ());
-  NS_LOG_LOGIC ("Number bytes " << m_bytesInQueue);
+  NS_LOG_LOGIC ("Number packets " << m_packets.GetNPackets ());
+  NS_LOG_LOGIC ("Number bytes " << m_packets.GetNBytes ());
 
   return p;
 }
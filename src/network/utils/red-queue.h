@@ -61,13 +61,14 @@
 #ifndef RED_QUEUE_H
 #define RED_QUEUE_H
 
-#include <queue>
+#include "ns3/packet-ring.h"
 #include "ns3/packet.h"
 #include "ns3/queue.h"
 #include "ns3/nstime.h"
 #include "ns3/boolean.h"
 #include "ns3/data-rate.h"
 #include "ns3/nstime.h"
+#include "ns3/callback.h"
 
 namespace ns3 {
 
@@ -109,6 +110,8 @@ public:
     uint32_t unforcedDrop;  //!< Early probability drops
     uint32_t forcedDrop;    //!< Forced drops, qavg > max threshold
     uint32_t qLimDrop;      //!< Drops due to queue limits
+    uint32_t unforcedMark;  //!< Early probability marks
+    uint32_t forcedMark;    //!< Forced marks, qavg > max threshold
   } Stats;
 
   /** 
@@ -159,6 +162,24 @@ public:
    */
   void SetTh (double minTh, double maxTh);
 
+  /**
+   * \brief Callback marking a packet with the congestion experienced
+   * codepoint of \RFC{3168}
+   *
+   * The queue does not know the headers of the packets it holds; the
+   * callback returns false if the packet is not ECN-capable, in which
+   * case the packet is dropped instead.
+   */
+  typedef Callback<bool, Ptr<Packet> > MarkCallback;
+
+  /**
+   * \brief Set the callback marking the packets instead of dropping them
+   * when the UseEcn attribute is true.
+   *
+   * \param mark the marking callback
+   */
+  void SetMarkCallback (MarkCallback mark);
+
   /**
    * \brief Get the RED statistics after running.
    *
@@ -233,9 +254,8 @@ private:
   double ModifyP (double p, uint32_t count, uint32_t countBytes,
                   uint32_t meanPktSize, bool wait, uint32_t size);
 
-  std::list<Ptr<Packet> > m_packets; //!< packets in the queue
+  PacketRing m_packets; //!< packets in the queue
 
-  uint32_t m_bytesInQueue; //!< bytes in the queue
   bool m_hasRedStarted; //!< True if RED has started
   Stats m_stats; //!< RED statistics
 
@@ -251,6 +271,9 @@ private:
   double m_qW;              //!< Queue weight given to cur queue size sample
   double m_lInterm;         //!< The max probability of dropping a packet
   bool m_isNs1Compat;       //!< Ns-1 compatibility
+  bool m_useEcn;            //!< Mark ECN-capable packets instead of dropping them
+  bool m_useHardDrop;       //!< Drop rather than mark when qavg > max threshold
+  MarkCallback m_mark;      //!< Marks a packet, if it is ECN-capable
   DataRate m_linkBandwidth; //!< Link bandwidth
   Time m_linkDelay;         //!< Link delay
 
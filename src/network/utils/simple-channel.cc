@@ -21,6 +21,7 @@
 #include "simple-net-device.h"
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
+#include "packet-batch.h"
 #include "ns3/node.h"
 #include "ns3/log.h"
 
@@ -68,6 +69,30 @@ SimpleChannel::Send (Ptr<Packet> p, uint16_t protocol,
     }
 }
 
+void
+SimpleChannel::SendBatch (Ptr<PacketBatch> batch, uint16_t protocol,
+                          Mac48Address to, Mac48Address from,
+                          Ptr<SimpleNetDevice> sender)
+{
+  NS_LOG_FUNCTION (this << batch << protocol << to << from << sender);
+  NS_ASSERT (!batch->IsEmpty ());
+  for (std::vector<Ptr<SimpleNetDevice> >::const_iterator i = m_devices.begin (); i != m_devices.end (); ++i)
+    {
+      Ptr<SimpleNetDevice> tmp = *i;
+      if (tmp == sender)
+        {
+          continue;
+        }
+      for (uint32_t j = 0; j < batch->GetNPackets (); ++j)
+        {
+          Time arrival = batch->GetTimestamp (j) + m_delay - Simulator::Now ();
+          Simulator::ScheduleWithContext (tmp->GetNode ()->GetId (), arrival,
+                                          &SimpleNetDevice::Receive, tmp, batch->GetPacket (j)->Copy (),
+                                          protocol, to, from);
+        }
+    }
+}
+
 void
 SimpleChannel::Add (Ptr<SimpleNetDevice> device)
 {
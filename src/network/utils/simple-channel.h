@@ -29,6 +29,7 @@ namespace ns3 {
 
 class SimpleNetDevice;
 class Packet;
+class PacketBatch;
 
 /**
  * \ingroup channel
@@ -67,6 +68,24 @@ public:
   virtual void Send (Ptr<Packet> p, uint16_t protocol, Mac48Address to, Mac48Address from,
                      Ptr<SimpleNetDevice> sender);
 
+  /**
+   * A batch of packets is sent by a net device.  A receive event is
+   * scheduled for each packet of the batch and each net device connected
+   * to the channel other than the net device who sent the batch.
+   *
+   * The timestamp of each packet is expected to hold the time at which
+   * the packet is handed to the channel; the packet is received after
+   * the channel delay, counted from that time.
+   *
+   * \param batch packets to be sent
+   * \param protocol protocol number
+   * \param to address to send packets to
+   * \param from address the packets are coming from
+   * \param sender netdevice who sent the packets
+   */
+  virtual void SendBatch (Ptr<PacketBatch> batch, uint16_t protocol, Mac48Address to, Mac48Address from,
+                          Ptr<SimpleNetDevice> sender);
+
   /**
    * Attached a net device to the channel.
    *
@@ -19,6 +19,7 @@
  */
 #include "simple-net-device.h"
 #include "simple-channel.h"
+#include "packet-batch.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
 #include "ns3/log.h"
@@ -466,6 +467,70 @@ SimpleNetDevice::SendFrom (Ptr<Packet> p, const Address& source, const Address&
   return true;
 }
 
+bool
+SimpleNetDevice::SendBatch (Ptr<PacketBatch> batch, const Address& dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << batch << dest << protocolNumber);
+
+  //
+  // The batch is only handed to the channel as a unit if the device is idle,
+  // otherwise the packets would overtake the ones waiting in the queue.
+  //
+  if (m_queue->GetNPackets () != 0 || TransmitCompleteEvent.IsRunning ()
+      || batch->GetNPackets () < 2)
+    {
+      return NetDevice::SendBatch (batch, dest, protocolNumber);
+    }
+
+  Mac48Address to = Mac48Address::ConvertFrom (dest);
+
+  //
+  // The packets go through the queue, so that its limits and traces apply
+  // as if they had been sent one by one: the first one goes straight to
+  // the wire, the others wait in the queue until the whole batch has been
+  // accepted.
+  //
+  bool result = true;
+  Ptr<PacketBatch> wire = CreateObject<PacketBatch> ();
+  for (std::vector<Ptr<Packet> >::const_iterator i = batch->Begin (); i != batch->End (); ++i)
+    {
+      Ptr<Packet> packet = *i;
+      if (packet->GetSize () > GetMtu () || m_queue->Enqueue (packet) == false)
+        {
+          result = false;
+          continue;
+        }
+      if (wire->IsEmpty ())
+        {
+          wire->AddPacket (m_queue->Dequeue ());
+        }
+    }
+
+  Ptr<Packet> packet;
+  while ((packet = m_queue->Dequeue ()) != 0)
+    {
+      wire->AddPacket (packet);
+    }
+
+  if (wire->IsEmpty ())
+    {
+      return false;
+    }
+
+  Time txStart = Simulator::Now ();
+  for (uint32_t i = 0; i < wire->GetNPackets (); ++i)
+    {
+      wire->SetTimestamp (i, txStart);
+      if (m_bps > DataRate (0))
+        {
+          txStart += m_bps.CalculateBytesTxTime (wire->GetPacket (i)->GetSize ());
+        }
+    }
+
+  m_channel->SendBatch (wire, protocolNumber, to, m_address, this);
+  TransmitCompleteEvent = Simulator::Schedule (txStart - Simulator::Now (), &SimpleNetDevice::TransmitComplete, this);
+  return result;
+}
 
 void
 SimpleNetDevice::TransmitComplete ()
@@ -35,6 +35,7 @@
 namespace ns3 {
 
 class SimpleChannel;
+class PacketBatch;
 class Node;
 class ErrorModel;
 
@@ -126,6 +127,7 @@ public:
   virtual bool IsBridge (void) const;
   virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber);
   virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber);
+  virtual bool SendBatch (Ptr<PacketBatch> batch, const Address& dest, uint16_t protocolNumber);
   virtual Ptr<Node> GetNode (void) const;
   virtual void SetNode (Ptr<Node> node);
   virtual bool NeedsArp (void) const;
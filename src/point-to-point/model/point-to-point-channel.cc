@@ -20,6 +20,7 @@
 #include "point-to-point-net-device.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/packet.h"
+#include "ns3/packet-batch.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 
@@ -106,6 +107,35 @@ PointToPointChannel::TransmitStart (
   return true;
 }
 
+bool
+PointToPointChannel::TransmitBatch (
+  Ptr<PacketBatch> batch,
+  Ptr<PointToPointNetDevice> src)
+{
+  NS_LOG_FUNCTION (this << batch << src);
+  NS_ASSERT (!batch->IsEmpty ());
+
+  NS_ASSERT (m_link[0].m_state != INITIALIZING);
+  NS_ASSERT (m_link[1].m_state != INITIALIZING);
+
+  uint32_t wire = src == m_link[0].m_src ? 0 : 1;
+  Ptr<PointToPointNetDevice> dst = m_link[wire].m_dst;
+
+  Time now = Simulator::Now ();
+  Time txStart = now;
+  for (uint32_t i = 0; i < batch->GetNPackets (); ++i)
+    {
+      Ptr<Packet> p = batch->GetPacket (i);
+      Time txEnd = batch->GetTimestamp (i);
+      Simulator::ScheduleWithContext (dst->GetNode ()->GetId (),
+                                      txEnd - now + m_delay, &PointToPointNetDevice::Receive,
+                                      dst, p);
+      m_txrxPointToPoint (p, src, dst, txEnd - txStart, txEnd - now + m_delay);
+      txStart = txEnd;
+    }
+  return true;
+}
+
 uint32_t 
 PointToPointChannel::GetNDevices (void) const
 {
@@ -30,6 +30,7 @@ namespace ns3 {
 
 class PointToPointNetDevice;
 class Packet;
+class PacketBatch;
 
 /**
  * \ingroup point-to-point
@@ -80,6 +81,20 @@ public:
    */
   virtual bool TransmitStart (Ptr<Packet> p, Ptr<PointToPointNetDevice> src, Time txTime);
 
+  /**
+   * \brief Transmit a batch of back-to-back packets over this channel
+   *
+   * The timestamp of each packet of the batch is expected to hold the
+   * (absolute) time at which its last bit leaves the source device.  Each
+   * packet is delivered to the destination device when its last bit
+   * arrives, exactly as if it had been sent with TransmitStart.
+   *
+   * \param batch PacketBatch to transmit
+   * \param src Source PointToPointNetDevice
+   * \returns true if successful (currently always true)
+   */
+  virtual bool TransmitBatch (Ptr<PacketBatch> batch, Ptr<PointToPointNetDevice> src);
+
   /**
    * \brief Get number of devices on this channel
    * \returns number of devices on this channel
@@ -25,6 +25,8 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
+#include "ns3/packet-batch.h"
+#include "ns3/fluid-background.h"
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
@@ -62,6 +64,11 @@ PointToPointNetDevice::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&PointToPointNetDevice::m_receiveErrorModel),
                    MakePointerChecker<ErrorModel> ())
+    .AddAttribute ("FluidBackground",
+                   "The fluid model of the background traffic sharing the link",
+                   PointerValue (),
+                   MakePointerAccessor (&PointToPointNetDevice::m_fluidBackground),
+                   MakePointerChecker<FluidBackground> ())
     .AddAttribute ("InterframeGap", 
                    "The time to wait between packet (frame) transmissions",
                    TimeValue (Seconds (0.0)),
@@ -177,7 +184,8 @@ PointToPointNetDevice::PointToPointNetDevice ()
     m_txMachineState (READY),
     m_channel (0),
     m_linkUp (false),
-    m_currentPkt (0)
+    m_currentPkt (0),
+    m_currentBatch (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -213,7 +221,9 @@ PointToPointNetDevice::DoDispose ()
   m_node = 0;
   m_channel = 0;
   m_receiveErrorModel = 0;
+  m_fluidBackground = 0;
   m_currentPkt = 0;
+  m_currentBatch = 0;
   NetDevice::DoDispose ();
 }
 
@@ -247,13 +257,27 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   m_currentPkt = p;
   m_phyTxBeginTrace (m_currentPkt);
 
-  Time txTime = m_bps.CalculateBytesTxTime (p->GetSize ());
+  Time txTime;
+  Time fluidDelay = Seconds (0);
+  if (m_fluidBackground)
+    {
+      //
+      // The background traffic takes its share of the link, and the packet
+      // reaches the peer only once the background backlog ahead of it drained.
+      //
+      txTime = m_fluidBackground->GetTransmissionTime (m_bps, p->GetSize ());
+      fluidDelay = m_fluidBackground->GetQueueingDelay (m_bps, txTime);
+    }
+  else
+    {
+      txTime = m_bps.CalculateBytesTxTime (p->GetSize ());
+    }
   Time txCompleteTime = txTime + m_tInterframeGap;
 
   NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.GetSeconds () << "sec");
   Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
 
-  bool result = m_channel->TransmitStart (p, this, txTime);
+  bool result = m_channel->TransmitStart (p, this, txTime + fluidDelay);
   if (result == false)
     {
       m_phyTxDropTrace (p);
@@ -261,6 +285,49 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   return result;
 }
 
+bool
+PointToPointNetDevice::TransmitBatchStart (Ptr<PacketBatch> batch)
+{
+  NS_LOG_FUNCTION (this << batch);
+  NS_LOG_LOGIC ("Batch of " << batch->GetNPackets () << " packets");
+
+  NS_ASSERT_MSG (m_txMachineState == READY, "Must be READY to transmit");
+  m_txMachineState = BUSY;
+  m_currentBatch = batch;
+
+  //
+  // The packets go out back to back, so the last bit of each packet leaves
+  // the device one transmission time (plus the interframe gap separating it
+  // from its predecessor) after the previous one.
+  //
+  Time txEnd = Simulator::Now ();
+  for (uint32_t i = 0; i < batch->GetNPackets (); ++i)
+    {
+      Ptr<Packet> p = batch->GetPacket (i);
+      m_phyTxBeginTrace (p);
+      if (i > 0)
+        {
+          txEnd += m_tInterframeGap;
+        }
+      txEnd += m_bps.CalculateBytesTxTime (p->GetSize ());
+      batch->SetTimestamp (i, txEnd);
+    }
+  Time txCompleteTime = txEnd + m_tInterframeGap - Simulator::Now ();
+
+  NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.GetSeconds () << "sec");
+  Simulator::Schedule (txCompleteTime, &PointToPointNetDevice::TransmitComplete, this);
+
+  bool result = m_channel->TransmitBatch (batch, this);
+  if (result == false)
+    {
+      for (std::vector<Ptr<Packet> >::const_iterator i = batch->Begin (); i != batch->End (); ++i)
+        {
+          m_phyTxDropTrace (*i);
+        }
+    }
+  return result;
+}
+
 void
 PointToPointNetDevice::TransmitComplete (void)
 {
@@ -275,10 +342,21 @@ PointToPointNetDevice::TransmitComplete (void)
   NS_ASSERT_MSG (m_txMachineState == BUSY, "Must be BUSY if transmitting");
   m_txMachineState = READY;
 
-  NS_ASSERT_MSG (m_currentPkt != 0, "PointToPointNetDevice::TransmitComplete(): m_currentPkt zero");
+  if (m_currentBatch != 0)
+    {
+      for (std::vector<Ptr<Packet> >::const_iterator i = m_currentBatch->Begin (); i != m_currentBatch->End (); ++i)
+        {
+          m_phyTxEndTrace (*i);
+        }
+      m_currentBatch = 0;
+    }
+  else
+    {
+      NS_ASSERT_MSG (m_currentPkt != 0, "PointToPointNetDevice::TransmitComplete(): m_currentPkt zero");
 
-  m_phyTxEndTrace (m_currentPkt);
-  m_currentPkt = 0;
+      m_phyTxEndTrace (m_currentPkt);
+      m_currentPkt = 0;
+    }
 
   Ptr<Packet> p = m_queue->Dequeue ();
   if (p == 0)
@@ -329,6 +407,13 @@ PointToPointNetDevice::SetReceiveErrorModel (Ptr<ErrorModel> em)
   m_receiveErrorModel = em;
 }
 
+void
+PointToPointNetDevice::SetFluidBackground (Ptr<FluidBackground> fluid)
+{
+  NS_LOG_FUNCTION (this << fluid);
+  m_fluidBackground = fluid;
+}
+
 void
 PointToPointNetDevice::Receive (Ptr<Packet> packet)
 {
@@ -532,6 +617,17 @@ PointToPointNetDevice::Send (
 
   m_macTxTrace (packet);
 
+  //
+  // The transmit buffer is shared with the background traffic, which may
+  // leave no room for the packet.
+  //
+  if (m_fluidBackground
+      && !m_fluidBackground->Admit (m_bps, packet->GetSize (), m_queue->GetNBytes ()))
+    {
+      m_macTxDropTrace (packet);
+      return false;
+    }
+
   //
   // We should enqueue and dequeue the packet to hit the tracing hooks.
   //
@@ -555,6 +651,71 @@ PointToPointNetDevice::Send (
   return false;
 }
 
+bool
+PointToPointNetDevice::SendBatch (
+  Ptr<PacketBatch> batch,
+  const Address &dest,
+  uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << batch << dest << protocolNumber);
+
+  //
+  // A batch only goes out as a unit if the transmitter is idle and nothing
+  // is waiting in the queue; otherwise the packets would overtake queued
+  // traffic, so we fall back to sending them one at a time.  The same goes
+  // when background traffic shares the link, since it spaces the packets.
+  //
+  if (IsLinkUp () == false || m_txMachineState != READY
+      || m_queue->IsEmpty () == false || batch->GetNPackets () < 2
+      || m_fluidBackground)
+    {
+      return NetDevice::SendBatch (batch, dest, protocolNumber);
+    }
+
+  //
+  // Every packet still goes through the queue, both to hit the tracing hooks
+  // and so that the queue limits apply exactly as if the packets had been
+  // sent one by one: the first one goes straight to the wire, the others
+  // wait in the queue until the whole batch has been accepted.
+  //
+  bool result = true;
+  Ptr<PacketBatch> wire = CreateObject<PacketBatch> ();
+  for (std::vector<Ptr<Packet> >::const_iterator i = batch->Begin (); i != batch->End (); ++i)
+    {
+      Ptr<Packet> packet = *i;
+      AddHeader (packet, protocolNumber);
+      m_macTxTrace (packet);
+      if (m_queue->Enqueue (packet) == false)
+        {
+          m_macTxDropTrace (packet);
+          result = false;
+          continue;
+        }
+      if (wire->IsEmpty ())
+        {
+          wire->AddPacket (m_queue->Dequeue ());
+        }
+    }
+
+  Ptr<Packet> packet;
+  while ((packet = m_queue->Dequeue ()) != 0)
+    {
+      wire->AddPacket (packet);
+    }
+
+  if (wire->IsEmpty ())
+    {
+      return false;
+    }
+
+  for (std::vector<Ptr<Packet> >::const_iterator i = wire->Begin (); i != wire->End (); ++i)
+    {
+      m_snifferTrace (*i);
+      m_promiscSnifferTrace (*i);
+    }
+  return TransmitBatchStart (wire) && result;
+}
+
 bool
 PointToPointNetDevice::SendFrom (Ptr<Packet> packet, 
                                  const Address &source, 
@@ -34,8 +34,10 @@
 namespace ns3 {
 
 class Queue;
+class PacketBatch;
 class PointToPointChannel;
 class ErrorModel;
+class FluidBackground;
 
 /**
  * \defgroup point-to-point Point-To-Point Network Device
@@ -137,6 +139,17 @@ public:
    */
   void SetReceiveErrorModel (Ptr<ErrorModel> em);
 
+  /**
+   * Attach a fluid model of background traffic to the PointToPointNetDevice.
+   *
+   * The background traffic shares the transmit buffer and the link with
+   * the packets: the packets are transmitted at the rate it leaves, are
+   * delayed by its backlog and are lost when it fills the buffer.
+   *
+   * \param fluid Ptr to the FluidBackground.
+   */
+  void SetFluidBackground (Ptr<FluidBackground> fluid);
+
   /**
    * Receive a packet from a connected PointToPointChannel.
    *
@@ -182,6 +195,7 @@ public:
 
   virtual bool Send (Ptr<Packet> packet, const Address &dest, uint16_t protocolNumber);
   virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber);
+  virtual bool SendBatch (Ptr<PacketBatch> batch, const Address &dest, uint16_t protocolNumber);
 
   virtual Ptr<Node> GetNode (void) const;
   virtual void SetNode (Ptr<Node> node);
@@ -272,6 +286,21 @@ private:
    */
   bool TransmitStart (Ptr<Packet> p);
 
+  /**
+   * Start Sending a Batch of Packets Down the Wire.
+   *
+   * The packets of the batch are serialized back to back, separated by the
+   * interframe gap.  The timestamp of each packet is set to the time at
+   * which its last bit leaves the device, the whole batch is handed to the
+   * channel at once and a single TransmitComplete event is scheduled at the
+   * end of the batch.
+   *
+   * \see PointToPointChannel::TransmitBatch ()
+   * \param batch the batch of packets to send
+   * \returns true if success, false on failure
+   */
+  bool TransmitBatchStart (Ptr<PacketBatch> batch);
+
   /**
    * Stop Sending a Packet Down the Wire and Begin the Interframe Gap.
    *
@@ -331,6 +360,11 @@ private:
    */
   Ptr<ErrorModel> m_receiveErrorModel;
 
+  /**
+   * Background traffic sharing the transmit buffer and the link
+   */
+  Ptr<FluidBackground> m_fluidBackground;
+
   /**
    * The trace source fired when packets come into the "top" of the device
    * at the L3/L2 transition, before being queued for transmission.
@@ -461,6 +495,7 @@ private:
   uint32_t m_mtu;
 
   Ptr<Packet> m_currentPkt; //!< Current packet processed
+  Ptr<PacketBatch> m_currentBatch; //!< Current batch processed
 
   /**
    * \brief PPP to Ethernet protocol number mapping
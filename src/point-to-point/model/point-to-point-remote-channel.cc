@@ -23,6 +23,7 @@
 #include "point-to-point-remote-channel.h"
 #include "point-to-point-net-device.h"
 #include "ns3/packet.h"
+#include "ns3/packet-batch.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/mpi-interface.h"
@@ -76,4 +77,20 @@ PointToPointRemoteChannel::TransmitStart (
   return true;
 }
 
+bool
+PointToPointRemoteChannel::TransmitBatch (
+  Ptr<PacketBatch> batch,
+  Ptr<PointToPointNetDevice> src)
+{
+  NS_LOG_FUNCTION (this << batch << src);
+
+  bool result = true;
+  for (uint32_t i = 0; i < batch->GetNPackets (); ++i)
+    {
+      Time txTime = batch->GetTimestamp (i) - Simulator::Now ();
+      result = TransmitStart (batch->GetPacket (i), src, txTime) && result;
+    }
+  return result;
+}
+
 } // namespace ns3
@@ -68,6 +68,18 @@ public:
    */
   virtual bool TransmitStart (Ptr<Packet> p, Ptr<PointToPointNetDevice> src,
                               Time txTime);
+
+  /**
+   * \brief Transmit a batch of packets
+   *
+   * MPI messages carry one packet each, so the batch is split and every
+   * packet is sent with its own receive time.
+   *
+   * \param batch PacketBatch to transmit
+   * \param src Source PointToPointNetDevice
+   * \returns true if successful (currently always true)
+   */
+  virtual bool TransmitBatch (Ptr<PacketBatch> batch, Ptr<PointToPointNetDevice> src);
 };
 
 } // namespace ns3
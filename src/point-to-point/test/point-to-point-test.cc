@@ -3,6 +3,8 @@
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/packet-batch.h"
+#include "ns3/fluid-background.h"
 
 using namespace ns3;
 
@@ -73,6 +75,237 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test class for PacketBatch transmission over PointToPoint
+ *
+ * It sends a batch of packets from one NetDevice to another and checks
+ * that they are all delivered, in order, each one when its own last bit
+ * arrives.
+ */
+class PointToPointBatchTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointBatchTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send a batch of packets to the device specified
+   *
+   * \param device NetDevice to send to
+   */
+  void SendBatch (Ptr<PointToPointNetDevice> device);
+
+  /**
+   * \brief Receive callback of the destination device
+   *
+   * \param device the receiving device
+   * \param packet the received packet
+   * \param protocol the protocol number
+   * \param sender the address of the sender
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &sender);
+
+  std::vector<uint32_t> m_rxSizes; //!< sizes of the received packets
+  std::vector<Time> m_rxTimes;     //!< times at which the packets were received
+};
+
+PointToPointBatchTest::PointToPointBatchTest ()
+  : TestCase ("PointToPoint PacketBatch")
+{
+}
+
+void
+PointToPointBatchTest::SendBatch (Ptr<PointToPointNetDevice> device)
+{
+  Ptr<PacketBatch> batch = CreateObject<PacketBatch> ();
+  batch->AddPacket (Create<Packet> (100));
+  batch->AddPacket (Create<Packet> (200));
+  batch->AddPacket (Create<Packet> (300));
+  device->SendBatch (batch, device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointBatchTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &sender)
+{
+  m_rxSizes.push_back (packet->GetSize ());
+  m_rxTimes.push_back (Simulator::Now ());
+  return true;
+}
+
+void
+PointToPointBatchTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (2)));
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue> ());
+  devA->SetDataRate (DataRate ("8Mbps"));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue> ());
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  // Node::AddDevice installs its own receive callback
+  devB->SetReceiveCallback (MakeCallback (&PointToPointBatchTest::Receive, this));
+
+  Simulator::Schedule (Seconds (1.0), &PointToPointBatchTest::SendBatch, this, devA);
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_rxSizes.size (), 3, "Not all the packets of the batch were received");
+  NS_TEST_ASSERT_MSG_EQ (m_rxSizes[0], 100, "Packets of the batch received out of order");
+  NS_TEST_ASSERT_MSG_EQ (m_rxSizes[1], 200, "Packets of the batch received out of order");
+  NS_TEST_ASSERT_MSG_EQ (m_rxSizes[2], 300, "Packets of the batch received out of order");
+
+  // three packets with a 2 bytes PPP header each, back to back
+  DataRate rate ("8Mbps");
+  Time lastBit = Seconds (1.0) + MilliSeconds (2);
+  lastBit += rate.CalculateBytesTxTime (102);
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[0], lastBit, "First packet of the batch not received at its arrival time");
+  lastBit += rate.CalculateBytesTxTime (202);
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[1], lastBit, "Second packet of the batch not received at its arrival time");
+  lastBit += rate.CalculateBytesTxTime (302);
+  NS_TEST_ASSERT_MSG_EQ (m_rxTimes[2], lastBit, "Third packet of the batch not received at its arrival time");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Test class for background fluid traffic over PointToPoint
+ *
+ * A FluidBackground of 100000 flows shares a 10 Mb/s link with a few
+ * packets.  At half the capacity it only slows down their transmission;
+ * above the capacity it builds a backlog delaying them, then fills the
+ * buffer and makes them lose about as much as the fluid itself.
+ */
+class PointToPointFluidTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointFluidTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send packets to the device specified
+   *
+   * \param device NetDevice to send to
+   * \param size the size of the packets
+   * \param n the number of packets
+   */
+  void Send (Ptr<PointToPointNetDevice> device, uint32_t size, uint32_t n);
+
+  /**
+   * \brief Receive callback of the destination device
+   *
+   * \param device the receiving device
+   * \param packet the received packet
+   * \param protocol the protocol number
+   * \param sender the address of the sender
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &sender);
+
+  std::map<uint32_t, Time> m_rxTimes;      //!< the last reception time of each packet size
+  std::map<uint32_t, uint32_t> m_rxCounts; //!< the number of packets received of each size
+};
+
+PointToPointFluidTest::PointToPointFluidTest ()
+  : TestCase ("PointToPoint FluidBackground")
+{
+}
+
+void
+PointToPointFluidTest::Send (Ptr<PointToPointNetDevice> device, uint32_t size, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      device->Send (Create<Packet> (size), device->GetBroadcast (), 0x800);
+    }
+}
+
+bool
+PointToPointFluidTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &sender)
+{
+  m_rxTimes[packet->GetSize ()] = Simulator::Now ();
+  m_rxCounts[packet->GetSize ()]++;
+  return true;
+}
+
+void
+PointToPointFluidTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (2)));
+
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue> ());
+  devA->SetDataRate (DataRate ("10Mbps"));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue> ());
+
+  Ptr<FluidBackground> fluid = CreateObject<FluidBackground> ();
+  fluid->AssignStreams (1);
+  fluid->AddFlows (DataRate ("50bps"), Seconds (0), Seconds (10), 100000);
+  fluid->AddFlows (DataRate ("70bps"), Seconds (2), Seconds (10), 100000);
+  devA->SetFluidBackground (fluid);
+
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  devB->SetReceiveCallback (MakeCallback (&PointToPointFluidTest::Receive, this));
+
+  // 5 Mb/s of background: the packet gets the other half of the link
+  Simulator::Schedule (Seconds (1.0), &PointToPointFluidTest::Send, this, devA, 998, 1);
+  // 12 Mb/s of background, served at 9.5 Mb/s: 200 ms later, 62500 bytes wait
+  Simulator::Schedule (Seconds (2.2), &PointToPointFluidTest::Send, this, devA, 898, 1);
+  // the backlog filled the buffer, the fluid loses 1 - 9.5/12 of its traffic
+  for (uint32_t i = 0; i < 200; i++)
+    {
+      Simulator::Schedule (Seconds (3.0) + MilliSeconds (20 * i), &PointToPointFluidTest::Send, this, devA, 798, 1);
+    }
+
+  Simulator::Run ();
+
+  double expected = 1.0 + 1000 * 8 / 5e6 + 0.002;
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_rxTimes[998].GetSeconds (), expected, 1e-6,
+                             "The packet did not get the capacity left by the fluid");
+  expected = 2.2 + 900 * 8 / 0.5e6 + 62500 * 8 / 9.5e6 + 0.002;
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_rxTimes[898].GetSeconds (), expected, 1e-4,
+                             "The packet was not delayed by the fluid backlog");
+  NS_TEST_EXPECT_MSG_GT (m_rxCounts[798], 140, "The packets lost more than the fluid");
+  NS_TEST_EXPECT_MSG_LT (m_rxCounts[798], 175, "The packets lost less than the fluid");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -89,6 +322,8 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointBatchTest, TestCase::QUICK);
+  AddTestCase (new PointToPointFluidTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -0,0 +1,314 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/type-id.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/red-queue.h"
+#include "ns3/ecn-marker.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("Ns3TcpCongestionControlTest");
+
+// ===========================================================================
+// Tests of the CUBIC, DCTCP and BBR congestion controls
+// ===========================================================================
+//
+// A sender and a receiver on either side of a router, the link from the
+// router to the receiver being the bottleneck:
+//
+//        100Mbps, 1ms          10Mbps, 10ms
+//   n0 ---------------- n1 ----------------- n2
+//                          ^ bottleneck queue
+//
+class Ns3TcpCongestionControlTestCase : public TestCase
+{
+public:
+  Ns3TcpCongestionControlTestCase (std::string name);
+  virtual ~Ns3TcpCongestionControlTestCase () {}
+
+protected:
+  /**
+   * \brief Transfer data from n0 to n2
+   * \param socketType the TypeId name of the sockets of all the nodes
+   * \param queue the queue of the bottleneck
+   * \param bytes the number of bytes to transfer
+   */
+  void RunTransfer (std::string socketType, Ptr<Queue> queue, uint32_t bytes);
+
+  uint32_t m_received;       //!< bytes received by the sink
+  uint32_t m_maxQueue;       //!< largest bottleneck queue, in packets
+  uint32_t m_maxQueueLate;   //!< largest bottleneck queue after the first two seconds
+  uint32_t m_firstSsThresh;  //!< first slow start threshold set by the sender
+  uint32_t m_cwndBefore;     //!< congestion window of the sender at that time
+
+private:
+  void ConnectTraces (void);
+  void CwndChange (uint32_t oldValue, uint32_t newValue);
+  void SsThreshChange (uint32_t oldValue, uint32_t newValue);
+  void SampleQueue (Ptr<Queue> queue);
+
+  uint32_t m_cwnd;           //!< current congestion window of the sender
+};
+
+Ns3TcpCongestionControlTestCase::Ns3TcpCongestionControlTestCase (std::string name)
+  : TestCase (name),
+    m_received (0),
+    m_maxQueue (0),
+    m_maxQueueLate (0),
+    m_firstSsThresh (0),
+    m_cwndBefore (0),
+    m_cwnd (0)
+{
+}
+
+void
+Ns3TcpCongestionControlTestCase::CwndChange (uint32_t oldValue, uint32_t newValue)
+{
+  m_cwnd = newValue;
+}
+
+void
+Ns3TcpCongestionControlTestCase::SsThreshChange (uint32_t oldValue, uint32_t newValue)
+{
+  if (m_firstSsThresh == 0)
+    {
+      m_firstSsThresh = newValue;
+      m_cwndBefore = m_cwnd;
+    }
+}
+
+void
+Ns3TcpCongestionControlTestCase::ConnectTraces (void)
+{
+  Config::ConnectWithoutContext ("/NodeList/0/$ns3::TcpL4Protocol/SocketList/0/CongestionWindow",
+                                 MakeCallback (&Ns3TcpCongestionControlTestCase::CwndChange, this));
+  Config::ConnectWithoutContext ("/NodeList/0/$ns3::TcpL4Protocol/SocketList/0/SlowStartThreshold",
+                                 MakeCallback (&Ns3TcpCongestionControlTestCase::SsThreshChange, this));
+}
+
+void
+Ns3TcpCongestionControlTestCase::SampleQueue (Ptr<Queue> queue)
+{
+  m_maxQueue = std::max (m_maxQueue, queue->GetNPackets ());
+  if (Simulator::Now () > Seconds (2))
+    {
+      m_maxQueueLate = std::max (m_maxQueueLate, queue->GetNPackets ());
+    }
+  Simulator::Schedule (MilliSeconds (1), &Ns3TcpCongestionControlTestCase::SampleQueue, this, queue);
+}
+
+void
+Ns3TcpCongestionControlTestCase::RunTransfer (std::string socketType, Ptr<Queue> queue, uint32_t bytes)
+{
+  uint16_t sinkPort = 50000;
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (512000));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (512000));
+
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  PointToPointHelper access;
+  access.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  access.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer accessDevices = access.Install (nodes.Get (0), nodes.Get (1));
+
+  PointToPointHelper bottleneck;
+  bottleneck.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  bottleneck.SetChannelAttribute ("Delay", StringValue ("10ms"));
+  NetDeviceContainer bottleneckDevices = bottleneck.Install (nodes.Get (1), nodes.Get (2));
+  DynamicCast<PointToPointNetDevice> (bottleneckDevices.Get (0))->SetQueue (queue);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      nodes.Get (i)->GetObject<TcpL4Protocol> ()->SetAttribute ("SocketType",
+                                                               TypeIdValue (TypeId::LookupByName (socketType)));
+    }
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  address.Assign (accessDevices);
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (bottleneckDevices);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  BulkSendHelper source ("ns3::TcpSocketFactory",
+                         InetSocketAddress (interfaces.GetAddress (1), sinkPort));
+  source.SetAttribute ("MaxBytes", UintegerValue (bytes));
+  ApplicationContainer sourceApps = source.Install (nodes.Get (0));
+  sourceApps.Start (Seconds (0.1));
+
+  PacketSinkHelper sink ("ns3::TcpSocketFactory",
+                         InetSocketAddress (Ipv4Address::GetAny (), sinkPort));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (2));
+  sinkApps.Start (Seconds (0.0));
+
+  Simulator::Schedule (Seconds (0.11), &Ns3TcpCongestionControlTestCase::ConnectTraces, this);
+  Simulator::Schedule (Seconds (0.1), &Ns3TcpCongestionControlTestCase::SampleQueue, this, queue);
+
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  m_received = DynamicCast<PacketSink> (sinkApps.Get (0))->GetTotalRx ();
+  Simulator::Destroy ();
+}
+
+// ===========================================================================
+// CUBIC reduces its window by Beta on losses
+// ===========================================================================
+//
+class Ns3TcpCubicTestCase : public Ns3TcpCongestionControlTestCase
+{
+public:
+  Ns3TcpCubicTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ns3TcpCubicTestCase::Ns3TcpCubicTestCase ()
+  : Ns3TcpCongestionControlTestCase ("Check that CUBIC reduces its window by 30% on a loss")
+{
+}
+
+void
+Ns3TcpCubicTestCase::DoRun (void)
+{
+  Ptr<DropTailQueue> queue = CreateObject<DropTailQueue> ();
+  queue->SetAttribute ("MaxPackets", UintegerValue (20));
+  RunTransfer ("ns3::TcpCubic", queue, 2000000);
+
+  NS_TEST_ASSERT_MSG_NE (m_firstSsThresh, 0, "The window was never reduced");
+  double ratio = static_cast<double> (m_firstSsThresh) / m_cwndBefore;
+  NS_TEST_EXPECT_MSG_EQ_TOL (ratio, 0.7, 0.05, "The window was not reduced by Beta");
+  NS_TEST_EXPECT_MSG_EQ (m_received, 2000000, "The transfer did not complete");
+}
+
+// ===========================================================================
+// DCTCP keeps the queue around the marking threshold without losses
+// ===========================================================================
+//
+class Ns3TcpDctcpTestCase : public Ns3TcpCongestionControlTestCase
+{
+public:
+  Ns3TcpDctcpTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ns3TcpDctcpTestCase::Ns3TcpDctcpTestCase ()
+  : Ns3TcpCongestionControlTestCase ("Check that DCTCP keeps the queue short with ECN marks")
+{
+}
+
+void
+Ns3TcpDctcpTestCase::DoRun (void)
+{
+  Ptr<RedQueue> queue = CreateObject<RedQueue> ();
+  queue->SetAttribute ("MinTh", DoubleValue (20));
+  queue->SetAttribute ("MaxTh", DoubleValue (20));
+  queue->SetAttribute ("QW", DoubleValue (1));
+  queue->SetAttribute ("Gentle", BooleanValue (false));
+  queue->SetAttribute ("QueueLimit", UintegerValue (1000));
+  queue->SetAttribute ("LinkBandwidth", StringValue ("10Mbps"));
+  queue->SetAttribute ("LinkDelay", StringValue ("10ms"));
+  queue->SetAttribute ("UseEcn", BooleanValue (true));
+  queue->SetAttribute ("UseHardDrop", BooleanValue (false));
+  queue->SetMarkCallback (MakeCallback (&EcnMarker::Mark));
+  RunTransfer ("ns3::TcpDctcp", queue, 4000000);
+
+  RedQueue::Stats stats = queue->GetStats ();
+  NS_TEST_EXPECT_MSG_GT (stats.forcedMark + stats.unforcedMark, 0, "No packet was marked");
+  NS_TEST_EXPECT_MSG_EQ (stats.forcedDrop + stats.unforcedDrop + stats.qLimDrop, 0, "Packets were dropped");
+  NS_TEST_EXPECT_MSG_LT (m_maxQueueLate, 40, "The queue was not kept around the marking threshold");
+  NS_TEST_EXPECT_MSG_EQ (m_received, 4000000, "The transfer did not complete");
+}
+
+// ===========================================================================
+// BBR keeps a shorter queue than NewReno behind a large buffer
+// ===========================================================================
+//
+class Ns3TcpBbrTestCase : public Ns3TcpCongestionControlTestCase
+{
+public:
+  Ns3TcpBbrTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ns3TcpBbrTestCase::Ns3TcpBbrTestCase ()
+  : Ns3TcpCongestionControlTestCase ("Check that BBR does not fill a large buffer")
+{
+}
+
+void
+Ns3TcpBbrTestCase::DoRun (void)
+{
+  Ptr<DropTailQueue> queue = CreateObject<DropTailQueue> ();
+  queue->SetAttribute ("MaxPackets", UintegerValue (1000));
+  RunTransfer ("ns3::TcpNewReno", queue, 4000000);
+  uint32_t newRenoQueue = m_maxQueueLate;
+  NS_TEST_EXPECT_MSG_EQ (m_received, 4000000, "The NewReno transfer did not complete");
+
+  m_received = 0;
+  m_maxQueue = 0;
+  m_maxQueueLate = 0;
+  queue = CreateObject<DropTailQueue> ();
+  queue->SetAttribute ("MaxPackets", UintegerValue (1000));
+  RunTransfer ("ns3::TcpBbr", queue, 4000000);
+  NS_TEST_EXPECT_MSG_EQ (m_received, 4000000, "The BBR transfer did not complete");
+  NS_TEST_EXPECT_MSG_LT (m_maxQueueLate * 2, newRenoQueue, "BBR filled the buffer as NewReno");
+}
+
+class Ns3TcpCongestionControlTestSuite : public TestSuite
+{
+public:
+  Ns3TcpCongestionControlTestSuite ();
+};
+
+Ns3TcpCongestionControlTestSuite::Ns3TcpCongestionControlTestSuite ()
+  : TestSuite ("ns3-tcp-congestion-control", SYSTEM)
+{
+  AddTestCase (new Ns3TcpCubicTestCase, TestCase::QUICK);
+  AddTestCase (new Ns3TcpDctcpTestCase, TestCase::QUICK);
+  AddTestCase (new Ns3TcpBbrTestCase, TestCase::QUICK);
+}
+
+static Ns3TcpCongestionControlTestSuite ns3TcpCongestionControlTestSuite;